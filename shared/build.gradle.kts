@@ -34,7 +34,7 @@ kotlin {
             baseName = "JamiShared"
             isStatic = true
             if (enableJamiBridgeCinterop) {
-                linkerOpts("-L$libjamiLibPath", "-lc++")
+                linkerOpts("-L$libjamiLibPath", "-lc++", "-lsqlite3")
             }
         }
         if (enableJamiBridgeCinterop) {
@@ -51,7 +51,7 @@ kotlin {
                     }
                 }
                 kotlinOptions {
-                    freeCompilerArgs = listOf("-linker-options", "-L$libjamiLibPath -l$libName -ljami -lc++")
+                    freeCompilerArgs = listOf("-linker-options", "-L$libjamiLibPath -l$libName -ljami -lc++ -lsqlite3")
                 }
             }
         }
@@ -66,7 +66,7 @@ kotlin {
             baseName = "JamiShared"
             isStatic = true
             if (enableJamiBridgeCinterop) {
-                linkerOpts("-L$libjamiLibPath", "-lJamiBridge_macos", "-ljami", "-lc++")
+                linkerOpts("-L$libjamiLibPath", "-lJamiBridge_macos", "-ljami", "-lc++", "-lsqlite3")
             }
         }
         if (enableJamiBridgeCinterop) {
@@ -79,7 +79,7 @@ kotlin {
                     }
                 }
                 kotlinOptions {
-                    freeCompilerArgs = listOf("-linker-options", "-L$libjamiLibPath -lJamiBridge_macos -ljami -lc++")
+                    freeCompilerArgs = listOf("-linker-options", "-L$libjamiLibPath -lJamiBridge_macos -ljami -lc++ -lsqlite3")
                 }
             }
         }
@@ -567,6 +567,14 @@ actual class DaemonBridge(private val context: Context) : DaemonBridgeApi, KoinC
         return JamiService.loadSwarmUntil(accountId, conversationId, fromMessage, toMessage)
     }
 
+    override fun cancelSwarmLoad(taskId: Long) {
+        // SwarmLoaded arrives in a single JNI call, nothing to cancel
+    }
+
+    override fun cancelSearch(taskId: Long) {
+        // The daemon cannot stop a search; AccountService drops the remaining batches
+    }
+
     // ==================== Codec Operations ====================
 
     override fun getCodecList(): List<Long> {
@@ -33,6 +33,12 @@ class DataTransfer : Interaction {
 
     var bytesProgress: Long = 0
 
+    /** Smoothed transfer rate while ongoing, 0 when unknown */
+    var bytesPerSecond: Long = 0
+
+    /** Estimated seconds to completion while ongoing, -1 when unknown */
+    var etaSeconds: Double = -1.0
+
     private var cachedExtension: String? = null
     var fileId: String? = null
 
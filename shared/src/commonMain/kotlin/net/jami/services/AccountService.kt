@@ -16,8 +16,12 @@
  */
 package net.jami.services
 
+import kotlinx.atomicfu.locks.SynchronizedObject
+import kotlinx.atomicfu.locks.synchronized
+import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
@@ -25,9 +29,12 @@ import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.emptyFlow
 import kotlinx.coroutines.flow.filter
 import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.onCompletion
 import kotlinx.coroutines.flow.onSubscription
+import kotlinx.coroutines.flow.receiveAsFlow
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.sync.withLock
 import kotlinx.serialization.json.Json
@@ -92,9 +99,13 @@ class AccountService(
 
     // Task ID -> deferred for loadSwarmUntil results
     private val loadingTasks = mutableMapOf<Long, CompletableDeferred<List<SwarmMessage>>>()
+    // Task ID -> messages of the chunks applied so far, for results delivered in chunks
+    private val loadedChunks = mutableMapOf<Long, MutableList<SwarmMessage>>()
 
-    // Task ID -> SharedFlow for searchConversation streaming results
-    private val conversationSearches = mutableMapOf<Long, MutableSharedFlow<ConversationSearchResult>>()
+    // Task ID -> channel for searchConversation streaming results.
+    // Under searchesLock: results arrive on the callback processor, cancellation on the collector.
+    private val searchesLock = SynchronizedObject()
+    private val conversationSearches = mutableMapOf<Long, Channel<ConversationSearchResult>>()
 
     private val accountsMap = mutableMapOf<String, Account>()
 
@@ -591,12 +602,21 @@ class AccountService(
             until
         )
         loadingTasks[taskId] = deferred
-        return deferred.await()
+        try {
+            return deferred.await()
+        } catch (e: CancellationException) {
+            // Conversation closed before the history arrived: drop the remaining chunks
+            loadingTasks.remove(taskId)
+            loadedChunks.remove(taskId)
+            daemonBridge.cancelSwarmLoad(taskId)
+            throw e
+        }
     }
 
     /**
      * Search within a conversation.
      * Returns a [Flow] that emits batches of results and completes when the search is done.
+     * Cancelling the collector (e.g. when the query changed) drops the remaining batches.
      */
     fun searchConversation(
         accountId: String,
@@ -608,25 +628,58 @@ class AccountService(
         after: Long = 0,
         before: Long = 0,
         maxResult: Long = 0
+    ): Flow<ConversationSearchResult> =
+        startSearch(accountId, conversationUri.rawRingId, query, author, type, lastId, after, before, maxResult)
+
+    /**
+     * Search all conversations of an account with a single request: the daemon searches
+     * them in parallel and each conversation's results are emitted as soon as it is done.
+     */
+    fun searchAccount(accountId: String, query: String, maxResultPerConversation: Long = 0): Flow<ConversationSearchResult> =
+        startSearch(accountId, "", query, maxResult = maxResultPerConversation)
+
+    /**
+     * Search the messages indexed on this device. Instant, but only covers messages this
+     * device has received or loaded; empty on platforms without a local index.
+     */
+    fun searchLocalMessages(accountId: String, query: String, limit: Int = 50): List<IndexedMessage> =
+        daemonBridge.searchLocalMessages(accountId, query, limit)
+
+    private fun startSearch(
+        accountId: String,
+        conversationId: String,
+        query: String,
+        author: String = "",
+        type: String = "",
+        lastId: String = "",
+        after: Long = 0,
+        before: Long = 0,
+        maxResult: Long = 0
     ): Flow<ConversationSearchResult> {
-        val flow = MutableSharedFlow<ConversationSearchResult>(extraBufferCapacity = 64)
-        val taskId = daemonBridge.searchConversation(
-            accountId, conversationUri.rawRingId, author, lastId, query, type, after, before, maxResult, 0
-        )
-        conversationSearches[taskId] = flow
-        return flow
+        val results = Channel<ConversationSearchResult>(Channel.UNLIMITED)
+        // Registered under the lock, so a batch arriving before the task id returns waits for it
+        val taskId = synchronized(searchesLock) {
+            daemonBridge.searchConversation(
+                accountId, conversationId, author, lastId, query, type, after, before, maxResult, 0
+            ).also { if (it != 0L) conversationSearches[it] = results }
+        }
+        // 0: the daemon did not start the search (not running), no result will ever come
+        if (taskId == 0L) return emptyFlow()
+        return results.receiveAsFlow().onCompletion {
+            // Still registered: the collector stopped before the search completed
+            if (synchronized(searchesLock) { conversationSearches.remove(taskId) } != null) {
+                daemonBridge.cancelSearch(taskId)
+            }
+        }
     }
 
     /**
      * Resolve swarm history loading tasks and update pagination cursor.
      * Should be called AFTER messages have been added to the model.
      */
-    /**
-     * Resolve swarm history loading tasks.
-     * Should be called AFTER messages have been added to the model.
-     */
     internal fun resolveSwarmLoaded(id: Long, accountId: String, conversationId: String, messages: List<SwarmMessage>) {
         val task = loadingTasks.remove(id)
+        val messages = loadedChunks.remove(id)?.apply { addAll(messages) } ?: messages
         val conversation = getAccount(accountId)?.getSwarm(conversationId)
         if (conversation != null) {
             // Update the session cursor for pagination to the oldest message currently in history.
@@ -639,18 +692,26 @@ class AccountService(
         }
     }
 
+    /**
+     * Keeps a chunk already added to the model, until the last one resolves the task
+     * with the whole result. Chunks of a task no longer awaited are not kept.
+     */
+    internal fun addSwarmChunk(id: Long, messages: List<SwarmMessage>) {
+        if (id !in loadingTasks) return
+        loadedChunks.getOrPut(id) { mutableListOf() }.addAll(messages)
+    }
+
     /**
      * Called when search results arrive from daemon.
      * Emits to the matching search Flow; completes the Flow when conversationId is empty.
      */
     internal fun onMessagesFound(id: Long, accountId: String, conversationId: String, messages: List<Map<String, String>>) {
         if (conversationId.isEmpty()) {
-            conversationSearches.remove(id)
+            synchronized(searchesLock) { conversationSearches.remove(id) }?.close()
             return
         }
         if (messages.isNotEmpty()) {
-            val flow = conversationSearches[id] ?: return
-            scope.launch { flow.emit(ConversationSearchResult(messages)) }
+            synchronized(searchesLock) { conversationSearches[id] }?.trySend(ConversationSearchResult(messages, conversationId))
         }
     }
 
@@ -1436,9 +1497,10 @@ data class AuthResult(
 )
 
 /**
- * A batch of search results from [AccountService.searchConversation].
+ * A batch of search results from [AccountService.searchConversation] or
+ * [AccountService.searchAccount], all from [conversationId].
  */
-data class ConversationSearchResult(val messages: List<Map<String, String>>)
+data class ConversationSearchResult(val messages: List<Map<String, String>>, val conversationId: String = "")
 
 /**
  * Result of a name-server lookup (name ↔ address).
@@ -266,6 +266,18 @@ class CallService(
         }
     }
 
+    /**
+     * Called inline: the bridge only records the set, and a newer one must not be
+     * overtaken by an older one on the dispatcher.
+     */
+    fun setVisibleConferenceStreams(accountId: String, confId: String, streams: List<StreamVisibility>) {
+        daemonBridge.setVisibleConferenceStreams(accountId, confId, streams)
+    }
+
+    fun setConferenceLayoutFollowsVisibility(enabled: Boolean) {
+        daemonBridge.setConferenceLayoutFollowsVisibility(enabled)
+    }
+
     fun playDtmf(key: String) {
         daemonBridge.playDtmf(key)
     }
@@ -111,10 +111,10 @@ class ContactService(
     // ==================== Contact Loading ====================
 
     /**
-     * Load contacts from the daemon for an account.
+     * Load contacts from the daemon for an account, or from a [contactsList]
+     * already fetched with the account snapshot.
      */
-    fun loadContacts(accountId: String) {
-        val contactsList = daemonBridge.getContacts(accountId)
+    fun loadContacts(accountId: String, contactsList: List<Map<String, String>> = daemonBridge.getContacts(accountId)) {
         val accountCache = contactCache.getOrPut(accountId) { mutableMapOf() }
 
         for (contactMap in contactsList) {
@@ -188,14 +188,38 @@ class ContactService(
      */
     internal fun onPresenceUpdate(accountId: String, uriString: String, status: Int) {
         Log.d(TAG, "onPresenceUpdate: uriString=$uriString status=$status accountId=$accountId")
+        val contact = applyPresence(accountId, uriString, status) ?: return
+        scope.launch {
+            _contactEvents.emit(ContactEvent.PresenceUpdated(accountId, contact))
+            Log.d(TAG, "onPresenceUpdate: emitted PresenceUpdated event for ${contact.uri.rawRingId}")
+        }
+    }
+
+    /**
+     * Handle a batch of presence updates: all contacts are updated, then one
+     * [ContactEvent.PresencesUpdated] is emitted for the whole batch.
+     */
+    internal fun onPresenceUpdates(updates: List<PresenceUpdate>) {
+        Log.d(TAG, "onPresenceUpdates: ${updates.size} update(s)")
+        val changed = updates.mapNotNull { update ->
+            applyPresence(update.accountId, update.buddyUri, update.status)
+                ?.let { ContactEvent.PresenceUpdated(update.accountId, it) }
+        }
+        if (changed.isEmpty()) return
+        scope.launch {
+            _contactEvents.emit(ContactEvent.PresencesUpdated(changed))
+        }
+    }
+
+    /** Sets the presence of the cached contact, null when the account is unknown. */
+    private fun applyPresence(accountId: String, uriString: String, status: Int): Contact? {
         val uri = Uri.fromString(uriString)
-        Log.d(TAG, "onPresenceUpdate: parsed uri.uri=${uri.uri} rawRingId=${uri.rawRingId}")
         // Use Account's contact cache — the same objects held by Conversation.contact —
         // so that Contact.isOnline reflects immediately in the conversation list.
         val account = accountService.getAccount(accountId)
         if (account == null) {
             Log.w(TAG, "onPresenceUpdate: account not found for $accountId")
-            return
+            return null
         }
         val contact = account.getContactFromCache(uri)
         val presenceStatus = when (status) {
@@ -203,20 +227,39 @@ class ContactService(
             1 -> Contact.PresenceStatus.AVAILABLE
             else -> Contact.PresenceStatus.CONNECTED
         }
-        Log.d(TAG, "onPresenceUpdate: setting presence $presenceStatus for contact ${contact.uri.rawRingId}, isOnline will be ${presenceStatus != Contact.PresenceStatus.OFFLINE}")
         contact.setPresence(presenceStatus)
-        scope.launch {
-            _contactEvents.emit(ContactEvent.PresenceUpdated(accountId, contact))
-            Log.d(TAG, "onPresenceUpdate: emitted PresenceUpdated event for ${contact.uri.rawRingId}")
-        }
+        return contact
     }
 
     /**
      * Handle profile received from daemon callback.
+     * With [displayName] set the bridge already parsed the card and wrote [avatarPath]
+     * (scaled) into the VCardService disk cache, so the vcf is not read again.
      */
-    internal fun onProfileReceived(accountId: String, peerId: String, vcardPath: String) {
+    internal fun onProfileReceived(
+        accountId: String,
+        peerId: String,
+        vcardPath: String,
+        displayName: String? = null,
+        avatarPath: String? = null
+    ) {
         scope.launch {
             val uri = Uri.fromString(peerId)
+            if (displayName != null) {
+                val avatar = avatarPath?.let { net.jami.utils.FileUtils.readBytes(it) }
+                if (displayName.isNotEmpty() || avatar != null) {
+                    val profile = Profile(
+                        displayName = displayName.ifEmpty { null },
+                        avatar = avatar
+                    )
+                    profileCache["$accountId:${uri.uri}"] = profile
+                    findContactInCache(accountId, uri)?.loadedProfile = profile
+                    vCardService.updatePeer(accountId, uri.rawRingId, avatar)
+                    _contactEvents.emit(ContactEvent.ProfileUpdated(accountId, uri, profile))
+                }
+                _contactEvents.emit(ContactEvent.ProfileReceived(accountId, uri, vcardPath))
+                return@launch
+            }
             val vcardContent = net.jami.utils.FileUtils.readText(vcardPath)
             if (vcardContent != null) {
                 val vcard = net.jami.utils.VCardUtils.parseVCard(vcardContent)
@@ -419,6 +462,8 @@ sealed class ContactEvent {
     data class ContactAdded(val accountId: String, val contact: Contact) : ContactEvent()
     data class ContactRemoved(val accountId: String, val contact: Contact, val banned: Boolean) : ContactEvent()
     data class PresenceUpdated(val accountId: String, val contact: Contact) : ContactEvent()
+    /** Presence changes delivered together, see [ContactService.onPresenceUpdates]. */
+    data class PresencesUpdated(val updates: List<PresenceUpdated>) : ContactEvent()
     data class ProfileUpdated(val accountId: String, val uri: Uri, val profile: Profile) : ContactEvent()
     data class ProfileReceived(val accountId: String, val uri: Uri, val vcardPath: String) : ContactEvent()
 }
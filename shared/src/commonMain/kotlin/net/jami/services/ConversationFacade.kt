@@ -620,55 +620,66 @@ class ConversationFacade(
 
         try {
             if (account.isJami) {
-                // Load swarm conversations from daemon
-                val conversationIds = daemonBridge.getConversations(account.accountId)
-            for (convId in conversationIds) {
-                try {
-                    val info = daemonBridge.getConversationInfo(account.accountId, convId)
-                    val mode = when (info["mode"]) {
-                        "0" -> Conversation.Mode.OneToOne
-                        "1" -> Conversation.Mode.AdminInvitesOnly
-                        "2" -> Conversation.Mode.InvitesOnly
-                        "3" -> Conversation.Mode.Public
-                        else -> Conversation.Mode.OneToOne
-                    }
-                    val conversation = account.getSwarm(convId)
-                        ?: account.newSwarm(convId, mode)
-                    conversation.setMode(mode)
-
-                    // Load members
-                    val members = daemonBridge.getConversationMembers(account.accountId, convId)
-                    for (member in members) {
-                        val memberUri = member["uri"] ?: continue
-                        val memberUriParsed = Uri.fromString(memberUri)
-                        if (conversation.findContact(memberUriParsed) == null) {
-                            val contact = account.getContactFromCache(memberUriParsed)
-                            val role = MemberRole.fromString(member["role"] ?: "")
-                            conversation.addContact(contact, role)
+                // Load swarm conversations from daemon: one snapshot instead of
+                // info + members round trips per conversation
+                val snapshot = daemonBridge.snapshotAccount(account.accountId)
+                // The rest of the snapshot refreshes what the account and contacts already hold
+                account.details.putAll(snapshot.details)
+                account.volatileDetails.putAll(snapshot.volatileDetails)
+                contactService.loadContacts(account.accountId, snapshot.contacts)
+                for (conversationSnapshot in snapshot.conversations) {
+                    val convId = conversationSnapshot.conversationId
+                    try {
+                        val info = conversationSnapshot.info
+                        val mode = when (info["mode"]) {
+                            "0" -> Conversation.Mode.OneToOne
+                            "1" -> Conversation.Mode.AdminInvitesOnly
+                            "2" -> Conversation.Mode.InvitesOnly
+                            "3" -> Conversation.Mode.Public
+                            else -> Conversation.Mode.OneToOne
+                        }
+                        val conversation = account.getSwarm(convId)
+                            ?: account.newSwarm(convId, mode)
+                        conversation.setMode(mode)
+
+                        // Load members
+                        for (member in conversationSnapshot.members) {
+                            val memberUri = member["uri"] ?: continue
+                            val memberUriParsed = Uri.fromString(memberUri)
+                            if (conversation.findContact(memberUriParsed) == null) {
+                                val contact = account.getContactFromCache(memberUriParsed)
+                                val role = MemberRole.fromString(member["role"] ?: "")
+                                conversation.addContact(contact, role)
+                            }
                         }
-                    }
 
-                    // Set title if available
-                    val title = info["title"]
-                    if (!title.isNullOrEmpty()) {
-                        conversation.setProfile(Profile(title, null))
-                    }
+                        // Set title if available
+                        val title = info["title"]
+                        if (!title.isNullOrEmpty()) {
+                            conversation.setProfile(Profile(title, null))
+                        }
 
-                    account.conversationStarted(conversation)
+                        account.conversationStarted(conversation)
 
-                    // Subscribe to presence and resolve registered names for each contact
-                    for (contact in conversation.contacts) {
-                        if (!contact.isUser) {
-                            contactService.subscribeBuddy(account.accountId, contact.uri, true)
-                            if (contact.username.isNullOrEmpty()) {
-                                accountService.lookupAddress(account.accountId, contact.uri.rawRingId)
+                        // Subscribe to presence and resolve registered names for each contact
+                        for (contact in conversation.contacts) {
+                            if (!contact.isUser) {
+                                contactService.subscribeBuddy(account.accountId, contact.uri, true)
+                                if (contact.username.isNullOrEmpty()) {
+                                    accountService.lookupAddress(account.accountId, contact.uri.rawRingId)
+                                }
                             }
                         }
+                    } catch (e: Exception) {
+                        Log.e(TAG, "loadSmartlist: failed to load conversation $convId", e)
                     }
-                } catch (e: Exception) {
-                    Log.e(TAG, "loadSmartlist: failed to load conversation $convId", e)
                 }
-            }
+
+                // Pending requests; trust requests of swarm accounts arrive as these too
+                for (request in snapshot.conversationRequests) {
+                    val convId = request["id"] ?: continue
+                    addConversationRequest(account, convId, request)
+                }
             } else {
                 // Load history for non-swarm (SIP) conversations
                 val interactions = historyService.getSmartlist(account.accountId)
@@ -1056,6 +1067,16 @@ class ConversationFacade(
             return
         }
 
+        addConversationRequest(account, conversationId, metadata)
+        scope.launch {
+            _conversationEvents.emit(ConversationEvent.ConversationRequestReceived(accountId, conversationId, metadata))
+        }
+    }
+
+    /**
+     * Add a conversation request to the account's pending conversations.
+     */
+    private fun addConversationRequest(account: Account, conversationId: String, metadata: Map<String, String>) {
         val conversation = account.getSwarm(conversationId)
             ?: account.newSwarm(conversationId, Conversation.Mode.Request)
         conversation.setMode(Conversation.Mode.Request)
@@ -1078,9 +1099,6 @@ class ConversationFacade(
         }
 
         account.addPendingConversation(conversation)
-        scope.launch {
-            _conversationEvents.emit(ConversationEvent.ConversationRequestReceived(accountId, conversationId, metadata))
-        }
     }
 
     /**
@@ -1153,6 +1171,17 @@ class ConversationFacade(
         }
     }
 
+    /**
+     * Called when messages are updated together: one [ConversationEvent.MessagesUpdated] for the batch.
+     */
+    internal fun onMessagesUpdated(updates: List<MessageUpdate>) {
+        Log.d(TAG, "onMessagesUpdated: ${updates.size} message(s)")
+        val events = updates.map { ConversationEvent.MessageUpdated(it.accountId, it.conversationId, it.message) }
+        scope.launch {
+            _conversationEvents.emit(ConversationEvent.MessagesUpdated(events))
+        }
+    }
+
     /**
      * Called when messages are found from search.
      * Delegates task resolution to AccountService, then emits the conversation event.
@@ -1424,6 +1453,17 @@ class ConversationFacade(
         }
     }
 
+    /**
+     * Called when composing statuses change together: one [ConversationEvent.ComposingStatusesChanged] for the batch.
+     */
+    internal fun onComposingStatusesChanged(updates: List<ComposingUpdate>) {
+        Log.d(TAG, "onComposingStatusesChanged: ${updates.size} update(s)")
+        val events = updates.map { ConversationEvent.ComposingStatusChanged(it.accountId, it.conversationId, it.contactUri, it.status) }
+        scope.launch {
+            _conversationEvents.emit(ConversationEvent.ComposingStatusesChanged(events))
+        }
+    }
+
     /**
      * Called when a data transfer event occurs.
      */
@@ -1496,6 +1536,33 @@ class ConversationFacade(
         }
     }
 
+    /**
+     * Called with the sampled progress of an ongoing data transfer, or of a file
+     * being prepared for sending ([FileTransferInfo.preparing]).
+     */
+    internal fun onDataTransferProgress(accountId: String, conversationId: String, interactionId: String, fileId: String, info: FileTransferInfo) {
+        scope.launch {
+            if (info.preparing) {
+                // No interaction yet: the file is known by the path it was sent with
+                _conversationEvents.emit(ConversationEvent.FilePreparing(
+                    accountId, conversationId, info.path, info.totalSize, info.bytesProgress,
+                    finished = info.etaSeconds == 0.0
+                ))
+                return@launch
+            }
+            val conversation = accountService.getAccount(accountId)?.getSwarm(conversationId) ?: return@launch
+            val transfer = conversation.getMessage(interactionId) as? DataTransfer ?: return@launch
+            if (transfer.fileId.isNullOrEmpty()) {
+                transfer.fileId = fileId
+            }
+            transfer.totalSize = info.totalSize
+            transfer.bytesProgress = info.bytesProgress
+            transfer.bytesPerSecond = info.bytesPerSecond
+            transfer.etaSeconds = info.etaSeconds
+            conversation.updateInteraction(transfer)
+        }
+    }
+
     companion object {
         private const val TAG = "ConversationFacade"
     }
@@ -1584,6 +1651,11 @@ sealed class ConversationEvent {
         val message: SwarmMessage
     ) : ConversationEvent()
 
+    /** Messages updated together, in order, see [ConversationFacade.onMessagesUpdated]. */
+    data class MessagesUpdated(
+        val updates: List<MessageUpdated>
+    ) : ConversationEvent()
+
     data class SwarmLoaded(
         val accountId: String,
         val conversationId: String,
@@ -1619,6 +1691,11 @@ sealed class ConversationEvent {
         val status: Int
     ) : ConversationEvent()
 
+    /** Composing changes delivered together, in order, see [ConversationFacade.onComposingStatusesChanged]. */
+    data class ComposingStatusesChanged(
+        val updates: List<ComposingStatusChanged>
+    ) : ConversationEvent()
+
     data class DataTransferEvent(
         val accountId: String,
         val conversationId: String,
@@ -1627,6 +1704,15 @@ sealed class ConversationEvent {
         val eventCode: Int
     ) : ConversationEvent()
 
+    data class FilePreparing(
+        val accountId: String,
+        val conversationId: String,
+        val path: String,
+        val totalSize: Long,
+        val bytesProgress: Long,
+        val finished: Boolean
+    ) : ConversationEvent()
+
     data class ActiveCallsChanged(
         val accountId: String,
         val conversationId: String,
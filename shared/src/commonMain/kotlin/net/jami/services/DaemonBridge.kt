@@ -13,6 +13,13 @@ interface DaemonBridgeApi {
     // ==================== Lifecycle ====================
     fun init(callbacks: DaemonCallbacks): Boolean
     fun start(): Boolean
+
+    /**
+     * Starts the daemon without blocking the caller. [onStarted] is called once accounts are
+     * loaded (true) or startup failed (false), on a background thread. The default runs
+     * [start] inline; bridges whose startup can take seconds (iOS) override it.
+     */
+    fun startAsync(onStarted: (Boolean) -> Unit) = onStarted(start())
     fun stop()
     fun isRunning(): Boolean
 
@@ -28,6 +35,28 @@ interface DaemonBridgeApi {
     fun sendRegister(accountId: String, enable: Boolean)
     fun setAccountsOrder(order: String)
     fun changeAccountPassword(accountId: String, oldPassword: String, newPassword: String): Boolean
+
+    /**
+     * Account details, contacts, requests and every conversation's info and members in one call.
+     * Maps have the same shape as the individual getters. Bridges that can build the graph
+     * natively (iOS) override this; the default issues the individual calls.
+     */
+    fun snapshotAccount(accountId: String): AccountSnapshot = AccountSnapshot(
+        accountId = accountId,
+        details = getAccountDetails(accountId),
+        volatileDetails = getVolatileAccountDetails(accountId),
+        contacts = getContacts(accountId),
+        conversations = getConversations(accountId).map { conversationId ->
+            ConversationSnapshot(
+                conversationId = conversationId,
+                info = getConversationInfo(accountId, conversationId),
+                members = getConversationMembers(accountId, conversationId)
+            )
+        },
+        conversationRequests = getConversationRequests(accountId),
+        trustRequests = getTrustRequests(accountId)
+    )
+    fun snapshotAccounts(): List<AccountSnapshot> = getAccountList().map { snapshotAccount(it) }
     fun exportToFile(accountId: String, path: String, scheme: String, password: String): Boolean
 
     // ==================== Credentials ====================
@@ -77,6 +106,16 @@ interface DaemonBridgeApi {
     fun resumeConference(accountId: String, confId: String): Boolean
     fun setActiveParticipant(accountId: String, confId: String, callId: String)
     fun setConferenceLayout(accountId: String, confId: String, layout: Int)
+
+    /**
+     * Participant streams currently on screen, with their size in pixels. Bridges that
+     * render conference sinks themselves (iOS) stop decoding the others; the default
+     * ignores it.
+     */
+    fun setVisibleConferenceStreams(accountId: String, confId: String, streams: List<StreamVisibility>) {}
+
+    /** Hosted conferences showing a single stream switch to the one-big layout on it (iOS). */
+    fun setConferenceLayoutFollowsVisibility(enabled: Boolean) {}
     fun hangUpConference(accountId: String, confId: String): Boolean
     fun joinParticipant(accountId: String, selCallId: String, account2Id: String, dragCallId: String): Boolean
     fun addParticipant(accountId: String, callId: String, account2Id: String, confId: String): Boolean
@@ -99,6 +138,12 @@ interface DaemonBridgeApi {
     fun getConversationPreferences(accountId: String, conversationId: String): Map<String, String>
     fun setConversationPreferences(accountId: String, conversationId: String, prefs: Map<String, String>)
     fun setMessageDisplayed(accountId: String, conversationUri: String, messageId: String, status: Int)
+
+    /**
+     * Unread message count per conversation, counted by the daemon without loading messages.
+     * Blocking. The default (bridges without countInteractions) reports none.
+     */
+    fun countUnreadMessages(accountId: String, conversationIds: List<String>): Map<String, Int> = emptyMap()
     fun getActiveCalls(accountId: String, conversationId: String): List<Map<String, String>>
 
     // ==================== Conversation Requests ====================
@@ -156,6 +201,16 @@ interface DaemonBridgeApi {
     // ==================== Search & History ====================
     fun searchConversation(accountId: String, conversationId: String, author: String, lastId: String, query: String, type: String, after: Long, before: Long, maxResult: Long, flag: Int): Long
     fun loadSwarmUntil(accountId: String, conversationId: String, fromMessage: String, toMessage: String): Long
+    /** Stops delivering the result of a [loadSwarmUntil] task that is no longer awaited. */
+    fun cancelSwarmLoad(taskId: Long)
+    /** Stops delivering the results of a superseded [searchConversation] task. */
+    fun cancelSearch(taskId: Long)
+    /**
+     * Full-text search of the messages indexed on this device, best matches first.
+     * Only bridges keeping a local index (iOS) override this; the default finds nothing,
+     * leaving [searchConversation] as the only source.
+     */
+    fun searchLocalMessages(accountId: String, query: String, limit: Int): List<IndexedMessage> = emptyList()
 
     // ==================== Push Notifications ====================
     fun setPushNotificationToken(token: String)
@@ -370,11 +425,94 @@ expect class DaemonBridge : DaemonBridgeApi
 
 /**
  * File transfer information from the daemon.
+ *
+ * [bytesPerSecond] and [etaSeconds] are smoothed estimates, only known on platforms
+ * that track ongoing transfers (0 and -1 otherwise).
+ *
+ * [preparing] marks a file still being preprocessed before it is sent (iOS): there
+ * is no interaction yet, [path] is the one given to sendFile and [etaSeconds] is 0
+ * once the file is handed to the daemon.
  */
 data class FileTransferInfo(
     val path: String,
     val totalSize: Long,
-    val bytesProgress: Long
+    val bytesProgress: Long,
+    val bytesPerSecond: Long = 0,
+    val etaSeconds: Double = -1.0,
+    val preparing: Boolean = false
+)
+
+/**
+ * A conference participant sink on screen, see [DaemonBridgeApi.setVisibleConferenceStreams].
+ */
+data class StreamVisibility(
+    val sinkId: String,
+    val width: Int,
+    val height: Int
+)
+
+/**
+ * Info and members of one conversation, see [DaemonBridgeApi.snapshotAccount].
+ */
+data class ConversationSnapshot(
+    val conversationId: String,
+    val info: Map<String, String>,
+    val members: List<Map<String, String>>
+)
+
+/**
+ * Bootstrap state of an account, see [DaemonBridgeApi.snapshotAccount].
+ */
+data class AccountSnapshot(
+    val accountId: String,
+    val details: Map<String, String>,
+    val volatileDetails: Map<String, String>,
+    val contacts: List<Map<String, String>>,
+    val conversations: List<ConversationSnapshot>,
+    val conversationRequests: List<Map<String, String>>,
+    val trustRequests: List<Map<String, String>>
+)
+
+/**
+ * A text message from the local index, see [DaemonBridgeApi.searchLocalMessages].
+ * [timestamp] is in seconds, like daemon message timestamps.
+ */
+data class IndexedMessage(
+    val accountId: String,
+    val conversationId: String,
+    val messageId: String,
+    val author: String,
+    val body: String,
+    val timestamp: Long
+)
+
+/**
+ * One presence change of a batch, see [DaemonCallbacks.onNewBuddyNotifications].
+ */
+data class PresenceUpdate(
+    val accountId: String,
+    val buddyUri: String,
+    val status: Int,
+    val lineStatus: String
+)
+
+/**
+ * One composing change of a batch, see [DaemonCallbacks.onComposingStatusesChanged].
+ */
+data class ComposingUpdate(
+    val accountId: String,
+    val conversationId: String,
+    val contactUri: String,
+    val status: Int
+)
+
+/**
+ * One edited message of a batch, see [DaemonCallbacks.onMessagesUpdated].
+ */
+data class MessageUpdate(
+    val accountId: String,
+    val conversationId: String,
+    val message: SwarmMessage
 )
 
 /**
@@ -414,8 +552,20 @@ interface DaemonCallbacks {
     fun onConversationMemberEvent(accountId: String, conversationId: String, memberId: String, event: Int)
     fun onMessageReceived(accountId: String, conversationId: String, message: SwarmMessage)
     fun onMessageUpdated(accountId: String, conversationId: String, message: SwarmMessage)
+    /**
+     * Messages edited together, for bridges that coalesce them (iOS). Applied as one update;
+     * by default each goes through [onMessageUpdated].
+     */
+    fun onMessagesUpdated(updates: List<MessageUpdate>) {
+        updates.forEach { onMessageUpdated(it.accountId, it.conversationId, it.message) }
+    }
     fun onMessagesFound(messageId: Int, accountId: String, conversationId: String, messages: List<Map<String, String>>)
     fun onSwarmLoaded(id: Long, accountId: String, conversationId: String, messages: List<SwarmMessage>)
+    /**
+     * Part of a [onSwarmLoaded] result, for bridges that deliver it in chunks (iOS). Every chunk
+     * is added to the conversation as it arrives; the one with [isLast] completes the load.
+     */
+    fun onSwarmLoadedChunk(id: Long, accountId: String, conversationId: String, messages: List<SwarmMessage>, isLast: Boolean)
     fun onConversationProfileUpdated(accountId: String, conversationId: String, profile: Map<String, String>)
     fun onConversationPreferencesUpdated(accountId: String, conversationId: String, preferences: Map<String, String>)
     fun onReactionAdded(accountId: String, conversationId: String, messageId: String, reaction: Map<String, String>)
@@ -424,17 +574,29 @@ interface DaemonCallbacks {
 
     // ==================== Presence Callbacks ====================
     fun onNewBuddyNotification(accountId: String, buddyUri: String, status: Int, lineStatus: String)
+    /** Presence changes coalesced by the bridge (iOS), applied as one update. */
+    fun onNewBuddyNotifications(updates: List<PresenceUpdate>) {
+        updates.forEach { onNewBuddyNotification(it.accountId, it.buddyUri, it.status, it.lineStatus) }
+    }
 
     // ==================== Contact Callbacks ====================
     fun onContactAdded(accountId: String, uri: String, confirmed: Boolean)
     fun onContactRemoved(accountId: String, uri: String, banned: Boolean)
     fun onIncomingTrustRequest(accountId: String, conversationId: String, from: String, payload: ByteArray, receiveTime: Long)
-    fun onProfileReceived(accountId: String, peerId: String, vcardPath: String)
+    /**
+     * A peer profile arrived. Bridges that parse the card natively (iOS/macOS) pass its
+     * [displayName] and a scaled [avatarPath]; otherwise both are null and [vcardPath] is read.
+     */
+    fun onProfileReceived(accountId: String, peerId: String, vcardPath: String, displayName: String? = null, avatarPath: String? = null)
 
     // ==================== Message Callbacks ====================
     fun onIncomingAccountMessage(accountId: String, messageId: String?, callId: String?, from: String, messages: Map<String, String>)
     fun onAccountMessageStatusChanged(accountId: String, conversationId: String, messageId: String, contactId: String, status: Int)
     fun onComposingStatusChanged(accountId: String, conversationId: String, contactUri: String, status: Int)
+    /** Composing changes coalesced by the bridge (iOS), applied as one update. */
+    fun onComposingStatusesChanged(updates: List<ComposingUpdate>) {
+        updates.forEach { onComposingStatusChanged(it.accountId, it.conversationId, it.contactUri, it.status) }
+    }
 
     // ==================== Name Service Callbacks ====================
     fun onNameRegistrationEnded(accountId: String, state: Int, name: String)
@@ -443,6 +605,7 @@ interface DaemonCallbacks {
 
     // ==================== Data Transfer Callbacks ====================
     fun onDataTransferEvent(accountId: String, conversationId: String, interactionId: String, fileId: String, eventCode: Int)
+    fun onDataTransferProgress(accountId: String, conversationId: String, interactionId: String, fileId: String, info: FileTransferInfo)
 }
 
 /**
@@ -466,6 +629,7 @@ class StubDaemonBridge : DaemonBridgeApi {
     var conversationMembers: MutableMap<String, List<Map<String, String>>> = mutableMapOf()
     var conversationInfo: MutableMap<String, Map<String, String>> = mutableMapOf()
     var contacts: MutableMap<String, List<Map<String, String>>> = mutableMapOf()
+    var conversationRequests: MutableMap<String, List<Map<String, String>>> = mutableMapOf()
     var codecs: List<Long> = emptyList()
     var addAccountResult: String = ""
     var placeCallResult: String = ""
@@ -555,7 +719,7 @@ class StubDaemonBridge : DaemonBridgeApi {
     override fun setMessageDisplayed(accountId: String, conversationUri: String, messageId: String, status: Int) {}
     override fun getActiveCalls(accountId: String, conversationId: String): List<Map<String, String>> = emptyList()
 
-    override fun getConversationRequests(accountId: String): List<Map<String, String>> = emptyList()
+    override fun getConversationRequests(accountId: String): List<Map<String, String>> = conversationRequests[accountId] ?: emptyList()
     override fun acceptConversationRequest(accountId: String, conversationId: String) {}
     override fun declineConversationRequest(accountId: String, conversationId: String) {}
 
@@ -596,8 +760,14 @@ class StubDaemonBridge : DaemonBridgeApi {
     override fun getCodecDetails(accountId: String, codecId: Long): Map<String, String> = emptyMap()
 
     private var nextTaskId: Long = 1L
-    override fun searchConversation(accountId: String, conversationId: String, author: String, lastId: String, query: String, type: String, after: Long, before: Long, maxResult: Long, flag: Int): Long = nextTaskId++
+    /** Answers searches with task id 0, as a daemon that is not running does. */
+    var rejectSearches = false
+    override fun searchConversation(accountId: String, conversationId: String, author: String, lastId: String, query: String, type: String, after: Long, before: Long, maxResult: Long, flag: Int): Long =
+        if (rejectSearches) 0L else nextTaskId++
     override fun loadSwarmUntil(accountId: String, conversationId: String, fromMessage: String, toMessage: String): Long = nextTaskId++
+    override fun cancelSwarmLoad(taskId: Long) {}
+    val cancelledSearches = mutableListOf<Long>()
+    override fun cancelSearch(taskId: Long) { cancelledSearches += taskId }
 
     override fun setPushNotificationToken(token: String) {}
     override fun setPushNotificationConfig(config: Map<String, String>) {}
@@ -49,13 +49,17 @@ class DaemonCallbacksImpl(
 
     sealed class ConversationTask {
         data class SwarmLoaded(val id: Long, val accountId: String, val conversationId: String, val messages: List<SwarmMessage>) : ConversationTask()
+        data class SwarmLoadedChunk(val id: Long, val accountId: String, val conversationId: String, val messages: List<SwarmMessage>, val isLast: Boolean) : ConversationTask()
         data class MessageReceived(val accountId: String, val conversationId: String, val message: SwarmMessage) : ConversationTask()
         data class MessageUpdated(val accountId: String, val conversationId: String, val message: SwarmMessage) : ConversationTask()
+        data class MessagesUpdated(val updates: List<MessageUpdate>) : ConversationTask()
         data class DataTransfer(val accountId: String, val conversationId: String, val interactionId: String, val fileId: String, val eventCode: Int) : ConversationTask()
+        data class DataTransferProgress(val accountId: String, val conversationId: String, val interactionId: String, val fileId: String, val info: FileTransferInfo) : ConversationTask()
         data class Ready(val accountId: String, val conversationId: String) : ConversationTask()
         data class Removed(val accountId: String, val conversationId: String) : ConversationTask()
         data class RequestReceived(val accountId: String, val conversationId: String, val metadata: Map<String, String>) : ConversationTask()
         data class MemberEvent(val accountId: String, val conversationId: String, val memberId: String, val event: Int) : ConversationTask()
+        data class MessagesFound(val messageId: Int, val accountId: String, val conversationId: String, val messages: List<Map<String, String>>) : ConversationTask()
     }
 
     sealed class AccountTask {
@@ -76,15 +80,30 @@ class DaemonCallbacksImpl(
                             // 2. Resolve loading tasks and update cursor
                             accountService.resolveSwarmLoaded(task.id, task.accountId, task.conversationId, task.messages)
                         }
+                        is ConversationTask.SwarmLoadedChunk -> {
+                            // Each chunk reaches the model (and the chat) as it arrives
+                            conversationFacade.onSwarmLoaded(task.id, task.accountId, task.conversationId, task.messages)
+                            if (task.isLast) {
+                                accountService.resolveSwarmLoaded(task.id, task.accountId, task.conversationId, task.messages)
+                            } else {
+                                accountService.addSwarmChunk(task.id, task.messages)
+                            }
+                        }
                         is ConversationTask.MessageReceived -> {
                             conversationFacade.onMessageReceived(task.accountId, task.conversationId, task.message)
                         }
                         is ConversationTask.MessageUpdated -> {
                             conversationFacade.onMessageUpdated(task.accountId, task.conversationId, task.message)
                         }
+                        is ConversationTask.MessagesUpdated -> {
+                            conversationFacade.onMessagesUpdated(task.updates)
+                        }
                         is ConversationTask.DataTransfer -> {
                             conversationFacade.onDataTransferEvent(task.accountId, task.conversationId, task.interactionId, task.fileId, task.eventCode)
                         }
+                        is ConversationTask.DataTransferProgress -> {
+                            conversationFacade.onDataTransferProgress(task.accountId, task.conversationId, task.interactionId, task.fileId, task.info)
+                        }
                         is ConversationTask.Ready -> {
                             conversationFacade.onConversationReady(task.accountId, task.conversationId)
                         }
@@ -97,6 +116,10 @@ class DaemonCallbacksImpl(
                         is ConversationTask.MemberEvent -> {
                             conversationFacade.onConversationMemberEvent(task.accountId, task.conversationId, task.memberId, task.event)
                         }
+                        is ConversationTask.MessagesFound -> {
+                            // In order: the empty-conversationId end marker closes the search after its last batch
+                            conversationFacade.onMessagesFound(task.messageId, task.accountId, task.conversationId, task.messages)
+                        }
                     }
                 } catch (e: Exception) {
                     Log.e(TAG, "Error in conversation event processor: ${e.message}")
@@ -234,14 +257,22 @@ class DaemonCallbacksImpl(
         conversationTasks.trySend(ConversationTask.MessageUpdated(accountId, conversationId, message))
     }
 
+    override fun onMessagesUpdated(updates: List<MessageUpdate>) {
+        if (updates.isNotEmpty()) conversationTasks.trySend(ConversationTask.MessagesUpdated(updates))
+    }
+
     override fun onMessagesFound(messageId: Int, accountId: String, conversationId: String, messages: List<Map<String, String>>) {
-        scope.launch { conversationFacade.onMessagesFound(messageId, accountId, conversationId, messages) }
+        conversationTasks.trySend(ConversationTask.MessagesFound(messageId, accountId, conversationId, messages))
     }
 
     override fun onSwarmLoaded(id: Long, accountId: String, conversationId: String, messages: List<SwarmMessage>) {
         conversationTasks.trySend(ConversationTask.SwarmLoaded(id, accountId, conversationId, messages))
     }
 
+    override fun onSwarmLoadedChunk(id: Long, accountId: String, conversationId: String, messages: List<SwarmMessage>, isLast: Boolean) {
+        conversationTasks.trySend(ConversationTask.SwarmLoadedChunk(id, accountId, conversationId, messages, isLast))
+    }
+
     override fun onConversationProfileUpdated(accountId: String, conversationId: String, profile: Map<String, String>) {
         scope.launch { conversationFacade.onConversationProfileUpdated(accountId, conversationId, profile) }
     }
@@ -268,6 +299,10 @@ class DaemonCallbacksImpl(
         scope.launch { contactService.onPresenceUpdate(accountId, buddyUri, status) }
     }
 
+    override fun onNewBuddyNotifications(updates: List<PresenceUpdate>) {
+        if (updates.isNotEmpty()) scope.launch { contactService.onPresenceUpdates(updates) }
+    }
+
     // ==================== Contact Callbacks ====================
 
     override fun onContactAdded(accountId: String, uri: String, confirmed: Boolean) {
@@ -282,8 +317,8 @@ class DaemonCallbacksImpl(
         scope.launch { accountService.onIncomingTrustRequest(accountId, conversationId, from, payload, receiveTime) }
     }
 
-    override fun onProfileReceived(accountId: String, peerId: String, vcardPath: String) {
-        scope.launch { contactService.onProfileReceived(accountId, peerId, vcardPath) }
+    override fun onProfileReceived(accountId: String, peerId: String, vcardPath: String, displayName: String?, avatarPath: String?) {
+        scope.launch { contactService.onProfileReceived(accountId, peerId, vcardPath, displayName, avatarPath) }
     }
 
     // ==================== Message Callbacks ====================
@@ -300,6 +335,10 @@ class DaemonCallbacksImpl(
         scope.launch { conversationFacade.onComposingStatusChanged(accountId, conversationId, contactUri, status) }
     }
 
+    override fun onComposingStatusesChanged(updates: List<ComposingUpdate>) {
+        if (updates.isNotEmpty()) scope.launch { conversationFacade.onComposingStatusesChanged(updates) }
+    }
+
     // ==================== Name Service Callbacks ====================
 
     override fun onNameRegistrationEnded(accountId: String, state: Int, name: String) {
@@ -319,4 +358,8 @@ class DaemonCallbacksImpl(
     override fun onDataTransferEvent(accountId: String, conversationId: String, interactionId: String, fileId: String, eventCode: Int) {
         conversationTasks.trySend(ConversationTask.DataTransfer(accountId, conversationId, interactionId, fileId, eventCode))
     }
+
+    override fun onDataTransferProgress(accountId: String, conversationId: String, interactionId: String, fileId: String, info: FileTransferInfo) {
+        conversationTasks.trySend(ConversationTask.DataTransferProgress(accountId, conversationId, interactionId, fileId, info))
+    }
 }
@@ -97,6 +97,14 @@ class VCardService(
         }
     }
 
+    /**
+     * Replace the in-memory entry for a peer's avatar with bytes already scaled by the
+     * native bridge, which also wrote them to the disk cache.
+     */
+    fun updatePeer(accountId: String, peerUri: String, avatar: ByteArray?) {
+        memoryCache["$accountId:$peerUri"] = avatar
+    }
+
     /**
      * Invalidate the in-memory cache entry for the local account avatar.
      * Call this when the account profile has been updated.
@@ -43,13 +43,24 @@ import androidx.compose.material3.MaterialTheme
 import androidx.compose.material3.Surface
 import androidx.compose.material3.Text
 import androidx.compose.runtime.Composable
+import androidx.compose.runtime.DisposableEffect
+import androidx.compose.runtime.LaunchedEffect
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableStateMapOf
+import androidx.compose.runtime.remember
+import androidx.compose.runtime.rememberUpdatedState
+import androidx.compose.runtime.snapshotFlow
 import androidx.compose.ui.Alignment
 import androidx.compose.ui.Modifier
 import androidx.compose.ui.draw.clip
 import androidx.compose.ui.graphics.Color
+import androidx.compose.ui.layout.onSizeChanged
 import androidx.compose.ui.text.style.TextAlign
 import androidx.compose.ui.text.style.TextOverflow
+import androidx.compose.ui.unit.IntSize
 import androidx.compose.ui.unit.dp
+import kotlinx.coroutines.flow.distinctUntilChanged
+import net.jami.services.StreamVisibility
 import kotlin.math.ceil
 import kotlin.math.sqrt
 
@@ -88,6 +99,8 @@ enum class GridLayoutMode {
  * @param layoutMode Layout mode (auto, grid, spotlight, strip)
  * @param showNames Whether to show participant names
  * @param showStatusIcons Whether to show mute/video status icons
+ * @param onVisibleStreamsChanged Called with the video tiles on screen and their size in
+ *   pixels whenever a tile scrolls in or out or is resized
  */
 @Composable
 fun ParticipantGrid(
@@ -95,26 +108,52 @@ fun ParticipantGrid(
     modifier: Modifier = Modifier,
     layoutMode: GridLayoutMode = GridLayoutMode.AUTO,
     showNames: Boolean = true,
-    showStatusIcons: Boolean = true
+    showStatusIcons: Boolean = true,
+    onVisibleStreamsChanged: (List<StreamVisibility>) -> Unit = {}
 ) {
+    val visibleStreams = remember { VisibleStreams() }
+    val onChanged by rememberUpdatedState(onVisibleStreamsChanged)
+    LaunchedEffect(visibleStreams) {
+        snapshotFlow { visibleStreams.toList() }
+            .distinctUntilChanged()
+            .collect { onChanged(it) }
+    }
+
     if (participants.isEmpty()) {
         EmptyParticipantState(modifier)
         return
     }
 
     when (layoutMode) {
-        GridLayoutMode.SPOTLIGHT -> SpotlightLayout(participants, modifier, showNames, showStatusIcons)
-        GridLayoutMode.STRIP -> StripLayout(participants, modifier, showNames, showStatusIcons)
-        else -> AutoGridLayout(participants, modifier, showNames, showStatusIcons)
+        GridLayoutMode.SPOTLIGHT -> SpotlightLayout(participants, modifier, showNames, showStatusIcons, visibleStreams)
+        GridLayoutMode.STRIP -> StripLayout(participants, modifier, showNames, showStatusIcons, visibleStreams)
+        else -> AutoGridLayout(participants, modifier, showNames, showStatusIcons, visibleStreams)
     }
 }
 
+/**
+ * Sizes of the video tiles currently composed, by sink. Lazy layouts dispose the
+ * tiles scrolled out, which removes them.
+ */
+private class VisibleStreams {
+    private val sizes = mutableStateMapOf<String, IntSize>()
+
+    fun update(sinkId: String, size: IntSize?) {
+        if (sinkId.isEmpty()) return
+        if (size == null || size.width == 0 || size.height == 0) sizes.remove(sinkId) else sizes[sinkId] = size
+    }
+
+    fun toList(): List<StreamVisibility> =
+        sizes.map { (sinkId, size) -> StreamVisibility(sinkId, size.width, size.height) }.sortedBy { it.sinkId }
+}
+
 @Composable
 private fun AutoGridLayout(
     participants: List<VideoParticipant>,
     modifier: Modifier,
     showNames: Boolean,
-    showStatusIcons: Boolean
+    showStatusIcons: Boolean,
+    visibleStreams: VisibleStreams
 ) {
     val count = participants.size
     val columns = calculateOptimalColumns(count)
@@ -128,7 +167,8 @@ private fun AutoGridLayout(
                     participant = participants.first(),
                     modifier = Modifier.fillMaxSize(),
                     showName = showNames,
-                    showStatusIcons = showStatusIcons
+                    showStatusIcons = showStatusIcons,
+                    visibleStreams = visibleStreams
                 )
             }
             count == 2 -> {
@@ -144,7 +184,8 @@ private fun AutoGridLayout(
                                     .weight(1f)
                                     .fillMaxHeight(),
                                 showName = showNames,
-                                showStatusIcons = showStatusIcons
+                                showStatusIcons = showStatusIcons,
+                                onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
                             )
                         }
                     }
@@ -160,7 +201,8 @@ private fun AutoGridLayout(
                                     .weight(1f)
                                     .fillMaxWidth(),
                                 showName = showNames,
-                                showStatusIcons = showStatusIcons
+                                showStatusIcons = showStatusIcons,
+                                onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
                             )
                         }
                     }
@@ -178,7 +220,8 @@ private fun AutoGridLayout(
                             participant = participant,
                             modifier = Modifier.aspectRatio(16f / 9f),
                             showName = showNames,
-                            showStatusIcons = showStatusIcons
+                            showStatusIcons = showStatusIcons,
+                            onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
                         )
                     }
                 }
@@ -192,7 +235,8 @@ private fun SpotlightLayout(
     participants: List<VideoParticipant>,
     modifier: Modifier,
     showNames: Boolean,
-    showStatusIcons: Boolean
+    showStatusIcons: Boolean,
+    visibleStreams: VisibleStreams
 ) {
     val activeSpeaker = participants.find { it.isActiveSpeaker } ?: participants.first()
     val others = participants.filter { it.id != activeSpeaker.id }
@@ -204,7 +248,8 @@ private fun SpotlightLayout(
                 .weight(1f)
                 .fillMaxWidth(),
             showName = showNames,
-            showStatusIcons = showStatusIcons
+            showStatusIcons = showStatusIcons,
+            onStreamSizeChanged = { visibleStreams.update(activeSpeaker.sinkId, it) }
         )
 
         if (others.isNotEmpty()) {
@@ -221,7 +266,8 @@ private fun SpotlightLayout(
                             .weight(1f)
                             .aspectRatio(16f / 9f),
                         showName = showNames,
-                        showStatusIcons = showStatusIcons
+                        showStatusIcons = showStatusIcons,
+                        onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
                     )
                 }
             }
@@ -234,7 +280,8 @@ private fun StripLayout(
     participants: List<VideoParticipant>,
     modifier: Modifier,
     showNames: Boolean,
-    showStatusIcons: Boolean
+    showStatusIcons: Boolean,
+    visibleStreams: VisibleStreams
 ) {
     Row(
         modifier = modifier.fillMaxSize(),
@@ -247,7 +294,8 @@ private fun StripLayout(
                     .weight(1f)
                     .fillMaxHeight(),
                 showName = showNames,
-                showStatusIcons = showStatusIcons
+                showStatusIcons = showStatusIcons,
+                onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
             )
         }
     }
@@ -258,13 +306,15 @@ private fun SingleParticipantLayout(
     participant: VideoParticipant,
     modifier: Modifier,
     showName: Boolean,
-    showStatusIcons: Boolean
+    showStatusIcons: Boolean,
+    visibleStreams: VisibleStreams
 ) {
     ParticipantTile(
         participant = participant,
         modifier = modifier,
         showName = showName,
-        showStatusIcons = showStatusIcons
+        showStatusIcons = showStatusIcons,
+        onStreamSizeChanged = { visibleStreams.update(participant.sinkId, it) }
     )
 }
 
@@ -276,7 +326,8 @@ fun ParticipantTile(
     participant: VideoParticipant,
     modifier: Modifier = Modifier,
     showName: Boolean = true,
-    showStatusIcons: Boolean = true
+    showStatusIcons: Boolean = true,
+    onStreamSizeChanged: ((IntSize?) -> Unit)? = null
 ) {
     val borderColor = if (participant.isActiveSpeaker) {
         MaterialTheme.colorScheme.primary
@@ -295,9 +346,16 @@ fun ParticipantTile(
             )
     ) {
         if (participant.isVideoEnabled) {
+            if (onStreamSizeChanged != null) {
+                DisposableEffect(participant.sinkId) {
+                    onDispose { onStreamSizeChanged(null) }
+                }
+            }
             VideoSurface(
                 sinkId = participant.sinkId,
-                modifier = Modifier.fillMaxSize()
+                modifier = Modifier
+                    .fillMaxSize()
+                    .onSizeChanged { onStreamSizeChanged?.invoke(it) }
             )
         } else {
             ParticipantAvatar(
@@ -92,6 +92,7 @@ import jami_kmp.shared.generated.resources.*
 import net.jami.di.getViewModel
 import net.jami.ui.platform.AppPermission
 import net.jami.ui.platform.PermissionRequesterEffect
+import net.jami.services.StreamVisibility
 
 import net.jami.ui.components.video.GridLayoutMode
 import net.jami.ui.components.video.ParticipantGrid
@@ -190,6 +191,7 @@ fun CallScreen(
         onFallbackAudio = { viewModel.fallbackToAudioOnly() },
         onRequestMicPermission = { viewModel.requestMicPermission() },
         onRequestCameraPermission = { viewModel.requestCameraPermission() },
+        onVisibleStreamsChanged = { streams -> viewModel.setVisibleStreams(streams) },
     )
 }
 
@@ -278,6 +280,7 @@ fun IncomingCallScreen(
         onFallbackAudio = { viewModel.fallbackToAudioOnly() },
         onRequestMicPermission = { viewModel.requestMicPermission() },
         onRequestCameraPermission = { viewModel.requestCameraPermission() },
+        onVisibleStreamsChanged = { streams -> viewModel.setVisibleStreams(streams) },
     )
 }
 
@@ -309,6 +312,7 @@ private fun CallScreenContent(
     onFallbackAudio: () -> Unit,
     onRequestMicPermission: () -> Unit = {},
     onRequestCameraPermission: () -> Unit = {},
+    onVisibleStreamsChanged: (List<StreamVisibility>) -> Unit = {},
 ) {
     // Navigate back on terminal state
     LaunchedEffect(state.callMode) {
@@ -365,7 +369,8 @@ private fun CallScreenContent(
             if (state.isConference && state.participants.isNotEmpty()) {
                 ConferenceVideoLayout(
                     participants = state.participants,
-                    modifier = Modifier.fillMaxSize()
+                    modifier = Modifier.fillMaxSize(),
+                    onVisibleStreamsChanged = onVisibleStreamsChanged
                 )
             } else if (state.remoteVideoSinkId.isNotEmpty()) {
                 VideoRenderer(
@@ -528,7 +533,8 @@ private fun CallScreenContent(
 @Composable
 private fun ConferenceVideoLayout(
     participants: List<ParticipantUi>,
-    modifier: Modifier = Modifier
+    modifier: Modifier = Modifier,
+    onVisibleStreamsChanged: (List<StreamVisibility>) -> Unit = {}
 ) {
     val videoParticipants = participants.map { p ->
         VideoParticipant(
@@ -547,7 +553,8 @@ private fun ConferenceVideoLayout(
         modifier = modifier,
         layoutMode = GridLayoutMode.AUTO,
         showNames = true,
-        showStatusIcons = true
+        showStatusIcons = true,
+        onVisibleStreamsChanged = onVisibleStreamsChanged
     )
 }
 
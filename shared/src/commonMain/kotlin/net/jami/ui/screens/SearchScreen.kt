@@ -67,6 +67,7 @@ import net.jami.ui.components.content.PresenceStatus
 import net.jami.ui.theme.JamiTheme
 import net.jami.ui.viewmodel.ContactItem
 import net.jami.ui.viewmodel.ConversationItem
+import net.jami.ui.viewmodel.MessageSearchItem
 import net.jami.ui.viewmodel.NewConversationViewModel
 
 /**
@@ -178,6 +179,7 @@ fun SearchScreen(
                 if (state.searchQuery.isNotEmpty()
                     && state.publicDirectoryResults.isEmpty()
                     && state.conversationResults.isEmpty()
+                    && state.messageResults.isEmpty()
                     && !state.isLoading
                 ) {
                     item(key = "no_results") {
@@ -235,6 +237,22 @@ fun SearchScreen(
                         )
                     }
                 }
+
+                // Message contents section, filled as each conversation's search completes
+                if (state.messageResults.isNotEmpty()) {
+                    item(key = "header_messages") {
+                        SectionHeader(stringResource(Res.string.search_results_messages))
+                    }
+                    items(
+                        items = state.messageResults,
+                        key = { "msg_${it.conversationId}_${it.messageId}" },
+                    ) { message ->
+                        MessageSearchResultItem(
+                            message = message,
+                            onClick = { onConversationClick(message.conversationId) },
+                        )
+                    }
+                }
             }
         }
     }
@@ -356,3 +374,38 @@ private fun ConversationSearchItem(
         }
     }
 }
+
+/**
+ * Single search result item for a message found in a conversation.
+ */
+@Composable
+private fun MessageSearchResultItem(
+    message: MessageSearchItem,
+    onClick: () -> Unit,
+) {
+    Column(
+        modifier = Modifier
+            .fillMaxWidth()
+            .clickable(onClick = onClick)
+            .padding(
+                horizontal = JamiTheme.spacing.l,
+                vertical = JamiTheme.spacing.m,
+            ),
+    ) {
+        Text(
+            text = message.conversationName,
+            style = JamiTheme.typography.titleSmall,
+            color = JamiTheme.colors.onSurface,
+            maxLines = 1,
+            overflow = TextOverflow.Ellipsis,
+        )
+        Spacer(Modifier.height(JamiTheme.spacing.xxs))
+        Text(
+            text = message.text,
+            style = JamiTheme.typography.bodyMedium,
+            color = JamiTheme.colors.onSurfaceVariant,
+            maxLines = 2,
+            overflow = TextOverflow.Ellipsis,
+        )
+    }
+}
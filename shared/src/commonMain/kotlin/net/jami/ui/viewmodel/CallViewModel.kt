@@ -39,6 +39,7 @@ import net.jami.services.AccountService
 import net.jami.services.CallService
 import net.jami.services.ContactService
 import net.jami.services.DeviceRuntimeService
+import net.jami.services.StreamVisibility
 import net.jami.services.expect.HardwareService
 import net.jami.services.expect.VideoEvent
 import net.jami.utils.Log
@@ -445,6 +446,16 @@ class CallViewModel(
         _state.value = _state.value.copy(conferenceLayout = layout)
     }
 
+    /**
+     * Participant tiles on screen, reported by the conference grid whenever they
+     * scroll in or out or change size.
+     */
+    fun setVisibleStreams(streams: List<StreamVisibility>) {
+        val accountId = currentAccountId ?: return
+        val confId = currentConference?.id ?: return
+        callService.setVisibleConferenceStreams(accountId, confId, streams)
+    }
+
     fun sendCallMessage(text: String) {
         val accountId = currentAccountId ?: return
         val callId = currentCallId ?: return
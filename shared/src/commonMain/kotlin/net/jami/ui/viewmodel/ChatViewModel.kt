@@ -96,6 +96,16 @@ data class MessageItem(
     val isEdited: Boolean = false,
 )
 
+/**
+ * An outgoing file still being resized or transcoded, before its message exists.
+ */
+data class PreparingFile(
+    val path: String,
+    val displayName: String,
+    val totalSize: Long,
+    val bytesProgress: Long,
+)
+
 /**
  * Aggregated delivery/read state for an outgoing message bubble.
  * SENDING = not yet confirmed, DELIVERED = remote received, READ = remote displayed.
@@ -149,6 +159,8 @@ data class ChatState(
     val peerUri: String = "",
     /** True for SIP/legacy conversations that do not support messaging. */
     val isLegacy: Boolean = false,
+    /** Outgoing files being prepared, in the order they were sent. */
+    val preparingFiles: List<PreparingFile> = emptyList(),
 )
 
 /**
@@ -188,9 +200,13 @@ class ChatViewModel(
                     }
                     is ConversationEvent.MessageUpdated -> {
                         if (event.conversationId == convId) {
-                            updateMessage(event)
+                            updateMessages(listOf(event))
                         }
                     }
+                    is ConversationEvent.MessagesUpdated -> {
+                        val updates = event.updates.filter { it.conversationId == convId }
+                        if (updates.isNotEmpty()) updateMessages(updates)
+                    }
                     is ConversationEvent.SwarmLoaded -> {
                         if (event.conversationId == convId) {
                             loadMessagesFromHistory()
@@ -201,9 +217,11 @@ class ChatViewModel(
                             _state.value = _state.value.copy(isContactTyping = event.status != 0)
                         }
                     }
-                    is ConversationEvent.MessagesFound -> {
-                        if (event.conversationId == convId) {
-                            handleSearchResults(event.messages)
+                    is ConversationEvent.ComposingStatusesChanged -> {
+                        // The last change for this conversation wins
+                        val latest = event.updates.lastOrNull { it.conversationId == convId }
+                        if (latest != null) {
+                            _state.value = _state.value.copy(isContactTyping = latest.status != 0)
                         }
                     }
                     is ConversationEvent.DataTransferEvent -> {
@@ -211,6 +229,9 @@ class ChatViewModel(
                             loadMessagesFromHistory()
                         }
                     }
+                    is ConversationEvent.FilePreparing -> {
+                        if (event.conversationId == convId) updatePreparingFile(event)
+                    }
                     is ConversationEvent.ReactionAdded -> {
                         if (event.conversationId == convId) rebuildMessageReactions(event.messageId)
                     }
@@ -265,6 +286,7 @@ class ChatViewModel(
                     isLoadingMore = false,
                     peerUri = peerUri,
                     isLegacy = isLegacy,
+                    preparingFiles = emptyList(),
                 )
 
                 // Mark conversation as visible and read all pending messages.
@@ -838,11 +860,23 @@ class ChatViewModel(
     /**
      * Update a message in the current list when it's been edited.
      */
-    private fun updateMessage(event: ConversationEvent.MessageUpdated) {
-        val msg = event.message
+    private fun updatePreparingFile(event: ConversationEvent.FilePreparing) {
+        val others = _state.value.preparingFiles.filter { it.path != event.path }
+        val preparingFiles = if (event.finished) others else {
+            val file = PreparingFile(event.path, event.path.substringAfterLast('/'), event.totalSize, event.bytesProgress)
+            val index = _state.value.preparingFiles.indexOfFirst { it.path == event.path }
+            if (index < 0) others + file else others.toMutableList().apply { add(index, file) }
+        }
+        _state.value = _state.value.copy(preparingFiles = preparingFiles)
+    }
+
+    /** Applies edited messages in one pass; a later edit of the same message wins. */
+    private fun updateMessages(events: List<ConversationEvent.MessageUpdated>) {
+        val edited = events.associate { it.message.id to it.message }
         val current = _state.value.messages
         val updated = current.map { item ->
-            if (item.id == msg.id) {
+            val msg = edited[item.id]
+            if (msg != null) {
                 item.copy(text = msg.textContent)
             } else {
                 item
@@ -865,7 +899,8 @@ class ChatViewModel(
 
     /**
      * Search for messages in the current conversation.
-     * Debounces input to avoid excessive daemon calls.
+     * Debounces input to avoid excessive daemon calls; results are shown batch by
+     * batch, and a newer query cancels the search of the previous one.
      */
     fun searchConversation(query: String) {
         _state.value = _state.value.copy(searchQuery = query, isSearchActive = true)
@@ -885,7 +920,11 @@ class ChatViewModel(
             val accountId = currentAccountId ?: return@launch
             val conversationId = currentConversationId ?: return@launch
             val conversationUri = Uri(Uri.SWARM_SCHEME, conversationId)
-            accountService.searchConversation(accountId, conversationUri, query.trim())
+            val found = mutableListOf<Map<String, String>>()
+            accountService.searchConversation(accountId, conversationUri, query.trim()).collect { batch ->
+                found += batch.messages
+                handleSearchResults(found)
+            }
         }
     }
 
@@ -906,6 +945,7 @@ class ChatViewModel(
      * Close the search UI and clear results.
      */
     fun closeSearch() {
+        searchJob?.cancel()
         _state.value = _state.value.copy(
             searchQuery = "",
             searchResults = emptyList(),
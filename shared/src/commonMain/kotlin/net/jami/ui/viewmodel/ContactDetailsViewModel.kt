@@ -83,6 +83,11 @@ class ContactDetailsViewModel(
                             refreshContact()
                         }
                     }
+                    is ContactEvent.PresencesUpdated -> {
+                        if (event.updates.any { it.contact.uri == currentContactUri }) {
+                            refreshContact()
+                        }
+                    }
                     is ContactEvent.ProfileUpdated -> {
                         if (event.uri == currentContactUri) {
                             refreshContact()
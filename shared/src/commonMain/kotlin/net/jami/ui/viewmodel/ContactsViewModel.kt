@@ -85,7 +85,8 @@ class ContactsViewModel(
                     is ContactEvent.ContactsLoaded,
                     is ContactEvent.ContactAdded,
                     is ContactEvent.ContactRemoved,
-                    is ContactEvent.PresenceUpdated -> {
+                    is ContactEvent.PresenceUpdated,
+                    is ContactEvent.PresencesUpdated -> {
                         refreshContactList()
                     }
                     else -> { /* Profile events handled separately */ }
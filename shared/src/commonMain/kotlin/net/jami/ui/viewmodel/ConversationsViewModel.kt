@@ -140,6 +140,7 @@ class ConversationsViewModel(
                 when (event) {
                     is ConversationEvent.MessageReceived,
                     is ConversationEvent.MessageUpdated,
+                    is ConversationEvent.MessagesUpdated,
                     is ConversationEvent.MessageStatusChanged,
                     is ConversationEvent.ConversationReady,
                     is ConversationEvent.ConversationRemoved,
@@ -210,24 +211,22 @@ class ConversationsViewModel(
         scope.launch {
             Log.d(TAG, "Starting presence event collector")
             contactService.contactEvents.collect { event ->
-                if (event is ContactEvent.PresenceUpdated) {
-                    val contactRawId = event.contact.uri.rawRingId
-                    val isOnline = event.contact.isOnline
-                    Log.d(TAG, "PresenceUpdated received: contactRawId=$contactRawId isOnline=$isOnline")
-                    val matchingItems = cachedConversations.filter { it.contactId == contactRawId }
-                    Log.d(TAG, "Found ${matchingItems.size} matching conversation items for $contactRawId")
-                    if (matchingItems.isEmpty()) {
-                        Log.w(TAG, "No matching conversation for presence update. Available contactIds: ${cachedConversations.map { it.contactId }}")
-                    }
-                    cachedConversations = cachedConversations.map { item ->
-                        if (item.contactId == contactRawId) item.copy(isOnline = isOnline)
-                        else item
-                    }
-                    _state.value = _state.value.copy(
-                        conversations = applyFilter(cachedConversations, _state.value.activeFilter)
-                    )
-                    Log.d(TAG, "State updated with presence change")
+                val updates = when (event) {
+                    is ContactEvent.PresenceUpdated -> listOf(event)
+                    is ContactEvent.PresencesUpdated -> event.updates
+                    else -> return@collect
+                }
+                // One state update per event, whatever the number of contacts in it
+                val online = updates.associate { it.contact.uri.rawRingId to it.contact.isOnline }
+                Log.d(TAG, "PresenceUpdated received for ${online.size} contact(s)")
+                cachedConversations = cachedConversations.map { item ->
+                    val isOnline = online[item.contactId]
+                    if (isOnline != null) item.copy(isOnline = isOnline)
+                    else item
                 }
+                _state.value = _state.value.copy(
+                    conversations = applyFilter(cachedConversations, _state.value.activeFilter)
+                )
             }
         }
     }
@@ -31,6 +31,7 @@ import kotlinx.coroutines.flow.filterNotNull
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.flow.map
 import kotlinx.coroutines.launch
+import net.jami.model.Account
 import net.jami.model.Contact
 import net.jami.model.TextMessage
 import net.jami.model.Uri
@@ -49,12 +50,24 @@ data class NewConversationState(
     val searchQuery: String = "",
     val publicDirectoryResults: List<ContactItem> = emptyList(),
     val conversationResults: List<ConversationItem> = emptyList(),
+    val messageResults: List<MessageSearchItem> = emptyList(),
     val selectedContacts: List<ContactItem> = emptyList(),
     val isGroup: Boolean = false,
     val groupName: String = "",
     val isLoading: Boolean = false
 )
 
+/**
+ * A message matching the search query, most recent first in [NewConversationState.messageResults].
+ */
+data class MessageSearchItem(
+    val conversationId: String,
+    val conversationName: String,
+    val messageId: String,
+    val text: String,
+    val timestamp: Long,
+)
+
 /**
  * ViewModel for creating a new conversation.
  *
@@ -101,7 +114,9 @@ class NewConversationViewModel(
             searchQuery = query,
             publicDirectoryResults = emptyList(),
             conversationResults = emptyList(),
+            messageResults = emptyList(),
         )
+        // Also drops the message search of the previous query
         searchJob?.cancel()
         if (query.isEmpty()) {
             searchJob = scope.launch { loadAllConversations() }
@@ -157,6 +172,7 @@ class NewConversationViewModel(
             searchQuery = "",
             publicDirectoryResults = emptyList(),
             conversationResults = emptyList(),
+            messageResults = emptyList(),
             selectedContacts = emptyList(),
             isGroup = false,
             groupName = "",
@@ -246,6 +262,59 @@ class NewConversationViewModel(
                 accountService.searchUser(accountId, query)
             }
         }
+
+        searchMessages(account, query)
+    }
+
+    /**
+     * Search message contents: the local index answers first, then one daemon request
+     * searches every conversation in parallel and each conversation's matches are
+     * merged in as soon as they arrive.
+     */
+    private suspend fun searchMessages(account: Account, query: String) {
+        val found = linkedMapOf<String, MessageSearchItem>()
+        fun publish() {
+            _state.value = _state.value.copy(messageResults = found.values.sortedByDescending { it.timestamp })
+        }
+
+        accountService.searchLocalMessages(account.accountId, query).forEach { message ->
+            found[message.messageId] = messageSearchItem(
+                account, message.conversationId, message.messageId, message.body, message.timestamp
+            )
+        }
+        if (found.isNotEmpty()) publish()
+
+        accountService.searchAccount(account.accountId, query, MAX_MESSAGE_RESULTS_PER_CONVERSATION).collect { batch ->
+            for (msg in batch.messages) {
+                val body = msg["body"]?.takeIf { it.isNotEmpty() } ?: continue
+                val messageId = msg["id"] ?: continue
+                if (messageId in found) continue
+                found[messageId] = messageSearchItem(
+                    account, batch.conversationId, messageId, body, msg["timestamp"]?.toLongOrNull() ?: 0L
+                )
+            }
+            publish()
+        }
+    }
+
+    private fun messageSearchItem(
+        account: Account,
+        conversationId: String,
+        messageId: String,
+        body: String,
+        timestampSeconds: Long,
+    ): MessageSearchItem {
+        val conversation = account.getSwarm(conversationId)
+        val conversationName = conversation?.profileFlow?.value?.displayName?.takeIf { it.isNotBlank() }
+            ?: conversation?.contact?.displayUsername
+            ?: conversationId
+        return MessageSearchItem(
+            conversationId = conversationId,
+            conversationName = conversationName,
+            messageId = messageId,
+            text = body,
+            timestamp = timestampSeconds * 1000L,
+        )
     }
 
     /**
@@ -408,4 +477,8 @@ class NewConversationViewModel(
     fun onCleared() {
         scope.cancel()
     }
+
+    companion object {
+        private const val MAX_MESSAGE_RESULTS_PER_CONVERSATION = 20L
+    }
 }
@@ -16,10 +16,13 @@
  */
 package net.jami.services
 
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.toList
 import kotlinx.coroutines.test.advanceUntilIdle
 import kotlinx.coroutines.test.runTest
 import net.jami.model.AccountConfig
 import net.jami.model.ConfigKey
+import net.jami.model.Uri
 import net.jami.services.StubDeviceRuntimeService
 import kotlin.test.Test
 import kotlin.test.assertEquals
@@ -165,4 +168,48 @@ class AccountServiceIntegrationTest {
         assertTrue(service.hasSipAccount())
         assertFalse(service.hasJamiAccount())
     }
+
+    @Test
+    fun searchAccountStreamsBatchesUntilSearchEnds() = runTest {
+        val stub = StubDaemonBridge()
+        val service = AccountService(stub, net.jami.services.expect.HardwareService(), StubDeviceRuntimeService(), kotlinx.coroutines.CoroutineScope(kotlinx.coroutines.SupervisorJob()))
+
+        val results = service.searchAccount("acc1", "hello")
+        service.onMessagesFound(1L, "acc1", "conv1", listOf(mapOf("id" to "m1", "body" to "hello")))
+        service.onMessagesFound(1L, "acc1", "conv2", listOf(mapOf("id" to "m2", "body" to "hello there")))
+        // Empty conversation id: every conversation has been searched
+        service.onMessagesFound(1L, "acc1", "", emptyList())
+
+        val batches = results.toList()
+        assertEquals(listOf("conv1", "conv2"), batches.map { it.conversationId })
+        assertTrue(stub.cancelledSearches.isEmpty())
+    }
+
+    @Test
+    fun stoppingSearchCollectionCancelsSearch() = runTest {
+        val stub = StubDaemonBridge()
+        val service = AccountService(stub, net.jami.services.expect.HardwareService(), StubDeviceRuntimeService(), kotlinx.coroutines.CoroutineScope(kotlinx.coroutines.SupervisorJob()))
+
+        val results = service.searchConversation("acc1", Uri(Uri.SWARM_SCHEME, "conv1"), "hello")
+        service.onMessagesFound(1L, "acc1", "conv1", listOf(mapOf("id" to "m1", "body" to "hello")))
+
+        assertEquals("m1", results.first().messages.single()["id"])
+        assertEquals(listOf(1L), stub.cancelledSearches)
+    }
+
+    @Test
+    fun rejectedSearchCompletesEmpty() = runTest {
+        val stub = StubDaemonBridge()
+        stub.rejectSearches = true
+        val service = AccountService(stub, net.jami.services.expect.HardwareService(), StubDeviceRuntimeService(), kotlinx.coroutines.CoroutineScope(kotlinx.coroutines.SupervisorJob()))
+
+        val first = service.searchConversation("acc1", Uri(Uri.SWARM_SCHEME, "conv1"), "hello")
+        val second = service.searchAccount("acc1", "hello")
+        // Rejected searches share task id 0: nothing may be delivered to them
+        service.onMessagesFound(0L, "acc1", "conv1", listOf(mapOf("id" to "m1", "body" to "hello")))
+
+        assertTrue(first.toList().isEmpty())
+        assertTrue(second.toList().isEmpty())
+        assertTrue(stub.cancelledSearches.isEmpty())
+    }
 }
@@ -22,6 +22,7 @@ import kotlinx.coroutines.test.advanceUntilIdle
 import kotlinx.coroutines.test.runTest
 import net.jami.model.AccountConfig
 import net.jami.model.ConfigKey
+import net.jami.model.Contact
 import net.jami.model.Conversation
 import net.jami.model.Uri
 import kotlin.test.Test
@@ -98,6 +99,37 @@ class ConversationFacadeIntegrationTest {
         assertNotNull(conversation)
     }
 
+    @Test
+    fun smartlistIsLoadedFromAccountSnapshot() = runTest {
+        val stub = StubDaemonBridge()
+        stub.accountIds = listOf("acc1")
+        stub.accountDetails["acc1"] = mapOf(ConfigKey.ACCOUNT_TYPE.key to AccountConfig.ACCOUNT_TYPE_JAMI)
+        stub.conversations["acc1"] = listOf("conv1")
+        stub.conversationInfo["conv1"] = mapOf("mode" to "2", "title" to "Team")
+        stub.conversationMembers["conv1"] = listOf(mapOf("uri" to "peer123", "role" to "member"))
+        stub.contacts["acc1"] = listOf(mapOf("uri" to "peer123", "confirmed" to "true"))
+        stub.conversationRequests["acc1"] = listOf(mapOf("id" to "conv2", "from" to "peer456"))
+        val (accountService, contactService, facade) = makeFacade(stub, this)
+        accountService.loadAccounts()
+        advanceUntilIdle()
+
+        val snapshot = stub.snapshotAccount("acc1")
+        assertEquals(listOf("conv1"), snapshot.conversations.map { it.conversationId })
+
+        facade.getAccountWithSmartlist("acc1")
+        val conversation = accountService.getAccount("acc1")?.getSwarm("conv1")
+        assertNotNull(conversation)
+        assertEquals(Conversation.Mode.InvitesOnly, conversation.mode)
+        assertNotNull(conversation.findContact(Uri.fromString("peer123")))
+        assertEquals(
+            Contact.Status.CONFIRMED,
+            contactService.findContactInCache("acc1", Uri.fromString("peer123"))?.status
+        )
+        val request = accountService.getAccount("acc1")?.getSwarm("conv2")
+        assertEquals(Conversation.Mode.Request, request?.mode)
+        assertNotNull(request?.findContact(Uri.fromId("peer456")))
+    }
+
     @Test
     fun setConversationPreferencesDoesNotCrash() = runTest {
         val stub = StubDaemonBridge()
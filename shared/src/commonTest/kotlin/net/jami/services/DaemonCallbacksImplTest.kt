@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2004-2025 Savoir-faire Linux Inc.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+package net.jami.services
+
+import kotlinx.coroutines.async
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import net.jami.model.Conversation
+import net.jami.model.SwarmMessage
+import net.jami.model.Uri
+import net.jami.viewmodel.makeTestServiceStack
+import net.jami.viewmodel.viewModelScope
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+/**
+ * Daemon callbacks as the bridges deliver them: through [DaemonCallbacksImpl]
+ * and its ordered task channels into the services.
+ */
+class DaemonCallbacksImplTest {
+
+    @Test
+    fun searchBatchesAreDeliveredBeforeTheEndMarker() = runTest {
+        val scope = viewModelScope()
+        val services = makeTestServiceStack(scope = scope)
+        val callbacks = DaemonCallbacksImpl(
+            services.accountService, services.callService, services.contactService,
+            services.conversationFacade, scope
+        )
+
+        val results = services.accountService.searchAccount("acc1", "hello")
+        for (i in 1..20) {
+            callbacks.onMessagesFound(1, "acc1", "conv$i", listOf(mapOf("id" to "m$i", "body" to "hello")))
+        }
+        // Sent right behind the last batch: it must not close the search before that batch
+        callbacks.onMessagesFound(1, "acc1", "", emptyList())
+        advanceUntilIdle()
+
+        val batches = results.toList()
+        assertEquals((1..20).map { "conv$it" }, batches.map { it.conversationId })
+        assertTrue(services.stub.cancelledSearches.isEmpty())
+    }
+
+    @Test
+    fun batchesOfASupersededSearchAreDropped() = runTest {
+        val scope = viewModelScope()
+        val services = makeTestServiceStack(scope = scope)
+        val callbacks = DaemonCallbacksImpl(
+            services.accountService, services.callService, services.contactService,
+            services.conversationFacade, scope
+        )
+
+        val results = services.accountService.searchConversation("acc1", Uri(Uri.SWARM_SCHEME, "conv1"), "hello")
+        callbacks.onMessagesFound(1, "acc1", "conv1", listOf(mapOf("id" to "m1", "body" to "hello")))
+        advanceUntilIdle()
+        assertEquals("m1", results.first().messages.single()["id"])
+        assertEquals(listOf(1L), services.stub.cancelledSearches)
+
+        // Late batches and the end marker of the cancelled task find nothing to deliver to
+        callbacks.onMessagesFound(1, "acc1", "conv1", listOf(mapOf("id" to "m2", "body" to "hello")))
+        callbacks.onMessagesFound(1, "acc1", "", emptyList())
+        advanceUntilIdle()
+        assertEquals(listOf(1L), services.stub.cancelledSearches)
+    }
+
+    @Test
+    fun preparationProgressIsKeyedByTheSentPath() = runTest {
+        val scope = viewModelScope()
+        val services = makeTestServiceStack(scope = scope)
+        val callbacks = DaemonCallbacksImpl(
+            services.accountService, services.callService, services.contactService,
+            services.conversationFacade, scope
+        )
+        val events = mutableListOf<ConversationEvent.FilePreparing>()
+        backgroundScope.launch {
+            services.conversationFacade.conversationEvents.collect {
+                if (it is ConversationEvent.FilePreparing) events += it
+            }
+        }
+        runCurrent()
+
+        val path = "/data/acc1/conv1/photo.heic"
+        callbacks.onDataTransferProgress("acc1", "conv1", "", "prepare-1",
+            FileTransferInfo(path, 1000, 400, preparing = true))
+        callbacks.onDataTransferProgress("acc1", "conv1", "", "prepare-1",
+            FileTransferInfo(path, 1000, 1000, etaSeconds = 0.0, preparing = true))
+        advanceUntilIdle()
+
+        assertEquals(listOf(400L, 1000L), events.map { it.bytesProgress })
+        assertTrue(events.all { it.path == path && it.conversationId == "conv1" })
+        assertEquals(listOf(false, true), events.map { it.finished })
+    }
+
+    @Test
+    fun swarmChunksResolveTheLoadWithTheWholeHistory() = runTest {
+        val scope = viewModelScope()
+        val services = makeTestServiceStack(scope = scope)
+        val callbacks = DaemonCallbacksImpl(
+            services.accountService, services.callService, services.contactService,
+            services.conversationFacade, scope
+        )
+        val conversation = Conversation("acc1", Uri(Uri.SWARM_SCHEME, "conv1"), initialMode = Conversation.Mode.OneToOne)
+        fun chunk(vararg ids: String) = ids.map { SwarmMessage(it, "text/plain", "", mapOf("body" to it)) }
+
+        val load = async { services.accountService.loadUntil(conversation) }
+        runCurrent()
+        callbacks.onSwarmLoadedChunk(1, "acc1", "conv1", chunk("m1", "m2"), isLast = false)
+        advanceUntilIdle()
+        assertFalse(load.isCompleted)
+
+        callbacks.onSwarmLoadedChunk(1, "acc1", "conv1", chunk("m3"), isLast = true)
+        advanceUntilIdle()
+        assertEquals(listOf("m1", "m2", "m3"), load.await().map { it.id })
+    }
+
+    @Test
+    fun editedMessagesOfABatchArriveAsOneEvent() = runTest {
+        val scope = viewModelScope()
+        val services = makeTestServiceStack(scope = scope)
+        val callbacks = DaemonCallbacksImpl(
+            services.accountService, services.callService, services.contactService,
+            services.conversationFacade, scope
+        )
+        val events = mutableListOf<ConversationEvent>()
+        backgroundScope.launch {
+            services.conversationFacade.conversationEvents.collect { events += it }
+        }
+        runCurrent()
+
+        callbacks.onMessagesUpdated((1..3).map {
+            MessageUpdate("acc1", "conv1", SwarmMessage("m$it", "text/plain", "", mapOf("body" to "edit $it")))
+        })
+        advanceUntilIdle()
+
+        val batch = events.single() as ConversationEvent.MessagesUpdated
+        assertEquals(listOf("m1", "m2", "m3"), batch.updates.map { it.message.id })
+    }
+}
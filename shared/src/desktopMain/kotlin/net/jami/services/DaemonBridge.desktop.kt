@@ -22,41 +22,42 @@ import net.jami.utils.Log
 /**
  * Desktop (JVM) implementation of DaemonBridge.
  *
- * This is a stub implementation. When the native library is built for desktop,
- * this can be updated to use the same SWIG JNI bindings as Android.
+ * Accounts, conversations, contacts and name lookups go through libjamibridge
+ * ([JamiNative], built by nativeInterop/jni/build-jamibridge-jni.sh), the JNI
+ * front-end of the C++ bridge core shared with iOS: coalesced read receipts
+ * and composing/message updates, native conversation caches, and signals
+ * drained in batches by [NativeEventPump].
  *
- * ## To Enable Full JNI Integration
- *
- * 1. Build libjami for desktop platform (Linux, Windows, or macOS)
- * 2. The SWIG Java classes in androidMain/java can be shared
- * 3. Create a separate JVM module or use Gradle's Java compilation support
- * 4. The implementation pattern is identical to Android (see DaemonBridge.android.kt)
- *
- * ## Note
- *
- * Gradle KMP doesn't support withJava() when Android plugin is present,
- * so a separate module would be needed to share Java SWIG classes between
- * Android and Desktop targets.
+ * Without the library, and for calls, video, transfers and the remaining
+ * operations, this is a stub implementation.
  */
 actual class DaemonBridge() : DaemonBridgeApi {
-    private var isInitialized = false
+    @Volatile private var isInitialized = false
     private var callbacks: DaemonCallbacks? = null
 
     companion object {
         private const val TAG = "DaemonBridge"
         private var isNativeLoaded = false
 
+        // LIBJAMI_FLAG_CONSOLE_LOG
+        private const val INIT_FLAGS = 1 shl 1
+
         init {
             try {
-                System.loadLibrary("jami")
+                System.loadLibrary("jamibridge")
                 isNativeLoaded = true
-                Log.i(TAG, "Native library 'jami' loaded successfully")
+                Log.i(TAG, "Native library 'jamibridge' loaded successfully")
             } catch (e: UnsatisfiedLinkError) {
-                Log.w(TAG, "Native library 'jami' not available - running in stub mode")
+                Log.w(TAG, "Native library 'jamibridge' not available - running in stub mode")
             }
         }
     }
 
+    private var eventPump: NativeEventPump? = null
+
+    // libjami must not be called before init or after fini: stub answers until then
+    private val isNativeReady: Boolean get() = isNativeLoaded && isInitialized
+
     override fun init(callbacks: DaemonCallbacks): Boolean {
         this.callbacks = callbacks
 
@@ -66,54 +67,86 @@ actual class DaemonBridge() : DaemonBridgeApi {
             return true
         }
 
-        // When native library is available, initialize here
-        // See DaemonBridge.android.kt for full implementation pattern
+        if (!JamiNative.init(INIT_FLAGS)) {
+            Log.e(TAG, "libjami init failed")
+            return false
+        }
+        eventPump = NativeEventPump(callbacks).also { it.start() }
         isInitialized = true
-        Log.i(TAG, "DaemonBridge initialized (desktop stub mode)")
+        Log.i(TAG, "DaemonBridge initialized (desktop)")
         return true
     }
 
     override fun start(): Boolean {
-        Log.i(TAG, "Daemon started (desktop stub mode)")
-        return isInitialized
+        if (!isNativeLoaded) {
+            Log.i(TAG, "Daemon started (desktop stub mode)")
+            return isInitialized
+        }
+        return isInitialized && JamiNative.start()
     }
 
     override fun stop() {
         if (isInitialized) {
             isInitialized = false
+            if (isNativeLoaded) {
+                JamiNative.fini()
+                eventPump?.stop()
+                eventPump = null
+            }
             Log.i(TAG, "Daemon stopped (desktop)")
         }
     }
 
     override fun isRunning(): Boolean = isInitialized
 
-    // ==================== Account Operations (Stubs) ====================
+    // ==================== Account Operations ====================
 
     override fun addAccount(details: Map<String, String>): String {
-        Log.d(TAG, "addAccount called (stub)")
-        return ""
+        if (!isNativeReady) {
+            Log.d(TAG, "addAccount called (stub)")
+            return ""
+        }
+        return JamiNative.addAccount(NativeCodec.encodeMap(details))
     }
 
     override fun removeAccount(accountId: String) {
-        Log.d(TAG, "removeAccount called (stub): $accountId")
+        if (!isNativeReady) {
+            Log.d(TAG, "removeAccount called (stub): $accountId")
+            return
+        }
+        JamiNative.removeAccount(accountId)
     }
 
     override fun getAccountDetails(accountId: String): Map<String, String> {
-        Log.d(TAG, "getAccountDetails called (stub): $accountId")
-        return emptyMap()
+        if (!isNativeReady) {
+            Log.d(TAG, "getAccountDetails called (stub): $accountId")
+            return emptyMap()
+        }
+        return NativeCodec.decodeMap(JamiNative.getAccountDetails(accountId))
     }
 
     override fun setAccountDetails(accountId: String, details: Map<String, String>) {
-        Log.d(TAG, "setAccountDetails called (stub): $accountId")
+        if (!isNativeReady) {
+            Log.d(TAG, "setAccountDetails called (stub): $accountId")
+            return
+        }
+        JamiNative.setAccountDetails(accountId, NativeCodec.encodeMap(details))
     }
 
     override fun getAccountList(): List<String> {
-        Log.d(TAG, "getAccountList called (stub)")
-        return emptyList()
+        if (!isNativeReady) {
+            Log.d(TAG, "getAccountList called (stub)")
+            return emptyList()
+        }
+        return NativeCodec.decodeStringList(JamiNative.getAccountList())
     }
 
     override fun setAccountActive(accountId: String, active: Boolean) {
-        Log.d(TAG, "setAccountActive called (stub): $accountId, active=$active")
+        if (!isNativeReady) {
+            Log.d(TAG, "setAccountActive called (stub): $accountId, active=$active")
+            return
+        }
+        JamiNative.setAccountActive(accountId, active)
     }
 
     override fun getAccountTemplate(accountType: String): Map<String, String> {
@@ -122,12 +155,19 @@ actual class DaemonBridge() : DaemonBridgeApi {
     }
 
     override fun getVolatileAccountDetails(accountId: String): Map<String, String> {
-        Log.d(TAG, "getVolatileAccountDetails called (stub): $accountId")
-        return emptyMap()
+        if (!isNativeReady) {
+            Log.d(TAG, "getVolatileAccountDetails called (stub): $accountId")
+            return emptyMap()
+        }
+        return NativeCodec.decodeMap(JamiNative.getVolatileAccountDetails(accountId))
     }
 
     override fun sendRegister(accountId: String, enable: Boolean) {
-        Log.d(TAG, "sendRegister called (stub): $accountId, enable=$enable")
+        if (!isNativeReady) {
+            Log.d(TAG, "sendRegister called (stub): $accountId, enable=$enable")
+            return
+        }
+        JamiNative.sendRegister(accountId, enable)
     }
 
     override fun setAccountsOrder(order: String) {
@@ -258,63 +298,117 @@ actual class DaemonBridge() : DaemonBridgeApi {
     override fun getParticipantList(accountId: String, confId: String): List<String> = emptyList()
     override fun getConferenceDetails(accountId: String, confId: String): Map<String, String> = emptyMap()
 
-    // ==================== Conversation Operations (Stubs) ====================
+    // ==================== Conversation Operations ====================
 
     override fun getConversations(accountId: String): List<String> {
-        Log.d(TAG, "getConversations called (stub): $accountId")
-        return emptyList()
+        if (!isNativeReady) {
+            Log.d(TAG, "getConversations called (stub): $accountId")
+            return emptyList()
+        }
+        return NativeCodec.decodeStringList(JamiNative.getConversations(accountId))
     }
 
     override fun startConversation(accountId: String): String {
-        Log.d(TAG, "startConversation called (stub): $accountId")
-        return ""
+        if (!isNativeReady) {
+            Log.d(TAG, "startConversation called (stub): $accountId")
+            return ""
+        }
+        return JamiNative.startConversation(accountId)
     }
 
     override fun sendMessage(accountId: String, conversationId: String, message: String, replyTo: String, flag: Int) {
-        Log.d(TAG, "sendMessage called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "sendMessage called (stub): $conversationId")
+            return
+        }
+        JamiNative.sendMessage(accountId, conversationId, message.encodeToByteArray(), replyTo, flag)
     }
 
     override fun loadConversation(accountId: String, conversationId: String, fromMessage: String, size: Int) {
-        Log.d(TAG, "loadConversation called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "loadConversation called (stub): $conversationId")
+            return
+        }
+        JamiNative.loadConversation(accountId, conversationId, fromMessage, size)
     }
 
     override fun getConversationMembers(accountId: String, conversationId: String): List<Map<String, String>> {
-        Log.d(TAG, "getConversationMembers called (stub): $conversationId")
-        return emptyList()
+        if (!isNativeReady) {
+            Log.d(TAG, "getConversationMembers called (stub): $conversationId")
+            return emptyList()
+        }
+        return NativeCodec.decodeMapList(JamiNative.getConversationMembers(accountId, conversationId))
     }
 
     override fun getConversationInfo(accountId: String, conversationId: String): Map<String, String> {
-        Log.d(TAG, "getConversationInfo called (stub): $conversationId")
-        return emptyMap()
+        if (!isNativeReady) {
+            Log.d(TAG, "getConversationInfo called (stub): $conversationId")
+            return emptyMap()
+        }
+        return NativeCodec.decodeMap(JamiNative.conversationInfos(accountId, conversationId))
     }
 
     override fun removeConversation(accountId: String, conversationId: String) {
-        Log.d(TAG, "removeConversation called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "removeConversation called (stub): $conversationId")
+            return
+        }
+        JamiNative.removeConversation(accountId, conversationId)
     }
 
     override fun addConversationMember(accountId: String, conversationId: String, uri: String) {
-        Log.d(TAG, "addConversationMember called (stub): $conversationId, $uri")
+        if (!isNativeReady) {
+            Log.d(TAG, "addConversationMember called (stub): $conversationId, $uri")
+            return
+        }
+        JamiNative.addConversationMember(accountId, conversationId, uri)
     }
 
     override fun removeConversationMember(accountId: String, conversationId: String, uri: String) {
-        Log.d(TAG, "removeConversationMember called (stub): $conversationId, $uri")
+        if (!isNativeReady) {
+            Log.d(TAG, "removeConversationMember called (stub): $conversationId, $uri")
+            return
+        }
+        JamiNative.removeConversationMember(accountId, conversationId, uri)
     }
 
     override fun updateConversationInfo(accountId: String, conversationId: String, info: Map<String, String>) {
-        Log.d(TAG, "updateConversationInfo called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "updateConversationInfo called (stub): $conversationId")
+            return
+        }
+        JamiNative.updateConversationInfos(accountId, conversationId, NativeCodec.encodeMap(info))
     }
 
     override fun getConversationPreferences(accountId: String, conversationId: String): Map<String, String> {
-        Log.d(TAG, "getConversationPreferences called (stub): $conversationId")
-        return emptyMap()
+        if (!isNativeReady) {
+            Log.d(TAG, "getConversationPreferences called (stub): $conversationId")
+            return emptyMap()
+        }
+        return NativeCodec.decodeMap(JamiNative.getConversationPreferences(accountId, conversationId))
     }
 
     override fun setConversationPreferences(accountId: String, conversationId: String, prefs: Map<String, String>) {
-        Log.d(TAG, "setConversationPreferences called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "setConversationPreferences called (stub): $conversationId")
+            return
+        }
+        JamiNative.setConversationPreferences(accountId, conversationId, NativeCodec.encodeMap(prefs))
     }
 
     override fun setMessageDisplayed(accountId: String, conversationUri: String, messageId: String, status: Int) {
-        Log.d(TAG, "setMessageDisplayed called (stub): $conversationUri, $messageId")
+        if (!isNativeReady) {
+            Log.d(TAG, "setMessageDisplayed called (stub): $conversationUri, $messageId")
+            return
+        }
+        // Coalesced natively: only the newest receipt per conversation is sent
+        JamiNative.setMessageDisplayed(accountId, conversationUri, messageId)
+    }
+
+    override fun countUnreadMessages(accountId: String, conversationIds: List<String>): Map<String, Int> {
+        if (!isNativeReady) return emptyMap()
+        val counts = JamiNative.countUnreadMessages(accountId, NativeCodec.encodeStringList(conversationIds))
+        return conversationIds.zip(counts.asList()).toMap()
     }
 
     override fun getActiveCalls(accountId: String, conversationId: String): List<Map<String, String>> {
@@ -322,19 +416,30 @@ actual class DaemonBridge() : DaemonBridgeApi {
         return emptyList()
     }
 
-    // ==================== Conversation Requests (Stubs) ====================
+    // ==================== Conversation Requests ====================
 
     override fun getConversationRequests(accountId: String): List<Map<String, String>> {
-        Log.d(TAG, "getConversationRequests called (stub): $accountId")
-        return emptyList()
+        if (!isNativeReady) {
+            Log.d(TAG, "getConversationRequests called (stub): $accountId")
+            return emptyList()
+        }
+        return NativeCodec.decodeMapList(JamiNative.getConversationRequests(accountId))
     }
 
     override fun acceptConversationRequest(accountId: String, conversationId: String) {
-        Log.d(TAG, "acceptConversationRequest called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "acceptConversationRequest called (stub): $conversationId")
+            return
+        }
+        JamiNative.acceptConversationRequest(accountId, conversationId)
     }
 
     override fun declineConversationRequest(accountId: String, conversationId: String) {
-        Log.d(TAG, "declineConversationRequest called (stub): $conversationId")
+        if (!isNativeReady) {
+            Log.d(TAG, "declineConversationRequest called (stub): $conversationId")
+            return
+        }
+        JamiNative.declineConversationRequest(accountId, conversationId)
     }
 
     // ==================== Trust Requests (Stubs) ====================
@@ -356,19 +461,30 @@ actual class DaemonBridge() : DaemonBridgeApi {
         Log.d(TAG, "sendTrustRequest called (stub): $uri")
     }
 
-    // ==================== Contact Operations (Stubs) ====================
+    // ==================== Contact Operations ====================
 
     override fun addContact(accountId: String, uri: String) {
-        Log.d(TAG, "addContact called (stub): $uri")
+        if (!isNativeReady) {
+            Log.d(TAG, "addContact called (stub): $uri")
+            return
+        }
+        JamiNative.addContact(accountId, uri)
     }
 
     override fun removeContact(accountId: String, uri: String, ban: Boolean) {
-        Log.d(TAG, "removeContact called (stub): $uri")
+        if (!isNativeReady) {
+            Log.d(TAG, "removeContact called (stub): $uri")
+            return
+        }
+        JamiNative.removeContact(accountId, uri, ban)
     }
 
     override fun getContacts(accountId: String): List<Map<String, String>> {
-        Log.d(TAG, "getContacts called (stub): $accountId")
-        return emptyList()
+        if (!isNativeReady) {
+            Log.d(TAG, "getContacts called (stub): $accountId")
+            return emptyList()
+        }
+        return NativeCodec.decodeMapList(JamiNative.getContacts(accountId))
     }
 
     override fun getContactDetails(accountId: String, uri: String): Map<String, String> {
@@ -380,16 +496,22 @@ actual class DaemonBridge() : DaemonBridgeApi {
         Log.d(TAG, "subscribeBuddy called (stub): $uri, subscribe=$subscribe")
     }
 
-    // ==================== Name Lookup (Stubs) ====================
+    // ==================== Name Lookup ====================
 
     override fun lookupName(accountId: String, nameServiceUrl: String, name: String): Boolean {
-        Log.d(TAG, "lookupName called (stub): $name")
-        return false
+        if (!isNativeReady) {
+            Log.d(TAG, "lookupName called (stub): $name")
+            return false
+        }
+        return JamiNative.lookupName(accountId, nameServiceUrl, name.encodeToByteArray())
     }
 
     override fun lookupAddress(accountId: String, nameServiceUrl: String, address: String): Boolean {
-        Log.d(TAG, "lookupAddress called (stub): $address")
-        return false
+        if (!isNativeReady) {
+            Log.d(TAG, "lookupAddress called (stub): $address")
+            return false
+        }
+        return JamiNative.lookupAddress(accountId, nameServiceUrl, address)
     }
 
     override fun registerName(accountId: String, name: String, scheme: String, password: String): Boolean {
@@ -409,7 +531,11 @@ actual class DaemonBridge() : DaemonBridgeApi {
     }
 
     override fun setIsComposing(accountId: String, uri: String, isComposing: Boolean) {
-        Log.d(TAG, "setIsComposing called (stub): $uri, composing=$isComposing")
+        if (!isNativeReady) {
+            Log.d(TAG, "setIsComposing called (stub): $uri, composing=$isComposing")
+            return
+        }
+        JamiNative.setIsComposing(accountId, uri, isComposing)
     }
 
     override fun cancelMessage(accountId: String, messageId: Long): Boolean {
@@ -448,8 +574,19 @@ actual class DaemonBridge() : DaemonBridgeApi {
     }
 
     override fun loadSwarmUntil(accountId: String, conversationId: String, fromMessage: String, toMessage: String): Long {
-        Log.d(TAG, "loadSwarmUntil called (stub): $conversationId")
-        return -1L
+        if (!isNativeReady) {
+            Log.d(TAG, "loadSwarmUntil called (stub): $conversationId")
+            return -1L
+        }
+        return JamiNative.loadSwarmUntil(accountId, conversationId, fromMessage, toMessage).toLong() and 0xffffffffL
+    }
+
+    override fun cancelSwarmLoad(taskId: Long) {
+        Log.d(TAG, "cancelSwarmLoad called (stub): $taskId")
+    }
+
+    override fun cancelSearch(taskId: Long) {
+        Log.d(TAG, "cancelSearch called (stub): $taskId")
     }
 
     // ==================== Codec Operations (Stubs) ====================
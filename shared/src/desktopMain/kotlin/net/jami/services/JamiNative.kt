@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2004-2025 Savoir-faire Linux Inc.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+package net.jami.services
+
+import java.nio.ByteBuffer
+
+/**
+ * JNI entry points of libjamibridge (nativeInterop/jni/JamiBridgeJNI.cpp).
+ *
+ * Maps and lists cross as ByteArrays in the bridge core's encoding, see
+ * [NativeCodec]. Identifiers are passed as String; free text (message
+ * bodies, names) as UTF-8 bytes.
+ */
+internal object JamiNative {
+    // Lifecycle
+    @JvmStatic external fun init(flags: Int): Boolean
+    @JvmStatic external fun start(): Boolean
+    @JvmStatic external fun fini()
+
+    /**
+     * Copies whole event records into [buffer] (direct) and returns their size:
+     * 0 after [timeoutMs] without events or once [fini] ran, minus the size of
+     * a record larger than the buffer.
+     */
+    @JvmStatic external fun pollEvents(buffer: ByteBuffer, timeoutMs: Int): Int
+
+    /** Event records dropped so far because nothing polled and the queue filled up */
+    @JvmStatic external fun droppedEvents(): Long
+
+    // Accounts
+    @JvmStatic external fun getAccountList(): ByteArray
+    @JvmStatic external fun getAccountDetails(accountId: String): ByteArray
+    @JvmStatic external fun getVolatileAccountDetails(accountId: String): ByteArray
+    @JvmStatic external fun addAccount(details: ByteArray): String
+    @JvmStatic external fun removeAccount(accountId: String)
+    @JvmStatic external fun setAccountDetails(accountId: String, details: ByteArray)
+    @JvmStatic external fun setAccountActive(accountId: String, active: Boolean)
+    @JvmStatic external fun sendRegister(accountId: String, enable: Boolean)
+
+    // Conversations (info, members and preferences are cached natively)
+    @JvmStatic external fun getConversations(accountId: String): ByteArray
+    @JvmStatic external fun conversationInfos(accountId: String, conversationId: String): ByteArray
+    @JvmStatic external fun getConversationMembers(accountId: String, conversationId: String): ByteArray
+    @JvmStatic external fun getConversationPreferences(accountId: String, conversationId: String): ByteArray
+    @JvmStatic external fun setConversationPreferences(accountId: String, conversationId: String, prefs: ByteArray)
+    @JvmStatic external fun updateConversationInfos(accountId: String, conversationId: String, infos: ByteArray)
+    @JvmStatic external fun startConversation(accountId: String): String
+    @JvmStatic external fun removeConversation(accountId: String, conversationId: String)
+    @JvmStatic external fun addConversationMember(accountId: String, conversationId: String, uri: String)
+    @JvmStatic external fun removeConversationMember(accountId: String, conversationId: String, uri: String)
+    @JvmStatic external fun loadConversation(accountId: String, conversationId: String, fromMessage: String, size: Int): Int
+    @JvmStatic external fun loadSwarmUntil(accountId: String, conversationId: String, fromMessage: String, toMessage: String): Int
+    @JvmStatic external fun sendMessage(accountId: String, conversationId: String, message: ByteArray, replyTo: String, flag: Int)
+    @JvmStatic external fun setMessageDisplayed(accountId: String, conversationId: String, messageId: String)
+    @JvmStatic external fun countUnreadMessages(accountId: String, conversationIds: ByteArray): IntArray
+
+    // Requests, contacts and names
+    @JvmStatic external fun getConversationRequests(accountId: String): ByteArray
+    @JvmStatic external fun acceptConversationRequest(accountId: String, conversationId: String)
+    @JvmStatic external fun declineConversationRequest(accountId: String, conversationId: String)
+    @JvmStatic external fun getContacts(accountId: String): ByteArray
+    @JvmStatic external fun addContact(accountId: String, uri: String)
+    @JvmStatic external fun removeContact(accountId: String, uri: String, ban: Boolean)
+    @JvmStatic external fun lookupName(accountId: String, nameServer: String, name: ByteArray): Boolean
+    @JvmStatic external fun lookupAddress(accountId: String, nameServer: String, address: String): Boolean
+    @JvmStatic external fun setIsComposing(accountId: String, conversationUri: String, composing: Boolean)
+}
@@ -0,0 +1,255 @@
+/*
+ *  Copyright (C) 2004-2025 Savoir-faire Linux Inc.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+package net.jami.services
+
+import net.jami.model.SwarmMessage
+import net.jami.utils.Log
+import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Encoding shared with the bridge core (nativeInterop/jbcore/EventBuffer.h):
+ * little-endian, strings as u32 byte count + UTF-8, maps and lists as u32
+ * count + elements.
+ */
+internal object NativeCodec {
+    fun encodeMap(map: Map<String, String>): ByteArray = encode { out ->
+        out.count(map.size)
+        for ((key, value) in map) {
+            out.string(key)
+            out.string(value)
+        }
+    }
+
+    fun encodeStringList(values: List<String>): ByteArray = encode { out ->
+        out.count(values.size)
+        values.forEach { out.string(it) }
+    }
+
+    fun decodeMap(bytes: ByteArray): Map<String, String> = reader(bytes).map()
+    fun decodeMapList(bytes: ByteArray): List<Map<String, String>> = reader(bytes).mapList()
+    fun decodeStringList(bytes: ByteArray): List<String> = reader(bytes).stringList()
+
+    private fun reader(bytes: ByteArray) = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN)
+
+    private inline fun encode(block: (ByteArrayOutputStream) -> Unit): ByteArray =
+        ByteArrayOutputStream().also(block).toByteArray()
+
+    private fun ByteArrayOutputStream.count(value: Int) {
+        write(value and 0xff)
+        write((value ushr 8) and 0xff)
+        write((value ushr 16) and 0xff)
+        write((value ushr 24) and 0xff)
+    }
+
+    private fun ByteArrayOutputStream.string(value: String) {
+        val bytes = value.encodeToByteArray()
+        count(bytes.size)
+        write(bytes)
+    }
+}
+
+internal fun ByteBuffer.string(): String {
+    val size = int
+    val bytes = ByteArray(size)
+    get(bytes)
+    return bytes.decodeToString()
+}
+
+internal fun ByteBuffer.boolean(): Boolean = get().toInt() != 0
+
+internal fun ByteBuffer.stringList(): List<String> = List(int) { string() }
+
+internal fun ByteBuffer.map(): Map<String, String> {
+    val count = int
+    val map = LinkedHashMap<String, String>(count)
+    repeat(count) { map[string()] = string() }
+    return map
+}
+
+internal fun ByteBuffer.mapList(): List<Map<String, String>> = List(int) { map() }
+
+internal fun ByteBuffer.swarmMessage(): SwarmMessage {
+    val id = string()
+    val type = string()
+    val linearizedParent = string()
+    val body = map()
+    // Reactions as message id -> emojis, as on the other platforms
+    val reactions = mutableMapOf<String, List<String>>()
+    for (reaction in mapList()) {
+        val messageId = reaction["id"] ?: continue
+        val emoji = reaction["body"] ?: continue
+        reactions[messageId] = (reactions[messageId] ?: emptyList()) + emoji
+    }
+    val editions = mapList()
+    val status = LinkedHashMap<String, Int>()
+    repeat(int) { status[string()] = int }
+    return SwarmMessage(id, type, linearizedParent, body, reactions, editions, status)
+}
+
+/**
+ * Drains the native event queue on one daemon thread and dispatches each
+ * record to [callbacks]. Record layout: u16 type, u32 payload size, payload.
+ * The buffer grows when a record does not fit.
+ */
+internal class NativeEventPump(private val callbacks: DaemonCallbacks) {
+    private var thread: Thread? = null
+    @Volatile private var running = false
+
+    fun start() {
+        if (running) return
+        running = true
+        thread = Thread(::run, "jami-events").apply {
+            isDaemon = true
+            start()
+        }
+    }
+
+    /** Call after JamiNative.fini(), which wakes the thread */
+    fun stop() {
+        running = false
+        thread?.join(STOP_TIMEOUT_MS)
+        thread = null
+    }
+
+    private fun run() {
+        var buffer = ByteBuffer.allocateDirect(INITIAL_CAPACITY).order(ByteOrder.LITTLE_ENDIAN)
+        var dropped = JamiNative.droppedEvents()
+        while (running) {
+            val size = JamiNative.pollEvents(buffer, POLL_TIMEOUT_MS)
+            if (size < 0) {
+                buffer = ByteBuffer.allocateDirect(-size).order(ByteOrder.LITTLE_ENDIAN)
+                continue
+            }
+            if (size > 0) {
+                val total = JamiNative.droppedEvents()
+                if (total != dropped) Log.w(TAG, "${total - dropped} events dropped while the queue was full")
+                dropped = total
+            }
+            buffer.clear().limit(size)
+            dispatchRecords(buffer)
+        }
+    }
+
+    /** Dispatches the whole records between the position and the limit of [records] */
+    internal fun dispatchRecords(records: ByteBuffer) {
+        while (records.hasRemaining()) {
+            val type = records.short.toInt() and 0xffff
+            val length = records.int
+            val end = records.position() + length
+            try {
+                dispatch(type, records)
+            } catch (e: Exception) {
+                Log.e(TAG, "Event $type failed: ${e.message}")
+            }
+            records.position(end)
+        }
+    }
+
+    private fun dispatch(type: Int, event: ByteBuffer) {
+        when (type) {
+            ACCOUNTS_CHANGED -> callbacks.onAccountsChanged()
+            ACCOUNT_DETAILS_CHANGED -> callbacks.onAccountDetailsChanged(event.string(), event.map())
+            REGISTRATION_STATE_CHANGED ->
+                callbacks.onRegistrationStateChanged(event.string(), event.string(), event.int, event.string())
+            VOLATILE_DETAILS_CHANGED -> callbacks.onVolatileAccountDetailsChanged(event.string(), event.map())
+            CONVERSATION_READY -> callbacks.onConversationReady(event.string(), event.string())
+            CONVERSATION_REMOVED -> callbacks.onConversationRemoved(event.string(), event.string())
+            CONVERSATION_REQUEST_RECEIVED ->
+                callbacks.onConversationRequestReceived(event.string(), event.string(), event.map())
+            CONVERSATION_REQUEST_DECLINED -> callbacks.onConversationRequestDeclined(event.string(), event.string())
+            CONVERSATION_MEMBER_EVENT ->
+                callbacks.onConversationMemberEvent(event.string(), event.string(), event.string(), event.int)
+            CONVERSATION_PROFILE_UPDATED ->
+                callbacks.onConversationProfileUpdated(event.string(), event.string(), event.map())
+            CONVERSATION_PREFERENCES_UPDATED ->
+                callbacks.onConversationPreferencesUpdated(event.string(), event.string(), event.map())
+            SWARM_MESSAGE_RECEIVED ->
+                callbacks.onMessageReceived(event.string(), event.string(), event.swarmMessage())
+            SWARM_MESSAGES_UPDATED -> repeat(event.int) {
+                callbacks.onMessageUpdated(event.string(), event.string(), event.swarmMessage())
+            }
+            SWARM_LOADED -> {
+                val requestId = event.int.toLong() and 0xffffffffL
+                val accountId = event.string()
+                val conversationId = event.string()
+                callbacks.onSwarmLoaded(requestId, accountId, conversationId, List(event.int) { event.swarmMessage() })
+            }
+            COMPOSING_STATUS_CHANGED -> repeat(event.int) {
+                callbacks.onComposingStatusChanged(event.string(), event.string(), event.string(), event.int)
+            }
+            REACTION_ADDED ->
+                callbacks.onReactionAdded(event.string(), event.string(), event.string(), event.map())
+            REACTION_REMOVED ->
+                callbacks.onReactionRemoved(event.string(), event.string(), event.string(), event.string())
+            ACCOUNT_MESSAGE_STATUS_CHANGED -> {
+                val accountId = event.string()
+                val conversationId = event.string()
+                val peer = event.string()
+                val messageId = event.string()
+                callbacks.onAccountMessageStatusChanged(accountId, conversationId, messageId, peer, event.int)
+            }
+            CONTACT_ADDED -> callbacks.onContactAdded(event.string(), event.string(), event.boolean())
+            CONTACT_REMOVED -> callbacks.onContactRemoved(event.string(), event.string(), event.boolean())
+            PROFILE_RECEIVED -> callbacks.onProfileReceived(event.string(), event.string(), event.string())
+            REGISTERED_NAME_FOUND -> {
+                val accountId = event.string()
+                val query = event.string()
+                val state = event.int
+                callbacks.onRegisteredNameFound(accountId, state, event.string(), event.string(), query)
+            }
+            MESSAGES_FOUND -> {
+                val requestId = event.int
+                callbacks.onMessagesFound(requestId, event.string(), event.string(), event.mapList())
+            }
+            else -> Log.w(TAG, "Unknown event type $type")
+        }
+    }
+
+    private companion object {
+        const val TAG = "NativeEventPump"
+        const val INITIAL_CAPACITY = 256 * 1024
+        const val POLL_TIMEOUT_MS = 500
+        const val STOP_TIMEOUT_MS = 2000L
+
+        // jbcore::EventType
+        const val ACCOUNTS_CHANGED = 1
+        const val ACCOUNT_DETAILS_CHANGED = 2
+        const val REGISTRATION_STATE_CHANGED = 3
+        const val VOLATILE_DETAILS_CHANGED = 4
+        const val CONVERSATION_READY = 5
+        const val CONVERSATION_REMOVED = 6
+        const val CONVERSATION_REQUEST_RECEIVED = 7
+        const val CONVERSATION_REQUEST_DECLINED = 8
+        const val CONVERSATION_MEMBER_EVENT = 9
+        const val CONVERSATION_PROFILE_UPDATED = 10
+        const val CONVERSATION_PREFERENCES_UPDATED = 11
+        const val SWARM_MESSAGE_RECEIVED = 12
+        const val SWARM_MESSAGES_UPDATED = 13
+        const val SWARM_LOADED = 14
+        const val COMPOSING_STATUS_CHANGED = 15
+        const val REACTION_ADDED = 16
+        const val REACTION_REMOVED = 17
+        const val ACCOUNT_MESSAGE_STATUS_CHANGED = 18
+        const val CONTACT_ADDED = 19
+        const val CONTACT_REMOVED = 20
+        const val PROFILE_RECEIVED = 21
+        const val REGISTERED_NAME_FOUND = 22
+        const val MESSAGES_FOUND = 23
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2004-2025 Savoir-faire Linux Inc.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+package net.jami.services
+
+import net.jami.model.SwarmMessage
+import java.io.ByteArrayOutputStream
+import java.lang.reflect.Proxy
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+
+/**
+ * The wire format of nativeInterop/jbcore/EventBuffer.h as the desktop side
+ * decodes it. Records are written here field by field, in the order the
+ * handlers of jbcore/CoreSignals.cpp write them, with the EventType values.
+ */
+class NativeEventsTest {
+
+    /** Mirror of jbcore::EventWriter */
+    private class RecordWriter(type: Int) {
+        private val out = ByteArrayOutputStream()
+
+        init {
+            out.write(type and 0xff)
+            out.write((type ushr 8) and 0xff)
+            int32(0)
+        }
+
+        fun int32(value: Int) = apply {
+            for (shift in 0 until 32 step 8) out.write((value ushr shift) and 0xff)
+        }
+
+        fun count(value: Int) = int32(value)
+
+        fun string(value: String) = apply {
+            val bytes = value.encodeToByteArray()
+            count(bytes.size)
+            out.write(bytes)
+        }
+
+        fun boolean(value: Boolean) = apply { out.write(if (value) 1 else 0) }
+
+        fun map(value: Map<String, String>) = apply {
+            count(value.size)
+            for ((key, entry) in value) string(key).string(entry)
+        }
+
+        fun mapList(value: List<Map<String, String>>) = apply {
+            count(value.size)
+            value.forEach { map(it) }
+        }
+
+        fun message(id: String, body: Map<String, String>) = apply {
+            string(id).string("text/plain").string("parent-$id").map(body)
+            mapList(listOf(mapOf("id" to "r-$id", "body" to "👍")))
+            mapList(listOf(mapOf("body" to "edited")))
+            count(1).string("peer").int32(2)
+        }
+
+        fun finish(): ByteArray {
+            val bytes = out.toByteArray()
+            ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN).putInt(2, bytes.size - 6)
+            return bytes
+        }
+    }
+
+    private fun message(id: String, body: Map<String, String>) = SwarmMessage(
+        id, "text/plain", "parent-$id", body,
+        reactions = mapOf("r-$id" to listOf("👍")),
+        editions = listOf(mapOf("body" to "edited")),
+        status = mapOf("peer" to 2)
+    )
+
+    /** Every callback as its name and arguments */
+    private fun recordingCallbacks(calls: MutableList<List<Any?>>): DaemonCallbacks =
+        Proxy.newProxyInstance(DaemonCallbacks::class.java.classLoader, arrayOf(DaemonCallbacks::class.java)) { _, method, args ->
+            calls += listOf(method.name) + (args?.toList() ?: emptyList())
+            null
+        } as DaemonCallbacks
+
+    @Test
+    fun mapRoundTrip() {
+        val map = linkedMapOf("Account.alias" to "Alice", "" to "empty key", "unicode" to "héllo ✓")
+        assertEquals(map, NativeCodec.decodeMap(NativeCodec.encodeMap(map)))
+        assertEquals(emptyMap(), NativeCodec.decodeMap(NativeCodec.encodeMap(emptyMap())))
+    }
+
+    @Test
+    fun stringListRoundTrip() {
+        val values = listOf("a", "", "ünïcode", "a")
+        assertEquals(values, NativeCodec.decodeStringList(NativeCodec.encodeStringList(values)))
+    }
+
+    @Test
+    fun encodingMatchesTheNativeLayout() {
+        // u32 count, then u32 byte count + UTF-8 per string, little-endian
+        val expected = byteArrayOf(
+            1, 0, 0, 0,
+            1, 0, 0, 0, 'k'.code.toByte(),
+            2, 0, 0, 0, 0xc3.toByte(), 0xa9.toByte(),
+        )
+        assertContentEquals(expected, NativeCodec.encodeMap(mapOf("k" to "é")))
+        val list = RecordWriter(0).mapList(listOf(mapOf("a" to "1"), emptyMap())).finish()
+        assertEquals(
+            listOf(mapOf("a" to "1"), emptyMap()),
+            NativeCodec.decodeMapList(list.copyOfRange(6, list.size))
+        )
+    }
+
+    @Test
+    fun everyEventTypeIsDispatched() {
+        val details = mapOf("Account.alias" to "Alice")
+        val body = mapOf("body" to "hello", "author" to "peer")
+        val results = listOf(mapOf("id" to "m1", "body" to "hello"))
+        val records = listOf(
+            RecordWriter(1),
+            RecordWriter(2).string("acc").map(details),
+            RecordWriter(3).string("acc").string("REGISTERED").int32(200).string("ok"),
+            RecordWriter(4).string("acc").map(details),
+            RecordWriter(5).string("acc").string("conv"),
+            RecordWriter(6).string("acc").string("conv"),
+            RecordWriter(7).string("acc").string("conv").map(details),
+            RecordWriter(8).string("acc").string("conv"),
+            RecordWriter(9).string("acc").string("conv").string("member").int32(1),
+            RecordWriter(10).string("acc").string("conv").map(details),
+            RecordWriter(11).string("acc").string("conv").map(details),
+            RecordWriter(12).string("acc").string("conv").message("m1", body),
+            RecordWriter(13).count(2)
+                .string("acc").string("conv").message("m1", body)
+                .string("acc").string("conv2").message("m2", body),
+            // An id above Int.MAX_VALUE, as the daemon's uint32_t
+            RecordWriter(14).int32(-2).string("acc").string("conv").count(2).message("m1", body).message("m2", body),
+            RecordWriter(15).count(2)
+                .string("acc").string("conv").string("peer").int32(1)
+                .string("acc").string("conv").string("peer").int32(0),
+            RecordWriter(16).string("acc").string("conv").string("m1").map(details),
+            RecordWriter(17).string("acc").string("conv").string("m1").string("r1"),
+            RecordWriter(18).string("acc").string("conv").string("peer").string("m1").int32(3),
+            RecordWriter(19).string("acc").string("peer").boolean(true),
+            RecordWriter(20).string("acc").string("peer").boolean(false),
+            RecordWriter(21).string("acc").string("peer").string("/tmp/peer.vcf"),
+            RecordWriter(22).string("acc").string("alice").int32(0).string("0xabc").string("alice"),
+            RecordWriter(23).int32(7).string("acc").string("conv").mapList(results),
+            // Skipped, then the next record still decodes
+            RecordWriter(999).string("ignored"),
+            RecordWriter(1),
+        )
+        val buffer = ByteArrayOutputStream().apply { records.forEach { write(it.finish()) } }.toByteArray()
+
+        val calls = mutableListOf<List<Any?>>()
+        NativeEventPump(recordingCallbacks(calls))
+            .dispatchRecords(ByteBuffer.wrap(buffer).order(ByteOrder.LITTLE_ENDIAN))
+
+        val expected = listOf(
+            listOf("onAccountsChanged"),
+            listOf("onAccountDetailsChanged", "acc", details),
+            listOf("onRegistrationStateChanged", "acc", "REGISTERED", 200, "ok"),
+            listOf("onVolatileAccountDetailsChanged", "acc", details),
+            listOf("onConversationReady", "acc", "conv"),
+            listOf("onConversationRemoved", "acc", "conv"),
+            listOf("onConversationRequestReceived", "acc", "conv", details),
+            listOf("onConversationRequestDeclined", "acc", "conv"),
+            listOf("onConversationMemberEvent", "acc", "conv", "member", 1),
+            listOf("onConversationProfileUpdated", "acc", "conv", details),
+            listOf("onConversationPreferencesUpdated", "acc", "conv", details),
+            listOf("onMessageReceived", "acc", "conv", message("m1", body)),
+            listOf("onMessageUpdated", "acc", "conv", message("m1", body)),
+            listOf("onMessageUpdated", "acc", "conv2", message("m2", body)),
+            listOf("onSwarmLoaded", 0xfffffffeL, "acc", "conv", listOf(message("m1", body), message("m2", body))),
+            listOf("onComposingStatusChanged", "acc", "conv", "peer", 1),
+            listOf("onComposingStatusChanged", "acc", "conv", "peer", 0),
+            listOf("onReactionAdded", "acc", "conv", "m1", details),
+            listOf("onReactionRemoved", "acc", "conv", "m1", "r1"),
+            listOf("onAccountMessageStatusChanged", "acc", "conv", "m1", "peer", 3),
+            listOf("onContactAdded", "acc", "peer", true),
+            listOf("onContactRemoved", "acc", "peer", false),
+            listOf("onProfileReceived", "acc", "peer", "/tmp/peer.vcf", null, null),
+            listOf("onRegisteredNameFound", "acc", 0, "0xabc", "alice", "alice"),
+            listOf("onMessagesFound", 7, "acc", "conv", results),
+            listOf("onAccountsChanged"),
+        )
+        assertEquals(expected, calls)
+    }
+}
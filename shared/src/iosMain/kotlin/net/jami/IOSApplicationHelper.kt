@@ -38,13 +38,16 @@ private object JamiLifecycle : KoinComponent {
     fun start() {
         try {
             if (daemonBridge.init(daemonCallbacks)) {
-                if (daemonBridge.start()) {
-                    accountService.loadAccountsFromDaemon(isConnected = true)
-                    CoroutineScope(Dispatchers.Default).launch {
-                        hardwareService.initVideo()
+                // Returns right away: the UI shows its cached state until daemonAccountsReady
+                daemonBridge.startAsync { started ->
+                    if (started) {
+                        accountService.loadAccountsFromDaemon(isConnected = true)
+                        CoroutineScope(Dispatchers.Default).launch {
+                            hardwareService.initVideo()
+                        }
+                    } else {
+                        Log.e(TAG, "Failed to start Jami daemon")
                     }
-                } else {
-                    Log.e(TAG, "Failed to start Jami daemon")
                 }
             } else {
                 Log.e(TAG, "Failed to initialize Jami daemon")
@@ -22,9 +22,15 @@ import kotlinx.cinterop.*
 import net.jami.bridge.*
 import net.jami.model.MediaAttribute
 import net.jami.model.SwarmMessage
+import net.jami.services.expect.HardwareService
 import net.jami.utils.Log
+import org.koin.core.component.KoinComponent
+import org.koin.core.component.inject
+import platform.AVFoundation.AVSampleBufferDisplayLayer
 import platform.Foundation.*
+import platform.UIKit.UIView
 import platform.darwin.NSObject
+import platform.darwin.dispatch_get_main_queue
 
 /**
  * iOS implementation of DaemonBridge using JamiBridge Objective-C++ wrapper via cinterop.
@@ -34,6 +40,15 @@ actual class DaemonBridge() : DaemonBridgeApi {
     private var callbacks: DaemonCallbacks? = null
     private val bridge: JamiBridgeWrapper = JamiBridgeWrapper.shared()
     private var delegateImpl: JamiBridgeDelegateImpl? = null
+    private var dataPath: String? = null
+    // startAsync() completion, called from the configuration delivery queue
+    private var onStarted: ((Boolean) -> Unit)? = null
+
+    // Native window handles -> display layers, mirrors ANativeWindow handles on Android
+    private val nativeWindows = mutableMapOf<Long, AVSampleBufferDisplayLayer>()
+    private var nextWindowId = 1L
+    private val windowSinks = mutableMapOf<Long, String>()
+    private val windowSizes = mutableMapOf<Long, Pair<Int, Int>>()
 
     companion object {
         private const val TAG = "DaemonBridge.iOS"
@@ -45,9 +60,14 @@ actual class DaemonBridge() : DaemonBridgeApi {
         this.callbacks = callbacks
 
         // Create and set delegate
-        delegateImpl = JamiBridgeDelegateImpl(callbacks)
+        delegateImpl = JamiBridgeDelegateImpl(callbacks, ::onDaemonStageChanged)
         bridge.delegate = delegateImpl
 
+        // Callbacks arrive on the bridge's per-domain background queues; DaemonCallbacks is
+        // thread-safe (same as the JNI threads on Android). Video events drive HardwareService
+        // and UIKit state, so only that domain is delivered on the main thread.
+        bridge.setDeliveryQueue(dispatch_get_main_queue(), forDomain = JBSignalDomain.JBSignalDomainVideo)
+
         // Get data path from app support directory
         val paths = NSSearchPathForDirectoriesInDomains(
             NSApplicationSupportDirectory,
@@ -70,19 +90,45 @@ actual class DaemonBridge() : DaemonBridgeApi {
             )
         }
 
-        bridge.initDaemonWithDataPath(dataPath)
+        // libjami::init runs in start()/startAsync(), off the launch path for the latter
+        this.dataPath = dataPath
         isInitialized = true
         Log.i(TAG, "DaemonBridge initialized with path: $dataPath")
         return true
     }
 
     override fun start(): Boolean {
-        if (!isInitialized) return false
+        val path = dataPath
+        if (!isInitialized || path == null) return false
+        bridge.initDaemonWithDataPath(path)
         bridge.startDaemon()
         Log.i(TAG, "Daemon started")
         return true
     }
 
+    override fun startAsync(onStarted: (Boolean) -> Unit) {
+        val path = dataPath
+        if (!isInitialized || path == null) {
+            onStarted(false)
+            return
+        }
+        this.onStarted = onStarted
+        bridge.startDaemonAsyncWithDataPath(path)
+    }
+
+    private fun onDaemonStageChanged(stage: JBDaemonStage) {
+        Log.i(TAG, "Daemon stage: $stage")
+        val started = when (stage) {
+            JBDaemonStage.JBDaemonStageAccountsLoaded -> true
+            JBDaemonStage.JBDaemonStageFailed -> false
+            else -> return
+        }
+        onStarted?.let {
+            onStarted = null
+            it(started)
+        }
+    }
+
     override fun stop() {
         bridge.stopDaemon()
         isInitialized = false
@@ -137,6 +183,12 @@ actual class DaemonBridge() : DaemonBridgeApi {
     override fun changeAccountPassword(accountId: String, oldPassword: String, newPassword: String): Boolean =
         bridge.changeAccountPassword(accountId, oldPassword = oldPassword, newPassword = newPassword)
 
+    override fun snapshotAccount(accountId: String): AccountSnapshot =
+        bridge.snapshotAccount(accountId).toAccountSnapshot()
+
+    override fun snapshotAccounts(): List<AccountSnapshot> =
+        bridge.snapshotAllAccounts().mapNotNull { (it as? JBAccountSnapshot)?.toAccountSnapshot() }
+
     override fun exportToFile(accountId: String, path: String, scheme: String, password: String): Boolean {
         return bridge.exportAccount(accountId, toDestinationPath = path, withPassword = password)
     }
@@ -265,6 +317,21 @@ actual class DaemonBridge() : DaemonBridgeApi {
         bridge.setConferenceLayout(accountId, conferenceId = confId, layout = jbLayout)
     }
 
+    override fun setVisibleConferenceStreams(accountId: String, confId: String, streams: List<StreamVisibility>) {
+        val visible = streams.map { stream ->
+            JBStreamVisibility().apply {
+                sinkId = stream.sinkId
+                width = stream.width
+                height = stream.height
+            }
+        }
+        bridge.setVisibleConferenceStreams(visible, accountId = accountId, conferenceId = confId)
+    }
+
+    override fun setConferenceLayoutFollowsVisibility(enabled: Boolean) {
+        bridge.conferenceLayoutFollowsVisibility = enabled
+    }
+
     override fun hangUpConference(accountId: String, confId: String): Boolean {
         bridge.hangUpConference(accountId, conferenceId = confId)
         return true
@@ -335,13 +402,7 @@ actual class DaemonBridge() : DaemonBridgeApi {
         val members = bridge.getConversationMembers(accountId, conversationId = conversationId) ?: return emptyList()
         @Suppress("UNCHECKED_CAST")
         val memberList = members as? List<Any> ?: return emptyList()
-        return memberList.mapNotNull { member ->
-            val jbMember = member as? JBConversationMember ?: return@mapNotNull null
-            mapOf(
-                "uri" to (jbMember.uri ?: ""),
-                "role" to jbMember.role.toString()
-            )
-        }
+        return memberList.mapNotNull { (it as? JBConversationMember)?.toMap() }
     }
 
     override fun getConversationInfo(accountId: String, conversationId: String): Map<String, String> {
@@ -375,6 +436,13 @@ actual class DaemonBridge() : DaemonBridgeApi {
         bridge.setMessageDisplayed(accountId, conversationId = conversationUri, messageId = messageId)
     }
 
+    override fun countUnreadMessages(accountId: String, conversationIds: List<String>): Map<String, Int> =
+        bridge.countUnreadMessages(accountId, conversationIds = conversationIds).entries.mapNotNull { (id, count) ->
+            val conversationId = id as? String ?: return@mapNotNull null
+            val value = count as? NSNumber ?: return@mapNotNull null
+            conversationId to value.intValue
+        }.toMap()
+
     override fun getActiveCalls(accountId: String, conversationId: String): List<Map<String, String>> {
         // JamiBridge getActiveCalls takes only accountId
         return emptyList()
@@ -386,14 +454,7 @@ actual class DaemonBridge() : DaemonBridgeApi {
         val requests = bridge.getConversationRequests(accountId) ?: return emptyList()
         @Suppress("UNCHECKED_CAST")
         val requestList = requests as? List<Any> ?: return emptyList()
-        return requestList.mapNotNull { request ->
-            val jbRequest = request as? JBConversationRequest ?: return@mapNotNull null
-            mapOf(
-                "conversationId" to (jbRequest.conversationId ?: ""),
-                "from" to (jbRequest.from ?: ""),
-                "received" to jbRequest.received.toString()
-            )
-        }
+        return requestList.mapNotNull { (it as? JBConversationRequest)?.toMap() }
     }
 
     override fun acceptConversationRequest(accountId: String, conversationId: String) {
@@ -410,14 +471,7 @@ actual class DaemonBridge() : DaemonBridgeApi {
         val requests = bridge.getTrustRequests(accountId) ?: return emptyList()
         @Suppress("UNCHECKED_CAST")
         val requestList = requests as? List<Any> ?: return emptyList()
-        return requestList.mapNotNull { request ->
-            val jbRequest = request as? JBTrustRequest ?: return@mapNotNull null
-            mapOf(
-                "from" to (jbRequest.from ?: ""),
-                "conversationId" to (jbRequest.conversationId ?: ""),
-                "received" to jbRequest.received.toString()
-            )
-        }
+        return requestList.mapNotNull { (it as? JBTrustRequest)?.toMap() }
     }
 
     override fun acceptTrustRequest(accountId: String, uri: String) {
@@ -446,15 +500,7 @@ actual class DaemonBridge() : DaemonBridgeApi {
         val contacts = bridge.getContacts(accountId) ?: return emptyList()
         @Suppress("UNCHECKED_CAST")
         val contactList = contacts as? List<Any> ?: return emptyList()
-        return contactList.mapNotNull { contact ->
-            val jbContact = contact as? JBContact ?: return@mapNotNull null
-            mapOf(
-                "uri" to (jbContact.uri ?: ""),
-                "displayName" to (jbContact.displayName ?: ""),
-                "confirmed" to jbContact.isConfirmed.toString(),
-                "banned" to jbContact.isBanned.toString()
-            )
-        }
+        return contactList.mapNotNull { (it as? JBContact)?.toMap() }
     }
 
     override fun getContactDetails(accountId: String, uri: String): Map<String, String> {
@@ -467,14 +513,15 @@ actual class DaemonBridge() : DaemonBridgeApi {
 
     // ==================== Name Lookup ====================
 
+    // Answered from the bridge's lookup cache when possible; the result is
+    // delivered through onRegisteredNameFound, cached or not. False when no
+    // request went out and no result will come.
     override fun lookupName(accountId: String, nameServiceUrl: String, name: String): Boolean {
-        val result = bridge.lookupName(accountId, name = name)
-        return result != null && result.state == JBLookupState.JBLookupStateSuccess
+        return bridge.lookupName(accountId, name = name)
     }
 
     override fun lookupAddress(accountId: String, nameServiceUrl: String, address: String): Boolean {
-        val result = bridge.lookupAddress(accountId, address = address)
-        return result != null && result.state == JBLookupState.JBLookupStateSuccess
+        return bridge.lookupAddress(accountId, address = address)
     }
 
     override fun registerName(accountId: String, name: String, scheme: String, password: String): Boolean {
@@ -530,12 +577,7 @@ actual class DaemonBridge() : DaemonBridgeApi {
     }
 
     override fun fileTransferInfo(accountId: String, conversationId: String, fileId: String): FileTransferInfo? {
-        val info = bridge.getFileTransferInfo(accountId, conversationId = conversationId, fileId = fileId) ?: return null
-        return FileTransferInfo(
-            path = info.path ?: "",
-            totalSize = info.totalSize,
-            bytesProgress = info.progress
-        )
+        return bridge.getFileTransferInfo(accountId, conversationId = conversationId, fileId = fileId)?.toFileTransferInfo()
     }
 
     // ==================== Search & History ====================
@@ -549,6 +591,17 @@ actual class DaemonBridge() : DaemonBridgeApi {
         bridge.loadSwarmUntil(accountId, conversationId = conversationId,
             fromMessage = fromMessage, toMessage = toMessage).toLong()
 
+    override fun cancelSwarmLoad(taskId: Long) =
+        bridge.cancelMessagesLoad(taskId.toInt())
+
+    override fun cancelSearch(taskId: Long) =
+        bridge.cancelSearch(taskId.toUInt())
+
+    override fun searchLocalMessages(accountId: String, query: String, limit: Int): List<IndexedMessage> =
+        bridge.searchMessageIndex(query, accountId = accountId, limit = limit.toULong())
+            .filterIsInstance<JBIndexedMessage>()
+            .map { IndexedMessage(it.accountId, it.conversationId, it.messageId, it.author, it.body, it.timestamp) }
+
     // ==================== Codec Operations ====================
 
     override fun getCodecList(): List<Long> =
@@ -603,7 +656,8 @@ actual class DaemonBridge() : DaemonBridgeApi {
     // ==================== Video Frame Capture ====================
 
     override fun captureVideoFrame(uri: String, data: ByteArray, rotation: Int) {
-        // TODO: Implement via JamiBridge cinterop
+        // Not used on iOS: camera frames are published natively by the capture output
+        // attached through JamiBridgeWrapper.attachCaptureOutput (see IOSCameraService)
     }
 
     override fun captureVideoPacket(
@@ -621,27 +675,41 @@ actual class DaemonBridge() : DaemonBridgeApi {
     // ==================== Native Window Management ====================
 
     override fun acquireNativeWindow(surface: Any): Long {
-        // TODO: Implement via JamiBridge cinterop
-        return 0L
+        val layer = when (surface) {
+            is AVSampleBufferDisplayLayer -> surface
+            is UIView -> surface.layer.sublayers
+                ?.firstOrNull { it is AVSampleBufferDisplayLayer } as? AVSampleBufferDisplayLayer
+            else -> null
+        } ?: return 0L
+        val windowId = nextWindowId++
+        nativeWindows[windowId] = layer
+        return windowId
     }
 
     override fun releaseNativeWindow(windowId: Long) {
-        // TODO: Implement via JamiBridge cinterop
+        nativeWindows.remove(windowId)
     }
 
     override fun setNativeWindowGeometry(windowId: Long, width: Int, height: Int) {
-        // TODO: Implement via JamiBridge cinterop
+        // Geometry is per sink on iOS, applied when the window is bound in registerVideoCallback.
+        // width and height are view points; setVideoSinkSize converts them to pixels.
+        windowSizes[windowId] = width to height
+        windowSinks[windowId]?.let { bridge.setVideoSinkSize(it, width = width, height = height) }
     }
 
     // ==================== Video Callback Registration ====================
 
     override fun registerVideoCallback(id: String, windowId: Long): Boolean {
-        // TODO: Implement via JamiBridge cinterop
-        return false
+        val layer = nativeWindows[windowId] ?: return false
+        windowSinks[windowId] = id
+        windowSizes[windowId]?.let { (w, h) -> bridge.setVideoSinkSize(id, width = w, height = h) }
+        bridge.attachVideoSink(id, displayLayer = layer)
+        return true
     }
 
     override fun unregisterVideoCallback(id: String, windowId: Long) {
-        // TODO: Implement via JamiBridge cinterop
+        windowSinks.remove(windowId)
+        bridge.detachVideoSink(id)
     }
 
     // ==================== Video Input Switching ====================
@@ -661,6 +729,15 @@ actual class DaemonBridge() : DaemonBridgeApi {
 
 // ==================== Extension Functions ====================
 
+private fun JBFileTransferInfo.toFileTransferInfo() = FileTransferInfo(
+    path = path,
+    totalSize = totalSize,
+    bytesProgress = progress,
+    bytesPerSecond = bytesPerSecond,
+    etaSeconds = etaSeconds,
+    preparing = (flags and JBFileTransferFlagPreparing) != 0L
+)
+
 @Suppress("UNCHECKED_CAST")
 private fun Any?.toKotlinMap(): Map<String, String> {
     val dict = this as? Map<*, *> ?: return emptyMap()
@@ -710,14 +787,63 @@ private fun Any?.toKotlinLongList(): List<Long> {
 
 private fun List<Long>.toNSNumberList(): List<*> = this
 
+private fun JBConversationMember.toMap(): Map<String, String> = mapOf(
+    "uri" to (uri ?: ""),
+    "role" to role.toString()
+)
+
+private fun JBConversationRequest.toMap(): Map<String, String> = mapOf(
+    "conversationId" to (conversationId ?: ""),
+    "from" to (from ?: ""),
+    "received" to received.toString()
+)
+
+private fun JBTrustRequest.toMap(): Map<String, String> = mapOf(
+    "from" to (from ?: ""),
+    "conversationId" to (conversationId ?: ""),
+    "received" to received.toString()
+)
+
+private fun JBContact.toMap(): Map<String, String> = mapOf(
+    "uri" to (uri ?: ""),
+    "displayName" to (displayName ?: ""),
+    "confirmed" to isConfirmed.toString(),
+    "banned" to isBanned.toString()
+)
+
+private fun JBAccountSnapshot.toAccountSnapshot(): AccountSnapshot = AccountSnapshot(
+    accountId = accountId,
+    details = details.toKotlinMap(),
+    volatileDetails = volatileDetails.toKotlinMap(),
+    contacts = contacts.mapNotNull { (it as? JBContact)?.toMap() },
+    conversations = conversations.mapNotNull { conversation ->
+        val jbConversation = conversation as? JBConversationSnapshot ?: return@mapNotNull null
+        ConversationSnapshot(
+            conversationId = jbConversation.conversationId,
+            info = jbConversation.info.toKotlinMap(),
+            members = jbConversation.members.mapNotNull { (it as? JBConversationMember)?.toMap() }
+        )
+    },
+    conversationRequests = conversationRequests.mapNotNull { (it as? JBConversationRequest)?.toMap() },
+    trustRequests = trustRequests.mapNotNull { (it as? JBTrustRequest)?.toMap() }
+)
+
 // ==================== Delegate Implementation ====================
 
 /**
  * Implementation of JamiBridgeDelegate using NSObject.
  */
 private class JamiBridgeDelegateImpl(
-    private val callbacks: DaemonCallbacks
-) : NSObject(), JamiBridgeDelegateProtocol {
+    private val callbacks: DaemonCallbacks,
+    private val daemonStageChanged: (JBDaemonStage) -> Unit
+) : NSObject(), JamiBridgeDelegateProtocol, KoinComponent {
+
+    private val hardwareService: HardwareService by inject()
+
+    // Daemon Events
+    override fun onDaemonStageChanged(stage: JBDaemonStage) {
+        daemonStageChanged(stage)
+    }
 
     // Account Events
     override fun onRegistrationStateChanged(
@@ -751,11 +877,12 @@ private class JamiBridgeDelegateImpl(
     override fun onProfileReceived(
         accountId: String,
         from: String,
+        vcardPath: String,
         displayName: String,
         avatarPath: String?
     ) {
-        // DaemonCallbacks expects: onProfileReceived(accountId, peerId, vcardPath)
-        callbacks.onProfileReceived(accountId, from, avatarPath ?: displayName)
+        // The bridge already parsed the card and scaled its photo
+        callbacks.onProfileReceived(accountId, from, vcardPath, displayName, avatarPath)
     }
 
     override fun onNameRegistrationEnded(accountId: String, state: Int, name: String) {
@@ -766,7 +893,8 @@ private class JamiBridgeDelegateImpl(
         accountId: String,
         state: JBLookupState,
         address: String,
-        name: String
+        name: String,
+        query: String
     ) {
         val stateInt = when (state) {
             JBLookupState.JBLookupStateSuccess -> 0
@@ -775,7 +903,7 @@ private class JamiBridgeDelegateImpl(
             JBLookupState.JBLookupStateError -> 3
             else -> 3
         }
-        callbacks.onRegisteredNameFound(accountId, stateInt, address, name)
+        callbacks.onRegisteredNameFound(accountId, stateInt, address, name, query)
     }
 
     override fun onKnownDevicesChanged(accountId: String, devices: Map<Any?, *>) {
@@ -847,6 +975,23 @@ private class JamiBridgeDelegateImpl(
         callbacks.onVideoMuted(callId, muted)
     }
 
+    // Video Events
+    override fun onDecodingStarted(sinkId: String, width: Int, height: Int, isMixer: Boolean) {
+        hardwareService.decodingStarted(sinkId, "", width, height, isMixer)
+    }
+
+    override fun onDecodingStopped(sinkId: String, isMixer: Boolean) {
+        hardwareService.decodingStopped(sinkId, "", isMixer)
+    }
+
+    override fun onStartCapture(deviceId: String) {
+        hardwareService.startCapture(deviceId)
+    }
+
+    override fun onStopCapture(deviceId: String) {
+        hardwareService.stopCapture(deviceId)
+    }
+
     override fun onConferenceCreated(
         accountId: String,
         conversationId: String,
@@ -908,6 +1053,22 @@ private class JamiBridgeDelegateImpl(
         callbacks.onSwarmLoaded(requestId.toLong(), accountId, conversationId, swarmMessages)
     }
 
+    override fun onMessagesLoadedChunk(messages: List<*>, cursor: JBMessagesLoadCursor) {
+        // Cancelled from Kotlin, which already dropped the chunks it kept
+        if (cursor.cancelled) return
+        val chunk = messages.mapNotNull { (it as? JBSwarmMessage)?.toKotlinSwarmMessage() }
+        callbacks.onSwarmLoadedChunk(cursor.requestId.toLong(), cursor.accountId, cursor.conversationId, chunk, cursor.isLast)
+    }
+
+    override fun onMessagesFound(
+        accountId: String,
+        requestId: UInt,
+        conversationId: String,
+        messages: List<*>
+    ) {
+        callbacks.onMessagesFound(requestId.toInt(), accountId, conversationId, messages.map { it.toKotlinMap() })
+    }
+
     override fun onConversationMemberEvent(
         accountId: String,
         conversationId: String,
@@ -943,6 +1104,16 @@ private class JamiBridgeDelegateImpl(
         callbacks.onConversationProfileUpdated(accountId, conversationId, profileMap)
     }
 
+    override fun onConversationPreferencesUpdated(
+        accountId: String,
+        conversationId: String,
+        preferences: Map<Any?, *>
+    ) {
+        @Suppress("UNCHECKED_CAST")
+        val preferencesMap = (preferences as? Map<String, String>) ?: emptyMap()
+        callbacks.onConversationPreferencesUpdated(accountId, conversationId, preferencesMap)
+    }
+
     override fun onReactionAdded(
         accountId: String,
         conversationId: String,
@@ -963,6 +1134,26 @@ private class JamiBridgeDelegateImpl(
         callbacks.onReactionRemoved(accountId, conversationId, messageId, reactionId)
     }
 
+    // File Transfer Events
+    override fun onDataTransferEvent(
+        accountId: String,
+        conversationId: String,
+        interactionId: String,
+        fileId: String,
+        eventCode: Int
+    ) {
+        callbacks.onDataTransferEvent(accountId, conversationId, interactionId, fileId, eventCode)
+    }
+
+    override fun onDataTransferProgress(transfers: List<*>) {
+        transfers.filterIsInstance<JBFileTransferInfo>().forEach { info ->
+            callbacks.onDataTransferProgress(
+                info.accountId, info.conversationId, info.interactionId, info.fileId,
+                info.toFileTransferInfo()
+            )
+        }
+    }
+
     // Contact Events
     override fun onContactAdded(accountId: String, uri: String, confirmed: Boolean) {
         callbacks.onContactAdded(accountId, uri, confirmed)
@@ -996,37 +1187,87 @@ private class JamiBridgeDelegateImpl(
     override fun onPresenceChanged(accountId: String, uri: String, isOnline: Boolean) {
         callbacks.onNewBuddyNotification(accountId, uri, if (isOnline) 1 else 0, "")
     }
+
+    // Batched Events: each batch reaches the callbacks as one update
+    override fun onPresenceBatch(updates: List<*>) {
+        callbacks.onNewBuddyNotifications(updates.filterIsInstance<JBPresenceUpdate>().map { update ->
+            PresenceUpdate(update.accountId, update.uri, update.status, update.lineStatus)
+        })
+    }
+
+    override fun onComposingStatusBatch(updates: List<*>) {
+        callbacks.onComposingStatusesChanged(updates.filterIsInstance<JBComposingUpdate>().map { update ->
+            ComposingUpdate(update.accountId, update.conversationId, update.from, if (update.isComposing) 1 else 0)
+        })
+    }
+
+    override fun onMessagesUpdatedBatch(updates: List<*>) {
+        callbacks.onMessagesUpdated(updates.filterIsInstance<JBMessageUpdate>().map { update ->
+            MessageUpdate(update.accountId, update.conversationId, update.message.toKotlinSwarmMessage())
+        })
+    }
+}
+
+/**
+ * Map built from the bridge message on first access. The fields of a JBLazySwarmMessage behind
+ * it stay unconverted, in Objective-C and in Kotlin, until the model reads them.
+ */
+private class LazyMap<K, V>(load: () -> Map<K, V>) : AbstractMap<K, V>() {
+    private val map by lazy(load)
+    override val entries: Set<Map.Entry<K, V>> get() = map.entries
+    override val size: Int get() = map.size
+    override fun containsKey(key: K): Boolean = map.containsKey(key)
+    override fun get(key: K): V? = map[key]
 }
 
+/**
+ * Only id, type and replyTo are read on arrival. Body, reactions and status are converted
+ * when the model first reads them: a message that is only passed along (an update event,
+ * a page dropped by a cancelled load) never builds them.
+ */
 private fun JBSwarmMessage.toKotlinSwarmMessage(): SwarmMessage {
-    // Convert body NSDictionary to Map<String, String>
-    @Suppress("UNCHECKED_CAST")
-    val bodyMap = mutableMapOf<String, String>()
-    val nsBody = this.body as? Map<*, *>
-    nsBody?.forEach { (key, value) ->
-        val keyStr = key as? String ?: return@forEach
-        val valueStr = value as? String ?: return@forEach
-        bodyMap[keyStr] = valueStr
-    }
-
-    // Convert status map
-    val statusMap = mutableMapOf<String, Int>()
-    @Suppress("UNCHECKED_CAST")
-    val nsStatus = this.status as? Map<*, *>
-    nsStatus?.forEach { (key, value) ->
-        val keyStr = key as? String ?: return@forEach
-        if (value is Number) {
-            statusMap[keyStr] = value.toInt()
+    val message = this
+    val body = LazyMap {
+        val bodyMap = mutableMapOf<String, String>()
+        (message.body as? Map<*, *>)?.forEach { (key, value) ->
+            val keyStr = key as? String ?: return@forEach
+            val valueStr = value as? String ?: return@forEach
+            bodyMap[keyStr] = valueStr
+        }
+        bodyMap
+    }
+
+    // Same shape as the Android conversion: emojis by reaction id
+    val reactions = LazyMap {
+        val reactionsMap = mutableMapOf<String, List<String>>()
+        message.reactions.forEach { item ->
+            val reaction = item as? Map<*, *> ?: return@forEach
+            val id = reaction["id"] as? String ?: return@forEach
+            val emoji = reaction["body"] as? String ?: return@forEach
+            reactionsMap[id] = (reactionsMap[id] ?: emptyList()) + emoji
+        }
+        reactionsMap
+    }
+
+    val status = LazyMap {
+        val statusMap = mutableMapOf<String, Int>()
+        (message.status as? Map<*, *>)?.forEach { (key, value) ->
+            val keyStr = key as? String ?: return@forEach
+            if (value is Number) {
+                statusMap[keyStr] = value.toInt()
+            }
         }
+        statusMap
     }
 
     return SwarmMessage(
-        id = this.messageId ?: "",
-        type = this.type ?: "",
-        linearizedParent = this.replyTo ?: "",
-        body = bodyMap,
-        reactions = emptyMap(),
+        id = messageId ?: "",
+        type = type ?: "",
+        linearizedParent = replyTo ?: "",
+        body = body,
+        reactions = reactions,
+        // Not carried by JBSwarmMessage
         editions = emptyList(),
-        status = statusMap
+        status = status
     )
 }
@@ -22,14 +22,12 @@ import kotlinx.cinterop.useContents
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.IO
-import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
-import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
-import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import net.jami.bridge.JamiBridgeWrapper
 import net.jami.model.CameraFacing
 import net.jami.model.DeviceParams
 import net.jami.model.VideoDevices
@@ -39,7 +37,6 @@ import platform.AVFoundation.AVAuthorizationStatusAuthorized
 import platform.AVFoundation.AVAuthorizationStatusDenied
 import platform.AVFoundation.AVAuthorizationStatusNotDetermined
 import platform.AVFoundation.AVAuthorizationStatusRestricted
-import platform.AVFoundation.AVCaptureConnection
 import platform.AVFoundation.AVCaptureDevice
 import platform.AVFoundation.AVCaptureDeviceDiscoverySession
 import platform.AVFoundation.AVCaptureDeviceInput
@@ -50,14 +47,12 @@ import platform.AVFoundation.AVCaptureDeviceTypeBuiltInDualWideCamera
 import platform.AVFoundation.AVCaptureDeviceTypeBuiltInTripleCamera
 import platform.AVFoundation.AVCaptureDeviceTypeBuiltInUltraWideCamera
 import platform.AVFoundation.AVCaptureDeviceTypeBuiltInWideAngleCamera
-import platform.AVFoundation.AVCaptureOutput
 import platform.AVFoundation.AVCaptureSession
 import platform.AVFoundation.AVCaptureSessionPreset1280x720
 import platform.AVFoundation.AVCaptureSessionPreset640x480
 import platform.AVFoundation.AVCaptureSessionPresetHigh
 import platform.AVFoundation.AVCaptureSessionPresetMedium
 import platform.AVFoundation.AVCaptureVideoDataOutput
-import platform.AVFoundation.AVCaptureVideoDataOutputSampleBufferDelegateProtocol
 import platform.AVFoundation.AVCaptureVideoOrientationLandscapeLeft
 import platform.AVFoundation.AVCaptureVideoOrientationLandscapeRight
 import platform.AVFoundation.AVCaptureVideoOrientationPortrait
@@ -68,19 +63,13 @@ import platform.AVFoundation.AVMediaTypeVideo
 import platform.AVFoundation.authorizationStatusForMediaType
 import platform.AVFoundation.position
 import platform.AVFoundation.requestAccessForMediaType
-import platform.CoreMedia.CMSampleBufferGetImageBuffer
-import platform.CoreMedia.CMSampleBufferRef
-import platform.CoreVideo.CVPixelBufferGetHeight
-import platform.CoreVideo.CVPixelBufferGetWidth
 import platform.Foundation.NSNotificationCenter
 import platform.Foundation.NSOperationQueue
 import platform.QuartzCore.CALayer
 import platform.UIKit.UIDevice
 import platform.UIKit.UIDeviceOrientation
 import platform.UIKit.UIDeviceOrientationDidChangeNotification
-import platform.darwin.NSObject
 import platform.darwin.dispatch_get_main_queue
-import platform.darwin.dispatch_queue_create
 import kotlin.coroutines.resume
 import kotlin.coroutines.suspendCoroutine
 
@@ -90,7 +79,8 @@ import kotlin.coroutines.suspendCoroutine
  * Handles:
  * - Camera enumeration and selection
  * - AVCaptureSession management
- * - Video frame capture with AVCaptureVideoDataOutput
+ * - Video frame capture with AVCaptureVideoDataOutput (frames are published to the
+ *   daemon by the JamiBridge capture producer, without leaving native code)
  * - Preview layer management
  * - Device orientation handling
  */
@@ -100,6 +90,7 @@ class IOSCameraService(
     private val daemonBridge: DaemonBridgeApi
 ) {
     private val tag = "IOSCameraService"
+    private val bridge = JamiBridgeWrapper.shared()
 
     // Camera state
     private var captureSession: AVCaptureSession? = null
@@ -119,12 +110,6 @@ class IOSCameraService(
     private val _currentCameraId = MutableStateFlow<String?>(null)
     val currentCameraId: StateFlow<String?> = _currentCameraId.asStateFlow()
 
-    private val _frameEvents = MutableSharedFlow<FrameEvent>()
-    val frameEvents: SharedFlow<FrameEvent> = _frameEvents.asSharedFlow()
-
-    // Processing queue for video frames
-    private val videoQueue = dispatch_queue_create("net.jami.video.capture", null)
-
     // Current video parameters
     private var currentParams: IOSVideoParams? = null
 
@@ -275,13 +260,13 @@ class IOSCameraService(
             session.addInput(input)
             currentInput = input
 
-            // Add video output
+            // Add video output, its frames are published to the daemon natively by the bridge
             val output = AVCaptureVideoDataOutput()
-            output.alwaysDiscardsLateVideoFrames = true
-            output.setSampleBufferDelegate(sampleBufferDelegate, videoQueue)
+            bridge.attachCaptureOutput(output, inputId = "camera://${targetCamera.uniqueID}")
 
             if (!session.canAddOutput(output)) {
                 Log.e(tag, "Cannot add video output")
+                bridge.detachCaptureOutput(output)
                 _cameraState.value = CameraState.ERROR
                 return@withContext false
             }
@@ -363,6 +348,7 @@ class IOSCameraService(
             videoOutput?.let { session.removeOutput(it) }
             session.commitConfiguration()
         }
+        videoOutput?.let { bridge.detachCaptureOutput(it) }
 
         captureSession = null
         currentInput = null
@@ -421,6 +407,7 @@ class IOSCameraService(
                 }
 
                 // Update daemon
+                videoOutput?.let { bridge.attachCaptureOutput(it, inputId = "camera://${newCamera.uniqueID}") }
                 daemonBridge.setDefaultDevice(newCamera.uniqueID)
             }
 
@@ -493,68 +480,6 @@ class IOSCameraService(
         daemonBridge.setDeviceOrientation(rotation)
     }
 
-    // ══════════════════════════════════════════════════════════════════════════
-    // Sample Buffer Delegate
-    // ══════════════════════════════════════════════════════════════════════════
-
-    private val sampleBufferDelegate = object : NSObject(), AVCaptureVideoDataOutputSampleBufferDelegateProtocol {
-        override fun captureOutput(
-            output: AVCaptureOutput,
-            didOutputSampleBuffer: CMSampleBufferRef?,
-            fromConnection: AVCaptureConnection
-        ) {
-            val sampleBuffer = didOutputSampleBuffer ?: return
-            val params = currentParams ?: return
-
-            // Get pixel buffer dimensions
-            val pixelBuffer = CMSampleBufferGetImageBuffer(sampleBuffer) ?: return
-            val width = CVPixelBufferGetWidth(pixelBuffer).toInt()
-            val height = CVPixelBufferGetHeight(pixelBuffer).toInt()
-
-            // Update params if dimensions changed
-            if (width != params.width || height != params.height) {
-                currentParams = params.copy(width = width, height = height)
-            }
-
-            // Extract frame data and pass to daemon
-            try {
-                val pixelBuffer = CMSampleBufferGetImageBuffer(sampleBuffer) ?: return
-
-                // Lock base address to access raw pixel data
-                platform.CoreVideo.CVPixelBufferLockBaseAddress(pixelBuffer, 0)
-
-                val baseAddress = platform.CoreVideo.CVPixelBufferGetBaseAddress(pixelBuffer)
-                if (baseAddress != null) {
-                    val bytesPerRow = platform.CoreVideo.CVPixelBufferGetBytesPerRow(pixelBuffer).toInt()
-                    val frameSize = bytesPerRow * height * 3 / 2  // NV12: 1.5 bytes per pixel
-
-                    // Extract frame data from native memory
-                    val frameData = ByteArray(frameSize)
-                    for (i in 0 until frameSize) {
-                        frameData[i] = (baseAddress + i).readValue<Byte>()
-                    }
-
-                    // Forward NV12 frame to daemon
-                    daemonBridge.captureVideoFrame(
-                        uri = "camera://${params.cameraId}",
-                        data = frameData,
-                        rotation = deviceOrientation
-                    )
-                }
-
-                // Unlock base address
-                platform.CoreVideo.CVPixelBufferUnlockBaseAddress(pixelBuffer, 0)
-            } catch (e: Exception) {
-                Log.w(tag, "Failed to forward frame to daemon: ${e.message}")
-            }
-
-            // Emit frame event for UI
-            scope.launch {
-                _frameEvents.emit(FrameEvent(params.cameraId, width, height))
-            }
-        }
-    }
-
     // ══════════════════════════════════════════════════════════════════════════
     // Properties
     // ══════════════════════════════════════════════════════════════════════════
@@ -598,12 +523,3 @@ enum class CameraState {
     CAPTURING,
     ERROR
 }
-
-/**
- * Frame event for video capture.
- */
-data class FrameEvent(
-    val cameraId: String,
-    val width: Int,
-    val height: Int
-)
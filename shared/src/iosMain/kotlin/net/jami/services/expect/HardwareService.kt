@@ -1,6 +1,7 @@
 package net.jami.services.expect
 
 import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.useContents
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.flow.Flow
@@ -56,6 +57,8 @@ actual class HardwareService : KoinComponent {
     private val _maxResolutions = MutableStateFlow<Pair<Int?, Int?>>(1920 to 1080)
 
     private val videoSurfaces = mutableMapOf<String, UIView>()
+    // Native window handles per sink, bound to the daemon sink through registerVideoCallback
+    private val videoWindows = mutableMapOf<String, Long>()
     private var previewSurface: UIView? = null
     private var speakerphoneOn = false
     private var audioSessionActive = false
@@ -198,14 +201,35 @@ actual class HardwareService : KoinComponent {
     actual fun setBitrate(camId: String, bitrate: Int) {}
 
     actual fun addVideoSurface(id: String, holder: Any) {
-        (holder as? UIView)?.let { videoSurfaces[id] = it }
+        val view = holder as? UIView ?: return
+        removeVideoSurface(id)
+        videoSurfaces[id] = view
+        val window = daemonBridge.acquireNativeWindow(view)
+        if (window == 0L) {
+            Log.e(tag, "addVideoSurface: no AVSampleBufferDisplayLayer in view for id=$id")
+            return
+        }
+        videoWindows[id] = window
+        view.bounds.useContents {
+            // In points: the bridge scales them to the screen's pixels
+            daemonBridge.setNativeWindowGeometry(window, size.width.toInt(), size.height.toInt())
+        }
+        daemonBridge.registerVideoCallback(id, window)
     }
 
     actual fun updateVideoSurfaceId(currentId: String, newId: String) {
-        videoSurfaces.remove(currentId)?.let { videoSurfaces[newId] = it }
+        val view = videoSurfaces[currentId] ?: return
+        removeVideoSurface(currentId)
+        addVideoSurface(newId, view)
     }
 
-    actual fun removeVideoSurface(id: String) { videoSurfaces.remove(id) }
+    actual fun removeVideoSurface(id: String) {
+        videoSurfaces.remove(id)
+        videoWindows.remove(id)?.let { window ->
+            daemonBridge.unregisterVideoCallback(id, window)
+            daemonBridge.releaseNativeWindow(window)
+        }
+    }
 
     actual fun addPreviewVideoSurface(holder: Any, conference: Conference?) {
         previewSurface = holder as? UIView
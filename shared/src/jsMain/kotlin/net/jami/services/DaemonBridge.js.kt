@@ -521,6 +521,14 @@ actual class DaemonBridge() : DaemonBridgeApi {
         return -1L
     }
 
+    override fun cancelSwarmLoad(taskId: Long) {
+        // Nothing to cancel until loadSwarmUntil is implemented
+    }
+
+    override fun cancelSearch(taskId: Long) {
+        // Nothing to cancel until searchConversation is implemented
+    }
+
     // ==================== Codec Operations ====================
 
     override fun getCodecList(): List<Long> {
@@ -498,6 +498,14 @@ actual class DaemonBridge() : DaemonBridgeApi {
         return -1L
     }
 
+    override fun cancelSwarmLoad(taskId: Long) {
+        Log.d(TAG, "cancelSwarmLoad: $taskId")
+    }
+
+    override fun cancelSearch(taskId: Long) {
+        Log.d(TAG, "cancelSearch: $taskId")
+    }
+
     // ==================== Codec Operations ====================
 
     override fun getCodecList(): List<Long> {
@@ -657,10 +665,12 @@ private class JamiBridgeDelegateImpl(
     override fun onProfileReceived(
         accountId: String,
         from: String,
+        vcardPath: String,
         displayName: String,
         avatarPath: String?
     ) {
-        callbacks.onProfileReceived(accountId, from, avatarPath ?: displayName)
+        // The bridge already parsed the card and scaled its photo
+        callbacks.onProfileReceived(accountId, from, vcardPath, displayName, avatarPath)
     }
 
     override fun onNameRegistrationEnded(accountId: String, state: Int, name: String) {
@@ -0,0 +1,37 @@
+//
+//  JBAudioSession.h
+//  GetTogether
+//
+//  The AVAudioSession format reported to the daemon by GetHardwareAudioFormat:
+//  the session's current sample rate and I/O buffer size, re-read on route
+//  changes and media services resets. During calls it prefers a short I/O
+//  buffer and the daemon's internal rate, and restores the previous
+//  preferences once the last call ends. No-op on macOS.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBAudioSession : NSObject
+
++ (instancetype)shared;
+
+/// placeCall/acceptCall: the first call applies the low-latency preferences.
+- (void)callStarted:(const std::string&)callId;
+
+/// StateChange to an end state: the last call restores the preferences.
+- (void)callEnded:(const std::string&)callId;
+
+/// GetHardwareAudioFormat: appends {sample rate, frames per buffer}, the
+/// layout the daemon's audio layers read. Callable from any thread.
+- (void)appendHardwareFormat:(std::vector<int32_t>&)params;
+
+@end
+
+NS_ASSUME_NONNULL_END
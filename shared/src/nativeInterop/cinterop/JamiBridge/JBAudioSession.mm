@@ -0,0 +1,209 @@
+//
+//  JBAudioSession.mm
+//  GetTogether
+//
+//  The format is cached in atomics so the daemon thread asking for it never
+//  waits on the session queue. Preferences are only requests: the format is
+//  re-read after applying them, and again whenever the route changes (a
+//  Bluetooth HFP headset typically drops the session to 16 kHz).
+//
+//  The signal carries no channel count; channels are logged with each refresh
+//  so a mono route shows up next to the rate the daemon was given.
+//
+
+#import "JBAudioSession.h"
+#import "NativeFileLogger.h"
+
+#include <atomic>
+#include <cmath>
+#include <set>
+
+#if TARGET_OS_IOS
+#import <AVFoundation/AVFoundation.h>
+#endif
+
+namespace {
+
+// Fallback before the session has been read and on macOS
+constexpr int32_t kDefaultSampleRate = 48000;
+constexpr int32_t kDefaultFramesPerBuffer = 256;
+
+#if TARGET_OS_IOS
+// The daemon mixes and encodes (Opus) at 48 kHz
+constexpr double kPreferredSampleRate = 48000;
+// ~240 frames at 48 kHz; the session rounds to what the route supports
+constexpr NSTimeInterval kPreferredIOBufferDuration = 0.005;
+#endif
+
+std::atomic<int32_t> gSampleRate {0};
+std::atomic<int32_t> gFramesPerBuffer {0};
+
+} // namespace
+
+@implementation JBAudioSession {
+    dispatch_queue_t _queue;
+    // Only touched on _queue
+    std::set<std::string> _calls;
+    double _previousSampleRate;
+    NSTimeInterval _previousIOBufferDuration;
+}
+
++ (instancetype)shared {
+    static JBAudioSession *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBAudioSession alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.audiosession", attr);
+
+#if TARGET_OS_IOS
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        __weak JBAudioSession *weakSelf = self;
+        [center addObserverForName:AVAudioSessionRouteChangeNotification
+                            object:nil
+                             queue:nil
+                        usingBlock:^(NSNotification *) {
+            JBAudioSession *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            dispatch_async(strongSelf->_queue, ^{ [strongSelf refresh:"route change"]; });
+        }];
+        // The media server lost every preference: apply them again mid-call
+        [center addObserverForName:AVAudioSessionMediaServicesWereResetNotification
+                            object:nil
+                             queue:nil
+                        usingBlock:^(NSNotification *) {
+            JBAudioSession *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            dispatch_async(strongSelf->_queue, ^{
+                if (!strongSelf->_calls.empty()) [strongSelf applyPreferences];
+                [strongSelf refresh:"media services reset"];
+            });
+        }];
+#endif
+    }
+    return self;
+}
+
+#pragma mark - Call lifecycle
+
+- (void)callStarted:(const std::string&)callId {
+    // Blocks capture reference parameters by reference: copy them first
+    std::string callIdCopy = callId;
+    dispatch_async(_queue, ^{
+        bool first = self->_calls.empty();
+        self->_calls.insert(callIdCopy);
+        if (!first) return;
+        [self savePreferences];
+        [self applyPreferences];
+        [self refresh:"call started"];
+    });
+}
+
+- (void)callEnded:(const std::string&)callId {
+    std::string callIdCopy = callId;
+    dispatch_async(_queue, ^{
+        if (!self->_calls.erase(callIdCopy) || !self->_calls.empty()) return;
+        [self restorePreferences];
+        [self refresh:"calls ended"];
+    });
+}
+
+#pragma mark - Format
+
+- (void)appendHardwareFormat:(std::vector<int32_t>&)params {
+    int32_t sampleRate = gSampleRate.load(std::memory_order_relaxed);
+    int32_t framesPerBuffer = gFramesPerBuffer.load(std::memory_order_relaxed);
+    if (sampleRate <= 0) {
+        // First query (daemon audio layer init): read the session in place,
+        // its getters do not block
+        [self readFormat];
+        sampleRate = gSampleRate.load(std::memory_order_relaxed);
+        framesPerBuffer = gFramesPerBuffer.load(std::memory_order_relaxed);
+    }
+    params.push_back(sampleRate);
+    params.push_back(framesPerBuffer);
+}
+
+- (void)readFormat {
+#if TARGET_OS_IOS
+    AVAudioSession *session = [AVAudioSession sharedInstance];
+    double sampleRate = session.sampleRate;
+    NSTimeInterval ioBufferDuration = session.IOBufferDuration;
+    if (sampleRate > 0) {
+        gSampleRate.store((int32_t)lround(sampleRate), std::memory_order_relaxed);
+        int32_t frames = ioBufferDuration > 0 ? (int32_t)lround(ioBufferDuration * sampleRate) : 0;
+        gFramesPerBuffer.store(frames > 0 ? frames : kDefaultFramesPerBuffer, std::memory_order_relaxed);
+        return;
+    }
+#endif
+    gSampleRate.store(kDefaultSampleRate, std::memory_order_relaxed);
+    gFramesPerBuffer.store(kDefaultFramesPerBuffer, std::memory_order_relaxed);
+}
+
+- (void)refresh:(const char *)reason {
+    int32_t previousRate = gSampleRate.load(std::memory_order_relaxed);
+    int32_t previousFrames = gFramesPerBuffer.load(std::memory_order_relaxed);
+    [self readFormat];
+    int32_t sampleRate = gSampleRate.load(std::memory_order_relaxed);
+    int32_t framesPerBuffer = gFramesPerBuffer.load(std::memory_order_relaxed);
+    if (sampleRate == previousRate && framesPerBuffer == previousFrames) return;
+#if TARGET_OS_IOS
+    AVAudioSession *session = [AVAudioSession sharedInstance];
+    FILE_LOG_I("AudioSession", @"%s: %d Hz, %d frames/buffer, %ld in / %ld out channels", reason,
+               sampleRate, framesPerBuffer,
+               (long)session.inputNumberOfChannels, (long)session.outputNumberOfChannels);
+#else
+    FILE_LOG_I("AudioSession", @"%s: %d Hz, %d frames/buffer", reason, sampleRate, framesPerBuffer);
+#endif
+}
+
+#pragma mark - Preferences
+
+- (void)savePreferences {
+#if TARGET_OS_IOS
+    AVAudioSession *session = [AVAudioSession sharedInstance];
+    // preferred* read 0 until set: keep the values in effect instead
+    _previousSampleRate = session.preferredSampleRate > 0 ? session.preferredSampleRate : session.sampleRate;
+    _previousIOBufferDuration = session.preferredIOBufferDuration > 0
+        ? session.preferredIOBufferDuration : session.IOBufferDuration;
+#endif
+}
+
+- (void)applyPreferences {
+#if TARGET_OS_IOS
+    AVAudioSession *session = [AVAudioSession sharedInstance];
+    NSError *error = nil;
+    if (![session setPreferredSampleRate:kPreferredSampleRate error:&error]) {
+        FILE_LOG_W("AudioSession", @"setPreferredSampleRate: %@", error.localizedDescription);
+    }
+    error = nil;
+    if (![session setPreferredIOBufferDuration:kPreferredIOBufferDuration error:&error]) {
+        FILE_LOG_W("AudioSession", @"setPreferredIOBufferDuration: %@", error.localizedDescription);
+    }
+#endif
+}
+
+- (void)restorePreferences {
+#if TARGET_OS_IOS
+    AVAudioSession *session = [AVAudioSession sharedInstance];
+    NSError *error = nil;
+    if (_previousSampleRate > 0 && ![session setPreferredSampleRate:_previousSampleRate error:&error]) {
+        FILE_LOG_W("AudioSession", @"Restoring sample rate: %@", error.localizedDescription);
+    }
+    error = nil;
+    if (_previousIOBufferDuration > 0
+        && ![session setPreferredIOBufferDuration:_previousIOBufferDuration error:&error]) {
+        FILE_LOG_W("AudioSession", @"Restoring IO buffer duration: %@", error.localizedDescription);
+    }
+#endif
+}
+
+@end
@@ -0,0 +1,42 @@
+//
+//  JBBridgeInternal.h
+//  GetTogether
+//
+//  Parts of JamiBridgeWrapper reachable without a running daemon, for the
+//  benchmark and replay harness in bench/, and its daemon readiness for the
+//  bridge's helper classes.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import "JamiBridgeWrapper.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "jami.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+using JBSignalHandlerMap = std::map<std::string, std::shared_ptr<libjami::CallbackWrapperBase>>;
+
+@interface JamiBridgeWrapper (Internal)
+
+/// The handlers registerSignalHandlers installs in libjami, keyed by signal name
+- (JBSignalHandlerMap)makeSignalHandlers;
+
+/// Runs `block` when libjami is ready, as JB_REQUIRE_DAEMON checks it, for
+/// helpers calling libjami on their own: stopDaemon's fini waits until the
+/// block returned. NO, without running it, before the Initialized stage and
+/// once stopDaemon began.
+- (BOOL)performIfLibjamiReady:(NS_NOESCAPE dispatch_block_t)block;
+
+@end
+
+// Conversion behind getContacts: / snapshotAccount:
+NSArray<JBContact *> *toJBContacts(const std::vector<std::map<std::string, std::string>>& contacts);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,31 @@
+//
+//  JBCallTrace.h
+//  GetTogether
+//
+//  Call setup spans, keyed by call id: "FirstAudio" from placeCall/acceptCall
+//  to the CURRENT state, "FirstFrame" to the first DecodingStarted of the call.
+//  They are emitted in the daemon's tracepoint log (tracepoint-apple.h) with
+//  the daemon's signpost id for the call, so Instruments shows them next to
+//  the daemon's Call/ICE intervals; durations are also written to the file log.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import "JamiBridgeWrapper.h"
+
+#include <cstdint>
+#include <string>
+
+// Timestamp to take before calling into the daemon, so the span includes it
+uint64_t callTraceNow();
+
+// origin: "placeCall" or "acceptCall"
+void callTraceStarted(const std::string& callId, const char *origin, uint64_t startedAt, bool withVideo);
+
+void callTraceStateChanged(const std::string& callId, const std::string& state, JBCallState callState);
+
+void callTraceMediaChangeRequested(const std::string& callId, size_t mediaCount);
+
+// Sink ids of call video start with the call id (conference mixers do not match)
+void callTraceDecodingStarted(const std::string& sinkId, int width, int height);
@@ -0,0 +1,104 @@
+//
+//  JBCallTrace.mm
+//  GetTogether
+//
+//  Calls are tracked from placeCall/acceptCall until both spans are closed or
+//  the call ends; a call that ends first closes its open spans as "aborted".
+//
+
+#import "JBCallTrace.h"
+#import "NativeFileLogger.h"
+
+#include "tracepoint-apple.h"
+
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+struct PendingCall {
+    const char *origin;
+    uint64_t startedAt;
+    bool audioPending;
+    bool framePending;
+};
+
+std::mutex gCallsMutex;
+std::unordered_map<std::string, PendingCall> gCalls;
+
+os_log_t traceLog() {
+    return jami::tracepoint_apple::log();
+}
+
+double elapsedMillis(uint64_t since) {
+    return (double)(callTraceNow() - since) / 1e6;
+}
+
+} // namespace
+
+uint64_t callTraceNow() {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+void callTraceStarted(const std::string& callId, const char *origin, uint64_t startedAt, bool withVideo) {
+    if (callId.empty()) return;
+    os_signpost_id_t signpost = jami_trace_signpost_id(callId.c_str());
+    os_signpost_interval_begin(traceLog(), signpost, "FirstAudio", "%{public}s %{public}s", origin, callId.c_str());
+    if (withVideo) {
+        os_signpost_interval_begin(traceLog(), signpost, "FirstFrame", "%{public}s %{public}s", origin, callId.c_str());
+    }
+    std::lock_guard<std::mutex> lock(gCallsMutex);
+    gCalls[callId] = {origin, startedAt, true, withVideo};
+}
+
+void callTraceStateChanged(const std::string& callId, const std::string& state, JBCallState callState) {
+    os_signpost_id_t signpost = jami_trace_signpost_id(callId.c_str());
+    os_signpost_event_emit(traceLog(), signpost, "StateChange", "%{public}s", state.c_str());
+
+    bool ended = callState == JBCallStateOver || callState == JBCallStateHungup
+        || callState == JBCallStateFailure || callState == JBCallStateBusy;
+    if (callState != JBCallStateCurrent && !ended) return;
+
+    std::lock_guard<std::mutex> lock(gCallsMutex);
+    auto it = gCalls.find(callId);
+    if (it == gCalls.end()) return;
+    PendingCall& call = it->second;
+    if (call.audioPending) {
+        call.audioPending = false;
+        if (ended) {
+            os_signpost_interval_end(traceLog(), signpost, "FirstAudio", "aborted (%{public}s)", state.c_str());
+        } else {
+            double ms = elapsedMillis(call.startedAt);
+            os_signpost_interval_end(traceLog(), signpost, "FirstAudio", "%.1f ms", ms);
+            FILE_LOG_I("CallTrace", @"%s %s: first audio after %.0f ms", call.origin, callId.c_str(), ms);
+        }
+    }
+    if (ended && call.framePending) {
+        os_signpost_interval_end(traceLog(), signpost, "FirstFrame", "aborted (%{public}s)", state.c_str());
+        call.framePending = false;
+    }
+    if (!call.audioPending && !call.framePending) gCalls.erase(it);
+}
+
+void callTraceMediaChangeRequested(const std::string& callId, size_t mediaCount) {
+    os_signpost_event_emit(traceLog(), jami_trace_signpost_id(callId.c_str()),
+                           "MediaChangeRequested", "%zu media", mediaCount);
+}
+
+void callTraceDecodingStarted(const std::string& sinkId, int width, int height) {
+    std::lock_guard<std::mutex> lock(gCallsMutex);
+    for (auto it = gCalls.begin(); it != gCalls.end(); ++it) {
+        const std::string& callId = it->first;
+        PendingCall& call = it->second;
+        if (!call.framePending || sinkId.compare(0, callId.size(), callId) != 0) continue;
+        double ms = elapsedMillis(call.startedAt);
+        os_signpost_interval_end(traceLog(), jami_trace_signpost_id(callId.c_str()), "FirstFrame",
+                                 "%dx%d, %.1f ms", width, height, ms);
+        FILE_LOG_I("CallTrace", @"%s %s: first frame (%dx%d) after %.0f ms",
+                   call.origin, callId.c_str(), width, height, ms);
+        call.framePending = false;
+        if (!call.audioPending) gCalls.erase(it);
+        return;
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  JBCameraFrameProducer.h
+//  GetTogether
+//
+//  Camera capture producer: AVCaptureVideoDataOutput sample buffer delegate
+//  that adopts each camera CVPixelBuffer into the daemon's VideoFrame
+//  (getNewFrame/publishFrame) on the capture queue, without copying pixels.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+#import <AVFoundation/AVFoundation.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBCameraFrameProducer : NSObject <AVCaptureVideoDataOutputSampleBufferDelegate>
+
++ (instancetype)shared;
+
+/// Makes the producer the sample buffer delegate of `output` and publishes its
+/// frames to the daemon video input `inputId` (e.g. "camera://<uniqueID>").
+/// Also pins the output to NV12 so buffers can be adopted as-is.
+- (void)attachOutput:(AVCaptureVideoDataOutput *)output inputId:(NSString *)inputId;
+
+/// Stops publishing frames of `output` and removes the producer as its delegate.
+- (void)detachOutput:(AVCaptureVideoDataOutput *)output;
+
+/// StartCapture handler (daemon thread): picks hardware or NV12 frames from
+/// the current encoding acceleration setting for the frames that follow.
+- (void)captureStarted:(const std::string&)device;
+
+// Capture devices, as libjami device nodes (AVCaptureDevice uniqueIDs)
++ (NSArray<NSString *> *)captureDeviceIds;
+
+/// Capabilities for libjami::addVideoDevice(): one map per NV12 format with
+/// "format", "width", "height" and "rate" keys.
++ (std::vector<std::map<std::string, std::string>>)deviceInfoForDevice:(NSString *)deviceId;
+
+@end
+
+NS_ASSUME_NONNULL_END
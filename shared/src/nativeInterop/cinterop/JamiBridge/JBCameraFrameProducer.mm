@@ -0,0 +1,238 @@
+//
+//  JBCameraFrameProducer.mm
+//  GetTogether
+//
+//  Each camera sample buffer is adopted by reference into the AVFrame of the
+//  VideoFrame returned by getNewFrame():
+//
+//    encoding accelerated -> AV_PIX_FMT_VIDEOTOOLBOX, CVPixelBuffer in data[3]
+//    otherwise            -> AV_PIX_FMT_NV12, data[0]/data[1] point at the
+//                            locked (read-only) planes of the CVPixelBuffer
+//
+//  The AVFrame's buf[0] owns a retain on the pixel buffer, so the camera
+//  buffer is returned to AVFoundation's pool when the encoder drops the frame.
+//  Frames are published from the capture queue, never from the main thread.
+//
+
+#import "JBCameraFrameProducer.h"
+#import "JBCodecGovernor.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#import <CoreMedia/CoreMedia.h>
+#import <CoreVideo/CoreVideo.h>
+
+#include <algorithm>
+#include <set>
+#include <string_view>
+
+#include "videomanager_interface.h"
+
+extern "C" {
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+namespace {
+
+void releaseHardwareFrame(void* opaque, uint8_t* /*data*/) {
+    CVPixelBufferRelease(static_cast<CVPixelBufferRef>(opaque));
+}
+
+void releasePlanarFrame(void* opaque, uint8_t* /*data*/) {
+    auto pixelBuffer = static_cast<CVPixelBufferRef>(opaque);
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferRelease(pixelBuffer);
+}
+
+bool isBiPlanar420(OSType format) {
+    return format == kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange
+        || format == kCVPixelFormatType_420YpCbCr8BiPlanarFullRange;
+}
+
+// Fills avframe with references to pixelBuffer. On failure avframe is left empty.
+bool adoptPixelBuffer(AVFrame* avframe, CVPixelBufferRef pixelBuffer, bool hardware) {
+    av_frame_unref(avframe);
+    avframe->width = (int)CVPixelBufferGetWidth(pixelBuffer);
+    avframe->height = (int)CVPixelBufferGetHeight(pixelBuffer);
+    avframe->color_range = CVPixelBufferGetPixelFormatType(pixelBuffer) == kCVPixelFormatType_420YpCbCr8BiPlanarFullRange
+        ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG;
+
+    CVPixelBufferRetain(pixelBuffer);
+    if (hardware) {
+        avframe->format = AV_PIX_FMT_VIDEOTOOLBOX;
+        avframe->data[3] = reinterpret_cast<uint8_t*>(pixelBuffer);
+        avframe->buf[0] = av_buffer_create(reinterpret_cast<uint8_t*>(pixelBuffer), 0,
+                                           releaseHardwareFrame, pixelBuffer, AV_BUFFER_FLAG_READONLY);
+        if (!avframe->buf[0]) {
+            CVPixelBufferRelease(pixelBuffer);
+            av_frame_unref(avframe);
+            return false;
+        }
+        return true;
+    }
+
+    if (CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly) != kCVReturnSuccess) {
+        CVPixelBufferRelease(pixelBuffer);
+        av_frame_unref(avframe);
+        return false;
+    }
+    avframe->format = AV_PIX_FMT_NV12;
+    for (size_t plane = 0; plane < 2; plane++) {
+        avframe->data[plane] = static_cast<uint8_t*>(CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, plane));
+        avframe->linesize[plane] = (int)CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, plane);
+    }
+    avframe->buf[0] = av_buffer_create(avframe->data[0], CVPixelBufferGetDataSize(pixelBuffer),
+                                       releasePlanarFrame, pixelBuffer, AV_BUFFER_FLAG_READONLY);
+    if (!avframe->buf[0]) {
+        releasePlanarFrame(pixelBuffer, nullptr);
+        av_frame_unref(avframe);
+        return false;
+    }
+    return true;
+}
+
+NSArray<AVCaptureDevice *> *discoverCaptureDevices() {
+    NSArray<AVCaptureDeviceType> *deviceTypes = @[
+        AVCaptureDeviceTypeBuiltInWideAngleCamera,
+        AVCaptureDeviceTypeBuiltInDualCamera,
+        AVCaptureDeviceTypeBuiltInDualWideCamera,
+        AVCaptureDeviceTypeBuiltInTripleCamera,
+        AVCaptureDeviceTypeBuiltInUltraWideCamera,
+    ];
+    AVCaptureDeviceDiscoverySession *session =
+        [AVCaptureDeviceDiscoverySession discoverySessionWithDeviceTypes:deviceTypes
+                                                               mediaType:AVMediaTypeVideo
+                                                                position:AVCaptureDevicePositionUnspecified];
+    // Front camera first: it is the default for calls
+    return [session.devices sortedArrayUsingComparator:^NSComparisonResult(AVCaptureDevice *a, AVCaptureDevice *b) {
+        BOOL aFront = a.position == AVCaptureDevicePositionFront;
+        BOOL bFront = b.position == AVCaptureDevicePositionFront;
+        if (aFront == bFront) return NSOrderedSame;
+        return aFront ? NSOrderedAscending : NSOrderedDescending;
+    }];
+}
+
+} // namespace
+
+@implementation JBCameraFrameProducer {
+    dispatch_queue_t _captureQueue;
+    // Output -> daemon input id. Only touched on _captureQueue.
+    NSMapTable<AVCaptureOutput *, NSString *> *_inputs;
+    // Read on each StartCapture: getEncodingAccelerated() goes through the
+    // daemon config, and the codec governor toggles it between captures
+    BOOL _hardwareFrames;
+}
+
++ (instancetype)shared {
+    static JBCameraFrameProducer *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBCameraFrameProducer alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                             QOS_CLASS_USER_INTERACTIVE, 0);
+        _captureQueue = dispatch_queue_create("net.jami.bridge.camera", attr);
+        _inputs = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+- (void)attachOutput:(AVCaptureVideoDataOutput *)output inputId:(NSString *)inputId {
+    NSString *inputIdCopy = [inputId copy];
+    FILE_LOG_I("Camera", @"attachOutput %@", inputIdCopy);
+
+    output.videoSettings = @{
+        (id)kCVPixelBufferPixelFormatTypeKey: @(kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange),
+    };
+    output.alwaysDiscardsLateVideoFrames = YES;
+    dispatch_async(_captureQueue, ^{
+        [self->_inputs setObject:inputIdCopy forKey:output];
+    });
+    [output setSampleBufferDelegate:self queue:_captureQueue];
+}
+
+- (void)captureStarted:(const std::string&)device {
+    BOOL hardware = libjami::getEncodingAccelerated();
+    FILE_LOG_I("Camera", @"Capture started %s (hardware frames: %d)", device.c_str(), hardware);
+    dispatch_async(_captureQueue, ^{
+        self->_hardwareFrames = hardware;
+    });
+}
+
+- (void)detachOutput:(AVCaptureVideoDataOutput *)output {
+    [output setSampleBufferDelegate:nil queue:nil];
+    dispatch_async(_captureQueue, ^{
+        [self->_inputs removeObjectForKey:output];
+    });
+}
+
++ (NSArray<NSString *> *)captureDeviceIds {
+    NSMutableArray<NSString *> *ids = [NSMutableArray array];
+    for (AVCaptureDevice *device in discoverCaptureDevices()) {
+        [ids addObject:device.uniqueID];
+    }
+    return [ids copy];
+}
+
++ (std::vector<std::map<std::string, std::string>>)deviceInfoForDevice:(NSString *)deviceId {
+    std::vector<std::map<std::string, std::string>> info;
+    AVCaptureDevice *device = [AVCaptureDevice deviceWithUniqueID:deviceId];
+    if (!device) return info;
+
+    std::set<std::pair<int, int>> seen;
+    for (AVCaptureDeviceFormat *format in device.formats) {
+        if (CMFormatDescriptionGetMediaSubType(format.formatDescription) != kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange) {
+            continue;
+        }
+        CMVideoDimensions dims = CMVideoFormatDescriptionGetDimensions(format.formatDescription);
+        if (!seen.insert({dims.width, dims.height}).second) continue;
+        Float64 maxRate = 0;
+        for (AVFrameRateRange *range in format.videoSupportedFrameRateRanges) {
+            maxRate = std::max(maxRate, range.maxFrameRate);
+        }
+        info.push_back({
+            {"format", "NV12"},
+            {"width", std::to_string(dims.width)},
+            {"height", std::to_string(dims.height)},
+            {"rate", std::to_string((int)maxRate)},
+        });
+    }
+    return info;
+}
+
+#pragma mark - AVCaptureVideoDataOutputSampleBufferDelegate
+
+- (void)captureOutput:(AVCaptureOutput *)output
+didOutputSampleBuffer:(CMSampleBufferRef)sampleBuffer
+       fromConnection:(AVCaptureConnection *)connection {
+    NSString *inputId = [_inputs objectForKey:output];
+    if (!inputId) return;
+
+    CVPixelBufferRef pixelBuffer = CMSampleBufferGetImageBuffer(sampleBuffer);
+    if (!pixelBuffer || !isBiPlanar420(CVPixelBufferGetPixelFormatType(pixelBuffer))) return;
+
+    std::string_view id(inputId.UTF8String);
+    // Null while the daemon is not capturing from this input
+    libjami::VideoFrame* frame = libjami::getNewFrame(id);
+    if (!frame) return;
+
+    if (!adoptPixelBuffer(frame->pointer(), pixelBuffer, _hardwareFrames)) return;
+    libjami::publishFrame(id);
+    codecGovernorFrameCaptured();
+}
+
+// Late frames are discarded (alwaysDiscardsLateVideoFrames): the pipeline is behind
+- (void)captureOutput:(AVCaptureOutput *)output
+  didDropSampleBuffer:(CMSampleBufferRef)sampleBuffer
+       fromConnection:(AVCaptureConnection *)connection {
+    if ([_inputs objectForKey:output]) codecGovernorFrameDropped();
+}
+
+@end
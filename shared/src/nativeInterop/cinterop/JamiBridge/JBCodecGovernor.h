@@ -0,0 +1,57 @@
+//
+//  JBCodecGovernor.h
+//  GetTogether
+//
+//  Keeps calls on VideoToolbox and steps the capture device's resolution and
+//  framerate down (and back up) before iOS throttles the app: the target level
+//  follows NSProcessInfo.thermalState, low-power mode and the measured capture
+//  frame rate, and is applied with libjami::applySettings on the active device.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+
+#include <map>
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBCodecGovernor : NSObject
+
++ (instancetype)shared;
+
+/// Stepping on/off (default YES); turning it off restores the device settings.
+/// Hardware acceleration is forced on for calls either way.
+@property (atomic, assign) BOOL enabled;
+
+/// Switches encode/decode to VideoToolbox; called on the caller's thread
+/// before placeCall/acceptCall reach the daemon, so the call's codecs use it.
+/// What it switched on is switched back off when the last call ends.
+- (void)prepareCall;
+
+/// placeCall failed after prepareCall: restores acceleration if no call is left.
+- (void)callNotPlaced;
+
+/// placeCall/acceptCall: the first call starts monitoring.
+- (void)callStarted:(const std::string&)callId;
+
+/// StateChange to an end state: the last call restores the device settings
+/// and the acceleration settings.
+- (void)callEnded:(const std::string&)callId;
+
+/// StartCapture/StopCapture: the device whose settings are stepped
+- (void)captureStarted:(const std::string&)deviceId;
+- (void)captureStopped:(const std::string&)deviceId;
+
+/// applyVideoSettings: applies the user's settings, which become the new top
+/// level. The capture restart it causes does not reset the governor.
+- (void)applyUserSettings:(const std::map<std::string, std::string>&)settings
+                   device:(const std::string&)deviceId;
+
+@end
+
+// Called by JBCameraFrameProducer on the capture queue (atomic counters)
+void codecGovernorFrameCaptured();
+void codecGovernorFrameDropped();
+
+NS_ASSUME_NONNULL_END
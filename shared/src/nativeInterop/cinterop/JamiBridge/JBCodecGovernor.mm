@@ -0,0 +1,443 @@
+//
+//  JBCodecGovernor.mm
+//  GetTogether
+//
+//  The ladder is built from the device's capabilities when capture starts:
+//  (size, rate) pairs ordered by pixel rate, each step at most ~70% of the
+//  previous one, starting at the user's settings. Pressure maps to a level:
+//
+//    thermal fair -> 1, serious -> 3, critical -> last; low power -> at least 1
+//    measured fps below 75% of the level's rate for two windows -> one more
+//
+//  Levels go down one step per evaluation window and back up one step after
+//  kStepUpWindows calm windows, so a brief spike does not restart the camera.
+//
+//  applySettings restarts the capture: the StopCapture/StartCapture pair that
+//  follows a level change is the governor's own and is ignored. The baseline
+//  (the user's settings, top of the ladder) is read once per device and only
+//  replaced by a device change or applyUserSettings:, never by the stepped
+//  settings the daemon persisted meanwhile.
+//
+//  Acceleration is daemon config too: what prepareCall switched on is
+//  switched back off when the last call ends, so the user's choice outlives
+//  the calls.
+//
+
+#import "JBCodecGovernor.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "videomanager_interface.h"
+
+namespace {
+
+constexpr int64_t kEvaluationInterval = 5 * NSEC_PER_SEC;
+constexpr int kStrainedWindows = 2;
+constexpr int kStepUpWindows = 6;
+constexpr double kStrainedFpsRatio = 0.75;
+constexpr double kMinStepRatio = 0.7;
+constexpr double kReducedRate = 15;
+// Time for the capture restart of a level change to reach the bridge
+constexpr uint64_t kOwnRestartWindow = 3 * NSEC_PER_SEC;
+
+std::atomic<uint64_t> gFramesCaptured {0};
+std::atomic<uint64_t> gFramesDropped {0};
+
+struct Step {
+    std::string size;
+    std::string rate;
+    double pixelRate;
+};
+
+bool parseSize(const std::string& size, int& width, int& height) {
+    return sscanf(size.c_str(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+}
+
+double toRate(const std::string& rate) {
+    return strtod(rate.c_str(), nullptr);
+}
+
+// Rates are formatted the way the daemon lists them ("30", "15")
+std::string formatRate(double rate) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%g", rate);
+    return buffer;
+}
+
+std::vector<Step> buildLadder(const std::map<std::string, std::string>& settings,
+                              const libjami::VideoCapabilities& capabilities) {
+    std::vector<Step> ladder;
+    auto size = settings.find("size");
+    auto rate = settings.find("rate");
+    int width = 0, height = 0;
+    if (size == settings.end() || rate == settings.end() || !parseSize(size->second, width, height)) {
+        return ladder;
+    }
+    double baseRate = toRate(rate->second);
+    if (baseRate <= 0) return ladder;
+
+    std::vector<Step> candidates;
+    candidates.push_back({size->second, rate->second, (double)width * height * baseRate});
+
+    auto channel = settings.find("channel");
+    auto sizes = channel != settings.end() ? capabilities.find(channel->second) : capabilities.end();
+    if (sizes == capabilities.end() && !capabilities.empty()) sizes = capabilities.begin();
+    if (sizes != capabilities.end()) {
+        for (const auto& [candidateSize, rates] : sizes->second) {
+            int w = 0, h = 0;
+            if (!parseSize(candidateSize, w, h) || (double)w * h > (double)width * height) continue;
+            for (const auto& candidateRate : rates) {
+                double r = toRate(candidateRate);
+                if (r <= 0 || r > baseRate) continue;
+                candidates.push_back({candidateSize, candidateRate, (double)w * h * r});
+            }
+        }
+    } else if (baseRate > kReducedRate) {
+        // No capabilities: only the framerate can be stepped
+        candidates.push_back({size->second, formatRate(kReducedRate), (double)width * height * kReducedRate});
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Step& a, const Step& b) {
+        return a.pixelRate > b.pixelRate;
+    });
+    for (const auto& candidate : candidates) {
+        if (ladder.empty() || candidate.pixelRate <= ladder.back().pixelRate * kMinStepRatio) {
+            ladder.push_back(candidate);
+        }
+    }
+    return ladder;
+}
+
+// Daemon video inputs are "camera://<device id>", settings use the bare id
+std::string deviceFromInput(const std::string& input) {
+    static const std::string scheme = "camera://";
+    return input.compare(0, scheme.size(), scheme) == 0 ? input.substr(scheme.size()) : input;
+}
+
+} // namespace
+
+void codecGovernorFrameCaptured() {
+    gFramesCaptured.fetch_add(1, std::memory_order_relaxed);
+}
+
+void codecGovernorFrameDropped() {
+    gFramesDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+@implementation JBCodecGovernor {
+    dispatch_queue_t _queue;
+    dispatch_source_t _timer;
+    // Everything below is only touched on _queue
+    std::set<std::string> _calls;
+    std::string _device;
+    std::string _baselineDevice;
+    std::map<std::string, std::string> _baseline;
+    // Set by applyLevel: the next StopCapture of _device before this uptime is our restart
+    uint64_t _ownRestartDeadline;
+    std::vector<Step> _ladder;
+    size_t _level;
+    int _penalty;
+    int _strainedWindows;
+    int _healthyWindows;
+    int _calmWindows;
+    uint64_t _lastFrames;
+    uint64_t _lastDropped;
+    uint64_t _lastSampleTime;
+    // Switched on by prepareCall, to restore once no call is left. Under @synchronized.
+    BOOL _restoreEncoding;
+    BOOL _restoreDecoding;
+}
+
++ (instancetype)shared {
+    static JBCodecGovernor *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBCodecGovernor alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.governor", attr);
+        _enabled = YES;
+
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        __weak JBCodecGovernor *weakSelf = self;
+        void (^pressureChanged)(NSNotification *) = ^(NSNotification *) {
+            JBCodecGovernor *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            dispatch_async(strongSelf->_queue, ^{ [strongSelf evaluate:NO]; });
+        };
+        [center addObserverForName:NSProcessInfoThermalStateDidChangeNotification
+                            object:nil
+                             queue:nil
+                        usingBlock:pressureChanged];
+        if (@available(macOS 12.0, iOS 9.0, *)) {
+            [center addObserverForName:NSProcessInfoPowerStateDidChangeNotification
+                                object:nil
+                                 queue:nil
+                            usingBlock:pressureChanged];
+        }
+    }
+    return self;
+}
+
+- (void)setEnabled:(BOOL)enabled {
+    @synchronized (self) {
+        _enabled = enabled;
+    }
+    dispatch_async(_queue, ^{ [self evaluate:NO]; });
+}
+
+- (BOOL)enabled {
+    @synchronized (self) {
+        return _enabled;
+    }
+}
+
+#pragma mark - Call and capture lifecycle
+
+- (void)prepareCall {
+    @synchronized (self) {
+        if (!libjami::getEncodingAccelerated()) {
+            FILE_LOG_I("Governor", @"Enabling hardware encoding for calls");
+            libjami::setEncodingAccelerated(true);
+            _restoreEncoding = YES;
+        }
+        if (!libjami::getDecodingAccelerated()) {
+            FILE_LOG_I("Governor", @"Enabling hardware decoding for calls");
+            libjami::setDecodingAccelerated(true);
+            _restoreDecoding = YES;
+        }
+    }
+}
+
+- (void)callNotPlaced {
+    dispatch_async(_queue, ^{
+        if (self->_calls.empty()) [self restoreAcceleration];
+    });
+}
+
+- (void)callStarted:(const std::string&)callId {
+    // Blocks capture reference parameters by reference: copy them first
+    std::string callIdCopy = callId;
+    dispatch_async(_queue, ^{
+        bool first = self->_calls.empty();
+        self->_calls.insert(callIdCopy);
+        if (first) [self startMonitoring];
+    });
+}
+
+- (void)callEnded:(const std::string&)callId {
+    std::string callIdCopy = callId;
+    dispatch_async(_queue, ^{
+        if (!self->_calls.erase(callIdCopy) || !self->_calls.empty()) return;
+        [self stopMonitoring];
+        [self applyLevel:0 reason:"calls ended"];
+        [self restoreAcceleration];
+    });
+}
+
+// On _queue, once no call is left
+- (void)restoreAcceleration {
+    @synchronized (self) {
+        if (_restoreEncoding) {
+            FILE_LOG_I("Governor", @"Restoring software encoding");
+            libjami::setEncodingAccelerated(false);
+        }
+        if (_restoreDecoding) {
+            FILE_LOG_I("Governor", @"Restoring software decoding");
+            libjami::setDecodingAccelerated(false);
+        }
+        _restoreEncoding = NO;
+        _restoreDecoding = NO;
+    }
+}
+
+- (void)captureStarted:(const std::string&)deviceId {
+    std::string device = deviceFromInput(deviceId);
+    dispatch_async(_queue, ^{
+        // Same device: still running, or restarted by our own applySettings
+        if (device == self->_device) return;
+        [self applyLevel:0 reason:"device changed"];
+        self->_device = device;
+        self->_ownRestartDeadline = 0;
+        if (device != self->_baselineDevice) {
+            self->_baselineDevice = device;
+            self->_baseline = libjami::getSettings(device);
+        }
+        self->_ladder = buildLadder(self->_baseline, libjami::getCapabilities(device));
+        self->_level = 0;
+        FILE_LOG_I("Governor", @"Capture on %s: %zu quality levels", device.c_str(), self->_ladder.size());
+        [self resetWindows];
+        [self evaluate:NO];
+    });
+}
+
+- (void)captureStopped:(const std::string&)deviceId {
+    std::string device = deviceFromInput(deviceId);
+    dispatch_async(_queue, ^{
+        if (device != self->_device) return;
+        if (self->_ownRestartDeadline != 0 && clock_gettime_nsec_np(CLOCK_UPTIME_RAW) < self->_ownRestartDeadline) {
+            // Our level change restarting the camera: keep the level and the device
+            self->_ownRestartDeadline = 0;
+            return;
+        }
+        [self applyLevel:0 reason:"capture stopped"];
+        self->_ownRestartDeadline = 0;
+        self->_device.clear();
+        self->_ladder.clear();
+    });
+}
+
+- (void)applyUserSettings:(const std::map<std::string, std::string>&)settings
+                   device:(const std::string&)deviceId {
+    std::string device = deviceFromInput(deviceId);
+    // Synchronous, so the caller reads the new settings back, and on _queue, so
+    // the capture restart it causes is seen after it
+    dispatch_sync(_queue, ^{
+        if (device == self->_device) {
+            self->_ownRestartDeadline = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) + kOwnRestartWindow;
+        }
+        libjami::applySettings(device, settings);
+        // The user's settings become the new top level, whatever level was active
+        self->_baselineDevice = device;
+        self->_baseline = libjami::getSettings(device);
+        if (device != self->_device) return;
+        self->_ladder = buildLadder(self->_baseline, libjami::getCapabilities(device));
+        self->_level = 0;
+        [self resetWindows];
+        [self evaluate:NO];
+    });
+}
+
+#pragma mark - Evaluation
+
+- (void)startMonitoring {
+    _penalty = 0;
+    [self resetWindows];
+    if (_timer) return;
+    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+    __weak JBCodecGovernor *weakSelf = self;
+    dispatch_source_set_event_handler(_timer, ^{
+        JBCodecGovernor *strongSelf = weakSelf;
+        [strongSelf sampleFrames];
+        [strongSelf evaluate:YES];
+    });
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, kEvaluationInterval),
+                              kEvaluationInterval, NSEC_PER_SEC / 2);
+    dispatch_resume(_timer);
+}
+
+- (void)stopMonitoring {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+        _timer = nil;
+    }
+}
+
+- (void)resetWindows {
+    _strainedWindows = 0;
+    _healthyWindows = 0;
+    _calmWindows = 0;
+    _lastFrames = gFramesCaptured.load(std::memory_order_relaxed);
+    _lastDropped = gFramesDropped.load(std::memory_order_relaxed);
+    _lastSampleTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+/// Compares the frames delivered by the camera since the last window with the level's rate
+- (void)sampleFrames {
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    uint64_t frames = gFramesCaptured.load(std::memory_order_relaxed);
+    uint64_t dropped = gFramesDropped.load(std::memory_order_relaxed);
+    double seconds = (double)(now - _lastSampleTime) / NSEC_PER_SEC;
+    double fps = seconds > 0 ? (double)(frames - _lastFrames) / seconds : 0;
+    uint64_t delivered = frames - _lastFrames;
+    uint64_t droppedInWindow = dropped - _lastDropped;
+    _lastFrames = frames;
+    _lastDropped = dropped;
+    _lastSampleTime = now;
+
+    // No frames at all: capture is not running (audio call, camera off)
+    if (_ladder.empty() || delivered == 0) return;
+    double expected = toRate(_ladder[_level].rate);
+    if (fps < expected * kStrainedFpsRatio && droppedInWindow > 0) {
+        _healthyWindows = 0;
+        if (++_strainedWindows >= kStrainedWindows) {
+            _strainedWindows = 0;
+            _penalty = std::min<int>(_penalty + 1, (int)_ladder.size() - 1);
+            FILE_LOG_W("Governor", @"Capture at %.1f fps for %.0f expected (%llu dropped)",
+                       fps, expected, (unsigned long long)droppedInWindow);
+        }
+    } else {
+        _strainedWindows = 0;
+        if (_penalty > 0 && ++_healthyWindows >= kStepUpWindows) {
+            _healthyWindows = 0;
+            _penalty--;
+        }
+    }
+}
+
+- (size_t)targetLevel {
+    if (_ladder.empty()) return 0;
+    size_t last = _ladder.size() - 1;
+    size_t target = 0;
+    switch ([NSProcessInfo processInfo].thermalState) {
+        case NSProcessInfoThermalStateNominal: target = 0; break;
+        case NSProcessInfoThermalStateFair: target = 1; break;
+        case NSProcessInfoThermalStateSerious: target = 3; break;
+        case NSProcessInfoThermalStateCritical: target = last; break;
+    }
+    if (@available(macOS 12.0, iOS 9.0, *)) {
+        if ([NSProcessInfo processInfo].lowPowerModeEnabled) target = std::max<size_t>(target, 1);
+    }
+    return std::min(target + (size_t)_penalty, last);
+}
+
+/// windowElapsed: called from the timer (step-ups only count full windows)
+- (void)evaluate:(BOOL)windowElapsed {
+    if (_calls.empty() || _ladder.empty()) return;
+    if (!self.enabled) {
+        _penalty = 0;
+        [self applyLevel:0 reason:"disabled"];
+        return;
+    }
+    size_t target = [self targetLevel];
+    if (target > _level) {
+        _calmWindows = 0;
+        [self applyLevel:_level + 1 reason:"pressure"];
+    } else if (target < _level) {
+        if (windowElapsed && ++_calmWindows >= kStepUpWindows) {
+            [self applyLevel:_level - 1 reason:"recovered"];
+        }
+    } else {
+        _calmWindows = 0;
+    }
+}
+
+- (void)applyLevel:(size_t)level reason:(const char *)reason {
+    if (_ladder.empty() || _device.empty() || level == _level || level >= _ladder.size()) return;
+    const Step& step = _ladder[level];
+    auto settings = _baseline;
+    settings["size"] = step.size;
+    settings["rate"] = step.rate;
+    FILE_LOG_I("Governor", @"%s: level %zu -> %zu (%s @ %s fps, thermal %ld)", reason, _level, level,
+               step.size.c_str(), step.rate.c_str(), (long)[NSProcessInfo processInfo].thermalState);
+    _level = level;
+    // Restarts the capture with the new format; frame counts restart with it
+    _ownRestartDeadline = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) + kOwnRestartWindow;
+    libjami::applySettings(_device, settings);
+    [self resetWindows];
+}
+
+@end
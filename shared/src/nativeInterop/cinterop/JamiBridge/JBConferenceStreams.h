@@ -0,0 +1,40 @@
+//
+//  JBConferenceStreams.h
+//  GetTogether
+//
+//  Visibility-driven rendering of conference participant streams. The UI
+//  reports which participant sinks are on screen; sinks that are not stop being
+//  rendered (their SinkTarget is unregistered), after a grace delay for sinks
+//  that were visible so that scrolling through the grid does not thrash.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBConferenceStreams : NSObject
+
++ (instancetype)shared;
+
+/// Hosted conferences with a single visible stream switch to the ONE_BIG
+/// layout on it (and back to the grid). Off by default: the host's layout is
+/// what every participant receives.
+@property (atomic, assign) BOOL layoutFollowsVisibility;
+
+- (void)setVisibleStreams:(NSArray<JBStreamVisibility *> *)streams
+                accountId:(NSString *)accountId
+             conferenceId:(NSString *)conferenceId;
+
+// Called from the daemon signal handlers (daemon threads)
+- (void)conferenceInfosUpdated:(const std::string&)conferenceId
+                  participants:(const std::vector<std::map<std::string, std::string>>&)participants;
+- (void)conferenceRemoved:(const std::string&)conferenceId;
+
+@end
+
+NS_ASSUME_NONNULL_END
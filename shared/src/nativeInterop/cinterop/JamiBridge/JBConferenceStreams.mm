@@ -0,0 +1,242 @@
+//
+//  JBConferenceStreams.mm
+//  GetTogether
+//
+//  A conference is managed once the UI reported its visible streams: from
+//  then on, participant sinks it never showed are hidden as soon as the
+//  daemon announces them, shown sinks are hidden kHideDelay after they left
+//  the screen, and sinks that come back before that are never unregistered.
+//
+
+#import "JBConferenceStreams.h"
+#import "JBStringInterner.h"
+#import "JBVideoSinkManager.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#include <algorithm>
+#include <set>
+
+#include "callmanager_interface.h"
+
+namespace {
+
+constexpr int64_t kHideDelay = 1500 * NSEC_PER_MSEC;
+
+// libjami layout values (JBConferenceLayout does not follow them)
+constexpr uint32_t kLayoutGrid = 0;
+constexpr uint32_t kLayoutOneBig = 2;
+
+struct Participant {
+    std::string uri;
+    std::string device;
+};
+
+struct ConferenceStreams {
+    std::string accountId;
+    bool managed = false;
+    // sinkId -> participant, from the last OnConferenceInfosUpdated
+    std::map<std::string, Participant> participants;
+    // Sinks the UI currently reports as visible
+    std::set<std::string> requested;
+    // Last visibility applied to the sink manager
+    std::map<std::string, bool> shown;
+    // Hide deadline of shown sinks that left the screen
+    std::map<std::string, uint64_t> pendingHides;
+    std::string activeSink;
+};
+
+uint64_t now() {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+} // namespace
+
+@implementation JBConferenceStreams {
+    dispatch_queue_t _queue;
+    // Only touched on _queue
+    std::map<std::string, ConferenceStreams> _conferences;
+}
+
++ (instancetype)shared {
+    static JBConferenceStreams *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBConferenceStreams alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.streams", attr);
+    }
+    return self;
+}
+
+#pragma mark - Inputs
+
+- (void)setVisibleStreams:(NSArray<JBStreamVisibility *> *)streams
+                accountId:(NSString *)accountId
+             conferenceId:(NSString *)conferenceId {
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conferenceIdStr = toCppIdentifier(conferenceId);
+    std::set<std::string> requested;
+    JBVideoSinkManager *sinks = [JBVideoSinkManager shared];
+    for (JBStreamVisibility *stream in streams) {
+        requested.insert(toCppString(stream.sinkId));
+        // Frames are scaled for the tile right away, whatever the hysteresis
+        [sinks setDisplaySize:CGSizeMake(stream.width, stream.height) forSink:stream.sinkId];
+    }
+    dispatch_async(_queue, ^{
+        auto& conference = self->_conferences[conferenceIdStr];
+        conference.accountId = accountIdStr;
+        conference.managed = true;
+        conference.requested = requested;
+        uint64_t deadline = now() + kHideDelay;
+        for (const auto& sinkId : requested) {
+            conference.pendingHides.erase(sinkId);
+            [self apply:conference sink:sinkId visible:true];
+        }
+        for (const auto& [sinkId, visible] : conference.shown) {
+            if (visible && !requested.count(sinkId) && !conference.pendingHides.count(sinkId)) {
+                conference.pendingHides[sinkId] = deadline;
+            }
+        }
+        [self hideUnrequested:conference];
+        [self updateLayout:conference conferenceId:conferenceIdStr];
+        if (!conference.pendingHides.empty()) {
+            std::string conferenceIdCopy = conferenceIdStr;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kHideDelay), self->_queue, ^{
+                [self flushHides:conferenceIdCopy];
+            });
+        }
+    });
+}
+
+- (void)conferenceInfosUpdated:(const std::string&)conferenceId
+                  participants:(const std::vector<std::map<std::string, std::string>>&)participants {
+    // Blocks capture reference parameters by reference: copy what is needed first
+    std::string conferenceIdCopy = conferenceId;
+    std::map<std::string, Participant> current;
+    for (const auto& info : participants) {
+        auto sinkId = info.find("sinkId");
+        if (sinkId == info.end() || sinkId->second.empty()) continue;
+        auto uri = info.find("uri");
+        auto device = info.find("device");
+        current[sinkId->second] = {uri != info.end() ? uri->second : "", device != info.end() ? device->second : ""};
+    }
+    dispatch_async(_queue, ^{
+        auto& conference = self->_conferences[conferenceIdCopy];
+        // Sinks of participants that left go back to the default (visible) state
+        for (auto it = conference.shown.begin(); it != conference.shown.end();) {
+            if (current.count(it->first)) {
+                ++it;
+                continue;
+            }
+            if (!it->second) [[JBVideoSinkManager shared] setVisible:YES forSink:it->first];
+            conference.pendingHides.erase(it->first);
+            it = conference.shown.erase(it);
+        }
+        conference.participants = current;
+        if (!conference.managed) return;
+        [self hideUnrequested:conference];
+        [self updateLayout:conference conferenceId:conferenceIdCopy];
+    });
+}
+
+- (void)conferenceRemoved:(const std::string&)conferenceId {
+    std::string conferenceIdCopy = conferenceId;
+    dispatch_async(_queue, ^{
+        auto it = self->_conferences.find(conferenceIdCopy);
+        if (it == self->_conferences.end()) return;
+        for (const auto& [sinkId, visible] : it->second.shown) {
+            if (!visible) [[JBVideoSinkManager shared] setVisible:YES forSink:sinkId];
+        }
+        self->_conferences.erase(it);
+    });
+}
+
+#pragma mark - Visibility
+
+- (void)apply:(ConferenceStreams&)conference sink:(const std::string&)sinkId visible:(bool)visible {
+    auto it = conference.shown.find(sinkId);
+    if (it != conference.shown.end() && it->second == visible) return;
+    conference.shown[sinkId] = visible;
+    [[JBVideoSinkManager shared] setVisible:visible forSink:sinkId];
+}
+
+/// Participants never shown since the conference became managed need no grace delay
+- (void)hideUnrequested:(ConferenceStreams&)conference {
+    for (const auto& [sinkId, participant] : conference.participants) {
+        if (!conference.requested.count(sinkId) && !conference.shown.count(sinkId)) {
+            [self apply:conference sink:sinkId visible:false];
+        }
+    }
+}
+
+- (void)flushHides:(const std::string&)conferenceId {
+    auto it = _conferences.find(conferenceId);
+    if (it == _conferences.end()) return;
+    auto& conference = it->second;
+    uint64_t current = now();
+    bool changed = false;
+    for (auto hide = conference.pendingHides.begin(); hide != conference.pendingHides.end();) {
+        if (hide->second > current) {
+            ++hide;
+            continue;
+        }
+        if (!conference.requested.count(hide->first)) {
+            [self apply:conference sink:hide->first visible:false];
+            changed = true;
+        }
+        hide = conference.pendingHides.erase(hide);
+    }
+    if (changed) {
+        FILE_LOG_D("Streams", @"%s: %zu of %zu participant streams rendered", conferenceId.c_str(),
+                   (size_t)std::count_if(conference.shown.begin(), conference.shown.end(),
+                                         [](const auto& entry) { return entry.second; }),
+                   conference.participants.size());
+        [self updateLayout:conference conferenceId:conferenceId];
+    }
+}
+
+#pragma mark - Layout
+
+- (void)updateLayout:(ConferenceStreams&)conference conferenceId:(const std::string&)conferenceId {
+    if (!self.layoutFollowsVisibility) return;
+    // Only the host mixes: a joined conference's layout belongs to its host
+    auto hosted = libjami::getConferenceList(conference.accountId);
+    if (std::find(hosted.begin(), hosted.end(), conferenceId) == hosted.end()) return;
+
+    std::string single;
+    size_t shownCount = 0;
+    for (const auto& [sinkId, visible] : conference.shown) {
+        if (!visible || !conference.participants.count(sinkId)) continue;
+        shownCount++;
+        single = sinkId;
+    }
+    if (shownCount != 1) single.clear();
+    if (single == conference.activeSink) return;
+
+    if (!conference.activeSink.empty()) {
+        auto previous = conference.participants.find(conference.activeSink);
+        if (previous != conference.participants.end()) {
+            libjami::setActiveStream(conference.accountId, conferenceId, previous->second.uri,
+                                     previous->second.device, conference.activeSink, false);
+        }
+    }
+    if (single.empty()) {
+        libjami::setConferenceLayout(conference.accountId, conferenceId, kLayoutGrid);
+    } else {
+        const auto& participant = conference.participants[single];
+        libjami::setActiveStream(conference.accountId, conferenceId, participant.uri, participant.device, single, true);
+        libjami::setConferenceLayout(conference.accountId, conferenceId, kLayoutOneBig);
+    }
+    conference.activeSink = single;
+}
+
+@end
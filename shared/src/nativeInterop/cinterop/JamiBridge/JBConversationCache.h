@@ -0,0 +1,70 @@
+//
+//  JBConversationCache.h
+//  GetTogether
+//
+//  Converted conversation info, members and preferences per (account,
+//  conversation), loaded on first access and kept until a conversation signal
+//  or a local change invalidates them. Getters return the same immutable
+//  objects until then, so list redraws do not cross into libjami.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_OPTIONS(NSUInteger, JBConversationFields) {
+    JBConversationFieldInfo        = 1 << 0,
+    JBConversationFieldMembers     = 1 << 1,
+    JBConversationFieldPreferences = 1 << 2,
+    JBConversationFieldAll         = JBConversationFieldInfo | JBConversationFieldMembers | JBConversationFieldPreferences,
+};
+
+typedef NSDictionary<NSString *, NSString *> *_Nonnull (^JBConversationMapLoader)(void);
+typedef NSArray<JBConversationMember *> *_Nonnull (^JBConversationMembersLoader)(void);
+
+@interface JBConversationCache : NSObject
+
++ (instancetype)shared;
+
+/// Cached value, or the loader's result (called without the cache lock held).
+/// A value loaded while the entry was invalidated is returned but not kept.
+- (NSDictionary<NSString *, NSString *> *)info:(const std::string&)accountId
+                                conversationId:(const std::string&)conversationId
+                                        loader:(JBConversationMapLoader)loader;
+- (NSArray<JBConversationMember *> *)members:(const std::string&)accountId
+                              conversationId:(const std::string&)conversationId
+                                      loader:(JBConversationMembersLoader)loader;
+- (NSDictionary<NSString *, NSString *> *)preferences:(const std::string&)accountId
+                                       conversationId:(const std::string&)conversationId
+                                               loader:(JBConversationMapLoader)loader;
+
+/// Seeds fresh values (snapshot, ConversationPreferencesUpdated payload)
+- (void)storeInfo:(nullable NSDictionary<NSString *, NSString *> *)info
+          members:(nullable NSArray<JBConversationMember *> *)members
+      preferences:(nullable NSDictionary<NSString *, NSString *> *)preferences
+        accountId:(const std::string&)accountId
+   conversationId:(const std::string&)conversationId;
+
+/// Epoch of the entry, taken before reading values from the daemon
+- (uint64_t)epoch:(const std::string&)accountId conversationId:(const std::string&)conversationId;
+/// Seeds values read from the daemon, unless the entry was invalidated or
+/// stored since `epoch` (the values may predate that change). NO when dropped.
+- (BOOL)storeInfo:(nullable NSDictionary<NSString *, NSString *> *)info
+          members:(nullable NSArray<JBConversationMember *> *)members
+        accountId:(const std::string&)accountId
+   conversationId:(const std::string&)conversationId
+          ifEpoch:(uint64_t)epoch;
+
+- (void)invalidate:(JBConversationFields)fields
+         accountId:(const std::string&)accountId
+    conversationId:(const std::string&)conversationId;
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId;
+- (void)removeAccount:(const std::string&)accountId;
+- (void)clear;
+
+@end
+
+NS_ASSUME_NONNULL_END
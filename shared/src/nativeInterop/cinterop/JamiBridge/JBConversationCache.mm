@@ -0,0 +1,90 @@
+//
+//  JBConversationCache.mm
+//  GetTogether
+//
+//  jbcore::ConversationCache holding the converted Foundation objects; the
+//  epoch handling of loads racing invalidations lives there and is shared
+//  with the JNI library's encoded cache.
+//
+
+#import "JBConversationCache.h"
+#import "NativeFileLogger.h"
+
+#include "jbcore/ConversationCache.h"
+
+static_assert(JBConversationFieldInfo == jbcore::ConversationFieldInfo &&
+              JBConversationFieldMembers == jbcore::ConversationFieldMembers &&
+              JBConversationFieldPreferences == jbcore::ConversationFieldPreferences,
+              "JBConversationFields mirrors jbcore::ConversationField");
+
+@implementation JBConversationCache {
+    jbcore::ConversationCache<id> _cache;
+}
+
++ (instancetype)shared {
+    static JBConversationCache *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBConversationCache alloc] init];
+    });
+    return instance;
+}
+
+- (NSDictionary<NSString *, NSString *> *)info:(const std::string&)accountId
+                                conversationId:(const std::string&)conversationId
+                                        loader:(JBConversationMapLoader)loader {
+    return _cache.get(accountId, conversationId, jbcore::ConversationFieldInfo, [loader]() -> id { return loader(); });
+}
+
+- (NSArray<JBConversationMember *> *)members:(const std::string&)accountId
+                              conversationId:(const std::string&)conversationId
+                                      loader:(JBConversationMembersLoader)loader {
+    return _cache.get(accountId, conversationId, jbcore::ConversationFieldMembers, [loader]() -> id { return loader(); });
+}
+
+- (NSDictionary<NSString *, NSString *> *)preferences:(const std::string&)accountId
+                                       conversationId:(const std::string&)conversationId
+                                               loader:(JBConversationMapLoader)loader {
+    return _cache.get(accountId, conversationId, jbcore::ConversationFieldPreferences, [loader]() -> id { return loader(); });
+}
+
+- (void)storeInfo:(nullable NSDictionary<NSString *, NSString *> *)info
+          members:(nullable NSArray<JBConversationMember *> *)members
+      preferences:(nullable NSDictionary<NSString *, NSString *> *)preferences
+        accountId:(const std::string&)accountId
+   conversationId:(const std::string&)conversationId {
+    _cache.store(accountId, conversationId, [info copy], [members copy], [preferences copy]);
+}
+
+- (uint64_t)epoch:(const std::string&)accountId conversationId:(const std::string&)conversationId {
+    return _cache.epoch(accountId, conversationId);
+}
+
+- (BOOL)storeInfo:(nullable NSDictionary<NSString *, NSString *> *)info
+          members:(nullable NSArray<JBConversationMember *> *)members
+        accountId:(const std::string&)accountId
+   conversationId:(const std::string&)conversationId
+          ifEpoch:(uint64_t)epoch {
+    return _cache.storeIfEpoch(epoch, accountId, conversationId, [info copy], [members copy], nil);
+}
+
+- (void)invalidate:(JBConversationFields)fields
+         accountId:(const std::string&)accountId
+    conversationId:(const std::string&)conversationId {
+    _cache.invalidate((uint32_t)fields, accountId, conversationId);
+}
+
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId {
+    _cache.removeConversation(accountId, conversationId);
+}
+
+- (void)removeAccount:(const std::string&)accountId {
+    _cache.removeAccount(accountId);
+}
+
+- (void)clear {
+    _cache.clear();
+    FILE_LOG_I("ConversationCache", @"Conversation cache cleared");
+}
+
+@end
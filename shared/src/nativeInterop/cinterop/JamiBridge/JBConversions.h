@@ -0,0 +1,155 @@
+//
+//  JBConversions.h
+//  GetTogether
+//
+//  Type conversion helpers shared by the JamiBridge Objective-C++ sources.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <map>
+
+// Collection objects gathered on the stack (heap past N) and handed to the
+// Foundation bulk constructors, instead of growing a mutable collection and copying it
+template <size_t N = 16>
+class JBObjectBuffer {
+public:
+    explicit JBObjectBuffer(size_t capacity)
+        : heap_(capacity > N ? capacity : 0), data_(capacity > N ? heap_.data() : stack_) {}
+    JBObjectBuffer(const JBObjectBuffer&) = delete;
+    JBObjectBuffer& operator=(const JBObjectBuffer&) = delete;
+
+    void push(id object) { data_[size_++] = object; }
+    const id __strong *data() const { return data_; }
+    NSUInteger count() const { return size_; }
+
+private:
+    id stack_[N];
+    std::vector<id> heap_;
+    id __strong *data_;
+    NSUInteger size_ = 0;
+};
+
+// Map keys the daemon sends with every message, conference update, contact and
+// media list; constant strings, so converting them allocates nothing
+static inline NSString* knownKeyNSString(const std::string& key) {
+    using KnownKeys = std::unordered_map<std::string_view, __unsafe_unretained NSString *>;
+#define JB_KNOWN_KEY(literal) {std::string_view(literal, sizeof(literal) - 1), @literal}
+    static const KnownKeys keys = {
+        // Swarm message bodies
+        JB_KNOWN_KEY("id"), JB_KNOWN_KEY("type"), JB_KNOWN_KEY("author"), JB_KNOWN_KEY("body"),
+        JB_KNOWN_KEY("timestamp"), JB_KNOWN_KEY("linearizedParent"), JB_KNOWN_KEY("parents"),
+        JB_KNOWN_KEY("reply-to"), JB_KNOWN_KEY("react-to"), JB_KNOWN_KEY("action"), JB_KNOWN_KEY("uri"),
+        JB_KNOWN_KEY("device"), JB_KNOWN_KEY("fileId"), JB_KNOWN_KEY("displayName"),
+        JB_KNOWN_KEY("totalSize"), JB_KNOWN_KEY("sha3sum"), JB_KNOWN_KEY("tid"), JB_KNOWN_KEY("duration"),
+        JB_KNOWN_KEY("edit"), JB_KNOWN_KEY("mode"), JB_KNOWN_KEY("invited"),
+        // Conference participant infos
+        JB_KNOWN_KEY("sinkId"), JB_KNOWN_KEY("active"), JB_KNOWN_KEY("x"), JB_KNOWN_KEY("y"),
+        JB_KNOWN_KEY("w"), JB_KNOWN_KEY("h"), JB_KNOWN_KEY("videoMuted"), JB_KNOWN_KEY("audioLocalMuted"),
+        JB_KNOWN_KEY("audioModeratorMuted"), JB_KNOWN_KEY("isModerator"), JB_KNOWN_KEY("handRaised"),
+        JB_KNOWN_KEY("voiceActivity"), JB_KNOWN_KEY("recording"), JB_KNOWN_KEY("isLocal"),
+        // Contacts, members, conversation infos
+        JB_KNOWN_KEY("added"), JB_KNOWN_KEY("confirmed"), JB_KNOWN_KEY("removed"), JB_KNOWN_KEY("banned"),
+        JB_KNOWN_KEY("conversationId"), JB_KNOWN_KEY("role"), JB_KNOWN_KEY("lastDisplayed"),
+        JB_KNOWN_KEY("title"), JB_KNOWN_KEY("description"), JB_KNOWN_KEY("avatar"), JB_KNOWN_KEY("from"),
+        JB_KNOWN_KEY("received"),
+        // Media lists
+        JB_KNOWN_KEY("MEDIA_TYPE"), JB_KNOWN_KEY("ENABLED"), JB_KNOWN_KEY("MUTED"), JB_KNOWN_KEY("SOURCE"),
+        JB_KNOWN_KEY("LABEL"),
+    };
+#undef JB_KNOWN_KEY
+    auto known = keys.find(std::string_view(key));
+    return known != keys.end() ? known->second : nil;
+}
+
+// C++ string -> NSString (nil for invalid UTF-8)
+static inline NSString* toNSString(const std::string& str) {
+    if (str.empty()) return @"";
+    return [[NSString alloc] initWithBytes:str.data() length:str.size() encoding:NSUTF8StringEncoding];
+}
+
+// NSString -> C++ string
+static inline std::string toCppString(NSString* str) {
+    if (!str) return "";
+    // ASCII strings stored as 8-bit expose their bytes directly; sized by
+    // length, not by NUL, so an embedded NUL does not cut the string short
+    if (const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)str, kCFStringEncodingUTF8)) {
+        return std::string(bytes, [str lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    }
+    NSUInteger length = str.length;
+    std::string result;
+    result.resize([str maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    NSUInteger used = 0;
+    [str getBytes:result.data()
+        maxLength:result.size()
+       usedLength:&used
+         encoding:NSUTF8StringEncoding
+          options:0
+            range:NSMakeRange(0, length)
+   remainingRange:NULL];
+    result.resize(used);
+    return result;
+}
+
+// std::map<string,string> -> NSDictionary (pairs that are not valid UTF-8 are dropped)
+static inline NSDictionary<NSString*, NSString*>* toNSDictionary(const std::map<std::string, std::string>& map) {
+    JBObjectBuffer<> keys(map.size());
+    JBObjectBuffer<> values(map.size());
+    for (const auto& pair : map) {
+        NSString *key = knownKeyNSString(pair.first) ?: toNSString(pair.first);
+        NSString *value = toNSString(pair.second);
+        if (!key || !value) continue;
+        keys.push(key);
+        values.push(value);
+    }
+    return [NSDictionary dictionaryWithObjects:values.data() forKeys:keys.data() count:keys.count()];
+}
+
+// NSDictionary -> std::map<string,string>
+static inline std::map<std::string, std::string> toCppMap(NSDictionary<NSString*, NSString*>* dict) {
+    std::map<std::string, std::string> map;
+    std::map<std::string, std::string>* out = &map;
+    [dict enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        out->emplace(toCppString(key), toCppString(value));
+    }];
+    return map;
+}
+
+// std::vector<string> -> NSArray (strings that are not valid UTF-8 are dropped)
+static inline NSArray<NSString*>* toNSArray(const std::vector<std::string>& vec) {
+    JBObjectBuffer<> objects(vec.size());
+    for (const auto& str : vec) {
+        if (NSString *object = toNSString(str)) objects.push(object);
+    }
+    return [NSArray arrayWithObjects:objects.data() count:objects.count()];
+}
+
+// NSArray -> std::vector<string>
+static inline std::vector<std::string> toCppVector(NSArray<NSString*>* arr) {
+    std::vector<std::string> vec;
+    vec.reserve(arr.count);
+    for (NSString* str in arr) {
+        vec.push_back(toCppString(str));
+    }
+    return vec;
+}
+
+// std::map<string,int32_t> -> NSDictionary<NSString*, NSNumber*>
+static inline NSDictionary<NSString*, NSNumber*>* toNSNumberDictionary(const std::map<std::string, int32_t>& map) {
+    JBObjectBuffer<> keys(map.size());
+    JBObjectBuffer<> values(map.size());
+    for (const auto& pair : map) {
+        NSString *key = toNSString(pair.first);
+        if (!key) continue;
+        keys.push(key);
+        values.push(@(pair.second));
+    }
+    return [NSDictionary dictionaryWithObjects:values.data() forKeys:keys.data() count:keys.count()];
+}
@@ -0,0 +1,32 @@
+//
+//  JBExtensionSession.h
+//  GetTogether
+//
+//  Notification Service Extension profile: one daemon run that loads only the
+//  pushed account and conversation, registers only the message signals, waits
+//  for the pushed message and shuts the daemon down before completing. Sized
+//  for the extension's ~24 MB footprint cap and few seconds of wall time.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <map>
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBExtensionSession : NSObject
+
+/// Runs the whole session on its own queue; `completion` is called there once,
+/// after libjami::fini() returned. An empty `conversationId` accepts a message
+/// from any conversation of the account.
++ (void)runWithAccountId:(const std::string&)accountId
+          conversationId:(const std::string&)conversationId
+                pushData:(const std::map<std::string, std::string>&)pushData
+                 timeout:(NSTimeInterval)timeout
+              completion:(JBExtensionCompletion)completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,222 @@
+//
+//  JBExtensionSession.mm
+//  GetTogether
+//
+//  The daemon starts with NO_AUTOLOAD/NO_AUTOSYNC and without local media, so
+//  libjami::start loads no account; loadAccountAndConversation then loads the
+//  pushed account with that single conversation, and the push payload makes
+//  it fetch. Only SwarmMessageReceived and SwarmLoaded are registered.
+//
+//  The first message of the conversation ends the session after a short
+//  settle delay (a fetch delivers its commits back to back, the newest wins).
+//  If none arrived by 3/4 of the timeout, the newest message already on disk
+//  is loaded instead: the app or an earlier push may have fetched it.
+//
+
+#import "JBExtensionSession.h"
+#import "JBLazySwarmMessage.h"
+#import "NativeFileLogger.h"
+#include "JBSignalMetrics.h"
+#include "JBConversions.h"
+
+#include <mach/mach.h>
+#include <atomic>
+
+#include "configurationmanager_interface.h"
+
+namespace {
+
+constexpr double kHistoryFallbackRatio = 0.75;
+constexpr int64_t kSettleDelay = 300 * NSEC_PER_MSEC;
+
+// One daemon per process: a concurrent push completes right away, without a message
+std::atomic<bool> gSessionRunning {false};
+
+// What the extension's memory cap is enforced on
+uint64_t peakFootprintBytes() {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) return 0;
+    return count >= TASK_VM_INFO_REV3_COUNT ? info.ledger_phys_footprint_peak : info.resident_size_peak;
+}
+
+uint64_t nowNanos() {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+} // namespace
+
+@implementation JBExtensionSession {
+    dispatch_queue_t _queue;
+    std::string _accountId;
+    std::string _conversationId;
+    JBExtensionCompletion _completion;
+    uint64_t _startTime;
+    BOOL _ownsDaemon;
+    // Only touched on _queue
+    JBSwarmMessage *_message;
+    NSString *_messageConversationId;
+    BOOL _fromHistory;
+    uint32_t _historyRequest;
+    BOOL _settling;
+    BOOL _finished;
+}
+
++ (void)runWithAccountId:(const std::string&)accountId
+          conversationId:(const std::string&)conversationId
+                pushData:(const std::map<std::string, std::string>&)pushData
+                 timeout:(NSTimeInterval)timeout
+              completion:(JBExtensionCompletion)completion {
+    JBExtensionSession *session = [[JBExtensionSession alloc] initWithAccountId:accountId
+                                                                 conversationId:conversationId
+                                                                     completion:completion];
+    session->_ownsDaemon = !gSessionRunning.exchange(true);
+    if (!session->_ownsDaemon) {
+        FILE_LOG_W("Extension", @"A session is already running");
+        dispatch_async(session->_queue, ^{ [session complete:"busy"]; });
+        return;
+    }
+    // Blocks capture reference parameters by reference: copy them first
+    std::map<std::string, std::string> data = pushData;
+    dispatch_async(session->_queue, ^{
+        [session startWithPushData:data timeout:timeout];
+    });
+}
+
+- (instancetype)initWithAccountId:(const std::string&)accountId
+                   conversationId:(const std::string&)conversationId
+                       completion:(JBExtensionCompletion)completion {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.extension", attr);
+        _accountId = accountId;
+        _conversationId = conversationId;
+        _completion = [completion copy];
+        _startTime = nowNanos();
+    }
+    return self;
+}
+
+#pragma mark - Session
+
+- (void)startWithPushData:(const std::map<std::string, std::string>&)pushData timeout:(NSTimeInterval)timeout {
+    // The log ring and the dirty pages of the mapped log file count against the cap
+    fileLogSetFileOutputEnabled(false);
+
+    int flags = libjami::LIBJAMI_FLAG_IOS_EXTENSION | libjami::LIBJAMI_FLAG_NO_AUTOLOAD
+        | libjami::LIBJAMI_FLAG_NO_AUTOSYNC | libjami::LIBJAMI_FLAG_NO_LOCAL_MEDIA;
+    if (!libjami::init(static_cast<libjami::InitFlag>(flags))) {
+        FILE_LOG_E("Extension", @"libjami::init() failed");
+        [self complete:"init failed"];
+        return;
+    }
+    libjami::registerSignalHandlers([self makeSignalHandlers]);
+    if (!libjami::start()) {
+        FILE_LOG_E("Extension", @"libjami::start() failed");
+        [self finish:"start failed"];
+        return;
+    }
+    libjami::loadAccountAndConversation(_accountId, false, _conversationId);
+    if (!pushData.empty()) {
+        libjami::pushNotificationReceived("", pushData);
+    }
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * kHistoryFallbackRatio * NSEC_PER_SEC)),
+                   _queue, ^{ [self loadNewestMessage]; });
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)),
+                   _queue, ^{ [self finish:"timeout"]; });
+}
+
+- (std::map<std::string, std::shared_ptr<libjami::CallbackWrapperBase>>)makeSignalHandlers {
+    using namespace libjami;
+    std::map<std::string, std::shared_ptr<CallbackWrapperBase>> handlers;
+    // Strong captures: unregisterSignalHandlers in -finish: releases them
+    JBExtensionSession *session = self;
+
+    handlers.insert(instrumented_callback<ConversationSignal::SwarmMessageReceived>(
+        [session](const std::string& accountId, const std::string& conversationId, const SwarmMessage& message) {
+            if (![session accepts:accountId conversationId:conversationId]) return;
+            JBSwarmMessage *jbMessage = [[JBLazySwarmMessage alloc] initWithSwarmMessage:SwarmMessage(message)];
+            NSString *conversationIdNS = toNSString(conversationId);
+            dispatch_async(session->_queue, ^{
+                [session messageReceived:jbMessage conversationId:conversationIdNS fromHistory:NO];
+            });
+        }));
+
+    handlers.insert(instrumented_callback<ConversationSignal::SwarmLoaded>(
+        [session](uint32_t requestId, const std::string& accountId, const std::string& conversationId,
+                  std::vector<SwarmMessage> messages) {
+            if (messages.empty() || ![session accepts:accountId conversationId:conversationId]) return;
+            // Newest first
+            JBSwarmMessage *jbMessage = [[JBLazySwarmMessage alloc] initWithSwarmMessage:std::move(messages.front())];
+            NSString *conversationIdNS = toNSString(conversationId);
+            dispatch_async(session->_queue, ^{
+                if (requestId != session->_historyRequest) return;
+                [session messageReceived:jbMessage conversationId:conversationIdNS fromHistory:YES];
+            });
+        }));
+
+    return handlers;
+}
+
+// Daemon threads; the ids are immutable after init
+- (BOOL)accepts:(const std::string&)accountId conversationId:(const std::string&)conversationId {
+    return accountId == _accountId && (_conversationId.empty() || conversationId == _conversationId);
+}
+
+- (void)messageReceived:(JBSwarmMessage *)message
+         conversationId:(NSString *)conversationId
+            fromHistory:(BOOL)fromHistory {
+    if (_finished) return;
+    // A fetched message always beats the on-disk fallback
+    if (fromHistory && _message) return;
+    _message = message;
+    _messageConversationId = conversationId;
+    _fromHistory = fromHistory;
+    if (fromHistory) {
+        [self finish:"history"];
+        return;
+    }
+    if (_settling) return;
+    _settling = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kSettleDelay), _queue, ^{ [self finish:"message"]; });
+}
+
+- (void)loadNewestMessage {
+    if (_finished || _message || _conversationId.empty()) return;
+    _historyRequest = libjami::loadConversation(_accountId, _conversationId, "", 1);
+}
+
+#pragma mark - Shutdown
+
+- (void)finish:(const char *)reason {
+    if (_finished) return;
+    libjami::unregisterSignalHandlers();
+    libjami::fini();
+    [self complete:reason];
+}
+
+- (void)complete:(const char *)reason {
+    if (_finished) return;
+    _finished = YES;
+
+    JBExtensionResult *result = [[JBExtensionResult alloc] init];
+    result.accountId = toNSString(_accountId);
+    result.conversationId = _messageConversationId ?: toNSString(_conversationId);
+    result.message = _message;
+    result.fromHistory = _fromHistory;
+    result.peakFootprintBytes = peakFootprintBytes();
+    result.elapsedSeconds = (double)(nowNanos() - _startTime) / NSEC_PER_SEC;
+    FILE_LOG_I("Extension", @"Session ended (%s): message=%d history=%d, peak footprint %.1f MB, %.0f ms",
+               reason, _message != nil, _fromHistory,
+               result.peakFootprintBytes / (1024.0 * 1024.0), result.elapsedSeconds * 1000);
+
+    if (_ownsDaemon) gSessionRunning.store(false);
+    JBExtensionCompletion completion = _completion;
+    _completion = nil;
+    if (completion) completion(result);
+}
+
+@end
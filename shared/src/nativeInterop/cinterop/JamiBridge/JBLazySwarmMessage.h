@@ -0,0 +1,25 @@
+//
+//  JBLazySwarmMessage.h
+//  GetTogether
+//
+//  JBSwarmMessage backed by the moved-in libjami::SwarmMessage. Foundation
+//  objects for a property are built on its first access, on the reader's
+//  queue instead of the daemon thread. The Kotlin SwarmMessage reads id, type
+//  and replyTo on arrival; body, reactions and status only when the model
+//  first reads them.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include "conversation_interface.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBLazySwarmMessage : JBSwarmMessage
+
+- (instancetype)initWithSwarmMessage:(libjami::SwarmMessage&&)message;
+
+@end
+
+NS_ASSUME_NONNULL_END
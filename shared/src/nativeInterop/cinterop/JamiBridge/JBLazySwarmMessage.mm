@@ -0,0 +1,123 @@
+//
+//  JBLazySwarmMessage.mm
+//  GetTogether
+//
+
+#import "JBLazySwarmMessage.h"
+#include "JBConversions.h"
+#include "JBStringInterner.h"
+
+#import <os/lock.h>
+
+#include <cstdlib>
+
+typedef NS_OPTIONS(uint32_t, JBSwarmField) {
+    JBSwarmFieldMessageId = 1 << 0,
+    JBSwarmFieldType      = 1 << 1,
+    JBSwarmFieldAuthor    = 1 << 2,
+    JBSwarmFieldBody      = 1 << 3,
+    JBSwarmFieldReactions = 1 << 4,
+    JBSwarmFieldTimestamp = 1 << 5,
+    JBSwarmFieldReplyTo   = 1 << 6,
+    JBSwarmFieldStatus    = 1 << 7,
+    JBSwarmFieldAll       = (1 << 8) - 1,
+};
+
+static const std::string* bodyValue(const libjami::SwarmMessage& message, const char* key) {
+    auto it = message.body.find(key);
+    return it != message.body.end() ? &it->second : nullptr;
+}
+
+@implementation JBLazySwarmMessage {
+    os_unfair_lock _lock;
+    JBSwarmField _materialized;
+    libjami::SwarmMessage _message;
+}
+
+- (instancetype)initWithSwarmMessage:(libjami::SwarmMessage&&)message {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _materialized = 0;
+        _message = std::move(message);
+    }
+    return self;
+}
+
+// Must be called with _lock held
+- (void)materialize:(JBSwarmField)field {
+    if (_materialized & field) return;
+    switch (field) {
+        case JBSwarmFieldMessageId:
+            [super setMessageId:toNSString(_message.id)];
+            break;
+        case JBSwarmFieldType:
+            [super setType:toNSIdentifier(_message.type)];
+            break;
+        case JBSwarmFieldAuthor: {
+            auto author = bodyValue(_message, "author");
+            [super setAuthor:author ? toNSIdentifier(*author) : @""];
+            break;
+        }
+        case JBSwarmFieldBody:
+            [super setBody:toNSDictionary(_message.body)];
+            break;
+        case JBSwarmFieldReactions: {
+            NSMutableArray *reactions = [NSMutableArray arrayWithCapacity:_message.reactions.size()];
+            for (const auto& reaction : _message.reactions) {
+                [reactions addObject:toNSDictionary(reaction)];
+            }
+            [super setReactions:[reactions copy]];
+            break;
+        }
+        case JBSwarmFieldTimestamp: {
+            auto timestamp = bodyValue(_message, "timestamp");
+            [super setTimestamp:timestamp ? std::strtoll(timestamp->c_str(), nullptr, 10) : 0];
+            break;
+        }
+        case JBSwarmFieldReplyTo: {
+            auto replyTo = bodyValue(_message, "reply-to");
+            [super setReplyTo:replyTo ? toNSString(*replyTo) : nil];
+            break;
+        }
+        case JBSwarmFieldStatus:
+            [super setStatus:toNSNumberDictionary(_message.status)];
+            break;
+        default:
+            return;
+    }
+    [self markMaterialized:field];
+}
+
+// Must be called with _lock held
+- (void)markMaterialized:(JBSwarmField)field {
+    _materialized |= field;
+    if (_materialized == JBSwarmFieldAll) {
+        // Everything lives in Foundation objects now
+        _message = {};
+    }
+}
+
+#define LOCKED(...) do { os_unfair_lock_lock(&_lock); __VA_ARGS__; os_unfair_lock_unlock(&_lock); } while (0)
+
+- (NSString *)messageId { LOCKED([self materialize:JBSwarmFieldMessageId]); return [super messageId]; }
+- (NSString *)type { LOCKED([self materialize:JBSwarmFieldType]); return [super type]; }
+- (NSString *)author { LOCKED([self materialize:JBSwarmFieldAuthor]); return [super author]; }
+- (NSDictionary<NSString *, NSString *> *)body { LOCKED([self materialize:JBSwarmFieldBody]); return [super body]; }
+- (NSArray<NSDictionary<NSString *, NSString *> *> *)reactions { LOCKED([self materialize:JBSwarmFieldReactions]); return [super reactions]; }
+- (int64_t)timestamp { LOCKED([self materialize:JBSwarmFieldTimestamp]); return [super timestamp]; }
+- (NSString *)replyTo { LOCKED([self materialize:JBSwarmFieldReplyTo]); return [super replyTo]; }
+- (NSDictionary<NSString *, NSNumber *> *)status { LOCKED([self materialize:JBSwarmFieldStatus]); return [super status]; }
+
+// Setters override the lazy value
+- (void)setMessageId:(NSString *)messageId { LOCKED([super setMessageId:messageId]; [self markMaterialized:JBSwarmFieldMessageId]); }
+- (void)setType:(NSString *)type { LOCKED([super setType:type]; [self markMaterialized:JBSwarmFieldType]); }
+- (void)setAuthor:(NSString *)author { LOCKED([super setAuthor:author]; [self markMaterialized:JBSwarmFieldAuthor]); }
+- (void)setBody:(NSDictionary<NSString *, NSString *> *)body { LOCKED([super setBody:body]; [self markMaterialized:JBSwarmFieldBody]); }
+- (void)setReactions:(NSArray<NSDictionary<NSString *, NSString *> *> *)reactions { LOCKED([super setReactions:reactions]; [self markMaterialized:JBSwarmFieldReactions]); }
+- (void)setTimestamp:(int64_t)timestamp { LOCKED([super setTimestamp:timestamp]; [self markMaterialized:JBSwarmFieldTimestamp]); }
+- (void)setReplyTo:(NSString *)replyTo { LOCKED([super setReplyTo:replyTo]; [self markMaterialized:JBSwarmFieldReplyTo]); }
+- (void)setStatus:(NSDictionary<NSString *, NSNumber *> *)status { LOCKED([super setStatus:status]; [self markMaterialized:JBSwarmFieldStatus]); }
+
+#undef LOCKED
+
+@end
@@ -0,0 +1,47 @@
+//
+//  JBMediaPreprocessor.h
+//  GetTogether
+//
+//  Background stage between sendFile and libjami::sendFile for images and
+//  videos: ImageIO thumbnailing straight from the encoded file (the full
+//  bitmap is never decoded), HEIC or JPEG re-encoding without metadata, and
+//  hardware (VideoToolbox) transcoding through AVAssetExportSession presets.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+#import <CoreGraphics/CoreGraphics.h>
+#import <ImageIO/ImageIO.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^JBPreparedFileCompletion)(NSString *_Nullable preparedPath);
+
+@interface JBMediaPreprocessor : NSObject
+
++ (instancetype)shared;
+
+/// Copy of the current settings / replaces them for the next files
+- (JBMediaSettings *)settings;
+- (void)setSettings:(JBMediaSettings *)settings;
+
+/// Whether prepareFile: would rewrite `path` (an image or video not produced here)
+- (BOOL)shouldPrepare:(NSString *)path;
+
+/// Rewrites `path` off the caller's thread, reporting progress to the transfer
+/// tracker. `completion` runs on a background queue with the file to send, or
+/// nil to send the original (unsupported, already small enough, or failed).
+- (void)prepareFile:(NSString *)path
+          accountId:(NSString *)accountId
+     conversationId:(NSString *)conversationId
+         completion:(JBPreparedFileCompletion)completion;
+
+/// Camera capture: downscales and encodes a decoded image with the image
+/// settings. `completion` runs on the main queue.
+- (void)writeCapturedImage:(CGImageRef)image
+               orientation:(CGImagePropertyOrientation)orientation
+                completion:(JBPreparedFileCompletion)completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,363 @@
+//
+//  JBMediaPreprocessor.mm
+//  GetTogether
+//
+//  Images are handled one at a time on the preprocessor queue, which bounds
+//  the memory to one thumbnail; video exports run concurrently inside
+//  AVFoundation and are polled for progress. Outputs go to the temporary
+//  directory, like the picker's files, and are remembered so a file coming
+//  back through sendFile is not processed twice.
+//
+//  Only the orientation survives re-encoding: EXIF, GPS and maker notes are
+//  not copied, and videos go through the sharing metadata filter. An output
+//  that is not smaller than its source is dropped and the source is sent as
+//  it is, metadata included.
+//
+
+#import "JBMediaPreprocessor.h"
+#import "JBTransferTracker.h"
+#import "NativeFileLogger.h"
+
+#import <AVFoundation/AVFoundation.h>
+#import <UniformTypeIdentifiers/UniformTypeIdentifiers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr int64_t kVideoProgressInterval = 250 * NSEC_PER_MSEC;
+
+struct Settings {
+    bool enabled = true;
+    int maxImageDimension = 2048;
+    JBImageFormat imageFormat = JBImageFormatJPEG;
+    double imageQuality = 0.8;
+    JBVideoPreset videoPreset = JBVideoPreset720p;
+};
+
+std::atomic<uint64_t> gOutputCounter {0};
+
+NSString *outputPath(NSString *extension) {
+    NSString *name = [NSString stringWithFormat:@"jami_media_%lld_%llu.%@",
+                      (long long)[[NSDate date] timeIntervalSince1970],
+                      (unsigned long long)gOutputCounter.fetch_add(1), extension];
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+}
+
+int64_t fileSize(NSString *path) {
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+    return attributes ? (int64_t)attributes.fileSize : 0;
+}
+
+NSString *exportPreset(JBVideoPreset preset) {
+    switch (preset) {
+        case JBVideoPreset540p: return AVAssetExportPreset960x540;
+        case JBVideoPreset720p: return AVAssetExportPreset1280x720;
+        case JBVideoPreset1080p: return AVAssetExportPreset1920x1080;
+        case JBVideoPresetOriginal: break;
+    }
+    return nil;
+}
+
+int presetShortSide(JBVideoPreset preset) {
+    switch (preset) {
+        case JBVideoPreset540p: return 540;
+        case JBVideoPreset720p: return 720;
+        case JBVideoPreset1080p: return 1080;
+        case JBVideoPresetOriginal: break;
+    }
+    return INT_MAX;
+}
+
+// Draws `image` into a bitmap whose longest side is at most `maxDimension`
+CGImageRef createDownscaled(CGImageRef image, int maxDimension) {
+    size_t width = CGImageGetWidth(image);
+    size_t height = CGImageGetHeight(image);
+    size_t longest = std::max(width, height);
+    if (maxDimension <= 0 || longest <= (size_t)maxDimension) return CGImageRetain(image);
+    double scale = (double)maxDimension / longest;
+    size_t scaledWidth = std::max<size_t>(1, (size_t)lround(width * scale));
+    size_t scaledHeight = std::max<size_t>(1, (size_t)lround(height * scale));
+
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    CGContextRef context = CGBitmapContextCreate(nullptr, scaledWidth, scaledHeight, 8, 0, colorSpace,
+                                                 kCGImageAlphaNoneSkipLast | kCGBitmapByteOrder32Big);
+    CGColorSpaceRelease(colorSpace);
+    if (!context) return CGImageRetain(image);
+    CGContextSetInterpolationQuality(context, kCGInterpolationHigh);
+    CGContextDrawImage(context, CGRectMake(0, 0, scaledWidth, scaledHeight), image);
+    CGImageRef scaled = CGBitmapContextCreateImage(context);
+    CGContextRelease(context);
+    return scaled ?: CGImageRetain(image);
+}
+
+} // namespace
+
+@implementation JBMediaPreprocessor {
+    dispatch_queue_t _queue;
+    Settings _settings;              // @synchronized (self)
+    NSMutableSet<NSString *> *_outputs; // @synchronized (self)
+}
+
++ (instancetype)shared {
+    static JBMediaPreprocessor *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBMediaPreprocessor alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.media", attr);
+        _outputs = [NSMutableSet set];
+    }
+    return self;
+}
+
+#pragma mark - Settings
+
+- (JBMediaSettings *)settings {
+    Settings current = [self currentSettings];
+    JBMediaSettings *settings = [[JBMediaSettings alloc] init];
+    settings.enabled = current.enabled;
+    settings.maxImageDimension = current.maxImageDimension;
+    settings.imageFormat = current.imageFormat;
+    settings.imageQuality = current.imageQuality;
+    settings.videoPreset = current.videoPreset;
+    return settings;
+}
+
+- (void)setSettings:(JBMediaSettings *)settings {
+    @synchronized (self) {
+        _settings.enabled = settings.enabled;
+        _settings.maxImageDimension = settings.maxImageDimension;
+        _settings.imageFormat = settings.imageFormat;
+        _settings.imageQuality = std::clamp(settings.imageQuality, 0.0, 1.0);
+        _settings.videoPreset = settings.videoPreset;
+    }
+}
+
+- (Settings)currentSettings {
+    @synchronized (self) {
+        return _settings;
+    }
+}
+
+#pragma mark - Files
+
+- (BOOL)shouldPrepare:(NSString *)path {
+    if (![self currentSettings].enabled) return NO;
+    @synchronized (self) {
+        if ([_outputs containsObject:path]) return NO;
+    }
+    UTType *type = [UTType typeWithFilenameExtension:path.pathExtension];
+    if (!type) return NO;
+    // Animations would be flattened to their first frame
+    if ([type conformsToType:UTTypeGIF]) return NO;
+    return [type conformsToType:UTTypeImage] || [type conformsToType:UTTypeMovie];
+}
+
+- (void)prepareFile:(NSString *)path
+          accountId:(NSString *)accountId
+     conversationId:(NSString *)conversationId
+         completion:(JBPreparedFileCompletion)completion {
+    Settings settings = [self currentSettings];
+    NSString *prepareId = [NSString stringWithFormat:@"prepare-%llu",
+                           (unsigned long long)gOutputCounter.fetch_add(1)];
+    int64_t total = fileSize(path);
+    JBTransferTracker *tracker = [JBTransferTracker shared];
+    void (^report)(double, BOOL) = ^(double fraction, BOOL finished) {
+        [tracker preparationProgress:prepareId accountId:accountId conversationId:conversationId
+                          sourcePath:path totalSize:total fraction:fraction finished:finished];
+    };
+    JBPreparedFileCompletion done = ^(NSString *preparedPath) {
+        report(1, YES);
+        if (preparedPath) {
+            FILE_LOG_I("Media", @"%@: %lld -> %lld bytes", path.lastPathComponent, total, fileSize(preparedPath));
+        }
+        completion(preparedPath);
+    };
+
+    dispatch_async(_queue, ^{
+        report(0, NO);
+        UTType *type = [UTType typeWithFilenameExtension:path.pathExtension];
+        if ([type conformsToType:UTTypeMovie]) {
+            [self prepareVideo:path settings:settings progress:report completion:done];
+        } else {
+            done([self prepareImage:path settings:settings]);
+        }
+    });
+}
+
+- (void)writeCapturedImage:(CGImageRef)image
+               orientation:(CGImagePropertyOrientation)orientation
+                completion:(JBPreparedFileCompletion)completion {
+    Settings settings = [self currentSettings];
+    CGImageRetain(image);
+    dispatch_async(_queue, ^{
+        CGImageRef scaled = createDownscaled(image, settings.maxImageDimension);
+        CGImageRelease(image);
+        NSString *path = [self writeImage:scaled orientation:orientation settings:settings];
+        CGImageRelease(scaled);
+        dispatch_async(dispatch_get_main_queue(), ^{ completion(path); });
+    });
+}
+
+#pragma mark - Images (on _queue)
+
+- (nullable NSString *)prepareImage:(NSString *)path settings:(const Settings&)settings {
+    NSURL *url = [NSURL fileURLWithPath:path];
+    NSDictionary *sourceOptions = @{(id)kCGImageSourceShouldCache: @NO};
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)url, (__bridge CFDictionaryRef)sourceOptions);
+    if (!source) return nil;
+    if (CGImageSourceGetCount(source) != 1) {
+        CFRelease(source);
+        return nil;
+    }
+    NSDictionary *properties = CFBridgingRelease(
+        CGImageSourceCopyPropertiesAtIndex(source, 0, (__bridge CFDictionaryRef)sourceOptions));
+    int width = [properties[(id)kCGImagePropertyPixelWidth] intValue];
+    int height = [properties[(id)kCGImagePropertyPixelHeight] intValue];
+    // Transparency would be lost in a JPEG
+    if ([properties[(id)kCGImagePropertyHasAlpha] boolValue] && settings.imageFormat == JBImageFormatJPEG) {
+        CFRelease(source);
+        return nil;
+    }
+
+    int longest = std::max(width, height);
+    int maxPixelSize = settings.maxImageDimension > 0 ? std::min(longest, settings.maxImageDimension) : longest;
+    // Decodes at (close to) the target size, and bakes the EXIF orientation in
+    NSDictionary *thumbnailOptions = @{
+        (id)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+        (id)kCGImageSourceCreateThumbnailWithTransform: @YES,
+        (id)kCGImageSourceShouldCacheImmediately: @YES,
+        (id)kCGImageSourceThumbnailMaxPixelSize: @(std::max(maxPixelSize, 1)),
+    };
+    CGImageRef image = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)thumbnailOptions);
+    CFRelease(source);
+    if (!image) return nil;
+    NSString *output = [self writeImage:image orientation:kCGImagePropertyOrientationUp settings:settings];
+    CGImageRelease(image);
+    // An already small or well compressed source can come out bigger
+    if (output && fileSize(output) >= fileSize(path)) {
+        @synchronized (self) {
+            [_outputs removeObject:output];
+        }
+        [[NSFileManager defaultManager] removeItemAtPath:output error:nil];
+        return nil;
+    }
+    return output;
+}
+
+- (nullable NSString *)writeImage:(CGImageRef)image
+                      orientation:(CGImagePropertyOrientation)orientation
+                         settings:(const Settings&)settings {
+    if (!image) return nil;
+    NSMutableDictionary *properties = [NSMutableDictionary dictionary];
+    properties[(id)kCGImageDestinationLossyCompressionQuality] = @(settings.imageQuality);
+    if (orientation != kCGImagePropertyOrientationUp) {
+        properties[(id)kCGImagePropertyOrientation] = @(orientation);
+    }
+
+    BOOL heic = settings.imageFormat == JBImageFormatHEIC;
+    NSString *path = outputPath(heic ? @"heic" : @"jpg");
+    CGImageDestinationRef destination = CGImageDestinationCreateWithURL(
+        (__bridge CFURLRef)[NSURL fileURLWithPath:path],
+        (__bridge CFStringRef)(heic ? UTTypeHEIC : UTTypeJPEG).identifier, 1, nullptr);
+    if (!destination && heic) {
+        // No HEVC encoder (some simulators and Macs)
+        path = outputPath(@"jpg");
+        destination = CGImageDestinationCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:path],
+                                                      (__bridge CFStringRef)UTTypeJPEG.identifier, 1, nullptr);
+    }
+    if (!destination) return nil;
+    CGImageDestinationAddImage(destination, image, (__bridge CFDictionaryRef)properties);
+    bool written = CGImageDestinationFinalize(destination);
+    CFRelease(destination);
+    if (!written) {
+        FILE_LOG_W("Media", @"Encoding %@ failed", path.lastPathComponent);
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+        return nil;
+    }
+    @synchronized (self) {
+        [_outputs addObject:path];
+    }
+    return path;
+}
+
+#pragma mark - Videos (on _queue)
+
+- (void)prepareVideo:(NSString *)path
+            settings:(const Settings&)settings
+            progress:(void (^)(double, BOOL))progress
+          completion:(JBPreparedFileCompletion)completion {
+    NSString *preset = exportPreset(settings.videoPreset);
+    if (!preset) {
+        completion(nil);
+        return;
+    }
+    AVURLAsset *asset = [AVURLAsset URLAssetWithURL:[NSURL fileURLWithPath:path] options:nil];
+    AVAssetTrack *track = [asset tracksWithMediaType:AVMediaTypeVideo].firstObject;
+    if (!track) {
+        completion(nil);
+        return;
+    }
+    CGSize size = CGSizeApplyAffineTransform(track.naturalSize, track.preferredTransform);
+    int shortSide = (int)std::min(std::fabs(size.width), std::fabs(size.height));
+    if (shortSide <= presetShortSide(settings.videoPreset)
+        || ![[AVAssetExportSession exportPresetsCompatibleWithAsset:asset] containsObject:preset]) {
+        completion(nil);
+        return;
+    }
+
+    AVAssetExportSession *session = [[AVAssetExportSession alloc] initWithAsset:asset presetName:preset];
+    NSString *output = outputPath(@"mp4");
+    session.outputURL = [NSURL fileURLWithPath:output];
+    session.outputFileType = AVFileTypeMPEG4;
+    session.shouldOptimizeForNetworkUse = YES;
+    session.metadataItemFilter = [AVMetadataItemFilter metadataItemFilterForSharing];
+
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, kVideoProgressInterval),
+                              kVideoProgressInterval, kVideoProgressInterval / 4);
+    __weak AVAssetExportSession *weakSession = session;
+    dispatch_source_set_event_handler(timer, ^{
+        AVAssetExportSession *strongSession = weakSession;
+        if (strongSession) progress(strongSession.progress, NO);
+    });
+    dispatch_resume(timer);
+
+    int64_t sourceSize = fileSize(path);
+    [session exportAsynchronouslyWithCompletionHandler:^{
+        dispatch_source_cancel(timer);
+        dispatch_async(self->_queue, ^{
+            NSFileManager *fm = [NSFileManager defaultManager];
+            if (session.status != AVAssetExportSessionStatusCompleted) {
+                FILE_LOG_W("Media", @"Transcoding %@ failed: %@", path.lastPathComponent,
+                           session.error.localizedDescription);
+                [fm removeItemAtPath:output error:nil];
+                completion(nil);
+                return;
+            }
+            // A low-bitrate source can come out bigger
+            if (fileSize(output) >= sourceSize) {
+                [fm removeItemAtPath:output error:nil];
+                completion(nil);
+                return;
+            }
+            @synchronized (self) {
+                [self->_outputs addObject:output];
+            }
+            completion(output);
+        });
+    }];
+}
+
+@end
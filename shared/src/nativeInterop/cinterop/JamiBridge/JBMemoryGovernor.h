@@ -0,0 +1,35 @@
+//
+//  JBMemoryGovernor.h
+//  GetTogether
+//
+//  Central reaction to memory pressure and background transitions: follows
+//  the conversations recently opened, asks the daemon to drop the loaded
+//  history of the others (libjami::clearCache) and shrinks the bridge caches
+//  and video pools to the tier of the event. Measured footprint savings are
+//  reported by memoryMetricsSnapshot.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBMemoryGovernor : NSObject
+
++ (instancetype)shared;
+
+/// Loading, reading or sending in a conversation: it becomes the hottest.
+/// Any thread; constant time.
+- (void)conversationActive:(const std::string&)accountId conversationId:(const std::string&)conversationId;
+
+/// The conversation or the account is gone: nothing to clear anymore
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId;
+- (void)removeAccount:(const std::string&)accountId;
+
+- (JBMemoryMetrics *)metricsSnapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
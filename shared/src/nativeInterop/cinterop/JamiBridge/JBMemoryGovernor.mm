@@ -0,0 +1,273 @@
+//
+//  JBMemoryGovernor.mm
+//  GetTogether
+//
+//  Two tiers. Background (entering the background, memory pressure warning):
+//  the few hottest conversations keep their history and cached metadata, and
+//  the caches shrink to a working set. Critical (memory warning, critical
+//  pressure): only the hottest conversation keeps its history and every
+//  bridge cache is emptied; they all refill on demand.
+//
+//  Conversations falling off the tracked list have their history cleared
+//  right away, so nothing loaded is left untracked; cold ones stay tracked
+//  until a trim actually cleared them. Reclaimed bytes are the
+//  phys_footprint difference (what jetsam counts) around a trim, after
+//  malloc returned its free pages.
+//
+
+#import "JBMemoryGovernor.h"
+#import "JBBridgeInternal.h"
+#import "JBConversationCache.h"
+#import "JBMessageIndex.h"
+#import "JBNameResolver.h"
+#import "JBReadReceipts.h"
+#import "JBStringInterner.h"
+#import "JBVideoSinkManager.h"
+#import "NativeFileLogger.h"
+
+#if TARGET_OS_IOS
+#import <UIKit/UIKit.h>
+#endif
+
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#include <os/lock.h>
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "conversation_interface.h"
+
+namespace {
+
+// Most recently active conversations followed
+constexpr size_t kMaxTrackedConversations = 32;
+// Conversations keeping their history per tier
+constexpr size_t kBackgroundHotConversations = 3;
+constexpr size_t kCriticalHotConversations = 1;
+// Name lookups kept in the background tier (the critical tier clears them)
+constexpr size_t kBackgroundNameCacheCapacity = 128;
+
+using ConversationKey = std::pair<std::string, std::string>; // account, conversation
+
+struct ConversationKeyHash {
+    size_t operator()(const ConversationKey& key) const {
+        return std::hash<std::string>()(key.first) ^ (std::hash<std::string>()(key.second) << 1);
+    }
+};
+
+int64_t footprintBytes() {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) return 0;
+    return (int64_t)info.phys_footprint;
+}
+
+const char *tierName(JBMemoryTier tier) {
+    return tier == JBMemoryTierCritical ? "critical" : "background";
+}
+
+} // namespace
+
+@implementation JBMemoryGovernor {
+    dispatch_queue_t _queue;
+    dispatch_source_t _pressureSource;
+
+    os_unfair_lock _lock;
+    // Under _lock: most recently active first
+    std::list<ConversationKey> _recent;
+    std::unordered_map<ConversationKey, std::list<ConversationKey>::iterator, ConversationKeyHash> _positions;
+
+    // Only touched on _queue
+    uint64_t _trims;
+    uint64_t _conversationsCleared;
+    int64_t _reclaimedBytes;
+    int64_t _lastReclaimedBytes;
+    JBMemoryTier _lastTier;
+}
+
++ (instancetype)shared {
+    static JBMemoryGovernor *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBMemoryGovernor alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.memory", attr);
+
+        __weak JBMemoryGovernor *weakSelf = self;
+        // Also the only signal on macOS
+        _pressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                 DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                 _queue);
+        dispatch_source_set_event_handler(_pressureSource, ^{
+            JBMemoryGovernor *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            unsigned long pressure = dispatch_source_get_data(strongSelf->_pressureSource);
+            if (pressure & DISPATCH_MEMORYPRESSURE_CRITICAL) {
+                [strongSelf trim:JBMemoryTierCritical];
+            } else if (pressure & DISPATCH_MEMORYPRESSURE_WARN) {
+                [strongSelf trim:JBMemoryTierBackground];
+            }
+        });
+        dispatch_resume(_pressureSource);
+
+#if TARGET_OS_IOS
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        [center addObserverForName:UIApplicationDidReceiveMemoryWarningNotification
+                            object:nil
+                             queue:nil
+                        usingBlock:^(NSNotification *) {
+            JBMemoryGovernor *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            dispatch_async(strongSelf->_queue, ^{ [strongSelf trim:JBMemoryTierCritical]; });
+        }];
+        [center addObserverForName:UIApplicationDidEnterBackgroundNotification
+                            object:nil
+                             queue:nil
+                        usingBlock:^(NSNotification *) {
+            JBMemoryGovernor *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            dispatch_async(strongSelf->_queue, ^{ [strongSelf trim:JBMemoryTierBackground]; });
+        }];
+#endif
+    }
+    return self;
+}
+
+- (void)conversationActive:(const std::string&)accountId conversationId:(const std::string&)conversationId {
+    ConversationKey key {accountId, conversationId};
+    std::vector<ConversationKey> evicted;
+    os_unfair_lock_lock(&_lock);
+    auto it = _positions.find(key);
+    if (it != _positions.end()) {
+        _recent.splice(_recent.begin(), _recent, it->second);
+    } else {
+        _recent.push_front(key);
+        _positions.emplace(std::move(key), _recent.begin());
+        while (_recent.size() > kMaxTrackedConversations) {
+            _positions.erase(_recent.back());
+            evicted.push_back(std::move(_recent.back()));
+            _recent.pop_back();
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (evicted.empty()) return;
+    dispatch_async(_queue, ^{
+        [self clearConversations:evicted dropMetadata:NO];
+    });
+}
+
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId {
+    os_unfair_lock_lock(&_lock);
+    auto it = _positions.find({accountId, conversationId});
+    if (it != _positions.end()) {
+        _recent.erase(it->second);
+        _positions.erase(it);
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)removeAccount:(const std::string&)accountId {
+    os_unfair_lock_lock(&_lock);
+    for (auto it = _recent.begin(); it != _recent.end();) {
+        if (it->first == accountId) {
+            _positions.erase(*it);
+            it = _recent.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (JBMemoryMetrics *)metricsSnapshot {
+    JBMemoryMetrics *metrics = [[JBMemoryMetrics alloc] init];
+    dispatch_sync(_queue, ^{
+        metrics.trims = self->_trims;
+        metrics.conversationsCleared = self->_conversationsCleared;
+        metrics.reclaimedBytes = self->_reclaimedBytes;
+        metrics.lastReclaimedBytes = self->_lastReclaimedBytes;
+        metrics.lastTier = self->_lastTier;
+    });
+    metrics.footprintBytes = footprintBytes();
+    return metrics;
+}
+
+#pragma mark - Trimming (on _queue)
+
+- (void)trim:(JBMemoryTier)tier {
+    int64_t before = footprintBytes();
+    bool critical = tier == JBMemoryTierCritical;
+    size_t hot = critical ? kCriticalHotConversations : kBackgroundHotConversations;
+
+    std::vector<ConversationKey> cold;
+    os_unfair_lock_lock(&_lock);
+    if (_recent.size() > hot) cold.assign(std::next(_recent.begin(), (long)hot), _recent.end());
+    os_unfair_lock_unlock(&_lock);
+    bool cleared = [self clearConversations:cold dropMetadata:YES];
+    if (cleared) {
+        // Still cold: a conversation active again meanwhile stays tracked
+        os_unfair_lock_lock(&_lock);
+        auto it = _recent.begin();
+        for (size_t i = 0; i < hot && it != _recent.end(); i++) ++it;
+        while (it != _recent.end()) {
+            if (std::find(cold.begin(), cold.end(), *it) != cold.end()) {
+                _positions.erase(*it);
+                it = _recent.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        os_unfair_lock_unlock(&_lock);
+    }
+
+    if (critical) {
+        [[JBConversationCache shared] clear];
+        [[JBNameResolver shared] clear];
+        clearInternedIdentifiers();
+        [[JBReadReceipts shared] clearKnownMessages];
+    } else {
+        [[JBNameResolver shared] trimToCapacity:kBackgroundNameCacheCapacity];
+    }
+    [[JBVideoSinkManager shared] trimPools];
+    [[JBMessageIndex shared] releaseMemory];
+    malloc_zone_pressure_relief(nullptr, 0);
+
+    int64_t reclaimed = before - footprintBytes();
+    _trims++;
+    _lastReclaimedBytes = reclaimed;
+    _reclaimedBytes += reclaimed;
+    _lastTier = tier;
+    FILE_LOG_I("Memory", @"Trimmed (%s): %zu conversation(s) cleared, footprint %.1f MB, %+.1f MB",
+               tierName(tier), cleared ? cold.size() : 0, before / (1024.0 * 1024.0), -reclaimed / (1024.0 * 1024.0));
+}
+
+// False when the daemon is still starting or already stopping (nothing cleared)
+- (bool)clearConversations:(const std::vector<ConversationKey>&)conversations dropMetadata:(BOOL)dropMetadata {
+    if (conversations.empty()) return true;
+    // fini waits for the loop: clearCache never runs on a stopped daemon
+    BOOL ready = [[JamiBridgeWrapper shared] performIfLibjamiReady:^{
+        for (const auto& [accountId, conversationId] : conversations) {
+            libjami::clearCache(accountId, conversationId);
+            if (dropMetadata) [[JBConversationCache shared] removeConversation:conversationId accountId:accountId];
+        }
+    }];
+    if (!ready) return false;
+    _conversationsCleared += conversations.size();
+    return true;
+}
+
+@end
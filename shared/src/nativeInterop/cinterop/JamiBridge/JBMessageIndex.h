@@ -0,0 +1,51 @@
+//
+//  JBMessageIndex.h
+//  GetTogether
+//
+//  On-device full-text index (SQLite FTS5) of the text messages seen by the
+//  bridge in SwarmMessageReceived, SwarmMessageUpdated and SwarmLoaded.
+//  Signal handlers only queue the few fields needed; rows are written in
+//  batched transactions on a background queue and each account keeps at most
+//  its kMaxMessagesPerAccount most recent messages.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+#include <vector>
+
+#include "conversation_interface.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBMessageIndex : NSObject
+
++ (instancetype)shared;
+
+/// Opens (or creates) the index in `directory`. Messages queued before are dropped.
+- (void)openInDirectory:(NSString *)directory;
+
+/// Called from the daemon thread; copies what it needs from the messages
+- (void)indexMessages:(const std::vector<libjami::SwarmMessage>&)messages
+            accountId:(const std::string&)accountId
+       conversationId:(const std::string&)conversationId;
+- (void)indexMessage:(const libjami::SwarmMessage&)message
+           accountId:(const std::string&)accountId
+      conversationId:(const std::string&)conversationId;
+
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId;
+- (void)removeAccount:(NSString *)accountId;
+
+/// Drops SQLite's page cache and lookaside memory (memory pressure)
+- (void)releaseMemory;
+
+/// Best matches first. Every word of `query` must match (as a prefix).
+/// Runs after the writes queued so far.
+- (NSArray<JBIndexedMessage *> *)search:(NSString *)query
+                              accountId:(NSString *)accountId
+                                  limit:(NSUInteger)limit;
+
+@end
+
+NS_ASSUME_NONNULL_END
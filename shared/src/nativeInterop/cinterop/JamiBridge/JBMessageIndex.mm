@@ -0,0 +1,372 @@
+//
+//  JBMessageIndex.mm
+//  GetTogether
+//
+//  The index is a plain table keyed by (account, message id) with an external
+//  content FTS5 table kept in sync by triggers, so an edit or deletion is a
+//  single keyed statement. Pending writes are buffered under a lock and
+//  flushed at most kFlushDelay after the first one, or as soon as kMaxBatch
+//  are queued; a search flushes first so it sees every message signalled so far.
+//  A separate database file rather than the shared SQLDelight store: FTS5 is
+//  not available in Android's framework SQLite, so it cannot be in the common schema.
+//
+
+#import "JBMessageIndex.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+#include "JBStringInterner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <os/lock.h>
+#include <sqlite3.h>
+#include <unordered_set>
+
+namespace {
+
+constexpr int64_t kMaxMessagesPerAccount = 50000;
+// Pruned below the cap by this much, so a full account is not pruned on every flush
+constexpr int64_t kPruneSlack = 1000;
+constexpr size_t kMaxBatch = 512;
+constexpr int64_t kFlushDelay = 500 * NSEC_PER_MSEC;
+
+constexpr const char* kSchema = R"sql(
+PRAGMA journal_mode = WAL;
+PRAGMA synchronous = NORMAL;
+CREATE TABLE IF NOT EXISTS message (
+    rowid INTEGER PRIMARY KEY,
+    account_id TEXT NOT NULL,
+    conversation_id TEXT NOT NULL,
+    message_id TEXT NOT NULL,
+    author TEXT NOT NULL,
+    timestamp INTEGER NOT NULL,
+    body TEXT NOT NULL,
+    UNIQUE (account_id, message_id)
+);
+CREATE INDEX IF NOT EXISTS message_account_time_idx ON message(account_id, timestamp);
+CREATE INDEX IF NOT EXISTS message_conversation_idx ON message(account_id, conversation_id);
+CREATE VIRTUAL TABLE IF NOT EXISTS message_fts USING fts5(
+    body, content = 'message', content_rowid = 'rowid',
+    tokenize = 'unicode61 remove_diacritics 2'
+);
+CREATE TRIGGER IF NOT EXISTS message_ai AFTER INSERT ON message BEGIN
+    INSERT INTO message_fts(rowid, body) VALUES (new.rowid, new.body);
+END;
+CREATE TRIGGER IF NOT EXISTS message_ad AFTER DELETE ON message BEGIN
+    INSERT INTO message_fts(message_fts, rowid, body) VALUES ('delete', old.rowid, old.body);
+END;
+CREATE TRIGGER IF NOT EXISTS message_au AFTER UPDATE OF body ON message BEGIN
+    INSERT INTO message_fts(message_fts, rowid, body) VALUES ('delete', old.rowid, old.body);
+    INSERT INTO message_fts(rowid, body) VALUES (new.rowid, new.body);
+END;
+)sql";
+
+struct PendingWrite {
+    enum class Op { Upsert, Delete, DeleteConversation } op;
+    std::string accountId;
+    std::string conversationId;
+    std::string messageId;
+    std::string author;
+    int64_t timestamp = 0;
+    std::string body;
+};
+
+const std::string& bodyField(const libjami::SwarmMessage& message, const char* key) {
+    static const std::string empty;
+    auto it = message.body.find(key);
+    return it != message.body.end() ? it->second : empty;
+}
+
+// Every word must match as a prefix: hello wor -> "hello"* "wor"*
+std::string matchExpression(NSString *query) {
+    std::string expression;
+    NSCharacterSet *separators = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    for (NSString *word in [query componentsSeparatedByCharactersInSet:separators]) {
+        NSString *token = [word stringByReplacingOccurrencesOfString:@"\"" withString:@""];
+        if (token.length == 0) continue;
+        if (!expression.empty()) expression.push_back(' ');
+        expression.append("\"").append(toCppString(token)).append("\"*");
+    }
+    return expression;
+}
+
+} // namespace
+
+@implementation JBMessageIndex {
+    dispatch_queue_t _queue;
+    // Only used on _queue
+    sqlite3 *_db;
+    sqlite3_stmt *_upsert;
+    sqlite3_stmt *_delete;
+    sqlite3_stmt *_deleteConversation;
+    sqlite3_stmt *_count;
+    sqlite3_stmt *_prune;
+    sqlite3_stmt *_search;
+
+    os_unfair_lock _pendingLock;
+    std::vector<PendingWrite> _pending;
+    bool _flushScheduled;
+}
+
++ (instancetype)shared {
+    static JBMessageIndex *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBMessageIndex alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.messageindex", attr);
+        _pendingLock = OS_UNFAIR_LOCK_INIT;
+        _flushScheduled = false;
+    }
+    return self;
+}
+
+#pragma mark - Database (on _queue)
+
+- (sqlite3_stmt *)prepare:(const char *)sql {
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v3(_db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        FILE_LOG_E("MessageIndex", @"Prepare failed: %s", sqlite3_errmsg(_db));
+    }
+    return stmt;
+}
+
+- (void)close {
+    for (sqlite3_stmt *stmt : {_upsert, _delete, _deleteConversation, _count, _prune, _search}) {
+        sqlite3_finalize(stmt);
+    }
+    _upsert = _delete = _deleteConversation = _count = _prune = _search = nullptr;
+    if (_db) sqlite3_close_v2(_db);
+    _db = nullptr;
+}
+
+- (void)openInDirectory:(NSString *)directory {
+    std::string path = toCppString([directory stringByAppendingPathComponent:@"message_index.db"]);
+    dispatch_async(_queue, ^{
+        [self close];
+        os_unfair_lock_lock(&self->_pendingLock);
+        self->_pending.clear();
+        os_unfair_lock_unlock(&self->_pendingLock);
+
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+        if (sqlite3_open_v2(path.c_str(), &self->_db, flags, nullptr) != SQLITE_OK
+            || sqlite3_exec(self->_db, kSchema, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            FILE_LOG_E("MessageIndex", @"Cannot open %s: %s", path.c_str(), sqlite3_errmsg(self->_db));
+            [self close];
+            return;
+        }
+        self->_upsert = [self prepare:
+            "INSERT INTO message (account_id, conversation_id, message_id, author, timestamp, body) "
+            "VALUES (?1, ?2, ?3, ?4, ?5, ?6) "
+            "ON CONFLICT (account_id, message_id) DO UPDATE SET body = excluded.body "
+            "WHERE body != excluded.body"];
+        self->_delete = [self prepare:"DELETE FROM message WHERE account_id = ?1 AND message_id = ?2"];
+        self->_deleteConversation = [self prepare:
+            "DELETE FROM message WHERE account_id = ?1 AND conversation_id = ?2"];
+        self->_count = [self prepare:"SELECT count(*) FROM message WHERE account_id = ?1"];
+        self->_prune = [self prepare:
+            "DELETE FROM message WHERE rowid IN "
+            "(SELECT rowid FROM message WHERE account_id = ?1 ORDER BY timestamp ASC LIMIT ?2)"];
+        self->_search = [self prepare:
+            "SELECT m.conversation_id, m.message_id, m.author, m.timestamp, m.body "
+            "FROM message_fts JOIN message m ON m.rowid = message_fts.rowid "
+            "WHERE message_fts MATCH ?1 AND m.account_id = ?2 "
+            "ORDER BY bm25(message_fts) LIMIT ?3"];
+        FILE_LOG_I("MessageIndex", @"Opened %s", path.c_str());
+    });
+}
+
+static void bindText(sqlite3_stmt *stmt, int index, const std::string& value) {
+    sqlite3_bind_text(stmt, index, value.data(), (int)value.size(), SQLITE_STATIC);
+}
+
+static bool step(sqlite3_stmt *stmt) {
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE || rc == SQLITE_ROW;
+}
+
+- (void)write:(const PendingWrite&)write {
+    switch (write.op) {
+        case PendingWrite::Op::Upsert:
+            bindText(_upsert, 1, write.accountId);
+            bindText(_upsert, 2, write.conversationId);
+            bindText(_upsert, 3, write.messageId);
+            bindText(_upsert, 4, write.author);
+            sqlite3_bind_int64(_upsert, 5, write.timestamp);
+            bindText(_upsert, 6, write.body);
+            step(_upsert);
+            break;
+        case PendingWrite::Op::Delete:
+            bindText(_delete, 1, write.accountId);
+            bindText(_delete, 2, write.messageId);
+            step(_delete);
+            break;
+        case PendingWrite::Op::DeleteConversation:
+            bindText(_deleteConversation, 1, write.accountId);
+            bindText(_deleteConversation, 2, write.conversationId);
+            step(_deleteConversation);
+            break;
+    }
+}
+
+- (void)pruneAccount:(const std::string&)accountId {
+    bindText(_count, 1, accountId);
+    int64_t count = sqlite3_step(_count) == SQLITE_ROW ? sqlite3_column_int64(_count, 0) : 0;
+    sqlite3_reset(_count);
+    sqlite3_clear_bindings(_count);
+    if (count <= kMaxMessagesPerAccount) return;
+
+    bindText(_prune, 1, accountId);
+    sqlite3_bind_int64(_prune, 2, count - kMaxMessagesPerAccount + kPruneSlack);
+    step(_prune);
+}
+
+- (void)flush {
+    std::vector<PendingWrite> writes;
+    os_unfair_lock_lock(&_pendingLock);
+    writes.swap(_pending);
+    _flushScheduled = false;
+    os_unfair_lock_unlock(&_pendingLock);
+    if (writes.empty() || !_db) return;
+
+    std::unordered_set<std::string> grown;
+    sqlite3_exec(_db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+    for (const auto& write : writes) {
+        [self write:write];
+        if (write.op == PendingWrite::Op::Upsert) grown.insert(write.accountId);
+    }
+    for (const auto& accountId : grown) {
+        [self pruneAccount:accountId];
+    }
+    if (sqlite3_exec(_db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        FILE_LOG_E("MessageIndex", @"Commit failed: %s", sqlite3_errmsg(_db));
+        sqlite3_exec(_db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+}
+
+#pragma mark - Writes
+
+- (void)enqueue:(std::vector<PendingWrite>&&)writes {
+    if (writes.empty()) return;
+    bool schedule = false;
+    bool flushNow = false;
+    os_unfair_lock_lock(&_pendingLock);
+    std::move(writes.begin(), writes.end(), std::back_inserter(_pending));
+    if (_pending.size() >= kMaxBatch) {
+        flushNow = true;
+    } else if (!_flushScheduled) {
+        _flushScheduled = schedule = true;
+    }
+    os_unfair_lock_unlock(&_pendingLock);
+
+    if (flushNow) {
+        dispatch_async(_queue, ^{ [self flush]; });
+    } else if (schedule) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kFlushDelay), _queue, ^{ [self flush]; });
+    }
+}
+
+static void appendWrite(std::vector<PendingWrite>& writes, const libjami::SwarmMessage& message,
+                        const std::string& accountId, const std::string& conversationId) {
+    if (message.type != "text/plain") return;
+    const std::string& body = bodyField(message, "body");
+    PendingWrite write {
+        body.empty() ? PendingWrite::Op::Delete : PendingWrite::Op::Upsert,
+        accountId, conversationId, message.id,
+    };
+    if (write.op == PendingWrite::Op::Upsert) {
+        write.author = bodyField(message, "author");
+        write.timestamp = std::strtoll(bodyField(message, "timestamp").c_str(), nullptr, 10);
+        write.body = body;
+    }
+    writes.push_back(std::move(write));
+}
+
+- (void)indexMessages:(const std::vector<libjami::SwarmMessage>&)messages
+            accountId:(const std::string&)accountId
+       conversationId:(const std::string&)conversationId {
+    std::vector<PendingWrite> writes;
+    writes.reserve(messages.size());
+    for (const auto& message : messages) {
+        appendWrite(writes, message, accountId, conversationId);
+    }
+    [self enqueue:std::move(writes)];
+}
+
+- (void)indexMessage:(const libjami::SwarmMessage&)message
+           accountId:(const std::string&)accountId
+      conversationId:(const std::string&)conversationId {
+    std::vector<PendingWrite> writes;
+    appendWrite(writes, message, accountId, conversationId);
+    [self enqueue:std::move(writes)];
+}
+
+- (void)removeConversation:(const std::string&)conversationId accountId:(const std::string&)accountId {
+    std::vector<PendingWrite> writes;
+    writes.push_back({PendingWrite::Op::DeleteConversation, accountId, conversationId});
+    [self enqueue:std::move(writes)];
+}
+
+- (void)removeAccount:(NSString *)accountId {
+    std::string accountIdStr = toCppString(accountId);
+    dispatch_async(_queue, ^{
+        [self flush];
+        if (!self->_db) return;
+        sqlite3_stmt *stmt = [self prepare:"DELETE FROM message WHERE account_id = ?1"];
+        bindText(stmt, 1, accountIdStr);
+        step(stmt);
+        sqlite3_finalize(stmt);
+    });
+}
+
+- (void)releaseMemory {
+    dispatch_async(_queue, ^{
+        if (self->_db) sqlite3_db_release_memory(self->_db);
+    });
+}
+
+#pragma mark - Search
+
+- (NSArray<JBIndexedMessage *> *)search:(NSString *)query
+                              accountId:(NSString *)accountId
+                                  limit:(NSUInteger)limit {
+    std::string expression = matchExpression(query);
+    if (expression.empty()) return @[];
+    std::string accountIdStr = toCppString(accountId);
+
+    NSMutableArray<JBIndexedMessage *> *results = [NSMutableArray array];
+    dispatch_sync(_queue, ^{
+        [self flush];
+        if (!self->_search) return;
+        sqlite3_stmt *stmt = self->_search;
+        bindText(stmt, 1, expression);
+        bindText(stmt, 2, accountIdStr);
+        sqlite3_bind_int64(stmt, 3, (sqlite3_int64)limit);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            JBIndexedMessage *message = [[JBIndexedMessage alloc] init];
+            message.accountId = accountId;
+            message.conversationId = toNSIdentifier((const char *)sqlite3_column_text(stmt, 0));
+            message.messageId = toNSString((const char *)sqlite3_column_text(stmt, 1));
+            message.author = toNSIdentifier((const char *)sqlite3_column_text(stmt, 2));
+            message.timestamp = sqlite3_column_int64(stmt, 3);
+            message.body = toNSString((const char *)sqlite3_column_text(stmt, 4));
+            [results addObject:message];
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    });
+    return results;
+}
+
+@end
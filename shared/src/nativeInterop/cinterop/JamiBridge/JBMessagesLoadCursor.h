@@ -0,0 +1,32 @@
+//
+//  JBMessagesLoadCursor.h
+//  GetTogether
+//
+//  Owns the remaining messages of a SwarmLoaded result and hands them out
+//  chunk by chunk, so conversion happens incrementally on the signal queue.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <vector>
+
+#include "conversation_interface.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBMessagesLoadCursor ()
+
+- (instancetype)initWithRequestId:(int)requestId
+                        accountId:(NSString *)accountId
+                   conversationId:(NSString *)conversationId
+                         messages:(std::vector<libjami::SwarmMessage>&&)messages
+                        chunkSize:(NSUInteger)chunkSize;
+
+/// Converts and returns the next chunk and moves the cursor to it.
+/// nil once the last chunk was returned or the cursor was cancelled.
+- (nullable NSArray<JBSwarmMessage *> *)nextChunk;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,63 @@
+//
+//  JBMessagesLoadCursor.mm
+//  GetTogether
+//
+
+#import "JBMessagesLoadCursor.h"
+#import "JBLazySwarmMessage.h"
+#include "JBConversions.h"
+
+#include <algorithm>
+#include <atomic>
+
+@implementation JBMessagesLoadCursor {
+    std::vector<libjami::SwarmMessage> _messages;
+    NSUInteger _chunkSize;
+    NSUInteger _next;
+    BOOL _started;
+    std::atomic<bool> _cancelled;
+}
+
+- (instancetype)initWithRequestId:(int)requestId
+                        accountId:(NSString *)accountId
+                   conversationId:(NSString *)conversationId
+                         messages:(std::vector<libjami::SwarmMessage>&&)messages
+                        chunkSize:(NSUInteger)chunkSize {
+    if (self = [super init]) {
+        _requestId = requestId;
+        _accountId = [accountId copy];
+        _conversationId = [conversationId copy];
+        _messages = std::move(messages);
+        _total = _messages.size();
+        _chunkSize = chunkSize > 0 ? chunkSize : std::max<NSUInteger>(_total, 1);
+        _cancelled = false;
+    }
+    return self;
+}
+
+- (BOOL)isCancelled {
+    return _cancelled.load();
+}
+
+- (void)cancel {
+    _cancelled = true;
+}
+
+- (NSArray<JBSwarmMessage *> *)nextChunk {
+    if (_cancelled || (_started && _next >= _total)) {
+        std::vector<libjami::SwarmMessage>().swap(_messages);
+        return nil;
+    }
+    _started = YES;
+    _offset = _next;
+    NSUInteger end = std::min(_total, _next + _chunkSize);
+    NSMutableArray<JBSwarmMessage *> *chunk = [NSMutableArray arrayWithCapacity:end - _next];
+    for (NSUInteger i = _next; i < end; i++) {
+        [chunk addObject:[[JBLazySwarmMessage alloc] initWithSwarmMessage:std::move(_messages[i])]];
+    }
+    _next = end;
+    _isLast = _next >= _total;
+    return chunk;
+}
+
+@end
@@ -0,0 +1,51 @@
+//
+//  JBNameResolver.h
+//  GetTogether
+//
+//  Cached, deduplicating front-end for libjami::lookupName/lookupAddress.
+//  Results (found and not found) are kept in an LRU with per-state TTLs;
+//  callers that ask for a lookup already in flight wait on the same request.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBNameResolver : NSObject
+
++ (instancetype)shared;
+
+/// Fresh cached result, or nil
+- (nullable JBLookupResult *)cachedResultForName:(NSString *)name accountId:(NSString *)accountId;
+- (nullable JBLookupResult *)cachedResultForAddress:(NSString *)address accountId:(NSString *)accountId;
+
+/// Completion runs on the configuration signal queue, from the cache, once the
+/// name server answered, or with an error result when the request could not be
+/// sent or got no answer in time. A nil completion only makes sure a request is
+/// in flight. NO when the request could not be sent.
+- (BOOL)resolveName:(NSString *)name
+          accountId:(NSString *)accountId
+         completion:(nullable JBLookupCompletion)completion;
+- (BOOL)resolveAddress:(NSString *)address
+             accountId:(NSString *)accountId
+            completion:(nullable JBLookupCompletion)completion;
+
+/// Called from the RegisteredNameFound handler (daemon thread). Caches the result
+/// and returns it, completing every lookup waiting on `query`.
+- (JBLookupResult *)handleResult:(const std::string&)accountId
+                           query:(const std::string&)query
+                           state:(JBLookupState)state
+                         address:(const std::string&)address
+                            name:(const std::string&)name;
+
+- (void)clear;
+
+/// Keeps at most the `capacity` most recently used results
+- (void)trimToCapacity:(size_t)capacity;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,282 @@
+//
+//  JBNameResolver.mm
+//  GetTogether
+//
+//  RegisteredNameFound only carries the query string, not whether a name or an
+//  address was looked up, so a result completes the waiters of both kinds for
+//  that query. Found results are cached in both directions (name -> address and
+//  address -> name): opening a conversation after a search costs no request.
+//  A request the name server never answers fails its waiters after a timeout,
+//  and the next caller sends a new one.
+//
+
+#import "JBNameResolver.h"
+#import "JBSignalDispatcher.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "configurationmanager_interface.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kCacheCapacity = 1024;
+// Registered names never change owner, not-found names may be registered any time
+constexpr auto kFoundTtl = std::chrono::hours(1);
+constexpr auto kNotFoundTtl = std::chrono::minutes(5);
+// A lookup without answer by then fails its waiters
+constexpr auto kRequestTimeout = std::chrono::seconds(30);
+
+enum class LookupKind : char { Name = 'n', Address = 'a' };
+
+struct CachedLookup {
+    JBLookupState state;
+    std::string address;
+    std::string name;
+    std::string query;
+    Clock::time_point expires;
+};
+
+// Most recently used first
+using LookupList = std::list<std::pair<std::string, CachedLookup>>;
+
+struct PendingLookup {
+    std::vector<JBLookupCompletion> waiters;
+    uint64_t request;
+};
+
+// Names are case-insensitive on the name server
+std::string lookupKey(const std::string& accountId, LookupKind kind, std::string query) {
+    if (kind == LookupKind::Name) {
+        for (auto& c : query) c = (char)std::tolower((unsigned char)c);
+    }
+    std::string key;
+    key.reserve(accountId.size() + query.size() + 2);
+    key.append(accountId).push_back('\n');
+    key.push_back(static_cast<char>(kind));
+    key.append(query);
+    return key;
+}
+
+JBLookupResult *toLookupResult(JBLookupState state, const std::string& address,
+                               const std::string& name, const std::string& query) {
+    JBLookupResult *result = [[JBLookupResult alloc] init];
+    result.state = state;
+    result.address = toNSString(address);
+    result.name = toNSString(name);
+    result.query = toNSString(query);
+    return result;
+}
+
+} // namespace
+
+@implementation JBNameResolver {
+    std::mutex _mutex;
+    LookupList _lru;
+    std::unordered_map<std::string, LookupList::iterator> _cache;
+    std::unordered_map<std::string, PendingLookup> _pending;
+    uint64_t _lastRequest;
+}
+
++ (instancetype)shared {
+    static JBNameResolver *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBNameResolver alloc] init];
+    });
+    return instance;
+}
+
+#pragma mark - Cache (callers hold _mutex)
+
+- (std::optional<CachedLookup>)lookupCached:(const std::string&)key {
+    auto it = _cache.find(key);
+    if (it == _cache.end()) return std::nullopt;
+    if (it->second->second.expires <= Clock::now()) {
+        _lru.erase(it->second);
+        _cache.erase(it);
+        return std::nullopt;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return it->second->second;
+}
+
+- (void)storeCached:(std::string)key entry:(CachedLookup)entry {
+    auto it = _cache.find(key);
+    if (it != _cache.end()) {
+        it->second->second = std::move(entry);
+        _lru.splice(_lru.begin(), _lru, it->second);
+        return;
+    }
+    _lru.emplace_front(key, std::move(entry));
+    _cache.emplace(std::move(key), _lru.begin());
+    if (_lru.size() > kCacheCapacity) {
+        _cache.erase(_lru.back().first);
+        _lru.pop_back();
+    }
+}
+
+#pragma mark - Lookups
+
+- (nullable JBLookupResult *)cachedResult:(NSString *)query kind:(LookupKind)kind accountId:(NSString *)accountId {
+    std::optional<CachedLookup> cached;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cached = [self lookupCached:lookupKey(toCppString(accountId), kind, toCppString(query))];
+    }
+    if (!cached) return nil;
+    return toLookupResult(cached->state, cached->address, cached->name, toCppString(query));
+}
+
+- (nullable JBLookupResult *)cachedResultForName:(NSString *)name accountId:(NSString *)accountId {
+    return [self cachedResult:name kind:LookupKind::Name accountId:accountId];
+}
+
+- (nullable JBLookupResult *)cachedResultForAddress:(NSString *)address accountId:(NSString *)accountId {
+    return [self cachedResult:address kind:LookupKind::Address accountId:accountId];
+}
+
+- (BOOL)resolve:(NSString *)query
+           kind:(LookupKind)kind
+      accountId:(NSString *)accountId
+     completion:(nullable JBLookupCompletion)completion {
+    std::string accountIdStr = toCppString(accountId);
+    std::string queryStr = toCppString(query);
+    std::string key = lookupKey(accountIdStr, kind, queryStr);
+
+    std::optional<CachedLookup> cached;
+    uint64_t request = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cached = [self lookupCached:key];
+        if (!cached) {
+            auto [it, inserted] = _pending.try_emplace(key);
+            if (completion) it->second.waiters.push_back(completion);
+            if (inserted) request = it->second.request = ++_lastRequest;
+        }
+    }
+
+    if (cached) {
+        if (completion) {
+            JBLookupResult *result = toLookupResult(cached->state, cached->address, cached->name, queryStr);
+            // In the account's lane, behind the lookups of that account still queued
+            [[JBSignalDispatcher shared] dispatch:^{
+                completion(result);
+            } domain:JBSignalDomainConfiguration accountId:accountIdStr];
+        }
+        return YES;
+    }
+    // Already in flight
+    if (!request) return YES;
+
+    bool sent = kind == LookupKind::Name
+        ? libjami::lookupName(accountIdStr, "", queryStr)
+        : libjami::lookupAddress(accountIdStr, "", queryStr);
+    if (!sent) {
+        [self failRequest:request key:key accountId:accountIdStr query:queryStr];
+        return NO;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, std::chrono::nanoseconds(kRequestTimeout).count()),
+                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [self failRequest:request key:key accountId:accountIdStr query:queryStr];
+    });
+    return YES;
+}
+
+// Completes the waiters of `request` with an error, unless it was answered meanwhile
+- (void)failRequest:(uint64_t)request
+                key:(const std::string&)key
+          accountId:(const std::string&)accountId
+              query:(const std::string&)query {
+    std::vector<JBLookupCompletion> waiters;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _pending.find(key);
+        if (it == _pending.end() || it->second.request != request) return;
+        waiters = std::move(it->second.waiters);
+        _pending.erase(it);
+    }
+    FILE_LOG_W("NameResolver", @"Lookup of %s got no answer", query.c_str());
+    if (waiters.empty()) return;
+    JBLookupResult *result = toLookupResult(JBLookupStateError, "", "", query);
+    [[JBSignalDispatcher shared] dispatch:^{
+        for (const auto& waiter : waiters) waiter(result);
+    } domain:JBSignalDomainConfiguration accountId:accountId];
+}
+
+- (BOOL)resolveName:(NSString *)name
+          accountId:(NSString *)accountId
+         completion:(nullable JBLookupCompletion)completion {
+    return [self resolve:name kind:LookupKind::Name accountId:accountId completion:completion];
+}
+
+- (BOOL)resolveAddress:(NSString *)address
+             accountId:(NSString *)accountId
+            completion:(nullable JBLookupCompletion)completion {
+    return [self resolve:address kind:LookupKind::Address accountId:accountId completion:completion];
+}
+
+- (JBLookupResult *)handleResult:(const std::string&)accountId
+                           query:(const std::string&)query
+                           state:(JBLookupState)state
+                         address:(const std::string&)address
+                            name:(const std::string&)name {
+    std::vector<JBLookupCompletion> waiters;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto kind : {LookupKind::Name, LookupKind::Address}) {
+            auto it = _pending.find(lookupKey(accountId, kind, query));
+            if (it == _pending.end()) continue;
+            std::move(it->second.waiters.begin(), it->second.waiters.end(), std::back_inserter(waiters));
+            _pending.erase(it);
+        }
+
+        auto now = Clock::now();
+        if (state == JBLookupStateSuccess) {
+            CachedLookup entry {state, address, name, query, now + kFoundTtl};
+            [self storeCached:lookupKey(accountId, LookupKind::Name, name) entry:entry];
+            [self storeCached:lookupKey(accountId, LookupKind::Address, address) entry:std::move(entry)];
+        } else if (state != JBLookupStateError) {
+            // Address lookups echo the address, name lookups leave it empty
+            LookupKind kind = (!address.empty() && address == query) ? LookupKind::Address : LookupKind::Name;
+            [self storeCached:lookupKey(accountId, kind, query)
+                        entry:CachedLookup {state, address, name, query, now + kNotFoundTtl}];
+        }
+    }
+
+    JBLookupResult *result = toLookupResult(state, address, name, query);
+    if (!waiters.empty()) {
+        [[JBSignalDispatcher shared] dispatch:^{
+            for (const auto& waiter : waiters) waiter(result);
+        } domain:JBSignalDomainConfiguration accountId:accountId];
+    }
+    return result;
+}
+
+- (void)clear {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lru.clear();
+    _cache.clear();
+    FILE_LOG_I("NameResolver", @"Lookup cache cleared");
+}
+
+- (void)trimToCapacity:(size_t)capacity {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (_lru.size() > capacity) {
+        _cache.erase(_lru.back().first);
+        _lru.pop_back();
+    }
+}
+
+@end
@@ -0,0 +1,41 @@
+//
+//  JBProfileThumbnailCache.h
+//  GetTogether
+//
+//  Turns ProfileReceived payloads into a display name and a downscaled avatar
+//  file. Cards are parsed and photos decoded one at a time on a background
+//  queue, so a profile flood (account import) never holds more than one
+//  decoded photo. Thumbnails are JPEG, at most 512 px, written where the
+//  shared VCardService looks for its peer avatar cache:
+//  {Caches}/{accountId}/profiles/{base64url(peerUri)}.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// `vcardPath` is empty when the daemon passed the card inline, `avatarPath`
+/// nil when the card has no inline photo.
+typedef void (^JBProfileCompletion)(NSString *vcardPath, NSString *displayName, NSString *_Nullable avatarPath);
+
+@interface JBProfileThumbnailCache : NSObject
+
++ (instancetype)shared;
+
+/// `vcard` is the path of the vcf written by the daemon, or the card itself.
+/// A newer profile for the same peer supersedes a queued one, whose completion
+/// is then never called. The completion runs on the cache's private queue.
+- (void)processProfile:(const std::string&)vcard
+             accountId:(const std::string&)accountId
+                  from:(const std::string&)from
+            completion:(JBProfileCompletion)completion;
+
+/// Removes every thumbnail of an account
+- (void)removeAccount:(NSString *)accountId;
+
+@end
+
+NS_ASSUME_NONNULL_END
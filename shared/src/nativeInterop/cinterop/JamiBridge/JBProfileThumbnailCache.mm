@@ -0,0 +1,218 @@
+//
+//  JBProfileThumbnailCache.mm
+//  GetTogether
+//
+//  A vcf on disk is mapped rather than read, and its thumbnail is reused while
+//  it is at least as new as the vcf (the VCardService fast-path rule). Decoded
+//  photos go straight to ImageIO, which downsamples while decoding instead of
+//  materialising the full-size bitmap.
+//
+
+#import "JBProfileThumbnailCache.h"
+#import "JBVCardParser.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#import <ImageIO/ImageIO.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+constexpr int kThumbnailMaxPixelSize = 512;
+constexpr double kThumbnailQuality = 0.88;
+
+// Peer URIs may come with a scheme ("ring:", "jami:") or a host; the cache is keyed by the bare id
+std::string rawPeerId(std::string from) {
+    size_t colon = from.find(':');
+    if (colon != std::string::npos) from.erase(0, colon + 1);
+    size_t at = from.find('@');
+    if (at != std::string::npos) from.erase(at);
+    return from;
+}
+
+// Same file name as VCardService (Kotlin Base64.UrlSafe, padded)
+NSString *encodedPeerFileName(const std::string& peerId) {
+    NSData *data = [NSData dataWithBytes:peerId.data() length:peerId.size()];
+    NSString *encoded = [data base64EncodedStringWithOptions:0];
+    encoded = [encoded stringByReplacingOccurrencesOfString:@"+" withString:@"-"];
+    return [encoded stringByReplacingOccurrencesOfString:@"/" withString:@"_"];
+}
+
+bool modificationTime(NSString *path, struct timespec& time) {
+    struct stat st;
+    if (stat(path.fileSystemRepresentation, &st) != 0) return false;
+    time = st.st_mtimespec;
+    return true;
+}
+
+bool isNotOlder(const struct timespec& a, const struct timespec& b) {
+    return a.tv_sec > b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec >= b.tv_nsec);
+}
+
+// Decodes and downsamples `photo` into a JPEG at `path` (via a temporary file)
+bool writeThumbnail(NSData *photo, NSString *path) {
+    NSDictionary *sourceOptions = @{ (__bridge NSString *)kCGImageSourceShouldCache: @NO };
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)photo,
+                                                          (__bridge CFDictionaryRef)sourceOptions);
+    if (!source) return false;
+    NSDictionary *thumbnailOptions = @{
+        (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+        (__bridge NSString *)kCGImageSourceCreateThumbnailWithTransform: @YES,
+        (__bridge NSString *)kCGImageSourceShouldCacheImmediately: @YES,
+        (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize: @(kThumbnailMaxPixelSize),
+    };
+    CGImageRef thumbnail = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)thumbnailOptions);
+    CFRelease(source);
+    if (!thumbnail) return false;
+
+    NSString *tmpPath = [path stringByAppendingString:@".tmp"];
+    NSURL *tmpURL = [NSURL fileURLWithPath:tmpPath];
+    bool written = false;
+    CGImageDestinationRef destination = CGImageDestinationCreateWithURL((__bridge CFURLRef)tmpURL,
+                                                                        CFSTR("public.jpeg"), 1, NULL);
+    if (destination) {
+        NSDictionary *properties = @{
+            (__bridge NSString *)kCGImageDestinationLossyCompressionQuality: @(kThumbnailQuality),
+        };
+        CGImageDestinationAddImage(destination, thumbnail, (__bridge CFDictionaryRef)properties);
+        written = CGImageDestinationFinalize(destination);
+        CFRelease(destination);
+    }
+    CGImageRelease(thumbnail);
+
+    if (written && rename(tmpPath.fileSystemRepresentation, path.fileSystemRepresentation) == 0) {
+        return true;
+    }
+    unlink(tmpPath.fileSystemRepresentation);
+    return false;
+}
+
+} // namespace
+
+@implementation JBProfileThumbnailCache {
+    dispatch_queue_t _queue;
+    NSString *_cacheRoot;
+    std::mutex _mutex;
+    // "account\npeer" -> sequence of the latest queued profile
+    std::unordered_map<std::string, uint64_t> _latest;
+    uint64_t _sequence;
+}
+
++ (instancetype)shared {
+    static JBProfileThumbnailCache *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBProfileThumbnailCache alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.profiles", attr);
+        _cacheRoot = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    }
+    return self;
+}
+
+- (void)processProfile:(const std::string&)vcard
+             accountId:(const std::string&)accountId
+                  from:(const std::string&)from
+            completion:(JBProfileCompletion)completion {
+    // Blocks capture reference parameters by reference: copy them first.
+    // The payload is copied once into shared storage; a parsed photo is a view into it.
+    auto vcardCopy = std::make_shared<const std::string>(vcard);
+    std::string accountIdCopy = accountId;
+    std::string peerId = rawPeerId(from);
+    std::string key = accountId + "\n" + peerId;
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        sequence = ++_sequence;
+        _latest[key] = sequence;
+    }
+
+    dispatch_async(_queue, ^{
+        {
+            std::lock_guard<std::mutex> lock(self->_mutex);
+            auto it = self->_latest.find(key);
+            if (it == self->_latest.end() || it->second != sequence) return;
+            self->_latest.erase(it);
+        }
+        @autoreleasepool {
+            [self process:*vcardCopy accountId:accountIdCopy peerId:peerId completion:completion];
+        }
+    });
+}
+
+- (void)process:(const std::string&)vcard
+      accountId:(const std::string&)accountId
+         peerId:(const std::string&)peerId
+     completion:(JBProfileCompletion)completion {
+    // A path never spans lines, a card always does
+    bool inlineCard = vcard.find('\n') != std::string::npos;
+    NSString *vcardPath = inlineCard ? @"" : toNSString(vcard);
+    NSData *mapped = nil;
+    std::string_view content;
+    if (inlineCard) {
+        content = vcard;
+    } else {
+        NSError *error = nil;
+        mapped = [NSData dataWithContentsOfFile:vcardPath options:NSDataReadingMappedIfSafe error:&error];
+        if (!mapped) {
+            FILE_LOG_W("Profiles", @"Cannot read vcard %@: %@", vcardPath, error.localizedDescription);
+            completion(vcardPath, @"", nil);
+            return;
+        }
+        content = std::string_view((const char *)mapped.bytes, mapped.length);
+    }
+
+    JBVCardFields fields;
+    if (!parseVCard(content, fields)) {
+        FILE_LOG_W("Profiles", @"No vcard in profile from %s", peerId.c_str());
+    }
+    NSString *displayName = toNSString(fields.formattedName) ?: @"";
+
+    NSString *directory = [NSString stringWithFormat:@"%@/%s/profiles", _cacheRoot, accountId.c_str()];
+    NSString *thumbnailPath = [directory stringByAppendingPathComponent:encodedPeerFileName(peerId)];
+    if (fields.photoBase64.empty()) {
+        unlink(thumbnailPath.fileSystemRepresentation);
+        completion(vcardPath, displayName, nil);
+        return;
+    }
+
+    struct timespec vcardTime, thumbnailTime;
+    if (!inlineCard && modificationTime(vcardPath, vcardTime) &&
+        modificationTime(thumbnailPath, thumbnailTime) && isNotOlder(thumbnailTime, vcardTime)) {
+        completion(vcardPath, displayName, thumbnailPath);
+        return;
+    }
+
+    NSData *photo = decodeBase64(fields.photoBase64);
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    if (!photo.length || !writeThumbnail(photo, thumbnailPath)) {
+        FILE_LOG_W("Profiles", @"Cannot decode avatar of %s (%lu bytes)", peerId.c_str(), (unsigned long)fields.photoBase64.size());
+        unlink(thumbnailPath.fileSystemRepresentation);
+        completion(vcardPath, displayName, nil);
+        return;
+    }
+    completion(vcardPath, displayName, thumbnailPath);
+}
+
+- (void)removeAccount:(NSString *)accountId {
+    NSString *directory = [NSString stringWithFormat:@"%@/%@/profiles", _cacheRoot, accountId];
+    dispatch_async(_queue, ^{
+        [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+    });
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  JBReadReceipts.h
+//  GetTogether
+//
+//  Coalesced setMessageDisplayed: only the newest message displayed in each
+//  conversation reaches libjami (one swarm commit and peer sync), once the
+//  calls go quiet or the app moves to the background. Built on
+//  jbcore::ReceiptScheduler.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+#include <vector>
+
+#include "conversation_interface.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBReadReceipts : NSObject
+
++ (instancetype)shared;
+
+/// Message signal handlers (daemon thread): timestamps that order the
+/// receipts, so scrolling back through history does not move them back
+- (void)noteMessages:(const std::vector<libjami::SwarmMessage>&)messages;
+- (void)noteMessage:(const libjami::SwarmMessage&)message;
+
+/// setMessageDisplayed:, any thread. Schedules a flush.
+- (void)markDisplayed:(const std::string&)accountId
+       conversationId:(const std::string&)conversationId
+            messageId:(const std::string&)messageId;
+
+/// Receipt not flushed yet, empty if none
+- (std::string)pendingMessage:(const std::string&)accountId
+               conversationId:(const std::string&)conversationId;
+
+/// Sends the pending receipts now (background, stopDaemon)
+- (void)flush;
+
+- (void)removeAccount:(const std::string&)accountId;
+
+/// Memory pressure: forgets the message timestamps (pending receipts are kept)
+- (void)clearKnownMessages;
+
+@end
+
+NS_ASSUME_NONNULL_END
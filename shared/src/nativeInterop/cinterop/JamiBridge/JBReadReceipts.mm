@@ -0,0 +1,110 @@
+//
+//  JBReadReceipts.mm
+//  GetTogether
+//
+//  jbcore::ReceiptScheduler (the ordering and idle/cap timing of receipts,
+//  shared with the JNI library) run on a utility queue, plus the flush when
+//  the app moves to the background.
+//
+
+#import "JBReadReceipts.h"
+#import "NativeFileLogger.h"
+
+#if TARGET_OS_IOS
+#import <UIKit/UIKit.h>
+#endif
+
+#include "jbcore/ReceiptScheduler.h"
+
+#include <memory>
+
+#include "jami.h"
+
+namespace {
+
+// libjami's status for a displayed message
+constexpr int kDisplayedStatus = 3;
+
+} // namespace
+
+@implementation JBReadReceipts {
+    std::shared_ptr<jbcore::ReceiptScheduler> _scheduler;
+    dispatch_queue_t _queue;
+}
+
++ (instancetype)shared {
+    static JBReadReceipts *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBReadReceipts alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.receipts", attr);
+        dispatch_queue_t queue = _queue;
+        _scheduler = jbcore::ReceiptScheduler::create(
+            [queue](int64_t delayNs, std::function<void()> task) {
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delayNs), queue, ^{
+                    task();
+                });
+            },
+            [](const std::string& accountId, const std::string& conversationId, const std::string& messageId) {
+                // Flushed after stopDaemon called fini: there is no daemon left to send to
+                if (!libjami::initialized()) {
+                    FILE_LOG_D("ReadReceipts", @"Dropping receipt for %s: daemon not initialized", conversationId.c_str());
+                    return;
+                }
+                FILE_LOG_D("ReadReceipts", @"Sending receipt for %s", conversationId.c_str());
+                libjami::setMessageDisplayed(accountId, conversationId, messageId, kDisplayedStatus);
+            });
+#if TARGET_OS_IOS
+        __weak JBReadReceipts *weakSelf = self;
+        [[NSNotificationCenter defaultCenter] addObserverForName:UIApplicationDidEnterBackgroundNotification
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification *) {
+            [weakSelf flush];
+        }];
+#endif
+    }
+    return self;
+}
+
+- (void)noteMessages:(const std::vector<libjami::SwarmMessage>&)messages {
+    _scheduler->noteMessages(messages);
+}
+
+- (void)noteMessage:(const libjami::SwarmMessage&)message {
+    _scheduler->noteMessage(message);
+}
+
+- (void)markDisplayed:(const std::string&)accountId
+       conversationId:(const std::string&)conversationId
+            messageId:(const std::string&)messageId {
+    _scheduler->markDisplayed(accountId, conversationId, messageId);
+}
+
+- (std::string)pendingMessage:(const std::string&)accountId
+               conversationId:(const std::string&)conversationId {
+    return _scheduler->pendingMessage(accountId, conversationId);
+}
+
+- (void)flush {
+    _scheduler->flush();
+}
+
+- (void)removeAccount:(const std::string&)accountId {
+    _scheduler->removeAccount(accountId);
+}
+
+- (void)clearKnownMessages {
+    _scheduler->clearKnownMessages();
+}
+
+@end
@@ -0,0 +1,47 @@
+//
+//  JBScopedFileAccess.h
+//  GetTogether
+//
+//  Security-scoped files sent in place: a picked file that could not be
+//  cloned keeps its scope open until the transfer sending it ends, so libjami
+//  reads the original bytes instead of a temporary copy. The daemon's link to
+//  it is then replaced by a copy, for the peers fetching the file later.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBScopedFileAccess : NSObject
+
++ (instancetype)shared;
+
+/// Picker: `url` whose startAccessingSecurityScopedResource succeeded. The
+/// scope is released when its transfer ends, or after a while if never sent.
+- (void)holdURL:(NSURL *)url;
+
+/// sendFile: before the path reaches the daemon. No-op for paths not held.
+- (void)sendStarted:(const std::string&)path
+          accountId:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId;
+
+/// sendFile: `path` was preprocessed and a copy is sent instead, so its scope
+/// is released once no transfer uses it. No-op for paths not held.
+- (void)sourceReplaced:(const std::string&)path;
+
+/// sendFile: `path` never reached the daemon (not running), so its scope is
+/// released now instead of expiring. No-op for paths not held or still in use.
+- (void)sendDropped:(const std::string&)path;
+
+/// DataTransferEvent handler (daemon thread)
+- (void)handleEvent:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId
+             fileId:(const std::string&)fileId
+          eventCode:(int)eventCode;
+
+@end
+
+NS_ASSUME_NONNULL_END
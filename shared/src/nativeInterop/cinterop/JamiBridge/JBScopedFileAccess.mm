@@ -0,0 +1,249 @@
+//
+//  JBScopedFileAccess.mm
+//  GetTogether
+//
+//  libjami links a sent file into the conversation's data directory (a
+//  symlink to the original when it is outside the app's container), so the
+//  daemon's path for a transfer resolves to the picked file: that is how a
+//  DataTransferEvent's fileId is matched to a held scope. Events are only
+//  followed while sends are pending, and unmatched scopes expire.
+//
+//  Peers fetch a swarm file on demand, long after the first transfer ended,
+//  and the daemon serves it through its link. Before a scope is released,
+//  each link bound to the file is replaced by a copy in the container (an
+//  APFS clone when the volume allows it), so later requests still read it.
+//
+
+#import "JBScopedFileAccess.h"
+#import "NativeFileLogger.h"
+
+#include <copyfile.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "datatransfer_interface.h"
+
+namespace {
+
+// A picked file that is never sent, or whose transfer never reports
+constexpr int64_t kUnsentTimeout = 10 * 60 * NSEC_PER_SEC;
+
+struct HeldFile {
+    NSURL *url;
+    int transfers = 0;      // bound to a fileId, not ended
+    uint64_t generation = 0;
+    std::vector<std::string> links;  // daemon paths resolving to the file
+};
+
+struct PendingSend {
+    std::string path;
+    std::string accountId;
+    std::string conversationId;
+};
+
+bool isTerminal(int eventCode) {
+    using Code = libjami::DataTransferEventCode;
+    return eventCode == (int)Code::invalid || eventCode == (int)Code::unsupported
+        || eventCode >= (int)Code::finished;
+}
+
+// Held files are keyed by their resolved path, the form the daemon's links resolve to
+std::string resolvedPath(const std::string& path) {
+    std::error_code ec;
+    auto resolved = std::filesystem::canonical(path, ec);
+    return ec ? path : resolved.string();
+}
+
+} // namespace
+
+@implementation JBScopedFileAccess {
+    dispatch_queue_t _queue;
+    // Only touched on _queue
+    std::unordered_map<std::string, HeldFile> _held;
+    std::deque<PendingSend> _pending;
+    std::unordered_map<std::string, std::string> _transfers; // fileId -> held path
+    uint64_t _generation;
+}
+
++ (instancetype)shared {
+    static JBScopedFileAccess *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBScopedFileAccess alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.scopedfiles", attr);
+    }
+    return self;
+}
+
+- (void)holdURL:(NSURL *)url {
+    std::string path = resolvedPath(url.fileSystemRepresentation);
+    dispatch_async(_queue, ^{
+        auto [it, inserted] = self->_held.try_emplace(path);
+        if (!inserted) {
+            // Already held: the existing scope covers it, balance this start
+            [url stopAccessingSecurityScopedResource];
+        } else {
+            it->second.url = url;
+            FILE_LOG_I("ScopedFiles", @"Holding %@", url.lastPathComponent);
+        }
+        [self armExpiry:it->second path:path];
+    });
+}
+
+- (void)sendStarted:(const std::string&)path
+          accountId:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId {
+    // Blocks capture reference parameters by reference: copy them first
+    PendingSend send {resolvedPath(path), accountId, conversationId};
+    dispatch_async(_queue, ^{
+        auto it = self->_held.find(send.path);
+        if (it == self->_held.end()) return;
+        self->_pending.push_back(send);
+        [self armExpiry:it->second path:send.path];
+    });
+}
+
+- (void)sourceReplaced:(const std::string&)path {
+    std::string resolved = resolvedPath(path);
+    dispatch_async(_queue, ^{
+        [self releaseIfUnused:resolved reason:"replaced"];
+    });
+}
+
+- (void)sendDropped:(const std::string&)path {
+    std::string resolved = resolvedPath(path);
+    dispatch_async(_queue, ^{
+        [self releaseIfUnused:resolved reason:"send dropped"];
+    });
+}
+
+- (void)handleEvent:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId
+             fileId:(const std::string&)fileId
+          eventCode:(int)eventCode {
+    std::string account = accountId;
+    std::string conversation = conversationId;
+    std::string file = fileId;
+    dispatch_async(_queue, ^{
+        if (self->_held.empty()) return;
+        auto bound = self->_transfers.find(file);
+        if (bound == self->_transfers.end()) {
+            if (self->_pending.empty()) return;
+            [self bindTransfer:file accountId:account conversationId:conversation];
+            bound = self->_transfers.find(file);
+            if (bound == self->_transfers.end()) return;
+        }
+        if (!isTerminal(eventCode)) return;
+
+        std::string path = bound->second;
+        self->_transfers.erase(bound);
+        auto held = self->_held.find(path);
+        if (held == self->_held.end()) return;
+        held->second.transfers--;
+        bool morePending = std::any_of(self->_pending.begin(), self->_pending.end(),
+                                       [&](const PendingSend& send) { return send.path == path; });
+        if (held->second.transfers <= 0 && !morePending) {
+            [self releasePath:path reason:"transfer ended"];
+        }
+    });
+}
+
+#pragma mark - Private (on _queue)
+
+- (void)bindTransfer:(const std::string&)fileId
+           accountId:(const std::string&)accountId
+      conversationId:(const std::string&)conversationId {
+    std::string path;
+    int64_t total = 0;
+    int64_t progress = 0;
+    auto err = libjami::fileTransferInfo(accountId, conversationId, fileId, path, total, progress);
+    if (err != libjami::DataTransferError::success || path.empty()) return;
+    std::string resolved = resolvedPath(path);
+
+    for (auto it = _pending.begin(); it != _pending.end(); ++it) {
+        if (it->path != resolved || it->accountId != accountId || it->conversationId != conversationId) {
+            continue;
+        }
+        auto held = _held.find(resolved);
+        if (held != _held.end()) {
+            held->second.transfers++;
+            _transfers[fileId] = resolved;
+            auto& links = held->second.links;
+            if (path != resolved && std::find(links.begin(), links.end(), path) == links.end()) {
+                links.push_back(path);
+            }
+        }
+        _pending.erase(it);
+        return;
+    }
+}
+
+- (void)armExpiry:(HeldFile&)file path:(const std::string&)path {
+    uint64_t generation = ++_generation;
+    file.generation = generation;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kUnsentTimeout), _queue, ^{
+        auto it = self->_held.find(path);
+        if (it == self->_held.end() || it->second.generation != generation || it->second.transfers > 0) return;
+        [self releasePath:path reason:"expired"];
+    });
+}
+
+- (void)releaseIfUnused:(const std::string&)path reason:(const char *)reason {
+    auto it = _held.find(path);
+    if (it == _held.end() || it->second.transfers > 0) return;
+    bool pending = std::any_of(_pending.begin(), _pending.end(),
+                               [&](const PendingSend& send) { return send.path == path; });
+    if (!pending) [self releasePath:path reason:reason];
+}
+
+// Still in scope: replaces each daemon link to the file by a copy of it
+- (void)copyIntoLinks:(const HeldFile&)file {
+    const char *source = file.url.fileSystemRepresentation;
+    for (const auto& link : file.links) {
+        std::error_code ec;
+        if (!std::filesystem::is_symlink(link, ec)) continue;
+        std::string copy = link + ".copy";
+        unlink(copy.c_str());
+        // Renamed over the link once complete: peers never see a partial file
+        if (copyfile(source, copy.c_str(), nullptr, COPYFILE_DATA | COPYFILE_CLONE) != 0
+            || rename(copy.c_str(), link.c_str()) != 0) {
+            FILE_LOG_W("ScopedFiles", @"Copy of %@ failed: %s", file.url.lastPathComponent, strerror(errno));
+            unlink(copy.c_str());
+        }
+    }
+}
+
+- (void)releasePath:(const std::string&)path reason:(const char *)reason {
+    auto it = _held.find(path);
+    if (it == _held.end()) return;
+    FILE_LOG_I("ScopedFiles", @"Releasing %@ (%s)", it->second.url.lastPathComponent, reason);
+    [self copyIntoLinks:it->second];
+    [it->second.url stopAccessingSecurityScopedResource];
+    _held.erase(it);
+    _pending.erase(std::remove_if(_pending.begin(), _pending.end(),
+                                  [&](const PendingSend& send) { return send.path == path; }),
+                   _pending.end());
+    for (auto transfer = _transfers.begin(); transfer != _transfers.end();) {
+        transfer = transfer->second == path ? _transfers.erase(transfer) : std::next(transfer);
+    }
+}
+
+@end
@@ -0,0 +1,51 @@
+//
+//  JBSignalCoalescer.h
+//  GetTogether
+//
+//  jbcore::Coalescer (latest state per key, one batch per window) flushed
+//  through the delivery lanes of a domain, where each account's batch is
+//  converted and delivered.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import "JBSignalDispatcher.h"
+
+#include "jbcore/Coalescer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The window timer only drains the coalescer; delivery goes through the lanes
+inline jbcore::Scheduler coalescerTimer() {
+    return [](int64_t delayNs, std::function<void()> task) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delayNs), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            task();
+        });
+    };
+}
+
+template <typename Key, typename Value>
+struct SignalCoalescer
+{
+    using Flush = typename jbcore::Coalescer<Key, Value>::Flush;
+
+    // Flush is called on the signal queue of the domain, once per account with
+    // that account's events in first-arrival order. Each batch is queued at the
+    // back of its account's lane, so it reaches the delegate after the signals
+    // of that account received before the window closed.
+    static std::shared_ptr<jbcore::Coalescer<Key, Value>> create(JBSignalDomain domain, Flush flush) {
+        auto deliver = std::make_shared<const Flush>(std::move(flush));
+        return jbcore::Coalescer<Key, Value>::create(coalescerTimer(), [domain, deliver](std::vector<Value>&& events) {
+            for (auto& [account, batch] : jbcore::splitByAccount(std::move(events))) {
+                auto shared = std::make_shared<std::vector<Value>>(std::move(batch));
+                [[JBSignalDispatcher shared] dispatch:^{
+                    (*deliver)(std::move(*shared));
+                } domain:domain accountId:account];
+            }
+        });
+    }
+};
@@ -0,0 +1,52 @@
+//
+//  JBSignalDispatcher.h
+//  GetTogether
+//
+//  Per-domain delivery queues for daemon signals. Handlers convert the
+//  daemon data on the daemon thread, then dispatch the delegate call on
+//  signalQueue(domain) instead of the main queue.
+//
+//  Each delivery queue is fronted by a jbcore::FairQueue: deliveries of one
+//  account keep their order, accounts sharing a queue take turns (weighted),
+//  and the Call domain is its priority lane, so call signals pass the bulk
+//  traffic already queued even when the app points several domains at the
+//  same queue.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBSignalDispatcher : NSObject
+
++ (instancetype)shared;
+
+- (dispatch_queue_t)queueForDomain:(JBSignalDomain)domain;
+
+/// nil restores the bridge-owned queue of the domain
+- (void)setQueue:(nullable dispatch_queue_t)queue forDomain:(JBSignalDomain)domain;
+
+/// Runs `block` on the domain's queue in the lane of `accountId` (empty: the
+/// lane of account-less signals). Call domain blocks go to the priority lane.
+- (void)dispatch:(dispatch_block_t)block domain:(JBSignalDomain)domain accountId:(const std::string&)accountId;
+
+/// Deliveries taken from the account's lane per round (default 1)
+- (void)setWeight:(NSUInteger)weight forAccount:(const std::string&)accountId;
+- (void)removeAccount:(const std::string&)accountId;
+
+/// Lane counters merged over the delivery queues, keyed by account
+- (NSDictionary<NSString *, JBAccountQueueMetrics *> *)accountQueueMetrics;
+- (void)resetAccountQueueMetrics;
+
+@end
+
+static inline dispatch_queue_t signalQueue(JBSignalDomain domain) {
+    return [[JBSignalDispatcher shared] queueForDomain:domain];
+}
+
+NS_ASSUME_NONNULL_END
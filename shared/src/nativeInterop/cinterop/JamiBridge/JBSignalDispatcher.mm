@@ -0,0 +1,188 @@
+//
+//  JBSignalDispatcher.mm
+//  GetTogether
+//
+//  One FairQueue per distinct delivery queue, created on first use and kept
+//  with a strong reference to its queue (so the key cannot be reused by
+//  another queue). Every dispatch pushes one task and queues one runNext(),
+//  so the GCD queue still sees exactly one block per delivery.
+//
+
+#import "JBSignalDispatcher.h"
+#import "JBStringInterner.h"
+
+#import <os/lock.h>
+
+#include "jbcore/FairQueue.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+static const NSInteger kSignalDomainCount = JBSignalDomainVideo + 1;
+
+static dispatch_queue_t makeSignalQueue(const char* label, qos_class_t qos) {
+    dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, qos, 0);
+    return dispatch_queue_create(label, attr);
+}
+
+namespace {
+
+struct DeliveryLanes {
+    dispatch_queue_t queue;
+    std::shared_ptr<jbcore::FairQueue> lanes;
+};
+
+using LanesByQueue = std::unordered_map<const void*, DeliveryLanes>;
+
+// Under the dispatcher lock; the FairQueues are then used without it
+std::vector<std::shared_ptr<jbcore::FairQueue>> allLanes(const LanesByQueue& byQueue) {
+    std::vector<std::shared_ptr<jbcore::FairQueue>> result;
+    result.reserve(byQueue.size());
+    for (const auto& [queue, entry] : byQueue) {
+        result.push_back(entry.lanes);
+    }
+    return result;
+}
+
+} // namespace
+
+@implementation JBSignalDispatcher {
+    os_unfair_lock _lock;
+    dispatch_queue_t _defaultQueues[kSignalDomainCount];
+    dispatch_queue_t _queues[kSignalDomainCount];
+    // All below under _lock
+    LanesByQueue _lanes;
+    std::unordered_map<std::string, uint32_t> _weights;
+}
+
++ (instancetype)shared {
+    static JBSignalDispatcher *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBSignalDispatcher alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        // Call state drives CallKit and the in-call UI, it must never wait behind a swarm sync
+        _defaultQueues[JBSignalDomainCall] = makeSignalQueue("net.jami.bridge.signal.call", QOS_CLASS_USER_INTERACTIVE);
+        _defaultQueues[JBSignalDomainConversation] = makeSignalQueue("net.jami.bridge.signal.conversation", QOS_CLASS_USER_INITIATED);
+        _defaultQueues[JBSignalDomainConfiguration] = makeSignalQueue("net.jami.bridge.signal.config", QOS_CLASS_UTILITY);
+        _defaultQueues[JBSignalDomainPresence] = makeSignalQueue("net.jami.bridge.signal.presence", QOS_CLASS_UTILITY);
+        _defaultQueues[JBSignalDomainVideo] = makeSignalQueue("net.jami.bridge.signal.video", QOS_CLASS_USER_INITIATED);
+        for (NSInteger i = 0; i < kSignalDomainCount; i++) {
+            _queues[i] = _defaultQueues[i];
+        }
+    }
+    return self;
+}
+
+- (dispatch_queue_t)queueForDomain:(JBSignalDomain)domain {
+    NSParameterAssert(domain >= 0 && domain < kSignalDomainCount);
+    os_unfair_lock_lock(&_lock);
+    dispatch_queue_t queue = _queues[domain];
+    os_unfair_lock_unlock(&_lock);
+    return queue;
+}
+
+- (void)setQueue:(dispatch_queue_t)queue forDomain:(JBSignalDomain)domain {
+    NSParameterAssert(domain >= 0 && domain < kSignalDomainCount);
+    os_unfair_lock_lock(&_lock);
+    _queues[domain] = queue ?: _defaultQueues[domain];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)dispatch:(dispatch_block_t)block domain:(JBSignalDomain)domain accountId:(const std::string&)accountId {
+    NSParameterAssert(domain >= 0 && domain < kSignalDomainCount);
+    os_unfair_lock_lock(&_lock);
+    dispatch_queue_t queue = _queues[domain];
+    auto& entry = _lanes[(__bridge const void*)queue];
+    if (!entry.lanes) {
+        entry.queue = queue;
+        entry.lanes = std::make_shared<jbcore::FairQueue>();
+        for (const auto& [account, weight] : _weights) {
+            entry.lanes->setWeight(account, weight);
+        }
+    }
+    std::shared_ptr<jbcore::FairQueue> lanes = entry.lanes;
+    os_unfair_lock_unlock(&_lock);
+
+    lanes->push(accountId, [block] { block(); }, domain == JBSignalDomainCall);
+    dispatch_async(queue, ^{
+        lanes->runNext();
+    });
+}
+
+- (void)setWeight:(NSUInteger)weight forAccount:(const std::string&)accountId {
+    uint32_t clamped = (uint32_t)std::clamp<NSUInteger>(weight, 1, UINT32_MAX);
+    os_unfair_lock_lock(&_lock);
+    _weights[accountId] = clamped;
+    auto all = allLanes(_lanes);
+    os_unfair_lock_unlock(&_lock);
+    for (const auto& lanes : all) {
+        lanes->setWeight(accountId, clamped);
+    }
+}
+
+- (void)removeAccount:(const std::string&)accountId {
+    os_unfair_lock_lock(&_lock);
+    _weights.erase(accountId);
+    auto all = allLanes(_lanes);
+    os_unfair_lock_unlock(&_lock);
+    for (const auto& lanes : all) {
+        lanes->removeLane(accountId);
+    }
+}
+
+- (NSDictionary<NSString *, JBAccountQueueMetrics *> *)accountQueueMetrics {
+    os_unfair_lock_lock(&_lock);
+    auto all = allLanes(_lanes);
+    os_unfair_lock_unlock(&_lock);
+
+    std::map<std::string, jbcore::FairQueue::LaneStats> merged;
+    for (const auto& lanes : all) {
+        for (const auto& [account, stats] : lanes->stats()) {
+            // Account-less signals (video, transfers) are not an account's traffic
+            if (account.empty()) continue;
+            auto [it, inserted] = merged.emplace(account, stats);
+            if (inserted) continue;
+            auto& total = it->second;
+            total.pending += stats.pending;
+            total.peakPending = std::max(total.peakPending, stats.peakPending);
+            total.delivered += stats.delivered;
+            total.priorityDelivered += stats.priorityDelivered;
+            total.maxWaitNs = std::max(total.maxWaitNs, stats.maxWaitNs);
+        }
+    }
+
+    NSMutableDictionary<NSString *, JBAccountQueueMetrics *> *result =
+        [NSMutableDictionary dictionaryWithCapacity:merged.size()];
+    for (const auto& [account, stats] : merged) {
+        JBAccountQueueMetrics *metrics = [[JBAccountQueueMetrics alloc] init];
+        metrics.pending = stats.pending;
+        metrics.peakPending = stats.peakPending;
+        metrics.delivered = stats.delivered;
+        metrics.priorityDelivered = stats.priorityDelivered;
+        metrics.maxWaitMs = stats.maxWaitNs / 1e6;
+        metrics.weight = stats.weight;
+        result[toNSIdentifier(account)] = metrics;
+    }
+    return result;
+}
+
+- (void)resetAccountQueueMetrics {
+    os_unfair_lock_lock(&_lock);
+    auto all = allLanes(_lanes);
+    os_unfair_lock_unlock(&_lock);
+    for (const auto& lanes : all) {
+        lanes->resetStats();
+    }
+}
+
+@end
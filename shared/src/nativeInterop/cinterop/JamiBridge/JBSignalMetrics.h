@@ -0,0 +1,96 @@
+//
+//  JBSignalMetrics.h
+//  GetTogether
+//
+//  Per-signal latency accounting for the daemon -> delegate path. Handlers
+//  registered with instrumented_callback<Signal>() are timed from entry;
+//  dispatchSignal() marks the end of conversion and times the wait on the
+//  signal queue and the delegate call. Everything recorded on the hot path is
+//  a relaxed atomic add into fixed histograms, no lock and no allocation.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import "JBSignalDispatcher.h"
+#import "JBSignalTrace.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "jami.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+struct JBSignalStats;
+
+// Stats slot of a signal; created on first use, lives for the process
+JBSignalStats *signalStats(const char *name);
+
+// Marks the current handler invocation (thread-local) for the duration of its scope
+class JBSignalScope {
+public:
+    explicit JBSignalScope(JBSignalStats *stats);
+    ~JBSignalScope();
+    JBSignalScope(const JBSignalScope&) = delete;
+    JBSignalScope& operator=(const JBSignalScope&) = delete;
+
+private:
+    friend struct JBSignalDeliveryTrace;
+    friend void signalBytesConverted(size_t bytes);
+    JBSignalStats *stats_;
+    JBSignalScope *_Nullable previous_;
+    uint64_t entry_;
+    uint64_t converted_ {0};
+    uint64_t signpost_ {0};
+    size_t bytes_ {0};
+};
+
+// Adds to the bytes converted by the current handler (no-op outside one)
+void signalBytesConverted(size_t bytes);
+
+// Copied into the delivery block; captures the current handler, if any
+struct JBSignalDeliveryTrace {
+    JBSignalStats *_Nullable stats {nullptr};
+    uint64_t enqueued {0};
+    uint64_t signpost {0};
+
+    static JBSignalDeliveryTrace capture();
+    void run(dispatch_block_t block) const;
+};
+
+// Queues `block` on the domain's signal queue in the lane of `accountId`,
+// with delivery accounting (the queue wait includes the wait for its turn)
+static inline void dispatchSignal(JBSignalDomain domain, const std::string& accountId, dispatch_block_t block) {
+    JBSignalDeliveryTrace trace = JBSignalDeliveryTrace::capture();
+    [[JBSignalDispatcher shared] dispatch:^{
+        trace.run(block);
+    } domain:domain accountId:accountId];
+}
+
+// Signals that belong to no account
+static inline void dispatchSignal(JBSignalDomain domain, dispatch_block_t block) {
+    dispatchSignal(domain, std::string(), block);
+}
+
+// exportable_callback<Ts>() whose invocations are accounted under Ts::name
+// (and captured while a signal trace is active)
+template <typename Ts, typename F>
+std::pair<std::string, std::shared_ptr<libjami::CallbackWrapperBase>>
+instrumented_callback(F&& func) {
+    JBSignalStats *stats = signalStats(Ts::name);
+    return libjami::exportable_callback<Ts>(std::function<typename Ts::cb_type>(
+        [stats, func = std::forward<F>(func)](auto&&... args) {
+            if (signalTraceActive()) writeSignalTrace(Ts::name, traceEncodeArgs(args...));
+            JBSignalScope scope(stats);
+            return func(std::forward<decltype(args)>(args)...);
+        }));
+}
+
+NSDictionary<NSString *, JBSignalMetrics *> *signalMetricsSnapshot(void);
+void resetSignalMetrics(void);
+void setSignalSignpostsEnabled(bool enabled);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,241 @@
+//
+//  JBSignalMetrics.mm
+//  GetTogether
+//
+//  Latencies go into log-linear histograms: four linear sub-buckets per power
+//  of two microseconds, so a percentile is within 25% of the recorded value
+//  from 1 us to over an hour. Snapshots read the counters without stopping
+//  writers; a snapshot taken during a burst may be off by the in-flight samples.
+//  Signposts (subsystem net.jami.bridge, category Signals) are emitted when
+//  enabled and Instruments is recording: "Convert" on the daemon thread,
+//  "Queued" until the delivery block starts, "Delegate" around the delegate call.
+//
+
+#import "JBSignalMetrics.h"
+
+#import <os/signpost.h>
+
+#include <atomic>
+#include <array>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr int kSubBuckets = 4;
+constexpr int kBuckets = 32 * kSubBuckets;
+
+class LatencyHistogram {
+public:
+    void record(uint64_t nanoseconds) {
+        buckets_[bucketIndex(nanoseconds / 1000)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Microseconds at `quantile` (0...1), 0 when empty
+    double percentile(double quantile) const {
+        std::array<uint64_t, kBuckets> counts;
+        uint64_t total = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)(quantile * (double)(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return (double)bucketValue(i);
+        }
+        return (double)bucketValue(kBuckets - 1);
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static int bucketIndex(uint64_t micros) {
+        if (micros < kSubBuckets) return (int)micros;
+        int power = 63 - __builtin_clzll(micros);
+        int sub = (int)((micros >> (power - 2)) & (kSubBuckets - 1));
+        int index = (power - 1) * kSubBuckets + sub;
+        return index < kBuckets ? index : kBuckets - 1;
+    }
+
+    // Lower bound of a bucket in microseconds
+    static uint64_t bucketValue(int index) {
+        if (index < kSubBuckets) return (uint64_t)index;
+        int power = index / kSubBuckets + 1;
+        uint64_t sub = (uint64_t)(index % kSubBuckets);
+        return (kSubBuckets + sub) << (power - 2);
+    }
+
+    std::array<std::atomic<uint32_t>, kBuckets> buckets_ {};
+};
+
+uint64_t now() {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+os_log_t signpostLog() {
+    static os_log_t log = os_log_create("net.jami.bridge", "Signals");
+    return log;
+}
+
+std::atomic<bool> gSignpostsEnabled {false};
+
+bool signpostsActive() {
+    return gSignpostsEnabled.load(std::memory_order_relaxed) && os_signpost_enabled(signpostLog());
+}
+
+thread_local JBSignalScope *tCurrentScope = nullptr;
+
+} // namespace
+
+struct JBSignalStats {
+    explicit JBSignalStats(const char *signalName) : name(signalName) {}
+
+    const char *name;
+    std::atomic<uint64_t> count {0};
+    std::atomic<uint64_t> deliveries {0};
+    std::atomic<uint64_t> bytes {0};
+    LatencyHistogram conversion;
+    LatencyHistogram queueWait;
+    LatencyHistogram delegate;
+};
+
+namespace {
+
+struct StatsRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<JBSignalStats>> stats;
+};
+
+StatsRegistry& registry() {
+    static StatsRegistry *instance = new StatsRegistry();
+    return *instance;
+}
+
+} // namespace
+
+JBSignalStats *signalStats(const char *name) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& stats : r.stats) {
+        if (strcmp(stats->name, name) == 0) return stats.get();
+    }
+    r.stats.push_back(std::make_unique<JBSignalStats>(name));
+    return r.stats.back().get();
+}
+
+#pragma mark - Handler scope
+
+JBSignalScope::JBSignalScope(JBSignalStats *stats)
+    : stats_(stats), previous_(tCurrentScope), entry_(now()) {
+    tCurrentScope = this;
+    if (signpostsActive()) {
+        signpost_ = os_signpost_id_generate(signpostLog());
+        os_signpost_interval_begin(signpostLog(), signpost_, "Convert", "%{public}s", stats_->name);
+    }
+}
+
+JBSignalScope::~JBSignalScope() {
+    tCurrentScope = previous_;
+    // Handlers that deliver nothing are timed to their return
+    uint64_t converted = converted_ ? converted_ : now();
+    if (signpost_ && !converted_) {
+        os_signpost_interval_end(signpostLog(), signpost_, "Convert");
+    }
+    stats_->count.fetch_add(1, std::memory_order_relaxed);
+    stats_->conversion.record(converted - entry_);
+    if (bytes_) stats_->bytes.fetch_add(bytes_, std::memory_order_relaxed);
+}
+
+void signalBytesConverted(size_t bytes) {
+    if (tCurrentScope) tCurrentScope->bytes_ += bytes;
+}
+
+#pragma mark - Delivery
+
+JBSignalDeliveryTrace JBSignalDeliveryTrace::capture() {
+    JBSignalScope *scope = tCurrentScope;
+    if (!scope) return {};
+    uint64_t enqueued = now();
+    // The first delivery ends the conversion
+    if (!scope->converted_) {
+        scope->converted_ = enqueued;
+        if (scope->signpost_) {
+            os_signpost_interval_end(signpostLog(), scope->signpost_, "Convert");
+        }
+    }
+    if (scope->signpost_) {
+        os_signpost_interval_begin(signpostLog(), scope->signpost_, "Queued", "%{public}s", scope->stats_->name);
+    }
+    return {scope->stats_, enqueued, scope->signpost_};
+}
+
+void JBSignalDeliveryTrace::run(dispatch_block_t block) const {
+    if (!stats) {
+        block();
+        return;
+    }
+    uint64_t started = now();
+    if (signpost) {
+        os_signpost_interval_end(signpostLog(), signpost, "Queued");
+        os_signpost_interval_begin(signpostLog(), signpost, "Delegate", "%{public}s", stats->name);
+    }
+    block();
+    uint64_t finished = now();
+    if (signpost) {
+        os_signpost_interval_end(signpostLog(), signpost, "Delegate");
+    }
+    stats->deliveries.fetch_add(1, std::memory_order_relaxed);
+    stats->queueWait.record(started - enqueued);
+    stats->delegate.record(finished - started);
+}
+
+#pragma mark - Snapshot
+
+NSDictionary<NSString *, JBSignalMetrics *> *signalMetricsSnapshot(void) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    NSMutableDictionary<NSString *, JBSignalMetrics *> *snapshot =
+        [NSMutableDictionary dictionaryWithCapacity:r.stats.size()];
+    for (const auto& stats : r.stats) {
+        uint64_t count = stats->count.load(std::memory_order_relaxed);
+        if (count == 0) continue;
+        JBSignalMetrics *metrics = [[JBSignalMetrics alloc] init];
+        metrics.name = @(stats->name);
+        metrics.count = count;
+        metrics.deliveries = stats->deliveries.load(std::memory_order_relaxed);
+        metrics.bytesConverted = stats->bytes.load(std::memory_order_relaxed);
+        metrics.conversionP50Micros = stats->conversion.percentile(0.5);
+        metrics.conversionP99Micros = stats->conversion.percentile(0.99);
+        metrics.queueWaitP50Micros = stats->queueWait.percentile(0.5);
+        metrics.queueWaitP99Micros = stats->queueWait.percentile(0.99);
+        metrics.delegateP50Micros = stats->delegate.percentile(0.5);
+        metrics.delegateP99Micros = stats->delegate.percentile(0.99);
+        snapshot[metrics.name] = metrics;
+    }
+    return snapshot;
+}
+
+void resetSignalMetrics(void) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& stats : r.stats) {
+        stats->count.store(0, std::memory_order_relaxed);
+        stats->deliveries.store(0, std::memory_order_relaxed);
+        stats->bytes.store(0, std::memory_order_relaxed);
+        stats->conversion.reset();
+        stats->queueWait.reset();
+        stats->delegate.reset();
+    }
+}
+
+void setSignalSignpostsEnabled(bool enabled) {
+    gSignpostsEnabled.store(enabled, std::memory_order_relaxed);
+}
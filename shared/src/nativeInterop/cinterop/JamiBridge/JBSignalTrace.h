@@ -0,0 +1,198 @@
+//
+//  JBSignalTrace.h
+//  GetTogether
+//
+//  Capture format for daemon signals, shared by the bridge (writer) and the
+//  benchmark harness (reader). One JSON object per line:
+//
+//      {"t":<ns since capture start>,"signal":"<Ts::name>","args":[...]}
+//
+//  Arguments are encoded in cb_type order: strings as strings, numbers and
+//  bools as JSON scalars, maps as objects, vectors as arrays, SwarmMessage as
+//  an object of its fields. Out-parameters (pointers) are written as null.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "conversation_interface.h"
+
+// Starts writing every instrumented signal to `path` (truncated). Returns false if it cannot be opened.
+bool startSignalTrace(const std::string& path);
+void stopSignalTrace();
+bool signalTraceActive();
+// Appends one line; `args` is the encoded JSON array
+void writeSignalTrace(const char *signal, const std::string& args);
+
+// =============================================================================
+// Encoding
+// =============================================================================
+
+inline void traceEncode(std::string& out, const std::string& value);
+inline void traceEncode(std::string& out, bool value);
+inline void traceEncode(std::string& out, const libjami::SwarmMessage& message);
+template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+void traceEncode(std::string& out, T value);
+template <typename V>
+void traceEncode(std::string& out, const std::map<std::string, V>& map);
+template <typename V>
+void traceEncode(std::string& out, const std::vector<V>& vector);
+template <typename T>
+void traceEncode(std::string& out, T *) { out += "null"; }
+
+inline void traceEncode(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out.push_back((char)c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+inline void traceEncode(std::string& out, bool value) {
+    out += value ? "true" : "false";
+}
+
+template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, int>>
+void traceEncode(std::string& out, T value) {
+    out += std::to_string(value);
+}
+
+template <typename V>
+void traceEncode(std::string& out, const std::map<std::string, V>& map) {
+    out.push_back('{');
+    bool first = true;
+    for (const auto& [key, value] : map) {
+        if (!first) out.push_back(',');
+        first = false;
+        traceEncode(out, key);
+        out.push_back(':');
+        traceEncode(out, value);
+    }
+    out.push_back('}');
+}
+
+template <typename V>
+void traceEncode(std::string& out, const std::vector<V>& vector) {
+    out.push_back('[');
+    for (size_t i = 0; i < vector.size(); ++i) {
+        if (i) out.push_back(',');
+        traceEncode(out, vector[i]);
+    }
+    out.push_back(']');
+}
+
+inline void traceEncode(std::string& out, const libjami::SwarmMessage& message) {
+    out += "{\"id\":";
+    traceEncode(out, message.id);
+    out += ",\"type\":";
+    traceEncode(out, message.type);
+    out += ",\"linearizedParent\":";
+    traceEncode(out, message.linearizedParent);
+    out += ",\"body\":";
+    traceEncode(out, message.body);
+    out += ",\"reactions\":";
+    traceEncode(out, message.reactions);
+    out += ",\"editions\":";
+    traceEncode(out, message.editions);
+    out += ",\"status\":";
+    traceEncode(out, message.status);
+    out.push_back('}');
+}
+
+template <typename... Args>
+std::string traceEncodeArgs(const Args&... args) {
+    std::string out = "[";
+    bool first = true;
+    ((out += first ? "" : ",", first = false, traceEncode(out, args)), ...);
+    out.push_back(']');
+    return out;
+}
+
+// =============================================================================
+// Decoding (from NSJSONSerialization objects)
+// =============================================================================
+
+template <typename T, typename = void>
+struct TraceDecoder;
+
+template <>
+struct TraceDecoder<std::string> {
+    static std::string decode(id value) {
+        return [value isKindOfClass:[NSString class]] ? std::string([(NSString *)value UTF8String]) : std::string();
+    }
+};
+
+template <typename T>
+struct TraceDecoder<T, std::enable_if_t<std::is_arithmetic_v<T>>> {
+    static T decode(id value) {
+        if (![value isKindOfClass:[NSNumber class]]) return T();
+        if constexpr (std::is_same_v<T, bool>) return [(NSNumber *)value boolValue];
+        else if constexpr (std::is_floating_point_v<T>) return (T)[(NSNumber *)value doubleValue];
+        else if constexpr (std::is_signed_v<T>) return (T)[(NSNumber *)value longLongValue];
+        else return (T)[(NSNumber *)value unsignedLongLongValue];
+    }
+};
+
+template <typename V>
+struct TraceDecoder<std::map<std::string, V>> {
+    static std::map<std::string, V> decode(id value) {
+        std::map<std::string, V> map;
+        if (![value isKindOfClass:[NSDictionary class]]) return map;
+        [(NSDictionary *)value enumerateKeysAndObjectsUsingBlock:^(id key, id object, BOOL *) {
+            map.emplace(TraceDecoder<std::string>::decode(key), TraceDecoder<V>::decode(object));
+        }];
+        return map;
+    }
+};
+
+template <typename V>
+struct TraceDecoder<std::vector<V>> {
+    static std::vector<V> decode(id value) {
+        std::vector<V> vector;
+        if (![value isKindOfClass:[NSArray class]]) return vector;
+        vector.reserve([(NSArray *)value count]);
+        for (id element in (NSArray *)value) {
+            vector.push_back(TraceDecoder<V>::decode(element));
+        }
+        return vector;
+    }
+};
+
+template <>
+struct TraceDecoder<libjami::SwarmMessage> {
+    static libjami::SwarmMessage decode(id value) {
+        libjami::SwarmMessage message;
+        if (![value isKindOfClass:[NSDictionary class]]) return message;
+        NSDictionary *fields = value;
+        message.id = TraceDecoder<std::string>::decode(fields[@"id"]);
+        message.type = TraceDecoder<std::string>::decode(fields[@"type"]);
+        message.linearizedParent = TraceDecoder<std::string>::decode(fields[@"linearizedParent"]);
+        message.body = TraceDecoder<std::map<std::string, std::string>>::decode(fields[@"body"]);
+        message.reactions = TraceDecoder<std::vector<std::map<std::string, std::string>>>::decode(fields[@"reactions"]);
+        message.editions = TraceDecoder<std::vector<std::map<std::string, std::string>>>::decode(fields[@"editions"]);
+        message.status = TraceDecoder<std::map<std::string, int32_t>>::decode(fields[@"status"]);
+        return message;
+    }
+};
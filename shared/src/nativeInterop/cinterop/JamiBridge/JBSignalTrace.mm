@@ -0,0 +1,60 @@
+//
+//  JBSignalTrace.mm
+//  GetTogether
+//
+//  Lines are written under a mutex with stdio buffering; capture is meant for
+//  a debugging session, not for production, and costs an encode per signal.
+//
+
+#import "JBSignalTrace.h"
+#import "NativeFileLogger.h"
+
+#include <atomic>
+#include <ctime>
+#include <mutex>
+
+namespace {
+
+std::atomic<bool> gTraceActive {false};
+std::mutex gTraceMutex;
+FILE *gTraceFile = nullptr;
+uint64_t gTraceStart = 0;
+
+} // namespace
+
+bool startSignalTrace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    if (gTraceFile) fclose(gTraceFile);
+    gTraceFile = fopen(path.c_str(), "w");
+    if (!gTraceFile) {
+        FILE_LOG_E("SignalTrace", @"Cannot open %s", path.c_str());
+        gTraceActive.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    gTraceStart = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    gTraceActive.store(true, std::memory_order_relaxed);
+    FILE_LOG_I("SignalTrace", @"Capturing signals to %s", path.c_str());
+    return true;
+}
+
+void stopSignalTrace() {
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    gTraceActive.store(false, std::memory_order_relaxed);
+    if (gTraceFile) {
+        fclose(gTraceFile);
+        gTraceFile = nullptr;
+    }
+}
+
+bool signalTraceActive() {
+    return gTraceActive.load(std::memory_order_relaxed);
+}
+
+void writeSignalTrace(const char *signal, const std::string& args) {
+    uint64_t t = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    if (!gTraceFile) return;
+    fprintf(gTraceFile, "{\"t\":%llu,\"signal\":\"%s\",\"args\":", (unsigned long long)(t - gTraceStart), signal);
+    fwrite(args.data(), 1, args.size(), gTraceFile);
+    fputs("}\n", gTraceFile);
+}
@@ -0,0 +1,27 @@
+//
+//  JBStringInterner.h
+//  GetTogether
+//
+//  Canonical NSString instances for the identifiers that cross the bridge on
+//  every signal and call: account, conversation, call and conference ids,
+//  peer URIs, message types. A signal for a known id costs a hash lookup
+//  instead of an NSString allocation, and the same id is the same object.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+
+// Interned C++ string -> NSString. Only for identifiers (bounded set of values),
+// not for message bodies or other free text.
+NSString* toNSIdentifier(const std::string& str);
+
+// NSString -> C++ string; strings handed out by toNSIdentifier() are looked up
+// by pointer instead of being re-encoded.
+std::string toCppIdentifier(NSString* str);
+
+// Drops the table (e.g. under memory pressure). Strings already handed out stay valid.
+void clearInternedIdentifiers();
@@ -0,0 +1,85 @@
+//
+//  JBStringInterner.mm
+//  GetTogether
+//
+//  The forward table keeps a strong reference to every interned NSString, so
+//  a pointer found in the reverse table always designates a live string (its
+//  address cannot have been reused by another object). A full table is simply
+//  dropped: the set of live identifiers is small and refills within a few signals.
+//
+
+#import "JBStringInterner.h"
+#include "JBConversions.h"
+
+#include <os/lock.h>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t kMaxInternedStrings = 4096;
+
+struct InternTable {
+    os_unfair_lock lock = OS_UNFAIR_LOCK_INIT;
+    std::unordered_map<std::string, NSString*> strings;
+    // Interned NSString -> its key in `strings` (node keys have stable addresses)
+    std::unordered_map<const void*, const std::string*> reverse;
+};
+
+InternTable& table() {
+    static InternTable* instance = new InternTable();
+    return *instance;
+}
+
+} // namespace
+
+NSString* toNSIdentifier(const std::string& str) {
+    auto& t = table();
+    os_unfair_lock_lock(&t.lock);
+    auto it = t.strings.find(str);
+    if (it != t.strings.end()) {
+        NSString* interned = it->second;
+        os_unfair_lock_unlock(&t.lock);
+        return interned;
+    }
+    os_unfair_lock_unlock(&t.lock);
+
+    NSString* created = toNSString(str);
+    // Invalid UTF-8: nothing sensible to share
+    if (!created) return created;
+
+    os_unfair_lock_lock(&t.lock);
+    if (t.strings.size() >= kMaxInternedStrings) {
+        t.reverse.clear();
+        t.strings.clear();
+    }
+    auto [entry, inserted] = t.strings.emplace(str, created);
+    if (inserted) {
+        t.reverse.emplace((__bridge const void*)created, &entry->first);
+    }
+    // Another thread may have interned it meanwhile: return the canonical one
+    NSString* interned = entry->second;
+    os_unfair_lock_unlock(&t.lock);
+    return interned;
+}
+
+std::string toCppIdentifier(NSString* str) {
+    if (!str) return "";
+    auto& t = table();
+    os_unfair_lock_lock(&t.lock);
+    auto it = t.reverse.find((__bridge const void*)str);
+    if (it != t.reverse.end()) {
+        std::string result = *it->second;
+        os_unfair_lock_unlock(&t.lock);
+        return result;
+    }
+    os_unfair_lock_unlock(&t.lock);
+    return toCppString(str);
+}
+
+void clearInternedIdentifiers() {
+    auto& t = table();
+    os_unfair_lock_lock(&t.lock);
+    t.reverse.clear();
+    t.strings.clear();
+    os_unfair_lock_unlock(&t.lock);
+}
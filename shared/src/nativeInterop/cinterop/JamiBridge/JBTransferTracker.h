@@ -0,0 +1,69 @@
+//
+//  JBTransferTracker.h
+//  GetTogether
+//
+//  Event-driven file transfer progress. DataTransferEvent tells which transfers
+//  are ongoing; only those are sampled, by a single timer whose period backs
+//  off while no transfer moves. Each sample updates a smoothed throughput and
+//  ETA, and changed transfers are reported together once per tick.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import "JamiBridgeWrapper.h"
+
+#include <string>
+#include <vector>
+
+#include "conversation_interface.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^JBTransferProgressHandler)(NSArray<JBFileTransferInfo *> *transfers);
+
+/// What the tracker knows of one file, read in one go
+struct JBTrackedTransfer {
+    std::string interactionId;   // empty until the file's message or a DataTransferEvent was seen
+    std::string author;          // empty until the file's message was seen
+    int64_t bytesPerSecond = 0;  // smoothed throughput, 0 when unknown
+    double etaSeconds = -1;      // -1 when unknown
+};
+
+@interface JBTransferTracker : NSObject
+
++ (instancetype)shared;
+
+/// Called at most once per tick with the transfers whose progress changed, and
+/// once more for a transfer when it ends. Runs on the tracker's private queue.
+@property (nonatomic, copy, nullable) JBTransferProgressHandler progressHandler;
+
+/// Called from the DataTransferEvent handler (daemon thread)
+- (void)handleEvent:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId
+      interactionId:(const std::string&)interactionId
+             fileId:(const std::string&)fileId
+          eventCode:(int)eventCode;
+
+/// Message signal handlers (daemon thread): file messages give the author and
+/// interaction reported with their transfers
+- (void)noteMessages:(const std::vector<libjami::SwarmMessage>&)messages;
+- (void)noteMessage:(const libjami::SwarmMessage&)message;
+
+/// Preprocessing of a file before it is sent, reported through progressHandler
+/// like a transfer with JBFileTransferFlagPreparing; `prepareId` stands in for
+/// the fileId and the interactionId is empty, so the item is keyed by its path
+/// (`sourcePath`, the one given to sendFile). Progress is `fraction` of the
+/// source file's size, etaSeconds is 0 once `finished`.
+- (void)preparationProgress:(NSString *)prepareId
+                  accountId:(NSString *)accountId
+             conversationId:(NSString *)conversationId
+                 sourcePath:(NSString *)sourcePath
+                  totalSize:(int64_t)totalSize
+                   fraction:(double)fraction
+                   finished:(BOOL)finished;
+
+/// Estimates are only known while the transfer is followed (ongoing)
+- (JBTrackedTransfer)trackedTransferForFileId:(const std::string&)fileId;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,309 @@
+//
+//  JBTransferTracker.mm
+//  GetTogether
+//
+//  All state lives on one serial queue. The timer is one-shot and re-armed for
+//  the earliest due sample, so it does not exist at all while nothing is
+//  ongoing. A transfer that did not move since its last sample is sampled half
+//  as often each time (down to kMaxInterval); any progress resets it.
+//
+
+#import "JBTransferTracker.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+#include "JBStringInterner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "conversation_interface.h"
+#include "datatransfer_interface.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kMinInterval = std::chrono::milliseconds(250);
+constexpr auto kMaxInterval = std::chrono::seconds(2);
+constexpr auto kTimerLeeway = std::chrono::milliseconds(50);
+// Weight of the newest sample in the throughput average
+constexpr double kRateSmoothing = 0.3;
+
+// File messages seen, simply dropped when full
+constexpr size_t kMaxKnownFiles = 4096;
+constexpr std::string_view kFileMessageType = "application/data-transfer+json";
+
+using Code = libjami::DataTransferEventCode;
+
+bool isTerminal(int eventCode) {
+    return eventCode == (int)Code::invalid || eventCode == (int)Code::unsupported
+        || eventCode >= (int)Code::finished;
+}
+
+std::string bodyField(const libjami::SwarmMessage& message, const char *key) {
+    auto it = message.body.find(key);
+    return it != message.body.end() ? it->second : std::string();
+}
+
+// From the file's message, outliving its transfer
+struct KnownFile {
+    std::string interactionId;
+    std::string author;
+};
+
+struct Transfer {
+    std::string accountId;
+    std::string conversationId;
+    std::string interactionId;
+    std::string path;
+    int event = (int)Code::invalid;
+    int64_t total = 0;
+    int64_t progress = 0;
+    double bytesPerSecond = 0;
+    double etaSeconds = -1;
+    bool sampled = false;
+    Clock::time_point lastSample;
+    Clock::time_point nextSample;
+    Clock::duration interval = kMinInterval;
+};
+
+} // namespace
+
+@implementation JBTransferTracker {
+    dispatch_queue_t _queue;
+    dispatch_source_t _timer;
+    std::unordered_map<std::string, Transfer> _transfers;
+    std::unordered_map<std::string, KnownFile> _files; // by fileId
+}
+
++ (instancetype)shared {
+    static JBTransferTracker *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBTransferTracker alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+            DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("net.jami.bridge.transfers", attr);
+    }
+    return self;
+}
+
+#pragma mark - Events
+
+- (void)handleEvent:(const std::string&)accountId
+     conversationId:(const std::string&)conversationId
+      interactionId:(const std::string&)interactionId
+             fileId:(const std::string&)fileId
+          eventCode:(int)eventCode {
+    // Blocks capture reference parameters by reference: copy them first
+    std::string accountIdCopy = accountId;
+    std::string conversationIdCopy = conversationId;
+    std::string interactionIdCopy = interactionId;
+    std::string fileIdCopy = fileId;
+    dispatch_async(_queue, ^{
+        auto& transfer = self->_transfers[fileIdCopy];
+        transfer.accountId = accountIdCopy;
+        transfer.conversationId = conversationIdCopy;
+        transfer.interactionId = interactionIdCopy;
+        transfer.event = eventCode;
+
+        if (isTerminal(eventCode)) {
+            // Report the final state, then stop tracking
+            [self sample:fileIdCopy transfer:transfer now:Clock::now()];
+            if (eventCode == (int)Code::finished && transfer.total > 0) {
+                transfer.progress = transfer.total;
+            }
+            transfer.bytesPerSecond = 0;
+            transfer.etaSeconds = eventCode == (int)Code::finished ? 0 : -1;
+            [self report:@[[self infoFor:fileIdCopy transfer:transfer]]];
+            self->_transfers.erase(fileIdCopy);
+            FILE_LOG_D("Transfers", @"Transfer %s ended with %d (%zu tracked)",
+                       fileIdCopy.c_str(), eventCode, self->_transfers.size());
+        } else if (eventCode == (int)Code::ongoing) {
+            transfer.interval = kMinInterval;
+            transfer.nextSample = Clock::now();
+        }
+        [self rearm];
+    });
+}
+
+- (void)noteMessage:(const libjami::SwarmMessage&)message {
+    if (message.type != kFileMessageType) return;
+    [self noteMessages:{message}];
+}
+
+- (void)noteMessages:(const std::vector<libjami::SwarmMessage>&)messages {
+    std::vector<std::pair<std::string, KnownFile>> files;
+    for (const auto& message : messages) {
+        if (message.type != kFileMessageType) continue;
+        std::string fileId = bodyField(message, "fileId");
+        if (!fileId.empty()) files.emplace_back(std::move(fileId), KnownFile {message.id, bodyField(message, "author")});
+    }
+    if (files.empty()) return;
+    dispatch_async(_queue, ^{
+        if (self->_files.size() + files.size() > kMaxKnownFiles) self->_files.clear();
+        for (const auto& [fileId, file] : files) self->_files[fileId] = file;
+    });
+}
+
+- (void)preparationProgress:(NSString *)prepareId
+                  accountId:(NSString *)accountId
+             conversationId:(NSString *)conversationId
+                 sourcePath:(NSString *)sourcePath
+                  totalSize:(int64_t)totalSize
+                   fraction:(double)fraction
+                   finished:(BOOL)finished {
+    JBFileTransferInfo *info = [[JBFileTransferInfo alloc] init];
+    info.accountId = accountId;
+    info.conversationId = conversationId;
+    info.interactionId = @"";
+    info.fileId = prepareId;
+    info.path = sourcePath;
+    info.displayName = [sourcePath lastPathComponent];
+    info.totalSize = totalSize;
+    info.progress = (int64_t)(std::clamp(finished ? 1.0 : fraction, 0.0, 1.0) * totalSize);
+    info.bytesPerSecond = 0;
+    info.etaSeconds = finished ? 0 : -1;
+    info.author = @"";
+    info.flags = JBFileTransferFlagPreparing;
+    // Same queue as the transfer reports, so a file's preparation comes first
+    dispatch_async(_queue, ^{
+        [self report:@[info]];
+    });
+}
+
+#pragma mark - Sampling (on _queue)
+
+/// Updates `transfer` from the daemon, returns whether the progress moved
+- (bool)sample:(const std::string&)fileId transfer:(Transfer&)transfer now:(Clock::time_point)now {
+    std::string path;
+    int64_t total = 0;
+    int64_t progress = 0;
+    auto err = libjami::fileTransferInfo(transfer.accountId, transfer.conversationId,
+                                         fileId, path, total, progress);
+    if (err != libjami::DataTransferError::success) return false;
+
+    bool moved = progress != transfer.progress;
+    if (transfer.sampled) {
+        double dt = std::chrono::duration<double>(now - transfer.lastSample).count();
+        if (dt > 0) {
+            double instant = std::max<int64_t>(progress - transfer.progress, 0) / dt;
+            transfer.bytesPerSecond = transfer.bytesPerSecond == 0
+                ? instant
+                : transfer.bytesPerSecond + kRateSmoothing * (instant - transfer.bytesPerSecond);
+            if (transfer.bytesPerSecond < 1) transfer.bytesPerSecond = 0;
+        }
+    }
+    transfer.path = std::move(path);
+    transfer.total = total;
+    transfer.progress = progress;
+    transfer.lastSample = now;
+    transfer.sampled = true;
+    transfer.etaSeconds = (transfer.bytesPerSecond > 0 && total > progress)
+        ? (total - progress) / transfer.bytesPerSecond
+        : -1;
+    return moved;
+}
+
+- (void)tick {
+    auto now = Clock::now();
+    NSMutableArray<JBFileTransferInfo *> *changed = [NSMutableArray array];
+    for (auto& [fileId, transfer] : _transfers) {
+        if (transfer.event != (int)Code::ongoing || transfer.nextSample > now) continue;
+        double previousRate = transfer.bytesPerSecond;
+        bool moved = [self sample:fileId transfer:transfer now:now];
+        transfer.interval = moved ? kMinInterval : std::min<Clock::duration>(transfer.interval * 2, kMaxInterval);
+        transfer.nextSample = now + transfer.interval;
+        // A stalled transfer is reported while its estimate still changes
+        if (moved || transfer.bytesPerSecond != previousRate) {
+            [changed addObject:[self infoFor:fileId transfer:transfer]];
+        }
+    }
+    if (changed.count > 0) [self report:changed];
+    [self rearm];
+}
+
+/// Arms the timer for the earliest due sample, or drops it when nothing is ongoing
+- (void)rearm {
+    auto next = Clock::time_point::max();
+    for (const auto& [fileId, transfer] : _transfers) {
+        if (transfer.event == (int)Code::ongoing) next = std::min(next, transfer.nextSample);
+    }
+    if (next == Clock::time_point::max()) {
+        if (_timer) {
+            dispatch_source_cancel(_timer);
+            _timer = nil;
+        }
+        return;
+    }
+    if (!_timer) {
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        __weak JBTransferTracker *weakSelf = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weakSelf tick];
+        });
+        dispatch_resume(_timer);
+    }
+    auto delay = std::max<Clock::duration>(next - Clock::now(), Clock::duration::zero());
+    dispatch_source_set_timer(_timer,
+                              dispatch_time(DISPATCH_TIME_NOW, std::chrono::nanoseconds(delay).count()),
+                              DISPATCH_TIME_FOREVER,
+                              std::chrono::nanoseconds(kTimerLeeway).count());
+}
+
+- (JBFileTransferInfo *)infoFor:(const std::string&)fileId transfer:(const Transfer&)transfer {
+    JBFileTransferInfo *info = [[JBFileTransferInfo alloc] init];
+    info.accountId = toNSIdentifier(transfer.accountId);
+    info.conversationId = toNSIdentifier(transfer.conversationId);
+    info.interactionId = toNSString(transfer.interactionId);
+    info.fileId = toNSString(fileId);
+    info.path = toNSString(transfer.path);
+    info.displayName = [info.path lastPathComponent];
+    info.totalSize = transfer.total;
+    info.progress = transfer.progress;
+    info.bytesPerSecond = (int64_t)transfer.bytesPerSecond;
+    info.etaSeconds = transfer.etaSeconds;
+    auto file = _files.find(fileId);
+    info.author = file != _files.end() && !file->second.author.empty() ? toNSIdentifier(file->second.author) : @"";
+    info.flags = 0;
+    return info;
+}
+
+- (void)report:(NSArray<JBFileTransferInfo *> *)transfers {
+    JBTransferProgressHandler handler = self.progressHandler;
+    if (handler) handler(transfers);
+}
+
+#pragma mark - Queries
+
+- (JBTrackedTransfer)trackedTransferForFileId:(const std::string&)fileId {
+    __block JBTrackedTransfer result;
+    // Reference parameter: the block captures it by reference, fine for a sync call
+    dispatch_sync(_queue, ^{
+        auto transfer = self->_transfers.find(fileId);
+        if (transfer != self->_transfers.end()) {
+            result.interactionId = transfer->second.interactionId;
+            result.bytesPerSecond = (int64_t)transfer->second.bytesPerSecond;
+            result.etaSeconds = transfer->second.etaSeconds;
+        }
+        auto file = self->_files.find(fileId);
+        if (file != self->_files.end()) {
+            if (result.interactionId.empty()) result.interactionId = file->second.interactionId;
+            result.author = file->second.author;
+        }
+    });
+    return result;
+}
+
+@end
@@ -0,0 +1,30 @@
+//
+//  JBVCardParser.h
+//  GetTogether
+//
+//  Single-pass vCard (3.0/4.0) scan for the two properties the bridge needs:
+//  FN and PHOTO. The photo is returned as a view into the caller's buffer
+//  (still base64, possibly folded) so a large card is never copied; only the
+//  display name is unfolded and unescaped.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+#include <string_view>
+
+struct JBVCardFields {
+    std::string formattedName;
+    // Base64 payload of a PHOTO with ENCODING=b/BASE64 or a data: URI, folding included
+    std::string_view photoBase64;
+};
+
+// Parses the first card in `vcard`. Returns false if it holds no BEGIN:VCARD.
+bool parseVCard(std::string_view vcard, JBVCardFields& fields);
+
+// Decodes standard or URL-safe base64, skipping whitespace and line folds.
+// Returns nil on invalid input.
+NSData* decodeBase64(std::string_view base64);
@@ -0,0 +1,163 @@
+//
+//  JBVCardParser.mm
+//  GetTogether
+//
+//  Content lines are located in place: for each logical line (a physical line
+//  plus its space/tab-indented continuations) only the name and parameters
+//  are inspected, and the value stays a range of the input. Property names
+//  and parameters are case-insensitive; group prefixes ("item1.FN") are ignored.
+//
+
+#import "JBVCardParser.h"
+
+#include <array>
+#include <cctype>
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+bool startsWithIgnoreCase(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && equalsIgnoreCase(s.substr(0, prefix.size()), prefix);
+}
+
+bool containsIgnoreCase(std::string_view s, std::string_view needle) {
+    if (needle.size() > s.size()) return false;
+    for (size_t i = 0; i + needle.size() <= s.size(); ++i) {
+        if (equalsIgnoreCase(s.substr(i, needle.size()), needle)) return true;
+    }
+    return false;
+}
+
+// End of the logical line starting at `pos` (index of its final line break or size)
+size_t logicalLineEnd(std::string_view vcard, size_t pos) {
+    while (true) {
+        size_t nl = vcard.find('\n', pos);
+        if (nl == std::string_view::npos) return vcard.size();
+        if (nl + 1 < vcard.size() && (vcard[nl + 1] == ' ' || vcard[nl + 1] == '\t')) {
+            pos = nl + 1;
+            continue;
+        }
+        return nl;
+    }
+}
+
+// Unfolds and unescapes a text value (\n, \, \; \\)
+std::string unfoldText(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '\r') continue;
+        if (c == '\n') {
+            // Fold: drop the break and the single leading whitespace
+            if (i + 1 < value.size() && (value[i + 1] == ' ' || value[i + 1] == '\t')) ++i;
+            continue;
+        }
+        if (c == '\\' && i + 1 < value.size()) {
+            char next = value[++i];
+            out.push_back(next == 'n' || next == 'N' ? '\n' : next);
+            continue;
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+// Photo value to its base64 payload, or empty if the photo is not inline
+std::string_view inlinePhoto(std::string_view params, std::string_view value) {
+    if (startsWithIgnoreCase(value, "data:")) {
+        size_t comma = value.find(',');
+        if (comma == std::string_view::npos) return {};
+        if (!containsIgnoreCase(value.substr(0, comma), ";base64")) return {};
+        return value.substr(comma + 1);
+    }
+    if (containsIgnoreCase(params, "ENCODING=b") || containsIgnoreCase(params, "ENCODING=BASE64")) {
+        return value;
+    }
+    return {};
+}
+
+} // namespace
+
+bool parseVCard(std::string_view vcard, JBVCardFields& fields) {
+    bool inCard = false;
+    bool haveName = false;
+    size_t pos = 0;
+    while (pos < vcard.size()) {
+        size_t end = logicalLineEnd(vcard, pos);
+        std::string_view line = vcard.substr(pos, end - pos);
+        pos = end + 1;
+
+        // Name and parameters end at the first ':' outside a quoted parameter value
+        size_t colon = std::string_view::npos;
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '"') quoted = !quoted;
+            else if (line[i] == ':' && !quoted) { colon = i; break; }
+        }
+        if (colon == std::string_view::npos) continue;
+        std::string_view head = line.substr(0, colon);
+        std::string_view value = line.substr(colon + 1);
+        if (!value.empty() && value.back() == '\r') value.remove_suffix(1);
+
+        size_t semicolon = head.find(';');
+        std::string_view name = head.substr(0, semicolon);
+        std::string_view params = semicolon == std::string_view::npos ? std::string_view() : head.substr(semicolon);
+        size_t dot = name.rfind('.');
+        if (dot != std::string_view::npos) name.remove_prefix(dot + 1);
+
+        if (!inCard) {
+            inCard = equalsIgnoreCase(name, "BEGIN") && equalsIgnoreCase(value, "VCARD");
+            continue;
+        }
+        if (equalsIgnoreCase(name, "END")) break;
+        if (!haveName && equalsIgnoreCase(name, "FN")) {
+            fields.formattedName = unfoldText(value);
+            haveName = true;
+        } else if (fields.photoBase64.empty() && equalsIgnoreCase(name, "PHOTO")) {
+            fields.photoBase64 = inlinePhoto(params, value);
+        }
+    }
+    return inCard;
+}
+
+NSData* decodeBase64(std::string_view base64) {
+    static const std::array<int8_t, 256> table = [] {
+        std::array<int8_t, 256> t;
+        t.fill(-1);
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) t[(unsigned char)alphabet[i]] = (int8_t)i;
+        t['-'] = 62;
+        t['_'] = 63;
+        return t;
+    }();
+
+    NSMutableData *data = [NSMutableData dataWithLength:base64.size() / 4 * 3 + 3];
+    uint8_t *out = (uint8_t *)data.mutableBytes;
+    size_t length = 0;
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (char c : base64) {
+        if (c == '=') break;
+        int8_t v = table[(unsigned char)c];
+        if (v < 0) {
+            if (std::isspace((unsigned char)c)) continue;
+            return nil;
+        }
+        accumulator = (accumulator << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[length++] = (uint8_t)(accumulator >> bits);
+        }
+    }
+    data.length = length;
+    return data;
+}
@@ -0,0 +1,47 @@
+//
+//  JBVideoSinkManager.h
+//  GetTogether
+//
+//  Zero-copy video sink pipeline: registers libjami SinkTargets whose frames
+//  are backed by IOSurface CVPixelBuffers and enqueues them straight onto an
+//  AVSampleBufferDisplayLayer from the daemon's sink thread.
+//  Internal header - must not be included from JamiBridgeWrapper.h (cinterop).
+//
+
+#import <Foundation/Foundation.h>
+#import <AVFoundation/AVFoundation.h>
+
+#include <string>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface JBVideoSinkManager : NSObject
+
++ (instancetype)shared;
+
+/// Binds a display layer to a sink. Rendering starts as soon as the daemon
+/// reports DecodingStarted for the sink (immediately if it already did).
+- (void)attachLayer:(AVSampleBufferDisplayLayer *)layer toSink:(NSString *)sinkId;
+
+/// Unbinds the layer and unregisters the SinkTarget from the daemon.
+- (void)detachSink:(NSString *)sinkId;
+
+/// Size in pixels at which the sink is displayed. Frames are scaled down to it
+/// by the daemon, so the pool never holds buffers larger than the screen needs.
+- (void)setDisplaySize:(CGSize)size forSink:(NSString *)sinkId;
+
+/// Hidden sinks keep their layer (and last image) but are unregistered from the
+/// daemon until they are visible again. Sinks are visible by default.
+- (void)setVisible:(BOOL)visible forSink:(const std::string&)sinkId;
+
+/// Memory pressure: frees the pools of sinks not receiving frames and the
+/// unused buffers of the others. Pools are recreated on the next frame.
+- (void)trimPools;
+
+// Called from the daemon signal handlers (daemon threads)
+- (void)decodingStarted:(const std::string&)sinkId width:(int)width height:(int)height;
+- (void)decodingStopped:(const std::string&)sinkId;
+
+@end
+
+NS_ASSUME_NONNULL_END
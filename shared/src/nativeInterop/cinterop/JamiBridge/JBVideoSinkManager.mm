@@ -0,0 +1,431 @@
+//
+//  JBVideoSinkManager.mm
+//  GetTogether
+//
+//  Frame flow for a registered sink:
+//
+//    pull()  -> CVPixelBuffer from the sink's IOSurface pool, locked and
+//               wrapped in an AVFrame (NV12 planes point into the buffer)
+//    daemon  -> scales/converts the decoded picture directly into it
+//    push()  -> unlock, wrap in a CMSampleBuffer, enqueue on the layer
+//
+//  Hardware-decoded frames (AV_PIX_FMT_VIDEOTOOLBOX) already carry a
+//  CVPixelBuffer in data[3] and are enqueued as-is. No CPU copy and no
+//  main-queue hop happens in either case.
+//
+
+#import "JBVideoSinkManager.h"
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+
+#import <CoreMedia/CoreMedia.h>
+#import <CoreVideo/CoreVideo.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "videomanager_interface.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+// Pool buffers allowed in flight per sink before pull() starts dropping frames
+static const int kPoolAllocationThreshold = 4;
+
+namespace {
+
+// Ownership record for a pool buffer handed to the daemon inside an AVFrame
+struct PoolFrameContext {
+    CVPixelBufferRef pixelBuffer;
+    bool locked;
+};
+
+void releasePoolFrame(void* opaque, uint8_t* /*data*/) {
+    auto* ctx = static_cast<PoolFrameContext*>(opaque);
+    if (ctx->locked) {
+        CVPixelBufferUnlockBaseAddress(ctx->pixelBuffer, 0);
+    }
+    CVPixelBufferRelease(ctx->pixelBuffer);
+    delete ctx;
+}
+
+struct VideoSink {
+    std::string sinkId;
+    std::mutex mutex;
+
+    __weak AVSampleBufferDisplayLayer* layer {nil};
+    bool decoding {false};
+    bool registered {false};
+    // Off-screen conference streams keep their layer but no SinkTarget
+    bool visible {true};
+
+    int decodeWidth {0};
+    int decodeHeight {0};
+    int displayWidth {0};
+    int displayHeight {0};
+
+    CVPixelBufferPoolRef pool {nullptr};
+    int poolWidth {0};
+    int poolHeight {0};
+    CMVideoFormatDescriptionRef formatDescription {nullptr};
+
+    ~VideoSink() { releasePool(); }
+
+    void releasePool() {
+        if (pool) {
+            CVPixelBufferPoolFlush(pool, kCVPixelBufferPoolFlushExcessBuffers);
+            CVPixelBufferPoolRelease(pool);
+            pool = nullptr;
+        }
+        if (formatDescription) {
+            CFRelease(formatDescription);
+            formatDescription = nullptr;
+        }
+        poolWidth = poolHeight = 0;
+    }
+
+    // Decoded size, scaled down (aspect preserved) to the display size when known.
+    // NV12 needs even dimensions.
+    void outputSize(int& width, int& height) const {
+        width = decodeWidth;
+        height = decodeHeight;
+        if (displayWidth > 0 && displayHeight > 0 && width > displayWidth && height > displayHeight) {
+            double scale = std::max((double)displayWidth / width, (double)displayHeight / height);
+            width = (int)(width * scale);
+            height = (int)(height * scale);
+        }
+        width &= ~1;
+        height &= ~1;
+    }
+
+    // Must be called with mutex held
+    bool ensurePool() {
+        int width, height;
+        outputSize(width, height);
+        if (width <= 0 || height <= 0) return false;
+        if (pool && width == poolWidth && height == poolHeight) return true;
+
+        releasePool();
+        NSDictionary *poolAttributes = @{
+            (id)kCVPixelBufferPoolMinimumBufferCountKey: @3,
+        };
+        NSDictionary *bufferAttributes = @{
+            (id)kCVPixelBufferPixelFormatTypeKey: @(kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange),
+            (id)kCVPixelBufferWidthKey: @(width),
+            (id)kCVPixelBufferHeightKey: @(height),
+            (id)kCVPixelBufferIOSurfacePropertiesKey: @{},
+            (id)kCVPixelBufferMetalCompatibilityKey: @YES,
+        };
+        CVReturn ret = CVPixelBufferPoolCreate(kCFAllocatorDefault,
+                                               (__bridge CFDictionaryRef)poolAttributes,
+                                               (__bridge CFDictionaryRef)bufferAttributes,
+                                               &pool);
+        if (ret != kCVReturnSuccess) {
+            FILE_LOG_E("VideoSink", @"CVPixelBufferPoolCreate failed for %s (%dx%d): %d",
+                       sinkId.c_str(), width, height, ret);
+            pool = nullptr;
+            return false;
+        }
+        poolWidth = width;
+        poolHeight = height;
+        FILE_LOG_I("VideoSink", @"Pool ready for %s: %dx%d (decoded %dx%d)",
+                   sinkId.c_str(), width, height, decodeWidth, decodeHeight);
+        return true;
+    }
+};
+
+libjami::FrameBuffer pullFrame(VideoSink& sink) {
+    CVPixelBufferRef pixelBuffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sink.mutex);
+        if (!sink.layer || !sink.ensurePool()) return {};
+        NSDictionary *aux = @{ (id)kCVPixelBufferPoolAllocationThresholdKey: @(kPoolAllocationThreshold) };
+        CVReturn ret = CVPixelBufferPoolCreatePixelBufferWithAuxAttributes(kCFAllocatorDefault,
+                                                                           sink.pool,
+                                                                           (__bridge CFDictionaryRef)aux,
+                                                                           &pixelBuffer);
+        if (ret != kCVReturnSuccess) {
+            // kCVReturnWouldExceedAllocationThreshold: the renderer is behind, drop this frame
+            return {};
+        }
+    }
+
+    if (CVPixelBufferLockBaseAddress(pixelBuffer, 0) != kCVReturnSuccess) {
+        CVPixelBufferRelease(pixelBuffer);
+        return {};
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    if (!frame) {
+        CVPixelBufferUnlockBaseAddress(pixelBuffer, 0);
+        CVPixelBufferRelease(pixelBuffer);
+        return {};
+    }
+    frame->format = AV_PIX_FMT_NV12;
+    frame->width = (int)CVPixelBufferGetWidth(pixelBuffer);
+    frame->height = (int)CVPixelBufferGetHeight(pixelBuffer);
+    for (size_t plane = 0; plane < 2; plane++) {
+        frame->data[plane] = static_cast<uint8_t*>(CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, plane));
+        frame->linesize[plane] = (int)CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, plane);
+    }
+
+    auto* ctx = new PoolFrameContext {pixelBuffer, true};
+    frame->buf[0] = av_buffer_create(frame->data[0],
+                                     CVPixelBufferGetDataSize(pixelBuffer),
+                                     releasePoolFrame, ctx, 0);
+    if (!frame->buf[0]) {
+        releasePoolFrame(ctx, nullptr);
+        av_frame_free(&frame);
+        return {};
+    }
+    frame->opaque = ctx;
+    return libjami::FrameBuffer(frame);
+}
+
+CVPixelBufferRef pixelBufferForFrame(AVFrame* frame) {
+    if (frame->format == AV_PIX_FMT_VIDEOTOOLBOX) {
+        // Hardware decoder output, the IOSurface is in data[3]
+        return reinterpret_cast<CVPixelBufferRef>(frame->data[3]);
+    }
+    // One of our pool frames: buf[0] was created by pullFrame() with ctx as opaque
+    if (frame->opaque && frame->buf[0] && av_buffer_get_opaque(frame->buf[0]) == frame->opaque) {
+        auto* ctx = static_cast<PoolFrameContext*>(frame->opaque);
+        if (ctx->locked) {
+            CVPixelBufferUnlockBaseAddress(ctx->pixelBuffer, 0);
+            ctx->locked = false;
+        }
+        return ctx->pixelBuffer;
+    }
+    return nullptr;
+}
+
+void pushFrame(VideoSink& sink, libjami::FrameBuffer frame) {
+    if (!frame) return;
+    CVPixelBufferRef pixelBuffer = pixelBufferForFrame(frame.get());
+    if (!pixelBuffer) return;
+
+    AVSampleBufferDisplayLayer *layer = nil;
+    CMVideoFormatDescriptionRef formatDescription = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sink.mutex);
+        layer = sink.layer;
+        if (!layer) return;
+        if (!sink.formatDescription
+            || !CMVideoFormatDescriptionMatchesImageBuffer(sink.formatDescription, pixelBuffer)) {
+            if (sink.formatDescription) CFRelease(sink.formatDescription);
+            sink.formatDescription = nullptr;
+            if (CMVideoFormatDescriptionCreateForImageBuffer(kCFAllocatorDefault, pixelBuffer,
+                                                             &sink.formatDescription) != noErr) {
+                return;
+            }
+        }
+        formatDescription = (CMVideoFormatDescriptionRef)CFRetain(sink.formatDescription);
+    }
+
+    if (layer.status == AVQueuedSampleBufferRenderingStatusFailed) {
+        FILE_LOG_W("VideoSink", @"Layer failed for %s: %@, flushing", sink.sinkId.c_str(), layer.error);
+        [layer flush];
+    }
+    if (!layer.isReadyForMoreMediaData) {
+        // Never queue behind the display, a late frame is worse than a dropped one
+        CFRelease(formatDescription);
+        return;
+    }
+
+    CMSampleTimingInfo timing = {kCMTimeInvalid, kCMTimeInvalid, kCMTimeInvalid};
+    CMSampleBufferRef sampleBuffer = nullptr;
+    OSStatus status = CMSampleBufferCreateReadyWithImageBuffer(kCFAllocatorDefault, pixelBuffer,
+                                                               formatDescription, &timing,
+                                                               &sampleBuffer);
+    CFRelease(formatDescription);
+    if (status != noErr || !sampleBuffer) return;
+
+    CFArrayRef attachments = CMSampleBufferGetSampleAttachmentsArray(sampleBuffer, true);
+    if (attachments && CFArrayGetCount(attachments) > 0) {
+        auto dict = (CFMutableDictionaryRef)CFArrayGetValueAtIndex(attachments, 0);
+        CFDictionarySetValue(dict, kCMSampleAttachmentKey_DisplayImmediately, kCFBooleanTrue);
+    }
+    [layer enqueueSampleBuffer:sampleBuffer];
+    CFRelease(sampleBuffer);
+    // frame goes out of scope here: the pool buffer is released, the sample buffer keeps its own reference
+}
+
+} // namespace
+
+@implementation JBVideoSinkManager {
+    std::mutex _mutex;
+    std::map<std::string, std::shared_ptr<VideoSink>> _sinks;
+}
+
++ (instancetype)shared {
+    static JBVideoSinkManager *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[JBVideoSinkManager alloc] init];
+    });
+    return instance;
+}
+
+- (std::shared_ptr<VideoSink>)sinkForId:(const std::string&)sinkId create:(BOOL)create {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _sinks.find(sinkId);
+    if (it != _sinks.end()) return it->second;
+    if (!create) return nullptr;
+    auto sink = std::make_shared<VideoSink>();
+    sink->sinkId = sinkId;
+    _sinks.emplace(sinkId, sink);
+    return sink;
+}
+
+- (void)trimPools {
+    std::vector<std::shared_ptr<VideoSink>> sinks;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& entry : _sinks) sinks.push_back(entry.second);
+    }
+    for (const auto& sink : sinks) {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        if (!sink->registered) {
+            sink->releasePool();
+        } else if (sink->pool) {
+            CVPixelBufferPoolFlush(sink->pool, kCVPixelBufferPoolFlushExcessBuffers);
+        }
+    }
+}
+
+- (void)releaseSinkIfUnused:(const std::shared_ptr<VideoSink>&)sink {
+    {
+        std::lock_guard<std::mutex> sinkLock(sink->mutex);
+        if (sink->layer || sink->decoding || !sink->visible) return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _sinks.find(sink->sinkId);
+    if (it != _sinks.end() && it->second == sink) {
+        _sinks.erase(it);
+    }
+}
+
+// Never called with a sink mutex held: the daemon may be inside pull()/push()
+// holding its own sink lock while waiting for ours.
+- (void)registerTarget:(const std::shared_ptr<VideoSink>&)sink {
+    std::weak_ptr<VideoSink> weakSink = sink;
+    libjami::SinkTarget target;
+    target.pull = [weakSink]() -> libjami::FrameBuffer {
+        if (auto s = weakSink.lock()) return pullFrame(*s);
+        return {};
+    };
+    target.push = [weakSink](libjami::FrameBuffer frame) {
+        if (auto s = weakSink.lock()) pushFrame(*s, std::move(frame));
+    };
+    target.preferredFormat = AV_PIX_FMT_NV12;
+
+    bool ok = libjami::registerSinkTarget(sink->sinkId, std::move(target));
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        sink->registered = ok;
+    }
+    FILE_LOG_I("VideoSink", @"registerSinkTarget %s: %d", sink->sinkId.c_str(), ok);
+}
+
+- (void)unregisterTarget:(const std::shared_ptr<VideoSink>&)sink {
+    libjami::registerSinkTarget(sink->sinkId, {});
+    std::lock_guard<std::mutex> lock(sink->mutex);
+    sink->registered = false;
+    sink->releasePool();
+}
+
+- (void)attachLayer:(AVSampleBufferDisplayLayer *)layer toSink:(NSString *)sinkId {
+    auto sink = [self sinkForId:toCppString(sinkId) create:YES];
+    bool shouldRegister;
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        sink->layer = layer;
+        shouldRegister = sink->decoding && sink->visible && !sink->registered;
+    }
+    [layer flush];
+    if (shouldRegister) {
+        [self registerTarget:sink];
+    }
+}
+
+- (void)detachSink:(NSString *)sinkId {
+    auto sink = [self sinkForId:toCppString(sinkId) create:NO];
+    if (!sink) return;
+    AVSampleBufferDisplayLayer *layer;
+    bool wasRegistered;
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        layer = sink->layer;
+        sink->layer = nil;
+        wasRegistered = sink->registered;
+    }
+    if (wasRegistered) {
+        [self unregisterTarget:sink];
+    }
+    [layer flushAndRemoveImage];
+    [self releaseSinkIfUnused:sink];
+}
+
+- (void)setDisplaySize:(CGSize)size forSink:(NSString *)sinkId {
+    auto sink = [self sinkForId:toCppString(sinkId) create:YES];
+    std::lock_guard<std::mutex> lock(sink->mutex);
+    sink->displayWidth = (int)size.width;
+    sink->displayHeight = (int)size.height;
+    // The pool is re-created lazily on the next pull() if the output size changed
+}
+
+- (void)decodingStarted:(const std::string&)sinkId width:(int)width height:(int)height {
+    auto sink = [self sinkForId:sinkId create:YES];
+    bool shouldRegister;
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        sink->decoding = true;
+        sink->registered = false;  // The daemon created a new sink client
+        sink->decodeWidth = width;
+        sink->decodeHeight = height;
+        shouldRegister = sink->layer != nil && sink->visible;
+    }
+    if (shouldRegister) {
+        [self registerTarget:sink];
+    }
+}
+
+- (void)setVisible:(BOOL)visible forSink:(const std::string&)sinkId {
+    auto sink = [self sinkForId:sinkId create:visible ? NO : YES];
+    if (!sink) return;
+    bool shouldRegister;
+    bool shouldUnregister;
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        if (sink->visible == (bool)visible) return;
+        sink->visible = visible;
+        shouldRegister = visible && sink->decoding && sink->layer && !sink->registered;
+        shouldUnregister = !visible && sink->registered;
+    }
+    if (shouldRegister) {
+        [self registerTarget:sink];
+    } else if (shouldUnregister) {
+        // The daemon stops scaling and converting frames for the sink
+        [self unregisterTarget:sink];
+    }
+    if (visible) [self releaseSinkIfUnused:sink];
+}
+
+- (void)decodingStopped:(const std::string&)sinkId {
+    auto sink = [self sinkForId:sinkId create:NO];
+    if (!sink) return;
+    {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        sink->decoding = false;
+        sink->registered = false;
+        sink->releasePool();
+    }
+    [self releaseSinkIfUnused:sink];
+}
+
+@end
@@ -7,6 +7,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import <AVFoundation/AVFoundation.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -68,6 +69,49 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
     JBMemberEventTypeUnban
 };
 
+/// Progress of -startDaemonAsyncWithDataPath: (and of the synchronous calls)
+typedef NS_ENUM(NSInteger, JBDaemonStage) {
+    JBDaemonStageStopped,
+    JBDaemonStageStarting,           // Startup queued, libjami::init not done yet
+    JBDaemonStageInitialized,        // libjami::init done, signal handlers registered
+    JBDaemonStageAccountsLoaded,     // libjami::start returned: accounts and repos loaded
+    JBDaemonStageAccountRegistered,  // First account reached REGISTERED
+    JBDaemonStageFailed
+};
+
+/// JBFileTransferInfo.flags: bit 0 is libjami's direction, bridge bits above it
+typedef NS_OPTIONS(NSInteger, JBFileTransferFlag) {
+    JBFileTransferFlagIncoming = 1 << 0,
+    JBFileTransferFlagPreparing = 1 << 8   // Image/video being preprocessed before sending
+};
+
+typedef NS_ENUM(NSInteger, JBImageFormat) {
+    JBImageFormatJPEG,
+    JBImageFormatHEIC
+};
+
+typedef NS_ENUM(NSInteger, JBVideoPreset) {
+    JBVideoPresetOriginal,   // Sent as picked
+    JBVideoPreset540p,
+    JBVideoPreset720p,
+    JBVideoPreset1080p
+};
+
+/// What a memory trim keeps, see memoryMetricsSnapshot
+typedef NS_ENUM(NSInteger, JBMemoryTier) {
+    JBMemoryTierBackground,   // App backgrounded or pressure warning: a few hot conversations, trimmed caches
+    JBMemoryTierCritical      // Memory warning or critical pressure: the hottest conversation, empty caches
+};
+
+/// Delegate callbacks are delivered on one serial queue per domain.
+typedef NS_ENUM(NSInteger, JBSignalDomain) {
+    JBSignalDomainCall,           // Call state, media, conferences (user-interactive QoS)
+    JBSignalDomainConversation,   // Swarm messages, requests, members, reactions
+    JBSignalDomainConfiguration,  // Accounts, devices, contacts, name lookups
+    JBSignalDomainPresence,       // Buddy presence, composing status
+    JBSignalDomainVideo           // Decoding and capture start/stop
+};
+
 // =============================================================================
 // Data Classes
 // =============================================================================
@@ -103,19 +147,61 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 @property (nonatomic, copy) NSString *address;
 @property (nonatomic, copy) NSString *name;
 @property (nonatomic, assign) JBLookupState state;
+/// Name or address that was looked up
+@property (nonatomic, copy) NSString *query;
+@end
+
+typedef void (^JBLookupCompletion)(JBLookupResult *result);
+
+/// Info and members of one conversation, as returned by -snapshotAccount:
+@interface JBConversationSnapshot : NSObject
+@property (nonatomic, copy) NSString *conversationId;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *info;
+@property (nonatomic, strong) NSArray<JBConversationMember *> *members;
+@end
+
+/// Everything needed to show an account and its conversation list
+@interface JBAccountSnapshot : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *details;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *volatileDetails;
+@property (nonatomic, strong) NSArray<JBContact *> *contacts;
+@property (nonatomic, strong) NSArray<JBConversationSnapshot *> *conversations;
+@property (nonatomic, strong) NSArray<JBConversationRequest *> *conversationRequests;
+@property (nonatomic, strong) NSArray<JBTrustRequest *> *trustRequests;
 @end
 
 @interface JBFileTransferInfo : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *conversationId;
+@property (nonatomic, copy) NSString *interactionId;
 @property (nonatomic, copy) NSString *fileId;
 @property (nonatomic, copy) NSString *path;
 @property (nonatomic, copy) NSString *displayName;
 @property (nonatomic, assign) int64_t totalSize;
 @property (nonatomic, assign) int64_t progress;
 @property (nonatomic, assign) int64_t bytesPerSecond;
+/// Estimated seconds to completion, -1 when unknown
+@property (nonatomic, assign) double etaSeconds;
 @property (nonatomic, copy) NSString *author;
 @property (nonatomic, assign) int flags;
 @end
 
+/// What sendFile does to images and videos before they reach the daemon.
+/// Read mediaSettings, change it and assign it back.
+@interface JBMediaSettings : NSObject
+/// Rewrite images and transcode videos (default YES)
+@property (nonatomic, assign) BOOL enabled;
+/// Longest image side in pixels (default 2048)
+@property (nonatomic, assign) int maxImageDimension;
+/// Default JPEG, which every client decodes
+@property (nonatomic, assign) JBImageFormat imageFormat;
+/// Lossy compression quality, 0...1 (default 0.8)
+@property (nonatomic, assign) double imageQuality;
+/// Default 720p; videos already at or below the preset are sent as is
+@property (nonatomic, assign) JBVideoPreset videoPreset;
+@end
+
 @interface JBSwarmMessage : NSObject
 @property (nonatomic, copy) NSString *messageId;
 @property (nonatomic, copy) NSString *type;
@@ -127,6 +213,114 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 @property (nonatomic, strong) NSDictionary<NSString *, NSNumber *> *status;
 @end
 
+/// A text message from the local index, see searchMessageIndex:accountId:limit:
+@interface JBIndexedMessage : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *conversationId;
+@property (nonatomic, copy) NSString *messageId;
+@property (nonatomic, copy) NSString *author;
+@property (nonatomic, copy) NSString *body;
+@property (nonatomic, assign) int64_t timestamp;
+@end
+
+/// Batched event types: each entry is the latest state for its key within a batch window
+@interface JBPresenceUpdate : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *uri;
+@property (nonatomic, assign) int status;
+@property (nonatomic, copy) NSString *lineStatus;
+@end
+
+@interface JBComposingUpdate : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *conversationId;
+@property (nonatomic, copy) NSString *from;
+@property (nonatomic, assign) BOOL isComposing;
+@end
+
+@interface JBMessageUpdate : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *conversationId;
+@property (nonatomic, strong) JBSwarmMessage *message;
+@end
+
+/// Delivery statistics of one daemon signal since start or the last reset.
+/// Conversion: handler entry until its delegate call is queued (or it returns).
+/// Queue wait: queued until the delivery block starts. Delegate: the delegate call.
+@interface JBSignalMetrics : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) uint64_t count;
+@property (nonatomic, assign) uint64_t deliveries;
+@property (nonatomic, assign) uint64_t bytesConverted;
+@property (nonatomic, assign) double conversionP50Micros;
+@property (nonatomic, assign) double conversionP99Micros;
+@property (nonatomic, assign) double queueWaitP50Micros;
+@property (nonatomic, assign) double queueWaitP99Micros;
+@property (nonatomic, assign) double delegateP50Micros;
+@property (nonatomic, assign) double delegateP99Micros;
+@end
+
+/// Memory trims since launch. Bytes are phys_footprint (what jetsam counts);
+/// reclaimed amounts are measured around each trim and can be negative.
+@interface JBMemoryMetrics : NSObject
+@property (nonatomic, assign) uint64_t trims;
+/// Conversations whose loaded history the daemon dropped (libjami::clearCache)
+@property (nonatomic, assign) uint64_t conversationsCleared;
+@property (nonatomic, assign) int64_t reclaimedBytes;
+@property (nonatomic, assign) int64_t lastReclaimedBytes;
+@property (nonatomic, assign) JBMemoryTier lastTier;
+@property (nonatomic, assign) int64_t footprintBytes;
+@end
+
+/// Signal deliveries of one account since start or the last reset, over all
+/// delivery queues. Wait: queued until the delivery started.
+@interface JBAccountQueueMetrics : NSObject
+@property (nonatomic, assign) uint64_t pending;
+@property (nonatomic, assign) uint64_t peakPending;
+@property (nonatomic, assign) uint64_t delivered;
+/// Call signals, delivered ahead of the account lanes
+@property (nonatomic, assign) uint64_t priorityDelivered;
+@property (nonatomic, assign) double maxWaitMs;
+@property (nonatomic, assign) uint32_t weight;
+@end
+
+/// A conference participant sink on screen, with its size in pixels
+@interface JBStreamVisibility : NSObject
+@property (nonatomic, copy) NSString *sinkId;
+@property (nonatomic, assign) int width;
+@property (nonatomic, assign) int height;
+@end
+
+/// Outcome of a notification service extension run, see handleExtensionPush:
+@interface JBExtensionResult : NSObject
+@property (nonatomic, copy) NSString *accountId;
+@property (nonatomic, copy) NSString *conversationId;
+/// Newest message of the pushed conversation, nil when none arrived in time
+@property (nonatomic, strong, nullable) JBSwarmMessage *message;
+/// The message was already on disk rather than fetched for this push
+@property (nonatomic, assign) BOOL fromHistory;
+/// Peak physical footprint of the process, what the extension's memory cap applies to
+@property (nonatomic, assign) uint64_t peakFootprintBytes;
+@property (nonatomic, assign) double elapsedSeconds;
+@end
+
+typedef void (^JBExtensionCompletion)(JBExtensionResult *result);
+
+/// Position of a chunk within a SwarmLoaded result delivered in chunks
+@interface JBMessagesLoadCursor : NSObject
+@property (nonatomic, readonly) int requestId;
+@property (nonatomic, readonly, copy) NSString *accountId;
+@property (nonatomic, readonly, copy) NSString *conversationId;
+/// Index of the first message of the current chunk
+@property (nonatomic, readonly) NSUInteger offset;
+@property (nonatomic, readonly) NSUInteger total;
+/// YES for the final chunk (also delivered when the result is empty)
+@property (nonatomic, readonly) BOOL isLast;
+@property (nonatomic, readonly, getter=isCancelled) BOOL cancelled;
+/// Drops the remaining chunks; safe to call from any thread
+- (void)cancel;
+@end
+
 // =============================================================================
 // Delegate Protocol - Callbacks from daemon to Kotlin
 // =============================================================================
@@ -135,6 +329,11 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 
 @optional
 
+// Daemon Events
+/// Startup stage transitions, in order, on the configuration domain queue
+/// (after the signals the daemon emitted while reaching that stage).
+- (void)onDaemonStageChanged:(JBDaemonStage)stage;
+
 // Account Events
 - (void)onRegistrationStateChanged:(NSString *)accountId
                              state:(JBRegistrationState)state
@@ -144,8 +343,12 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 - (void)onAccountDetailsChanged:(NSString *)accountId
                         details:(NSDictionary<NSString *, NSString *> *)details;
 
+/// Peer profile parsed by the bridge. `vcardPath` is the vcf written by the
+/// daemon (empty if the card came inline), `displayName` its FN (may be empty),
+/// `avatarPath` a JPEG thumbnail of its photo (≤512 px) or nil.
 - (void)onProfileReceived:(NSString *)accountId
                      from:(NSString *)from
+                vcardPath:(NSString *)vcardPath
               displayName:(NSString *)displayName
                avatarPath:(nullable NSString *)avatarPath;
 
@@ -158,6 +361,14 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                       address:(NSString *)address
                          name:(NSString *)name;
 
+/// Same as above with the looked up name or address (used instead of it when implemented).
+/// Also delivered for lookups answered from the resolver cache.
+- (void)onRegisteredNameFound:(NSString *)accountId
+                        state:(JBLookupState)state
+                      address:(NSString *)address
+                         name:(NSString *)name
+                        query:(NSString *)query;
+
 - (void)onKnownDevicesChanged:(NSString *)accountId
                       devices:(NSDictionary<NSString *, NSString *> *)devices;
 
@@ -181,6 +392,18 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 
 - (void)onVideoMuted:(NSString *)callId muted:(BOOL)muted;
 
+// Video Events
+- (void)onDecodingStarted:(NSString *)sinkId
+                    width:(int)width
+                   height:(int)height
+                  isMixer:(BOOL)isMixer;
+
+- (void)onDecodingStopped:(NSString *)sinkId isMixer:(BOOL)isMixer;
+
+- (void)onStartCapture:(NSString *)deviceId;
+
+- (void)onStopCapture:(NSString *)deviceId;
+
 - (void)onConferenceCreated:(NSString *)accountId
              conversationId:(NSString *)conversationId
                conferenceId:(NSString *)conferenceId;
@@ -219,6 +442,19 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
           conversationId:(NSString *)conversationId
                 messages:(NSArray<JBSwarmMessage *> *)messages;
 
+/**
+ * Chunked alternative to onMessagesLoaded: (used instead of it when implemented).
+ * Results are split into chunks of messagesLoadChunkSize; the next chunk is only
+ * converted after this call returns, interleaved with other conversation signals.
+ */
+- (void)onMessagesLoadedChunk:(NSArray<JBSwarmMessage *> *)messages
+                       cursor:(JBMessagesLoadCursor *)cursor;
+
+- (void)onMessagesFound:(NSString *)accountId
+              requestId:(uint32_t)requestId
+         conversationId:(NSString *)conversationId
+               messages:(NSArray<NSDictionary<NSString *, NSString *> *> *)messages;
+
 - (void)onConversationMemberEvent:(NSString *)accountId
                    conversationId:(NSString *)conversationId
                         memberUri:(NSString *)memberUri
@@ -233,6 +469,10 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                       conversationId:(NSString *)conversationId
                              profile:(NSDictionary<NSString *, NSString *> *)profile;
 
+- (void)onConversationPreferencesUpdated:(NSString *)accountId
+                          conversationId:(NSString *)conversationId
+                             preferences:(NSDictionary<NSString *, NSString *> *)preferences;
+
 - (void)onReactionAdded:(NSString *)accountId
          conversationId:(NSString *)conversationId
               messageId:(NSString *)messageId
@@ -243,6 +483,20 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                 messageId:(NSString *)messageId
                reactionId:(NSString *)reactionId;
 
+// File Transfer Events
+- (void)onDataTransferEvent:(NSString *)accountId
+             conversationId:(NSString *)conversationId
+              interactionId:(NSString *)interactionId
+                     fileId:(NSString *)fileId
+                  eventCode:(int)eventCode;
+
+/**
+ * Progress of ongoing transfers, with smoothed bytesPerSecond and etaSeconds.
+ * Batched: at most one call per 250 ms for all transfers that moved, plus a
+ * final one when a transfer ends. No polling of getFileTransferInfo needed.
+ */
+- (void)onDataTransferProgress:(NSArray<JBFileTransferInfo *> *)transfers;
+
 // Contact Events
 - (void)onContactAdded:(NSString *)accountId
                    uri:(NSString *)uri
@@ -262,6 +516,22 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                       uri:(NSString *)uri
                  isOnline:(BOOL)isOnline;
 
+// Batched Events
+// High-frequency signals are coalesced over a short window, keeping the latest
+// state per key. When the delegate implements a batch method it replaces the
+// per-event method above; otherwise the per-event method is called per entry.
+// Conference infos are coalesced per conference and always use
+// onConferenceInfoUpdated:participantInfos:.
+
+/// Latest presence per (account, buddy uri)
+- (void)onPresenceBatch:(NSArray<JBPresenceUpdate *> *)updates;
+
+/// Latest composing status per (account, conversation, from)
+- (void)onComposingStatusBatch:(NSArray<JBComposingUpdate *> *)updates;
+
+/// Latest version per (account, conversation, message id)
+- (void)onMessagesUpdatedBatch:(NSArray<JBMessageUpdate *> *)updates;
+
 @end
 
 // =============================================================================
@@ -277,7 +547,44 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 @property (nonatomic, weak, nullable) id<JamiBridgeDelegate> delegate;
 
 // =========================================================================
-// Daemon Lifecycle (4 methods)
+// Signal Delivery (3 methods)
+// =========================================================================
+
+/**
+ * Queue on which delegate callbacks of `domain` are invoked. By default each
+ * domain has its own bridge-owned serial background queue, so the delegate
+ * decides itself what needs to hop to the main thread. Pass the main queue to
+ * get main-thread delivery for a domain, or nil to restore the default.
+ * Callbacks of one domain and account are always delivered in daemon order;
+ * accounts sharing a queue take turns, and call callbacks pass the queued
+ * callbacks of the other domains.
+ */
+- (void)setDeliveryQueue:(nullable dispatch_queue_t)queue forDomain:(JBSignalDomain)domain;
+- (dispatch_queue_t)deliveryQueueForDomain:(JBSignalDomain)domain;
+/// Callbacks delivered for the account per turn (default 1), e.g. more for the active account
+- (void)setDeliveryWeight:(NSUInteger)weight forAccount:(NSString *)accountId;
+
+// =========================================================================
+// Signal Metrics (7 methods)
+// =========================================================================
+
+/// Per-signal counters and latency percentiles, keyed by daemon signal name.
+/// Signals that have not fired since the last reset are omitted.
+- (NSDictionary<NSString *, JBSignalMetrics *> *)signalMetricsSnapshot;
+- (void)resetSignalMetrics;
+/// Trims run by the bridge on memory pressure and background transitions
+- (JBMemoryMetrics *)memoryMetricsSnapshot;
+/// Delivery lane of each account that received signals (reset with resetSignalMetrics)
+- (NSDictionary<NSString *, JBAccountQueueMetrics *> *)accountQueueMetricsSnapshot;
+/// Emits os_signpost intervals ("Convert", "Queued", "Delegate") for Instruments
+- (void)setSignalSignpostsEnabled:(BOOL)enabled;
+/// Writes every signal with its arguments to `path` (JSON lines, see JBSignalTrace.h),
+/// for replay with bench-jamibridge.sh. Message bodies are included: debugging only.
+- (BOOL)startSignalTrace:(NSString *)path;
+- (void)stopSignalTrace;
+
+// =========================================================================
+// Daemon Lifecycle (7 methods)
 // =========================================================================
 
 - (void)initDaemonWithDataPath:(NSString *)dataPath;
@@ -285,6 +592,47 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 - (void)stopDaemon;
 - (BOOL)isDaemonRunning;
 
+/**
+ * Runs libjami::init and libjami::start on a bridge startup queue and returns
+ * right away; progress is reported through onDaemonStageChanged:. Loading
+ * every account's conversations can take seconds, so the UI should show its
+ * cached state until JBDaemonStageAccountsLoaded. Ignored unless the daemon
+ * is stopped (or a previous startup failed).
+ */
+- (void)startDaemonAsyncWithDataPath:(NSString *)dataPath;
+
+/// Before JBDaemonStageInitialized, and once stopping began, the methods that
+/// reach libjami do nothing and return an empty value (NO, @"", @[], @{}, 0, nil);
+/// lookup completions are called with a JBLookupStateError result.
+@property (atomic, readonly) JBDaemonStage daemonStage;
+
+/**
+ * Runs `block` on the startup queue once accounts are loaded, right away if
+ * they already are. Blocks queued when startup fails, or when the daemon is
+ * stopped before it finished, are dropped.
+ */
+- (void)performWhenDaemonReady:(dispatch_block_t)block;
+
+// =========================================================================
+// Notification Service Extension (1 method)
+// =========================================================================
+
+/**
+ * Extension profile, instead of initDaemon/startDaemon: starts the daemon
+ * with only `accountId` and `conversationId` loaded and only the message
+ * signals registered (no audio, video or presence), hands it the push
+ * payload, and stops it again. `completion` is called once, on a bridge
+ * queue, after the daemon has shut down: with the newest message of the
+ * conversation, or none after `timeout` seconds. The file logger is switched
+ * to console output. Completes at once without a message if the daemon is
+ * already running in this process.
+ */
+- (void)handleExtensionPush:(NSDictionary<NSString *, NSString *> *)pushData
+                  accountId:(NSString *)accountId
+             conversationId:(NSString *)conversationId
+                    timeout:(NSTimeInterval)timeout
+                 completion:(JBExtensionCompletion)completion;
+
 // =========================================================================
 // Account Management (14 methods)
 // =========================================================================
@@ -320,9 +668,12 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                 name:(NSString *)name
             password:(NSString *)password;
 
-- (nullable JBLookupResult *)lookupName:(NSString *)accountId name:(NSString *)name;
+/// The result comes through onRegisteredNameFound, right away when a fresh one
+/// is cached. NO when no request went out (daemon not initialized, or libjami
+/// refused it): the delegate will not be notified.
+- (BOOL)lookupName:(NSString *)accountId name:(NSString *)name;
 
-- (nullable JBLookupResult *)lookupAddress:(NSString *)accountId address:(NSString *)address;
+- (BOOL)lookupAddress:(NSString *)accountId address:(NSString *)address;
 
 - (NSDictionary<NSString *, NSString *> *)getAccountTemplate:(NSString *)accountType;
 
@@ -353,6 +704,40 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 
 - (BOOL)provideAccountAuthentication:(NSString *)accountId password:(NSString *)password scheme:(NSString *)scheme;
 
+// =========================================================================
+// Account Bootstrap (2 methods)
+// =========================================================================
+// One call instead of getAccountDetails, getVolatileAccountDetails, getContacts,
+// getConversations, getConversationRequests, getTrustRequests and per-conversation
+// getConversationInfo/getConversationMembers. Conversations are queried in parallel.
+// Blocking: call off the main thread.
+
+- (JBAccountSnapshot *)snapshotAccount:(NSString *)accountId;
+
+- (NSArray<JBAccountSnapshot *> *)snapshotAllAccounts;
+
+// =========================================================================
+// Name Resolution (4 methods)
+// =========================================================================
+// Lookups go through an LRU cache of found and not-found results (with TTLs);
+// identical lookups in flight share one name server request. Completions are
+// called on the configuration signal queue.
+
+- (void)resolveName:(NSString *)name
+          accountId:(NSString *)accountId
+         completion:(JBLookupCompletion)completion;
+
+- (void)resolveAddress:(NSString *)address
+             accountId:(NSString *)accountId
+            completion:(JBLookupCompletion)completion;
+
+/// Resolves a whole contact list; completion gets one result per address.
+- (void)resolveAddresses:(NSArray<NSString *> *)addresses
+               accountId:(NSString *)accountId
+              completion:(void (^)(NSDictionary<NSString *, JBLookupResult *> *results))completion;
+
+- (void)clearLookupCache;
+
 // =========================================================================
 // Contact Management (7 methods)
 // =========================================================================
@@ -411,7 +796,7 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 - (NSArray<JBConversationRequest *> *)getConversationRequests:(NSString *)accountId;
 
 // =========================================================================
-// Messaging (4 methods)
+// Messaging (5 methods)
 // =========================================================================
 
 - (NSString *)sendMessage:(NSString *)accountId
@@ -429,6 +814,17 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                fromMessage:(NSString *)fromMessage
                  toMessage:(NSString *)toMessage;
 
+/// Messages per onMessagesLoadedChunk:cursor: call (default 64, 0 = whole result at once)
+@property (atomic, assign) NSUInteger messagesLoadChunkSize;
+
+/// Cancels the chunked delivery of a load request (no-op once it completed)
+- (void)cancelMessagesLoad:(int)requestId;
+
+/**
+ * Results arrive through onMessagesFound:requestId:conversationId:messages:, one
+ * batch per conversation, then once with an empty conversationId when done.
+ * An empty conversationId searches all conversations of the account in parallel.
+ */
 - (uint32_t)searchConversation:(NSString *)accountId
                 conversationId:(NSString *)conversationId
                         author:(NSString *)author
@@ -440,14 +836,27 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                      maxResult:(uint32_t)maxResult
                           flag:(int32_t)flag;
 
+/// Drops the remaining results of a search (the daemon has no way to stop it)
+- (void)cancelSearch:(uint32_t)requestId;
+
 - (void)setIsComposing:(NSString *)accountId
         conversationId:(NSString *)conversationId
            isComposing:(BOOL)isComposing;
 
+/// Coalesced: only the newest message displayed in the conversation is sent to
+/// the daemon (one swarm commit), once the calls pause for a couple of seconds,
+/// at most ~10 s later, or when the app moves to the background.
 - (void)setMessageDisplayed:(NSString *)accountId
              conversationId:(NSString *)conversationId
                   messageId:(NSString *)messageId;
 
+/// Unread message counts for the conversation list: conversationId -> messages
+/// after the account's last displayed one (receipts not yet sent included),
+/// stopping at its own latest message. Counted by the daemon without loading
+/// messages, conversations in parallel. Blocking: call off the main thread.
+- (NSDictionary<NSString *, NSNumber *> *)countUnreadMessages:(NSString *)accountId
+                                              conversationIds:(NSArray<NSString *> *)conversationIds;
+
 - (uint64_t)sendAccountTextMessage:(NSString *)accountId
                     conversationId:(NSString *)conversationId
                           messages:(NSDictionary<NSString *, NSString *> *)messages
@@ -460,6 +869,21 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                     conversationId:(NSString *)conversationId
                              prefs:(NSDictionary<NSString *, NSString *> *)prefs;
 
+// =========================================================================
+// Local Message Index (2 methods)
+// =========================================================================
+// Full-text index of the text messages received, updated or loaded through the
+// bridge, kept on the device (SQLite FTS5, bounded per account). Answers in
+// milliseconds without the daemon walking every conversation's history; messages
+// never loaded on this device are only found by searchConversation.
+
+/// Best matches first; every word of `query` must match as a word prefix. Blocking.
+- (NSArray<JBIndexedMessage *> *)searchMessageIndex:(NSString *)query
+                                          accountId:(NSString *)accountId
+                                              limit:(NSUInteger)limit;
+
+- (void)clearMessageIndex:(NSString *)accountId;
+
 // =========================================================================
 // Calls (12 methods)
 // =========================================================================
@@ -564,10 +988,29 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 - (BOOL)resumeConference:(NSString *)accountId conferenceId:(NSString *)conferenceId;
 - (void)setActiveParticipant:(NSString *)accountId conferenceId:(NSString *)conferenceId callId:(NSString *)callId;
 
+/**
+ * Participant sinks (the "sinkId" of each conference info) currently on screen.
+ * Listed sinks are rendered at the given size; the others are unregistered from
+ * the daemon, so no frame is scaled or converted for them. A sink that leaves
+ * the screen keeps rendering for 1.5 s, so scrolling does not re-register it.
+ * Call again whenever the visible tiles or their sizes change.
+ */
+- (void)setVisibleConferenceStreams:(NSArray<JBStreamVisibility *> *)streams
+                          accountId:(NSString *)accountId
+                       conferenceId:(NSString *)conferenceId;
+
+/// Hosted conferences showing a single stream switch to the one-big layout on
+/// it, and back to the grid (default NO: the host's layout is sent to everyone).
+@property (atomic, assign) BOOL conferenceLayoutFollowsVisibility;
+
 // =========================================================================
 // File Transfer (4 methods)
 // =========================================================================
 
+/// Images and videos are first downscaled/re-encoded (metadata stripped) or
+/// transcoded off the calling thread, see mediaSettings; the preprocessing is
+/// reported by onDataTransferProgress: with JBFileTransferFlagPreparing, an
+/// empty interactionId and `filePath` as the path, until the daemon takes over.
 - (NSString *)sendFile:(NSString *)accountId
         conversationId:(NSString *)conversationId
               filePath:(NSString *)filePath
@@ -587,6 +1030,8 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
                                       conversationId:(NSString *)conversationId
                                               fileId:(NSString *)fileId;
 
+@property (atomic, strong) JBMediaSettings *mediaSettings;
+
 // =========================================================================
 // Video (5 methods)
 // =========================================================================
@@ -600,10 +1045,46 @@ typedef NS_ENUM(NSInteger, JBMemberEventType) {
 - (void)setDefaultVideoDevice:(NSString *)deviceId;
 - (void)setDeviceOrientation:(NSString *)deviceId angle:(int)angle;
 - (void)applyVideoSettings:(NSString *)deviceId settings:(NSDictionary<NSString *, NSString *> *)settings;
+
+/// During calls, steps the capture resolution/framerate down under thermal,
+/// low-power or frame-rate pressure and back up when it clears (default YES).
+/// Calls always start with hardware encoding and decoding enabled.
+@property (atomic, assign) BOOL adaptiveVideoQuality;
+
 - (BOOL)switchVideoInput:(NSString *)accountId callId:(NSString *)callId uri:(NSString *)uri;
 - (void)addVideoDevice:(NSString *)node;
 - (void)removeVideoDevice:(NSString *)node;
 
+// =========================================================================
+// Video Capture (2 methods)
+// =========================================================================
+
+/**
+ * Publishes the frames of a camera capture output to the daemon video input
+ * `inputId` ("camera://<device uniqueID>"). Sample buffers are handled on a
+ * bridge-owned capture queue and handed to the daemon by reference (no pixel
+ * copy, no main-thread hop). The output is switched to NV12.
+ */
+- (void)attachCaptureOutput:(AVCaptureVideoDataOutput *)output inputId:(NSString *)inputId;
+- (void)detachCaptureOutput:(AVCaptureVideoDataOutput *)output;
+
+// =========================================================================
+// Video Rendering (3 methods)
+// =========================================================================
+
+/**
+ * Renders the daemon sink (call id or video input id) into the given layer.
+ * Frames are IOSurface-backed CVPixelBuffers enqueued from the daemon's sink
+ * thread, with no copy and no main-thread hop. The layer is held weakly and
+ * may be attached before the sink is decoding.
+ */
+- (void)attachVideoSink:(NSString *)sinkId displayLayer:(AVSampleBufferDisplayLayer *)layer;
+- (void)detachVideoSink:(NSString *)sinkId;
+
+/// Size of the view showing the sink, in points (UIKit view bounds). Converted to
+/// pixels with the screen scale; frames are downscaled to fit.
+- (void)setVideoSinkSize:(NSString *)sinkId width:(int)width height:(int)height;
+
 // =========================================================================
 // Audio Settings (4 methods)
 // =========================================================================
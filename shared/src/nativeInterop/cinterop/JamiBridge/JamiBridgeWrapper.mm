@@ -19,97 +19,47 @@
 #endif
 
 // C++ Standard Library
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <functional>
 #include <filesystem>
-
-// =============================================================================
-// Inline File Logger - writes to Documents folder for crash-safe debugging
-// =============================================================================
-
-static NSFileHandle *g_logFileHandle = nil;
-static NSDateFormatter *g_logDateFormatter = nil;
-static dispatch_queue_t g_logQueue = nil;
-
-static void initFileLogger() {
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSArray *paths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
-        NSString *documentsPath = paths.firstObject;
-        if (!documentsPath) {
-            NSLog(@"[FileLogger] ERROR: Could not find Documents directory");
-            return;
-        }
-
-        NSDateFormatter *timestampFormatter = [[NSDateFormatter alloc] init];
-        timestampFormatter.dateFormat = @"yyyy-MM-dd_HH-mm-ss";
-        NSString *timestamp = [timestampFormatter stringFromDate:[NSDate date]];
-
-        NSString *fileName = [NSString stringWithFormat:@"gettogether_native_%@.log", timestamp];
-        NSString *logFilePath = [documentsPath stringByAppendingPathComponent:fileName];
-
-        [[NSFileManager defaultManager] createFileAtPath:logFilePath contents:nil attributes:nil];
-        g_logFileHandle = [NSFileHandle fileHandleForWritingAtPath:logFilePath];
-
-        g_logDateFormatter = [[NSDateFormatter alloc] init];
-        g_logDateFormatter.dateFormat = @"HH:mm:ss.SSS";
-
-        g_logQueue = dispatch_queue_create("com.gettogether.filelogger", DISPATCH_QUEUE_SERIAL);
-
-        // Write header
-        NSString *header = [NSString stringWithFormat:
-            @"=====================================\n"
-            @"GetTogether iOS Native Debug Log\n"
-            @"Started: %@\n"
-            @"=====================================\n\n",
-            [NSDate date]];
-        NSData *data = [header dataUsingEncoding:NSUTF8StringEncoding];
-        [g_logFileHandle writeData:data];
-        [g_logFileHandle synchronizeFile];
-
-        NSLog(@"[FileLogger] Initialized at %@", logFilePath);
-    });
-}
-
-static void fileLog(const char* level, const char* tag, NSString *message) {
-    initFileLogger();
-
-    // Also log to NSLog
-    NSLog(@"%s/%s: %@", level, tag, message);
-
-    if (!g_logFileHandle) return;
-
-    dispatch_async(g_logQueue, ^{
-        NSString *timestamp = [g_logDateFormatter stringFromDate:[NSDate date]];
-        NSString *line = [NSString stringWithFormat:@"[%@] %s/%s: %@\n", timestamp, level, tag, message];
-        NSData *data = [line dataUsingEncoding:NSUTF8StringEncoding];
-        [g_logFileHandle writeData:data];
-        [g_logFileHandle synchronizeFile];
-    });
-}
-
-// Convenience macros for file logging
-#define FILE_LOG_I(tag, ...) do { \
-    NSString *msg = [NSString stringWithFormat:__VA_ARGS__]; \
-    fileLog("I", tag, msg); \
-} while(0)
-
-#define FILE_LOG_D(tag, ...) do { \
-    NSString *msg = [NSString stringWithFormat:__VA_ARGS__]; \
-    fileLog("D", tag, msg); \
-} while(0)
-
-#define FILE_LOG_W(tag, ...) do { \
-    NSString *msg = [NSString stringWithFormat:__VA_ARGS__]; \
-    fileLog("W", tag, msg); \
-} while(0)
-
-#define FILE_LOG_E(tag, ...) do { \
-    NSString *msg = [NSString stringWithFormat:__VA_ARGS__]; \
-    fileLog("E", tag, msg); \
-} while(0)
+#include <tuple>
+
+#include <sys/clonefile.h>
+
+#import "NativeFileLogger.h"
+#include "JBConversions.h"
+#include "JBStringInterner.h"
+#import "JBVideoSinkManager.h"
+#import "JBCameraFrameProducer.h"
+#import "JBSignalDispatcher.h"
+#import "JBLazySwarmMessage.h"
+#import "JBMessagesLoadCursor.h"
+#import "JBNameResolver.h"
+#import "JBTransferTracker.h"
+#import "JBMessageIndex.h"
+#import "JBConversationCache.h"
+#import "JBProfileThumbnailCache.h"
+#import "JBSignalMetrics.h"
+#import "JBBridgeInternal.h"
+#import "JBCallTrace.h"
+#import "JBCodecGovernor.h"
+#import "JBAudioSession.h"
+#import "JBExtensionSession.h"
+#import "JBScopedFileAccess.h"
+#import "JBMediaPreprocessor.h"
+#import "JBReadReceipts.h"
+#import "JBMemoryGovernor.h"
+#import "JBConferenceStreams.h"
+#include "JBSignalCoalescer.h"
+#include "jbcore/CoreEvents.h"
+#include "jbcore/UnreadCounter.h"
 
 // libjami C++ headers
 #include "jami.h"
@@ -127,91 +77,22 @@ using namespace libjami;
 // Type Conversion Helpers
 // =============================================================================
 
-// C++ string -> NSString
-static inline NSString* toNSString(const std::string& str) {
-    return [NSString stringWithUTF8String:str.c_str()];
+// Convert libjami::SwarmMessage to JBSwarmMessage. The message is moved into a
+// JBLazySwarmMessage, Foundation objects are only built for the fields that are read,
+// off the daemon thread (see JBLazySwarmMessage.h for when Kotlin reads them).
+static JBSwarmMessage* toJBSwarmMessage(SwarmMessage&& msg) {
+    return [[JBLazySwarmMessage alloc] initWithSwarmMessage:std::move(msg)];
 }
 
-// NSString -> C++ string
-static inline std::string toCppString(NSString* str) {
-    return str ? std::string([str UTF8String]) : "";
-}
-
-// std::map<string,string> -> NSDictionary
-static NSDictionary<NSString*, NSString*>* toNSDictionary(const std::map<std::string, std::string>& map) {
-    NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithCapacity:map.size()];
-    for (const auto& pair : map) {
-        dict[toNSString(pair.first)] = toNSString(pair.second);
-    }
-    return [dict copy];
-}
-
-// NSDictionary -> std::map<string,string>
-static std::map<std::string, std::string> toCppMap(NSDictionary<NSString*, NSString*>* dict) {
-    std::map<std::string, std::string> map;
-    for (NSString* key in dict) {
-        map[toCppString(key)] = toCppString(dict[key]);
-    }
-    return map;
-}
-
-// std::vector<string> -> NSArray
-static NSArray<NSString*>* toNSArray(const std::vector<std::string>& vec) {
-    NSMutableArray *arr = [NSMutableArray arrayWithCapacity:vec.size()];
-    for (const auto& str : vec) {
-        [arr addObject:toNSString(str)];
-    }
-    return [arr copy];
-}
-
-// NSArray -> std::vector<string>
-static std::vector<std::string> toCppVector(NSArray<NSString*>* arr) {
-    std::vector<std::string> vec;
-    vec.reserve(arr.count);
-    for (NSString* str in arr) {
-        vec.push_back(toCppString(str));
-    }
-    return vec;
-}
-
-// std::map<string,int32_t> -> NSDictionary<NSString*, NSNumber*>
-static NSDictionary<NSString*, NSNumber*>* toNSNumberDictionary(const std::map<std::string, int32_t>& map) {
-    NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithCapacity:map.size()];
-    for (const auto& pair : map) {
-        dict[toNSString(pair.first)] = @(pair.second);
-    }
-    return [dict copy];
-}
-
-// Convert libjami::SwarmMessage to JBSwarmMessage
 static JBSwarmMessage* toJBSwarmMessage(const SwarmMessage& msg) {
-    JBSwarmMessage *jbMsg = [[JBSwarmMessage alloc] init];
-    jbMsg.messageId = toNSString(msg.id);
-    jbMsg.type = toNSString(msg.type);
-    jbMsg.author = toNSString(msg.body.count("author") ? msg.body.at("author") : "");
-    jbMsg.body = toNSDictionary(msg.body);
-    jbMsg.status = toNSNumberDictionary(msg.status);
-    jbMsg.timestamp = 0; // Will be set from body if available
-    jbMsg.replyTo = nil;
-
-    // Extract timestamp from body if present
-    if (msg.body.count("timestamp")) {
-        jbMsg.timestamp = std::stoll(msg.body.at("timestamp"));
-    }
-
-    // Extract replyTo from body if present
-    if (msg.body.count("reply-to")) {
-        jbMsg.replyTo = toNSString(msg.body.at("reply-to"));
-    }
-
-    // Convert reactions
-    NSMutableArray *reactions = [NSMutableArray arrayWithCapacity:msg.reactions.size()];
-    for (const auto& reaction : msg.reactions) {
-        [reactions addObject:toNSDictionary(reaction)];
-    }
-    jbMsg.reactions = [reactions copy];
+    return toJBSwarmMessage(SwarmMessage(msg));
+}
 
-    return jbMsg;
+// Size of a string map crossing the bridge, for signalBytesConverted()
+static size_t payloadBytes(const std::map<std::string, std::string>& map) {
+    size_t bytes = 0;
+    for (const auto& [key, value] : map) bytes += key.size() + value.size();
+    return bytes;
 }
 
 // Convert registration state string to enum
@@ -291,6 +172,199 @@ static JBCallState toCallState(const std::string& state) {
 @implementation JBSwarmMessage
 @end
 
+@implementation JBPresenceUpdate
+@end
+
+@implementation JBComposingUpdate
+@end
+
+@implementation JBMessageUpdate
+@end
+
+@implementation JBConversationSnapshot
+@end
+
+@implementation JBAccountSnapshot
+@end
+
+@implementation JBIndexedMessage
+@end
+
+@implementation JBSignalMetrics
+@end
+
+@implementation JBStreamVisibility
+@end
+
+@implementation JBExtensionResult
+@end
+
+@implementation JBMediaSettings
+@end
+
+@implementation JBMemoryMetrics
+@end
+
+@implementation JBAccountQueueMetrics
+@end
+
+// =============================================================================
+// Coalesced Signal Payloads
+// =============================================================================
+
+// Shared with the JNI library (jbcore/CoreEvents.h)
+using jbcore::StringPair;
+using jbcore::StringTuple3;
+using jbcore::ComposingEvent;
+using jbcore::PresenceEvent;
+using jbcore::ConferenceInfoEvent;
+using jbcore::MessageUpdateEvent;
+
+// =============================================================================
+// Daemon Map Conversions
+// =============================================================================
+
+NSArray<JBContact *> *toJBContacts(const std::vector<std::map<std::string, std::string>>& contacts) {
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:contacts.size()];
+    for (const auto& contactMap : contacts) {
+        JBContact *contact = [[JBContact alloc] init];
+        contact.uri = toNSString(contactMap.count("id") ? contactMap.at("id") : "");
+        contact.displayName = toNSString(contactMap.count("displayName") ? contactMap.at("displayName") : "");
+        contact.isConfirmed = contactMap.count("confirmed") && contactMap.at("confirmed") == "true";
+        contact.isBanned = contactMap.count("banned") && contactMap.at("banned") == "true";
+        [result addObject:contact];
+    }
+    return [result copy];
+}
+
+static NSArray<JBTrustRequest *> *toJBTrustRequests(const std::vector<std::map<std::string, std::string>>& requests) {
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:requests.size()];
+    for (const auto& reqMap : requests) {
+        JBTrustRequest *request = [[JBTrustRequest alloc] init];
+        request.from = toNSString(reqMap.count(Account::TrustRequest::FROM) ? reqMap.at(Account::TrustRequest::FROM) : "");
+        request.conversationId = toNSString(reqMap.count(Account::TrustRequest::CONVERSATIONID) ? reqMap.at(Account::TrustRequest::CONVERSATIONID) : "");
+        // strtoll: a malformed value reads as 0 instead of throwing out of the snapshot
+        auto received = reqMap.find(Account::TrustRequest::RECEIVED);
+        request.received = received != reqMap.end() ? std::strtoll(received->second.c_str(), nullptr, 10) : 0;
+        [result addObject:request];
+    }
+    return [result copy];
+}
+
+static NSArray<JBConversationRequest *> *toJBConversationRequests(const std::vector<std::map<std::string, std::string>>& requests) {
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:requests.size()];
+    for (const auto& reqMap : requests) {
+        JBConversationRequest *request = [[JBConversationRequest alloc] init];
+        request.conversationId = toNSString(reqMap.count("id") ? reqMap.at("id") : "");
+        request.from = toNSString(reqMap.count("from") ? reqMap.at("from") : "");
+        request.metadata = toNSDictionary(reqMap);
+        [result addObject:request];
+    }
+    return [result copy];
+}
+
+static NSArray<JBConversationMember *> *toJBConversationMembers(const std::vector<std::map<std::string, std::string>>& members) {
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:members.size()];
+    for (const auto& memberMap : members) {
+        JBConversationMember *member = [[JBConversationMember alloc] init];
+        member.uri = toNSString(memberMap.count("uri") ? memberMap.at("uri") : "");
+
+        std::string role = memberMap.count("role") ? memberMap.at("role") : "";
+        if (role == "admin") {
+            member.role = JBMemberRoleAdmin;
+        } else if (role == "member") {
+            member.role = JBMemberRoleMember;
+        } else if (role == "invited") {
+            member.role = JBMemberRoleInvited;
+        } else if (role == "banned") {
+            member.role = JBMemberRoleBanned;
+        } else {
+            member.role = JBMemberRoleMember;
+        }
+
+        [result addObject:member];
+    }
+    return [result copy];
+}
+
+// Video source for call media: the daemon's default capture device
+static std::string defaultCameraSource() {
+    auto device = libjami::getDefaultDevice();
+    return "camera://" + (device.empty() ? std::string("0") : device);
+}
+
+// Marks the startup queue, see -stopDaemon
+static const void *const kStartupQueueKey = &kStartupQueueKey;
+
+// Account of each ongoing call, for the call signals libjami sends without one
+// (AudioMuted, VideoMuted): they are delivered in the lane of that account
+static std::mutex callAccountsMutex;
+static std::unordered_map<std::string, std::string> callAccounts;
+
+static void noteCallAccount(const std::string& callId, const std::string& accountId) {
+    std::lock_guard<std::mutex> lock(callAccountsMutex);
+    callAccounts[callId] = accountId;
+}
+
+static void forgetCallAccount(const std::string& callId) {
+    std::lock_guard<std::mutex> lock(callAccountsMutex);
+    callAccounts.erase(callId);
+}
+
+// Empty for an unknown call: the signal goes to the shared lane
+static std::string callAccount(const std::string& callId) {
+    std::lock_guard<std::mutex> lock(callAccountsMutex);
+    auto it = callAccounts.find(callId);
+    return it != callAccounts.end() ? it->second : std::string();
+}
+
+// Opens wrapper methods that call libjami: before init or after fini they
+// log, skip the call and return `fallback`
+#define JB_REQUIRE_DAEMON(fallback) do { \
+    if (!_libjamiReady.load(std::memory_order_acquire)) { \
+        FILE_LOG_D("JamiBridge", @"%s: daemon not initialized", __func__); \
+        return fallback; \
+    } \
+} while (0)
+
+// Lookup completions still run, on the configuration queue, with an error result
+static void failLookup(NSString *query, NSString *accountId, JBLookupCompletion completion) {
+    if (!completion) return;
+    JBLookupResult *result = [[JBLookupResult alloc] init];
+    result.state = JBLookupStateError;
+    result.address = @"";
+    result.name = @"";
+    result.query = [query copy];
+    dispatchSignal(JBSignalDomainConfiguration, toCppIdentifier(accountId), ^{ completion(result); });
+}
+
+static void failLookups(NSArray<NSString *> *addresses, NSString *accountId,
+                        void (^completion)(NSDictionary<NSString *, JBLookupResult *> *results)) {
+    NSMutableDictionary<NSString *, JBLookupResult *> *results =
+        [NSMutableDictionary dictionaryWithCapacity:addresses.count];
+    for (NSString *address in addresses) {
+        JBLookupResult *result = [[JBLookupResult alloc] init];
+        result.state = JBLookupStateError;
+        result.address = [address copy];
+        result.name = @"";
+        result.query = [address copy];
+        results[address] = result;
+    }
+    dispatchSignal(JBSignalDomainConfiguration, toCppIdentifier(accountId), ^{ completion(results); });
+}
+
+static JBAccountSnapshot *emptyAccountSnapshot(NSString *accountId) {
+    JBAccountSnapshot *snapshot = [[JBAccountSnapshot alloc] init];
+    snapshot.accountId = [accountId copy];
+    snapshot.details = @{};
+    snapshot.volatileDetails = @{};
+    snapshot.contacts = @[];
+    snapshot.conversationRequests = @[];
+    snapshot.trustRequests = @[];
+    snapshot.conversations = @[];
+    return snapshot;
+}
+
 // =============================================================================
 // JamiBridgeWrapper Implementation
 // =============================================================================
@@ -298,11 +372,27 @@ static JBCallState toCallState(const std::string& state) {
 @interface JamiBridgeWrapper ()
 
 @property (nonatomic, assign) BOOL daemonRunning;
+@property (atomic, assign, readwrite) JBDaemonStage daemonStage;
+@property (nonatomic, strong) dispatch_queue_t startupQueue;
+// performWhenDaemonReady: blocks waiting for the accounts, guarded by @synchronized (self)
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *readyBlocks;
+// An account registered while libjami::start was still running
+@property (atomic, assign) BOOL accountRegisteredDuringStart;
 @property (nonatomic, copy) NSString *dataPath;
+@property (nonatomic, copy, nullable) NSString *localVideoInputId;
+// Chunked SwarmLoaded deliveries in progress, by request id
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, JBMessagesLoadCursor *> *messagesLoads;
+// Searches cancelled by the client whose end marker has not arrived yet
+@property (nonatomic, strong) NSMutableIndexSet *cancelledSearches;
 
 @end
 
-@implementation JamiBridgeWrapper
+@implementation JamiBridgeWrapper {
+    // Stage at least Initialized, see JB_REQUIRE_DAEMON
+    std::atomic<bool> _libjamiReady;
+    // Shared in performIfLibjamiReady:, exclusive while stopDaemon clears _libjamiReady
+    std::shared_mutex _readyLock;
+}
 
 // =============================================================================
 // Singleton
@@ -321,34 +411,187 @@ static JBCallState toCallState(const std::string& state) {
     self = [super init];
     if (self) {
         _daemonRunning = NO;
+        _daemonStage = JBDaemonStageStopped;
+        _startupQueue = dispatch_queue_create("net.jami.bridge.startup",
+            dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+        dispatch_queue_set_specific(_startupQueue, kStartupQueueKey, (void *)kStartupQueueKey, nullptr);
+        _readyBlocks = [NSMutableArray array];
+        _messagesLoadChunkSize = 64;
+        _messagesLoads = [NSMutableDictionary dictionary];
+        _cancelledSearches = [NSMutableIndexSet indexSet];
+        // Starts observing memory pressure and background transitions
+        [JBMemoryGovernor shared];
     }
     return self;
 }
 
+// =============================================================================
+// Signal Delivery
+// =============================================================================
+
+- (void)setDeliveryQueue:(dispatch_queue_t)queue forDomain:(JBSignalDomain)domain {
+    [[JBSignalDispatcher shared] setQueue:queue forDomain:domain];
+}
+
+- (dispatch_queue_t)deliveryQueueForDomain:(JBSignalDomain)domain {
+    return [[JBSignalDispatcher shared] queueForDomain:domain];
+}
+
+- (void)setDeliveryWeight:(NSUInteger)weight forAccount:(NSString *)accountId {
+    [[JBSignalDispatcher shared] setWeight:weight forAccount:toCppIdentifier(accountId)];
+}
+
+- (NSDictionary<NSString *, JBSignalMetrics *> *)signalMetricsSnapshot {
+    return signalMetricsSnapshot();
+}
+
+- (void)resetSignalMetrics {
+    resetSignalMetrics();
+    [[JBSignalDispatcher shared] resetAccountQueueMetrics];
+}
+
+- (JBMemoryMetrics *)memoryMetricsSnapshot {
+    return [[JBMemoryGovernor shared] metricsSnapshot];
+}
+
+- (NSDictionary<NSString *, JBAccountQueueMetrics *> *)accountQueueMetricsSnapshot {
+    return [[JBSignalDispatcher shared] accountQueueMetrics];
+}
+
+- (void)setSignalSignpostsEnabled:(BOOL)enabled {
+    setSignalSignpostsEnabled(enabled);
+}
+
+- (BOOL)startSignalTrace:(NSString *)path {
+    return startSignalTrace(toCppString(path));
+}
+
+- (void)stopSignalTrace {
+    stopSignalTrace();
+}
+
 // =============================================================================
 // Signal Handler Registration
 // =============================================================================
 
 - (void)registerSignalHandlers {
-    std::map<std::string, std::shared_ptr<CallbackWrapperBase>> handlers;
+    libjami::registerSignalHandlers([self makeSignalHandlers]);
+    FILE_LOG_I("JamiBridge", @"Signal handlers registered successfully");
+}
+
+- (JBSignalHandlerMap)makeSignalHandlers {
+    JBSignalHandlerMap handlers;
 
     __weak JamiBridgeWrapper *weakSelf = self;
 
+    // =========================================================================
+    // Coalesced Signals
+    // =========================================================================
+    // Composing, presence, conference infos and message updates arrive in storms
+    // (swarm sync, reconnect with many contacts). They are buffered as C++ values
+    // and only the latest state per key is converted and delivered per window.
+
+    auto composing = SignalCoalescer<StringTuple3, ComposingEvent>::create(JBSignalDomainPresence,
+        [weakSelf](std::vector<ComposingEvent>&& events) {
+            id<JamiBridgeDelegate> delegate = weakSelf.delegate;
+            if ([delegate respondsToSelector:@selector(onComposingStatusBatch:)]) {
+                NSMutableArray<JBComposingUpdate *> *updates = [NSMutableArray arrayWithCapacity:events.size()];
+                for (const auto& event : events) {
+                    JBComposingUpdate *update = [[JBComposingUpdate alloc] init];
+                    update.accountId = toNSIdentifier(event.accountId);
+                    update.conversationId = toNSIdentifier(event.conversationId);
+                    update.from = toNSIdentifier(event.from);
+                    update.isComposing = event.status != 0;
+                    [updates addObject:update];
+                }
+                [delegate onComposingStatusBatch:updates];
+            } else if ([delegate respondsToSelector:@selector(onComposingStatusChanged:conversationId:from:isComposing:)]) {
+                for (const auto& event : events) {
+                    [delegate onComposingStatusChanged:toNSIdentifier(event.accountId)
+                                        conversationId:toNSIdentifier(event.conversationId)
+                                                  from:toNSIdentifier(event.from)
+                                           isComposing:event.status != 0];
+                }
+            }
+        });
+
+    auto presence = SignalCoalescer<StringPair, PresenceEvent>::create(JBSignalDomainPresence,
+        [weakSelf](std::vector<PresenceEvent>&& events) {
+            id<JamiBridgeDelegate> delegate = weakSelf.delegate;
+            if ([delegate respondsToSelector:@selector(onPresenceBatch:)]) {
+                NSMutableArray<JBPresenceUpdate *> *updates = [NSMutableArray arrayWithCapacity:events.size()];
+                for (const auto& event : events) {
+                    JBPresenceUpdate *update = [[JBPresenceUpdate alloc] init];
+                    update.accountId = toNSIdentifier(event.accountId);
+                    update.uri = toNSIdentifier(event.uri);
+                    update.status = event.status;
+                    update.lineStatus = toNSString(event.lineStatus);
+                    [updates addObject:update];
+                }
+                [delegate onPresenceBatch:updates];
+            } else if ([delegate respondsToSelector:@selector(onPresenceChanged:uri:isOnline:)]) {
+                for (const auto& event : events) {
+                    [delegate onPresenceChanged:toNSIdentifier(event.accountId)
+                                            uri:toNSIdentifier(event.uri)
+                                       isOnline:event.status != 0];
+                }
+            }
+        });
+
+    auto conferenceInfos = SignalCoalescer<std::string, ConferenceInfoEvent>::create(JBSignalDomainCall,
+        [weakSelf](std::vector<ConferenceInfoEvent>&& events) {
+            id<JamiBridgeDelegate> delegate = weakSelf.delegate;
+            if (![delegate respondsToSelector:@selector(onConferenceInfoUpdated:participantInfos:)]) return;
+            for (const auto& event : events) {
+                NSMutableArray *infos = [NSMutableArray arrayWithCapacity:event.participantInfos.size()];
+                for (const auto& info : event.participantInfos) {
+                    [infos addObject:toNSDictionary(info)];
+                }
+                [delegate onConferenceInfoUpdated:toNSIdentifier(event.conferenceId)
+                                 participantInfos:[infos copy]];
+            }
+        });
+
+    auto messageUpdates = SignalCoalescer<StringTuple3, MessageUpdateEvent>::create(JBSignalDomainConversation,
+        [weakSelf](std::vector<MessageUpdateEvent>&& events) {
+            id<JamiBridgeDelegate> delegate = weakSelf.delegate;
+            if ([delegate respondsToSelector:@selector(onMessagesUpdatedBatch:)]) {
+                NSMutableArray<JBMessageUpdate *> *updates = [NSMutableArray arrayWithCapacity:events.size()];
+                for (auto& event : events) {
+                    JBMessageUpdate *update = [[JBMessageUpdate alloc] init];
+                    update.accountId = toNSIdentifier(event.accountId);
+                    update.conversationId = toNSIdentifier(event.conversationId);
+                    update.message = toJBSwarmMessage(std::move(event.message));
+                    [updates addObject:update];
+                }
+                [delegate onMessagesUpdatedBatch:updates];
+            } else if ([delegate respondsToSelector:@selector(onMessageUpdated:conversationId:message:)]) {
+                for (auto& event : events) {
+                    [delegate onMessageUpdated:toNSIdentifier(event.accountId)
+                                conversationId:toNSIdentifier(event.conversationId)
+                                       message:toJBSwarmMessage(std::move(event.message))];
+                }
+            }
+        });
+
     // =========================================================================
     // Configuration/Account Signals
     // =========================================================================
 
     // Registration state changed
-    handlers.insert(exportable_callback<ConfigurationSignal::RegistrationStateChanged>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::RegistrationStateChanged>(
         [weakSelf](const std::string& accountId, const std::string& state,
                    int code, const std::string& detail) {
             FILE_LOG_I("JamiBridge-C++", @"RegistrationStateChanged CALLBACK: account=%s state=%s code=%d detail=%s",
                   accountId.c_str(), state.c_str(), code, detail.c_str());
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
             JBRegistrationState stateEnum = toRegistrationState(state);
             NSString *detailNS = toNSString(detail);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            if (stateEnum == JBRegistrationStateRegistered) {
+                [weakSelf daemonAccountRegistered];
+            }
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf) {
                     FILE_LOG_I("JamiBridge-C++", @"RegistrationStateChanged dispatching: hasDelegate=%d",
@@ -369,12 +612,12 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Account details changed
-    handlers.insert(exportable_callback<ConfigurationSignal::AccountDetailsChanged>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::AccountDetailsChanged>(
         [weakSelf](const std::string& accountId, const std::map<std::string, std::string>& details) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
             NSDictionary *detailsNS = toNSDictionary(details);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onAccountDetailsChanged:details:)]) {
                     [strongSelf.delegate onAccountDetailsChanged:accountIdNS
@@ -384,12 +627,12 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Contact added
-    handlers.insert(exportable_callback<ConfigurationSignal::ContactAdded>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::ContactAdded>(
         [weakSelf](const std::string& accountId, const std::string& uri, bool confirmed) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *uriNS = toNSString(uri);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *uriNS = toNSIdentifier(uri);
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onContactAdded:uri:confirmed:)]) {
                     [strongSelf.delegate onContactAdded:accountIdNS
@@ -400,12 +643,12 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Contact removed
-    handlers.insert(exportable_callback<ConfigurationSignal::ContactRemoved>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::ContactRemoved>(
         [weakSelf](const std::string& accountId, const std::string& uri, bool banned) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *uriNS = toNSString(uri);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *uriNS = toNSIdentifier(uri);
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onContactRemoved:uri:banned:)]) {
                     [strongSelf.delegate onContactRemoved:accountIdNS
@@ -416,19 +659,19 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Incoming trust request
-    handlers.insert(exportable_callback<ConfigurationSignal::IncomingTrustRequest>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::IncomingTrustRequest>(
         [weakSelf](const std::string& accountId, const std::string& from,
                    const std::string& conversationId, const std::vector<uint8_t>& payload,
                    time_t received) {
             FILE_LOG_I("JamiBridge-C++", @"IncomingTrustRequest CALLBACK: account=%s from=%s convId=%s payloadSize=%zu received=%ld",
                   accountId.c_str(), from.c_str(), conversationId.c_str(), payload.size(), (long)received);
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *fromNS = toNSString(from);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *fromNS = toNSIdentifier(from);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             NSData *payloadData = [NSData dataWithBytes:payload.data() length:payload.size()];
             int64_t receivedNS = (int64_t)received;
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf) {
                     FILE_LOG_I("JamiBridge-C++", @"IncomingTrustRequest dispatching: hasDelegate=%d", strongSelf.delegate != nil);
@@ -447,12 +690,12 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Name registration ended
-    handlers.insert(exportable_callback<ConfigurationSignal::NameRegistrationEnded>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::NameRegistrationEnded>(
         [weakSelf](const std::string& accountId, int state, const std::string& name) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
             NSString *nameNS = toNSString(name);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onNameRegistrationEnded:state:name:)]) {
                     [strongSelf.delegate onNameRegistrationEnded:accountIdNS
@@ -463,13 +706,9 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Registered name found (lookup result)
-    handlers.insert(exportable_callback<ConfigurationSignal::RegisteredNameFound>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::RegisteredNameFound>(
         [weakSelf](const std::string& accountId, const std::string& requestName,
                    int state, const std::string& address, const std::string& name) {
-            // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *addressNS = toNSString(address);
-            NSString *nameNS = toNSString(name);
             JBLookupState lookupState;
             switch (state) {
                 case 0: lookupState = JBLookupStateSuccess; break;
@@ -477,24 +716,22 @@ static JBCallState toCallState(const std::string& state) {
                 case 2: lookupState = JBLookupStateInvalid; break;
                 default: lookupState = JBLookupStateError; break;
             }
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onRegisteredNameFound:state:address:name:)]) {
-                    [strongSelf.delegate onRegisteredNameFound:accountIdNS
-                                                         state:lookupState
-                                                       address:addressNS
-                                                          name:nameNS];
-                }
-            });
+            // Caches the result and completes the resolver lookups waiting on it
+            JBLookupResult *result = [[JBNameResolver shared] handleResult:accountId
+                                                                     query:requestName
+                                                                     state:lookupState
+                                                                   address:address
+                                                                      name:name];
+            [weakSelf deliverRegisteredName:result accountId:toNSIdentifier(accountId)];
         }));
 
     // Known devices changed
-    handlers.insert(exportable_callback<ConfigurationSignal::KnownDevicesChanged>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::KnownDevicesChanged>(
         [weakSelf](const std::string& accountId, const std::map<std::string, std::string>& devices) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
             NSDictionary *devicesNS = toNSDictionary(devices);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConfiguration, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onKnownDevicesChanged:devices:)]) {
                     [strongSelf.delegate onKnownDevicesChanged:accountIdNS
@@ -503,44 +740,35 @@ static JBCallState toCallState(const std::string& state) {
             });
         }));
 
-    // Composing status changed
-    handlers.insert(exportable_callback<ConfigurationSignal::ComposingStatusChanged>(
-        [weakSelf](const std::string& accountId, const std::string& convId,
-                   const std::string& from, int status) {
-            // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *convIdNS = toNSString(convId);
-            NSString *fromNS = toNSString(from);
-            BOOL isComposing = (status != 0);
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onComposingStatusChanged:conversationId:from:isComposing:)]) {
-                    [strongSelf.delegate onComposingStatusChanged:accountIdNS
-                                                   conversationId:convIdNS
-                                                             from:fromNS
-                                                      isComposing:isComposing];
-                }
-            });
+    // Composing status changed (coalesced per account/conversation/peer)
+    handlers.insert(instrumented_callback<ConfigurationSignal::ComposingStatusChanged>(
+        [composing](const std::string& accountId, const std::string& convId,
+                    const std::string& from, int status) {
+            composing->post({accountId, convId, from}, {accountId, convId, from, status});
         }));
 
     // Profile received
-    handlers.insert(exportable_callback<ConfigurationSignal::ProfileReceived>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::ProfileReceived>(
         [weakSelf](const std::string& accountId, const std::string& from, const std::string& vcard) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *fromNS = toNSString(from);
-            NSString *vcardNS = toNSString(vcard);
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onProfileReceived:from:displayName:avatarPath:)]) {
-                    // Parse vcard to extract display name and avatar
-                    // For now, pass the vcard as display name
-                    [strongSelf.delegate onProfileReceived:accountIdNS
-                                                      from:fromNS
-                                               displayName:vcardNS
-                                                avatarPath:nil];
-                }
-            });
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *fromNS = toNSIdentifier(from);
+            signalBytesConverted(vcard.size());
+            // The card (or the vcf it was written to) is parsed off the daemon thread;
+            // only the name and the thumbnail path reach the delegate
+            [[JBProfileThumbnailCache shared] processProfile:vcard accountId:accountId from:from
+                                                  completion:^(NSString *vcardPath, NSString *displayName, NSString *avatarPath) {
+                dispatchSignal(JBSignalDomainConfiguration, toCppIdentifier(accountIdNS), ^{
+                    JamiBridgeWrapper *strongSelf = weakSelf;
+                    if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onProfileReceived:from:vcardPath:displayName:avatarPath:)]) {
+                        [strongSelf.delegate onProfileReceived:accountIdNS
+                                                          from:fromNS
+                                                     vcardPath:vcardPath
+                                                   displayName:displayName
+                                                    avatarPath:avatarPath];
+                    }
+                });
+            }];
         }));
 
     // =========================================================================
@@ -548,14 +776,23 @@ static JBCallState toCallState(const std::string& state) {
     // =========================================================================
 
     // Call state change
-    handlers.insert(exportable_callback<CallSignal::StateChange>(
+    handlers.insert(instrumented_callback<CallSignal::StateChange>(
         [weakSelf](const std::string& accountId, const std::string& callId,
                    const std::string& state, int code) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *callIdNS = toNSString(callId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *callIdNS = toNSIdentifier(callId);
             JBCallState stateEnum = toCallState(state);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            callTraceStateChanged(callId, state, stateEnum);
+            if (stateEnum == JBCallStateOver || stateEnum == JBCallStateHungup
+                || stateEnum == JBCallStateFailure || stateEnum == JBCallStateBusy) {
+                [[JBCodecGovernor shared] callEnded:callId];
+                [[JBAudioSession shared] callEnded:callId];
+                forgetCallAccount(callId);
+            } else {
+                noteCallAccount(callId, accountId);
+            }
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onCallStateChanged:callId:state:code:)]) {
                     [strongSelf.delegate onCallStateChanged:accountIdNS
@@ -567,13 +804,14 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Incoming call
-    handlers.insert(exportable_callback<CallSignal::IncomingCall>(
+    handlers.insert(instrumented_callback<CallSignal::IncomingCall>(
         [weakSelf](const std::string& accountId, const std::string& callId,
                    const std::string& peerId, const std::vector<std::map<std::string, std::string>>& mediaList) {
+            noteCallAccount(callId, accountId);
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *callIdNS = toNSString(callId);
-            NSString *peerIdNS = toNSString(peerId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *callIdNS = toNSIdentifier(callId);
+            NSString *peerIdNS = toNSIdentifier(peerId);
             // Check if video is in media list
             bool hasVideo = false;
             for (const auto& media : mediaList) {
@@ -582,7 +820,7 @@ static JBCallState toCallState(const std::string& state) {
                     break;
                 }
             }
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onIncomingCall:callId:peerId:peerDisplayName:hasVideo:)]) {
                     [strongSelf.delegate onIncomingCall:accountIdNS
@@ -595,11 +833,11 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Audio muted
-    handlers.insert(exportable_callback<CallSignal::AudioMuted>(
+    handlers.insert(instrumented_callback<CallSignal::AudioMuted>(
         [weakSelf](const std::string& callId, bool muted) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *callIdNS = toNSString(callId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *callIdNS = toNSIdentifier(callId);
+            dispatchSignal(JBSignalDomainCall, callAccount(callId), ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onAudioMuted:muted:)]) {
                     [strongSelf.delegate onAudioMuted:callIdNS muted:muted];
@@ -608,11 +846,11 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Video muted
-    handlers.insert(exportable_callback<CallSignal::VideoMuted>(
+    handlers.insert(instrumented_callback<CallSignal::VideoMuted>(
         [weakSelf](const std::string& callId, bool muted) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *callIdNS = toNSString(callId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *callIdNS = toNSIdentifier(callId);
+            dispatchSignal(JBSignalDomainCall, callAccount(callId), ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onVideoMuted:muted:)]) {
                     [strongSelf.delegate onVideoMuted:callIdNS muted:muted];
@@ -620,15 +858,73 @@ static JBCallState toCallState(const std::string& state) {
             });
         }));
 
+    // Decoding started - register the zero-copy sink before notifying the UI
+    handlers.insert(instrumented_callback<VideoSignal::DecodingStarted>(
+        [weakSelf](const std::string& id, const std::string& shmPath, int width, int height, bool isMixer) {
+            [[JBVideoSinkManager shared] decodingStarted:id width:width height:height];
+            callTraceDecodingStarted(id, width, height);
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *idNS = toNSString(id);
+            dispatchSignal(JBSignalDomainVideo, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onDecodingStarted:width:height:isMixer:)]) {
+                    [strongSelf.delegate onDecodingStarted:idNS width:width height:height isMixer:isMixer];
+                }
+            });
+        }));
+
+    // Decoding stopped
+    handlers.insert(instrumented_callback<VideoSignal::DecodingStopped>(
+        [weakSelf](const std::string& id, const std::string& shmPath, bool isMixer) {
+            [[JBVideoSinkManager shared] decodingStopped:id];
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *idNS = toNSString(id);
+            dispatchSignal(JBSignalDomainVideo, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onDecodingStopped:isMixer:)]) {
+                    [strongSelf.delegate onDecodingStopped:idNS isMixer:isMixer];
+                }
+            });
+        }));
+
+    // Start capture - the daemon needs frames from a camera input
+    handlers.insert(instrumented_callback<VideoSignal::StartCapture>(
+        [weakSelf](const std::string& device) {
+            [[JBCodecGovernor shared] captureStarted:device];
+            [[JBCameraFrameProducer shared] captureStarted:device];
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *deviceNS = toNSIdentifier(device);
+            dispatchSignal(JBSignalDomainVideo, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onStartCapture:)]) {
+                    [strongSelf.delegate onStartCapture:deviceNS];
+                }
+            });
+        }));
+
+    // Stop capture
+    handlers.insert(instrumented_callback<VideoSignal::StopCapture>(
+        [weakSelf](const std::string& device) {
+            [[JBCodecGovernor shared] captureStopped:device];
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *deviceNS = toNSIdentifier(device);
+            dispatchSignal(JBSignalDomainVideo, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onStopCapture:)]) {
+                    [strongSelf.delegate onStopCapture:deviceNS];
+                }
+            });
+        }));
+
     // Conference created
-    handlers.insert(exportable_callback<CallSignal::ConferenceCreated>(
+    handlers.insert(instrumented_callback<CallSignal::ConferenceCreated>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    const std::string& conferenceId) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            NSString *conferenceIdNS = toNSString(conferenceId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            NSString *conferenceIdNS = toNSIdentifier(conferenceId);
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConferenceCreated:conversationId:conferenceId:)]) {
                     [strongSelf.delegate onConferenceCreated:accountIdNS
@@ -639,14 +935,14 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Conference changed
-    handlers.insert(exportable_callback<CallSignal::ConferenceChanged>(
+    handlers.insert(instrumented_callback<CallSignal::ConferenceChanged>(
         [weakSelf](const std::string& accountId, const std::string& conferenceId,
                    const std::string& state) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conferenceIdNS = toNSString(conferenceId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conferenceIdNS = toNSIdentifier(conferenceId);
             NSString *stateNS = toNSString(state);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConferenceChanged:conferenceId:state:)]) {
                     [strongSelf.delegate onConferenceChanged:accountIdNS
@@ -657,12 +953,13 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Conference removed
-    handlers.insert(exportable_callback<CallSignal::ConferenceRemoved>(
+    handlers.insert(instrumented_callback<CallSignal::ConferenceRemoved>(
         [weakSelf](const std::string& accountId, const std::string& conferenceId) {
+            [[JBConferenceStreams shared] conferenceRemoved:conferenceId];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conferenceIdNS = toNSString(conferenceId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conferenceIdNS = toNSIdentifier(conferenceId);
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConferenceRemoved:conferenceId:)]) {
                     [strongSelf.delegate onConferenceRemoved:accountIdNS
@@ -671,39 +968,28 @@ static JBCallState toCallState(const std::string& state) {
             });
         }));
 
-    // Conference info updated
-    handlers.insert(exportable_callback<CallSignal::OnConferenceInfosUpdated>(
-        [weakSelf](const std::string& conferenceId,
-                   const std::vector<std::map<std::string, std::string>>& participantInfos) {
-            // Copy data before async dispatch to avoid use-after-free
-            NSString *conferenceIdNS = toNSString(conferenceId);
-            NSMutableArray *infos = [NSMutableArray arrayWithCapacity:participantInfos.size()];
-            for (const auto& info : participantInfos) {
-                [infos addObject:toNSDictionary(info)];
-            }
-            NSArray *infosCopy = [infos copy];
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConferenceInfoUpdated:participantInfos:)]) {
-                    [strongSelf.delegate onConferenceInfoUpdated:conferenceIdNS
-                                                participantInfos:infosCopy];
-                }
-            });
+    // Conference info updated (coalesced per conference)
+    handlers.insert(instrumented_callback<CallSignal::OnConferenceInfosUpdated>(
+        [conferenceInfos](const std::string& conferenceId,
+                          const std::vector<std::map<std::string, std::string>>& participantInfos) {
+            [[JBConferenceStreams shared] conferenceInfosUpdated:conferenceId participants:participantInfos];
+            conferenceInfos->post(conferenceId, {conferenceId, participantInfos});
         }));
 
     // Media change requested
-    handlers.insert(exportable_callback<CallSignal::MediaChangeRequested>(
+    handlers.insert(instrumented_callback<CallSignal::MediaChangeRequested>(
         [weakSelf](const std::string& accountId, const std::string& callId,
                    const std::vector<std::map<std::string, std::string>>& mediaList) {
+            callTraceMediaChangeRequested(callId, mediaList.size());
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *callIdNS = toNSString(callId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *callIdNS = toNSIdentifier(callId);
             NSMutableArray *list = [NSMutableArray arrayWithCapacity:mediaList.size()];
             for (const auto& media : mediaList) {
                 [list addObject:toNSDictionary(media)];
             }
             NSArray *listCopy = [list copy];
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainCall, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onMediaChangeRequested:callId:mediaList:)]) {
                     [strongSelf.delegate onMediaChangeRequested:accountIdNS
@@ -718,12 +1004,14 @@ static JBCallState toCallState(const std::string& state) {
     // =========================================================================
 
     // Conversation ready
-    handlers.insert(exportable_callback<ConversationSignal::ConversationReady>(
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationReady>(
         [weakSelf](const std::string& accountId, const std::string& conversationId) {
+            // Cloned or re-synced: anything cached may predate the repository
+            [[JBConversationCache shared] invalidate:JBConversationFieldAll accountId:accountId conversationId:conversationId];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConversationReady:conversationId:)]) {
                     [strongSelf.delegate onConversationReady:accountIdNS
@@ -733,12 +1021,14 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Conversation removed
-    handlers.insert(exportable_callback<ConversationSignal::ConversationRemoved>(
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationRemoved>(
         [weakSelf](const std::string& accountId, const std::string& conversationId) {
+            [[JBMessageIndex shared] removeConversation:conversationId accountId:accountId];
+            [[JBConversationCache shared] removeConversation:conversationId accountId:accountId];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConversationRemoved:conversationId:)]) {
                     [strongSelf.delegate onConversationRemoved:accountIdNS
@@ -748,16 +1038,16 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Conversation request received
-    handlers.insert(exportable_callback<ConversationSignal::ConversationRequestReceived>(
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationRequestReceived>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    std::map<std::string, std::string> metadata) {
             FILE_LOG_I("JamiBridge-C++", @"ConversationRequestReceived CALLBACK: account=%s convId=%s metadataCount=%zu",
                   accountId.c_str(), conversationId.c_str(), metadata.size());
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             NSDictionary *metadataNS = toNSDictionary(metadata);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf) {
                     FILE_LOG_I("JamiBridge-C++", @"ConversationRequestReceived dispatching: hasDelegate=%d", strongSelf.delegate != nil);
@@ -774,14 +1064,18 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Swarm message received
-    handlers.insert(exportable_callback<ConversationSignal::SwarmMessageReceived>(
+    handlers.insert(instrumented_callback<ConversationSignal::SwarmMessageReceived>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    const SwarmMessage& message) {
+            [[JBMessageIndex shared] indexMessage:message accountId:accountId conversationId:conversationId];
+            [[JBReadReceipts shared] noteMessage:message];
+            [[JBTransferTracker shared] noteMessage:message];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             JBSwarmMessage *messageNS = toJBSwarmMessage(message);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            signalBytesConverted(payloadBytes(message.body));
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onMessageReceived:conversationId:message:)]) {
                     [strongSelf.delegate onMessageReceived:accountIdNS
@@ -791,56 +1085,52 @@ static JBCallState toCallState(const std::string& state) {
             });
         }));
 
-    // Swarm message updated
-    handlers.insert(exportable_callback<ConversationSignal::SwarmMessageUpdated>(
-        [weakSelf](const std::string& accountId, const std::string& conversationId,
-                   const SwarmMessage& message) {
-            // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            JBSwarmMessage *messageNS = toJBSwarmMessage(message);
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onMessageUpdated:conversationId:message:)]) {
-                    [strongSelf.delegate onMessageUpdated:accountIdNS
-                                           conversationId:conversationIdNS
-                                                  message:messageNS];
-                }
-            });
+    // Swarm message updated (coalesced per message)
+    handlers.insert(instrumented_callback<ConversationSignal::SwarmMessageUpdated>(
+        [messageUpdates](const std::string& accountId, const std::string& conversationId,
+                         const SwarmMessage& message) {
+            // Edits and deletions: the index keeps the latest body
+            [[JBMessageIndex shared] indexMessage:message accountId:accountId conversationId:conversationId];
+            messageUpdates->post({accountId, conversationId, message.id}, {accountId, conversationId, message});
         }));
 
     // Swarm loaded (messages loaded)
-    handlers.insert(exportable_callback<ConversationSignal::SwarmLoaded>(
+    handlers.insert(instrumented_callback<ConversationSignal::SwarmLoaded>(
         [weakSelf](uint32_t requestId, const std::string& accountId,
                    const std::string& conversationId, std::vector<SwarmMessage> messages) {
-            // Copy data before async dispatch to avoid use-after-free
-            // Note: messages is passed by value so it's already a copy, but we convert to NS types early
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            NSMutableArray *msgArray = [NSMutableArray arrayWithCapacity:messages.size()];
-            for (const auto& msg : messages) {
-                [msgArray addObject:toJBSwarmMessage(msg)];
-            }
-            NSArray *msgArrayCopy = [msgArray copy];
-            dispatch_async(dispatch_get_main_queue(), ^{
-                JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onMessagesLoaded:accountId:conversationId:messages:)]) {
-                    [strongSelf.delegate onMessagesLoaded:(int)requestId
-                                                accountId:accountIdNS
-                                           conversationId:conversationIdNS
-                                                 messages:msgArrayCopy];
+            JamiBridgeWrapper *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            [[JBMessageIndex shared] indexMessages:messages accountId:accountId conversationId:conversationId];
+            [[JBReadReceipts shared] noteMessages:messages];
+            [[JBTransferTracker shared] noteMessages:messages];
+            // messages is passed by value: the cursor takes ownership and converts
+            // them chunk by chunk on the conversation queue
+            BOOL chunked = [strongSelf.delegate respondsToSelector:@selector(onMessagesLoadedChunk:cursor:)];
+            JBMessagesLoadCursor *cursor =
+                [[JBMessagesLoadCursor alloc] initWithRequestId:(int)requestId
+                                                      accountId:toNSIdentifier(accountId)
+                                                 conversationId:toNSIdentifier(conversationId)
+                                                       messages:std::move(messages)
+                                                      chunkSize:chunked ? strongSelf.messagesLoadChunkSize : 0];
+            if (chunked) {
+                @synchronized (strongSelf.messagesLoads) {
+                    strongSelf.messagesLoads[@(requestId)] = cursor;
                 }
+            }
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
+                [weakSelf deliverMessagesLoad:cursor chunked:chunked];
             });
         }));
 
     // Conversation member event
-    handlers.insert(exportable_callback<ConversationSignal::ConversationMemberEvent>(
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationMemberEvent>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    const std::string& memberUri, int event) {
+            [[JBConversationCache shared] invalidate:JBConversationFieldMembers accountId:accountId conversationId:conversationId];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
-            NSString *memberUriNS = toNSString(memberUri);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            NSString *memberUriNS = toNSIdentifier(memberUri);
             JBMemberEventType eventType;
             switch (event) {
                 case 0: eventType = JBMemberEventTypeJoin; break; // Add
@@ -849,7 +1139,7 @@ static JBCallState toCallState(const std::string& state) {
                 case 3: eventType = JBMemberEventTypeBan; break; // Banned
                 default: eventType = JBMemberEventTypeJoin; break;
             }
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConversationMemberEvent:conversationId:memberUri:event:)]) {
                     [strongSelf.delegate onConversationMemberEvent:accountIdNS
@@ -861,14 +1151,16 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Conversation profile updated
-    handlers.insert(exportable_callback<ConversationSignal::ConversationProfileUpdated>(
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationProfileUpdated>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    std::map<std::string, std::string> profile) {
+            // The profile is only part of conversationInfos: reload it on next access
+            [[JBConversationCache shared] invalidate:JBConversationFieldInfo accountId:accountId conversationId:conversationId];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             NSDictionary *profileNS = toNSDictionary(profile);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConversationProfileUpdated:conversationId:profile:)]) {
                     [strongSelf.delegate onConversationProfileUpdated:accountIdNS
@@ -878,16 +1170,76 @@ static JBCallState toCallState(const std::string& state) {
             });
         }));
 
+    // Conversation preferences updated (carries the full preference map)
+    handlers.insert(instrumented_callback<ConversationSignal::ConversationPreferencesUpdated>(
+        [weakSelf](const std::string& accountId, const std::string& conversationId,
+                   std::map<std::string, std::string> preferences) {
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            NSDictionary *preferencesNS = toNSDictionary(preferences);
+            [[JBConversationCache shared] storeInfo:nil
+                                            members:nil
+                                        preferences:preferencesNS
+                                          accountId:accountId
+                                     conversationId:conversationId];
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onConversationPreferencesUpdated:conversationId:preferences:)]) {
+                    [strongSelf.delegate onConversationPreferencesUpdated:accountIdNS
+                                                           conversationId:conversationIdNS
+                                                              preferences:preferencesNS];
+                }
+            });
+        }));
+
+    // Messages found: one batch per searched conversation as it completes,
+    // then an empty conversationId once the whole request is done
+    handlers.insert(instrumented_callback<ConversationSignal::MessagesFound>(
+        [weakSelf](uint32_t requestId, const std::string& accountId, const std::string& conversationId,
+                   std::vector<std::map<std::string, std::string>> messages) {
+            JamiBridgeWrapper *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            // Superseded search: drop the batch before converting it
+            BOOL cancelled;
+            @synchronized (strongSelf.cancelledSearches) {
+                cancelled = [strongSelf.cancelledSearches containsIndex:requestId];
+                if (cancelled && conversationId.empty()) {
+                    [strongSelf.cancelledSearches removeIndex:requestId];
+                }
+            }
+            if (cancelled) return;
+
+            // Copy data before async dispatch to avoid use-after-free
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            NSMutableArray *list = [NSMutableArray arrayWithCapacity:messages.size()];
+            for (const auto& message : messages) {
+                [list addObject:toNSDictionary(message)];
+                signalBytesConverted(payloadBytes(message));
+            }
+            NSArray *listCopy = [list copy];
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onMessagesFound:requestId:conversationId:messages:)]) {
+                    [strongSelf.delegate onMessagesFound:accountIdNS
+                                               requestId:requestId
+                                          conversationId:conversationIdNS
+                                                messages:listCopy];
+                }
+            });
+        }));
+
     // Reaction added
-    handlers.insert(exportable_callback<ConversationSignal::ReactionAdded>(
+    handlers.insert(instrumented_callback<ConversationSignal::ReactionAdded>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    const std::string& messageId, std::map<std::string, std::string> reaction) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             NSString *messageIdNS = toNSString(messageId);
             NSDictionary *reactionNS = toNSDictionary(reaction);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onReactionAdded:conversationId:messageId:reaction:)]) {
                     [strongSelf.delegate onReactionAdded:accountIdNS
@@ -899,15 +1251,15 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Reaction removed
-    handlers.insert(exportable_callback<ConversationSignal::ReactionRemoved>(
+    handlers.insert(instrumented_callback<ConversationSignal::ReactionRemoved>(
         [weakSelf](const std::string& accountId, const std::string& conversationId,
                    const std::string& messageId, const std::string& reactionId) {
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *conversationIdNS = toNSString(conversationId);
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
             NSString *messageIdNS = toNSString(messageId);
             NSString *reactionIdNS = toNSString(reactionId);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
                 if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onReactionRemoved:conversationId:messageId:reactionId:)]) {
                     [strongSelf.delegate onReactionRemoved:accountIdNS
@@ -919,33 +1271,76 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // =========================================================================
-    // Presence Signals
+    // Data Transfer Signals
     // =========================================================================
 
-    // New buddy notification (presence)
-    handlers.insert(exportable_callback<PresenceSignal::NewBuddyNotification>(
-        [weakSelf](const std::string& accountId, const std::string& buddyUri,
-                   int status, const std::string& lineStatus) {
+    // Transfer progress is sampled by the tracker while a transfer is ongoing.
+    // A sample is split by account so each part waits in its account's lane.
+    [JBTransferTracker shared].progressHandler = ^(NSArray<JBFileTransferInfo *> *transfers) {
+        std::map<std::string, NSMutableArray<JBFileTransferInfo *> *> byAccount;
+        for (JBFileTransferInfo *transfer in transfers) {
+            auto& accountTransfers = byAccount[toCppIdentifier(transfer.accountId)];
+            if (!accountTransfers) accountTransfers = [NSMutableArray array];
+            [accountTransfers addObject:transfer];
+        }
+        for (const auto& [accountId, accountTransfers] : byAccount) {
+            NSArray<JBFileTransferInfo *> *batch = [accountTransfers copy];
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
+                JamiBridgeWrapper *strongSelf = weakSelf;
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onDataTransferProgress:)]) {
+                    [strongSelf.delegate onDataTransferProgress:batch];
+                }
+            });
+        }
+    };
+
+    // Data transfer event
+    handlers.insert(instrumented_callback<DataTransferSignal::DataTransferEvent>(
+        [weakSelf](const std::string& accountId, const std::string& conversationId,
+                   const std::string& interactionId, const std::string& fileId, int eventCode) {
+            [[JBTransferTracker shared] handleEvent:accountId
+                                     conversationId:conversationId
+                                      interactionId:interactionId
+                                             fileId:fileId
+                                          eventCode:eventCode];
+            [[JBScopedFileAccess shared] handleEvent:accountId
+                                      conversationId:conversationId
+                                              fileId:fileId
+                                           eventCode:eventCode];
             // Copy data before async dispatch to avoid use-after-free
-            NSString *accountIdNS = toNSString(accountId);
-            NSString *buddyUriNS = toNSString(buddyUri);
-            BOOL isOnline = (status != 0);
-            dispatch_async(dispatch_get_main_queue(), ^{
+            NSString *accountIdNS = toNSIdentifier(accountId);
+            NSString *conversationIdNS = toNSIdentifier(conversationId);
+            NSString *interactionIdNS = toNSString(interactionId);
+            NSString *fileIdNS = toNSString(fileId);
+            dispatchSignal(JBSignalDomainConversation, accountId, ^{
                 JamiBridgeWrapper *strongSelf = weakSelf;
-                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onPresenceChanged:uri:isOnline:)]) {
-                    [strongSelf.delegate onPresenceChanged:accountIdNS
-                                                       uri:buddyUriNS
-                                                  isOnline:isOnline];
+                if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onDataTransferEvent:conversationId:interactionId:fileId:eventCode:)]) {
+                    [strongSelf.delegate onDataTransferEvent:accountIdNS
+                                              conversationId:conversationIdNS
+                                               interactionId:interactionIdNS
+                                                      fileId:fileIdNS
+                                                   eventCode:eventCode];
                 }
             });
         }));
 
+    // =========================================================================
+    // Presence Signals
+    // =========================================================================
+
+    // New buddy notification (presence, coalesced per account/buddy)
+    handlers.insert(instrumented_callback<PresenceSignal::NewBuddyNotification>(
+        [presence](const std::string& accountId, const std::string& buddyUri,
+                   int status, const std::string& lineStatus) {
+            presence->post({accountId, buddyUri}, {accountId, buddyUri, status, lineStatus});
+        }));
+
     // =========================================================================
     // iOS/Android-specific callbacks (conditionally compiled)
     // =========================================================================
 #if defined(__ANDROID__) || (defined(TARGET_OS_IOS) && TARGET_OS_IOS)
     // Get app data path - iOS/Android needs to provide the data directory
-    handlers.insert(exportable_callback<ConfigurationSignal::GetAppDataPath>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::GetAppDataPath>(
         [weakSelf](const std::string& name, std::vector<std::string>* paths) {
             JamiBridgeWrapper *strongSelf = weakSelf;
             if (strongSelf && strongSelf.dataPath) {
@@ -954,7 +1349,7 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Get device name
-    handlers.insert(exportable_callback<ConfigurationSignal::GetDeviceName>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::GetDeviceName>(
         [](std::vector<std::string>* names) {
 #if TARGET_OS_IPHONE
             NSString *deviceName = [[UIDevice currentDevice] name];
@@ -965,16 +1360,14 @@ static JBCallState toCallState(const std::string& state) {
         }));
 
     // Get hardware audio format
-    handlers.insert(exportable_callback<ConfigurationSignal::GetHardwareAudioFormat>(
+    handlers.insert(instrumented_callback<ConfigurationSignal::GetHardwareAudioFormat>(
         [](std::vector<int32_t>* params) {
-            // Standard audio format: 48000 Hz, stereo
-            params->push_back(48000); // Sample rate
-            params->push_back(2);     // Channels
+            // {sample rate, frames per buffer} of the current AVAudioSession route
+            [[JBAudioSession shared] appendHardwareFormat:*params];
         }));
 #endif // iOS/Android callbacks
 
-    libjami::registerSignalHandlers(handlers);
-    FILE_LOG_I("JamiBridge", @"Signal handlers registered successfully");
+    return handlers;
 }
 
 // =============================================================================
@@ -982,6 +1375,40 @@ static JBCallState toCallState(const std::string& state) {
 // =============================================================================
 
 - (void)initDaemonWithDataPath:(NSString *)dataPath {
+    [self setStage:JBDaemonStageStarting];
+    if (![self initializeDaemonWithDataPath:dataPath]) {
+        [self setStage:JBDaemonStageFailed];
+    }
+}
+
+- (void)startDaemon {
+    if (![self startInitializedDaemon]) {
+        [self setStage:JBDaemonStageFailed];
+    }
+}
+
+- (void)startDaemonAsyncWithDataPath:(NSString *)dataPath {
+    @synchronized (self) {
+        JBDaemonStage stage = self.daemonStage;
+        if (stage != JBDaemonStageStopped && stage != JBDaemonStageFailed) {
+            FILE_LOG_W("JamiBridge", @"startDaemonAsync ignored, stage=%ld", (long)stage);
+            return;
+        }
+        [self setStage:JBDaemonStageStarting];
+    }
+    NSString *path = [dataPath copy];
+    dispatch_async(self.startupQueue, ^{
+        if (!libjami::initialized() && ![self initializeDaemonWithDataPath:path]) {
+            [self setStage:JBDaemonStageFailed];
+            return;
+        }
+        if (![self startInitializedDaemon]) {
+            [self setStage:JBDaemonStageFailed];
+        }
+    });
+}
+
+- (BOOL)initializeDaemonWithDataPath:(NSString *)dataPath {
     FILE_LOG_I("JamiBridge", @"initDaemon with path: %@", dataPath);
     self.dataPath = dataPath;
 
@@ -994,6 +1421,7 @@ static JBCallState toCallState(const std::string& state) {
             FILE_LOG_E("JamiBridge", @"Failed to create data directory: %@", error);
         }
     }
+    [[JBMessageIndex shared] openInDirectory:dataPath];
 
     // Initialize with iOS flags
     int flags = LIBJAMI_FLAG_CONSOLE_LOG | LIBJAMI_FLAG_IOS_EXTENSION;
@@ -1001,32 +1429,57 @@ static JBCallState toCallState(const std::string& state) {
 
     if (!libjami::init(static_cast<InitFlag>(flags))) {
         FILE_LOG_E("JamiBridge", @"libjami::init() FAILED!");
-        return;
+        return NO;
     }
     FILE_LOG_I("JamiBridge", @"libjami::init() succeeded");
 
     [self registerSignalHandlers];
     FILE_LOG_I("JamiBridge", @"Daemon initialized successfully");
+    [self setStage:JBDaemonStageInitialized];
+    return YES;
 }
 
-- (void)startDaemon {
+- (BOOL)startInitializedDaemon {
     FILE_LOG_I("JamiBridge", @"startDaemon called");
 
     std::filesystem::path configPath;  // Empty = use default
     FILE_LOG_I("JamiBridge", @"Calling libjami::start()...");
     if (!libjami::start(configPath)) {
         FILE_LOG_E("JamiBridge", @"libjami::start() FAILED!");
-        return;
+        return NO;
     }
 
     self.daemonRunning = YES;
     FILE_LOG_I("JamiBridge", @"Daemon started successfully, daemonRunning=YES");
+    [self setStage:JBDaemonStageAccountsLoaded];
+    if (self.accountRegisteredDuringStart) {
+        [self setStage:JBDaemonStageAccountRegistered];
+    }
+    return YES;
 }
 
 - (void)stopDaemon {
     NSLog(@"[JamiBridge] stopDaemon");
-    libjami::fini();
-    self.daemonRunning = NO;
+    dispatch_block_t stop = ^{
+        [[JBReadReceipts shared] flush];
+        {
+            // Closed before fini, after the helpers inside performIfLibjamiReady:.
+            // The stage only changes once fini returned.
+            std::unique_lock<std::shared_mutex> lock(self->_readyLock);
+            self->_libjamiReady.store(false, std::memory_order_release);
+        }
+        libjami::fini();
+        self.daemonRunning = NO;
+        self.accountRegisteredDuringStart = NO;
+        [self setStage:JBDaemonStageStopped];
+    };
+    // Waits for a startup in progress: fini must not run concurrently with start.
+    // A performWhenDaemonReady: block is already on the startup queue.
+    if (dispatch_get_specific(kStartupQueueKey)) {
+        stop();
+    } else {
+        dispatch_sync(self.startupQueue, stop);
+    }
     NSLog(@"[JamiBridge] Daemon stopped");
 }
 
@@ -1034,11 +1487,101 @@ static JBCallState toCallState(const std::string& state) {
     return libjami::initialized() && self.daemonRunning;
 }
 
+- (BOOL)performIfLibjamiReady:(NS_NOESCAPE dispatch_block_t)block {
+    std::shared_lock<std::shared_mutex> lock(_readyLock);
+    if (!_libjamiReady.load(std::memory_order_acquire)) return NO;
+    block();
+    return YES;
+}
+
+- (void)performWhenDaemonReady:(dispatch_block_t)block {
+    @synchronized (self) {
+        JBDaemonStage stage = self.daemonStage;
+        if (stage == JBDaemonStageAccountsLoaded || stage == JBDaemonStageAccountRegistered) {
+            dispatch_async(self.startupQueue, block);
+        } else if (stage == JBDaemonStageFailed) {
+            FILE_LOG_W("JamiBridge", @"performWhenDaemonReady: daemon failed to start, block dropped");
+        } else {
+            [self.readyBlocks addObject:[block copy]];
+        }
+    }
+}
+
+// Any thread
+- (void)setStage:(JBDaemonStage)stage {
+    NSArray<dispatch_block_t> *ready = nil;
+    @synchronized (self) {
+        if (stage == self.daemonStage) return;
+        self.daemonStage = stage;
+        _libjamiReady.store(stage == JBDaemonStageInitialized || stage == JBDaemonStageAccountsLoaded
+                            || stage == JBDaemonStageAccountRegistered, std::memory_order_release);
+        if (stage == JBDaemonStageAccountsLoaded) {
+            ready = [self.readyBlocks copy];
+            [self.readyBlocks removeAllObjects];
+        } else if (stage == JBDaemonStageStopped || stage == JBDaemonStageFailed) {
+            if (self.readyBlocks.count > 0) {
+                FILE_LOG_W("JamiBridge", @"Dropping %lu blocks waiting for the daemon",
+                           (unsigned long)self.readyBlocks.count);
+            }
+            [self.readyBlocks removeAllObjects];
+        }
+        // Queued under the lock so transitions reach the delegate in order
+        __weak JamiBridgeWrapper *weakSelf = self;
+        dispatchSignal(JBSignalDomainConfiguration, ^{
+            JamiBridgeWrapper *strongSelf = weakSelf;
+            if (strongSelf && [strongSelf.delegate respondsToSelector:@selector(onDaemonStageChanged:)]) {
+                [strongSelf.delegate onDaemonStageChanged:stage];
+            }
+        });
+    }
+    FILE_LOG_I("JamiBridge", @"Daemon stage: %ld", (long)stage);
+    for (dispatch_block_t block in ready) {
+        dispatch_async(self.startupQueue, block);
+    }
+}
+
+// RegistrationStateChanged to REGISTERED, on the daemon thread
+- (void)daemonAccountRegistered {
+    @synchronized (self) {
+        JBDaemonStage stage = self.daemonStage;
+        if (stage == JBDaemonStageAccountsLoaded) {
+            [self setStage:JBDaemonStageAccountRegistered];
+        } else if (stage == JBDaemonStageStarting || stage == JBDaemonStageInitialized) {
+            self.accountRegisteredDuringStart = YES;
+        }
+    }
+}
+
+// =============================================================================
+// Notification Service Extension
+// =============================================================================
+
+- (void)handleExtensionPush:(NSDictionary<NSString *, NSString *> *)pushData
+                  accountId:(NSString *)accountId
+             conversationId:(NSString *)conversationId
+                    timeout:(NSTimeInterval)timeout
+                 completion:(JBExtensionCompletion)completion {
+    if (self.daemonStage != JBDaemonStageStopped && self.daemonStage != JBDaemonStageFailed) {
+        FILE_LOG_W("JamiBridge", @"handleExtensionPush: daemon already started, ignored");
+        JBExtensionResult *result = [[JBExtensionResult alloc] init];
+        result.accountId = [accountId copy];
+        result.conversationId = [conversationId copy];
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{ completion(result); });
+        return;
+    }
+    [JBExtensionSession runWithAccountId:toCppString(accountId)
+                          conversationId:toCppString(conversationId)
+                                pushData:toCppMap(pushData)
+                                 timeout:timeout
+                              completion:completion];
+}
+
 // =============================================================================
 // Account Management
 // =============================================================================
 
 - (NSString *)createAccountWithDisplayName:(NSString *)displayName password:(NSString *)password {
+    JB_REQUIRE_DAEMON(@"");
     FILE_LOG_I("JamiBridge", @"createAccount: displayName=%@", displayName);
 
     std::map<std::string, std::string> details;
@@ -1059,10 +1602,11 @@ static JBCallState toCallState(const std::string& state) {
     auto accounts = libjami::getAccountList();
     FILE_LOG_I("JamiBridge", @"Current account count: %zu", accounts.size());
 
-    return toNSString(accountId);
+    return toNSIdentifier(accountId);
 }
 
 - (NSString *)importAccountFromArchive:(NSString *)archivePath password:(NSString *)password {
+    JB_REQUIRE_DAEMON(@"");
     NSLog(@"[JamiBridge] importAccount from: %@", archivePath);
 
     std::map<std::string, std::string> details;
@@ -1071,50 +1615,64 @@ static JBCallState toCallState(const std::string& state) {
     details[Account::ConfProperties::ARCHIVE_PASSWORD] = toCppString(password);
 
     std::string accountId = libjami::addAccount(details);
-    return toNSString(accountId);
+    return toNSIdentifier(accountId);
 }
 
 - (BOOL)exportAccount:(NSString *)accountId
     toDestinationPath:(NSString *)destinationPath
          withPassword:(NSString *)password {
+    JB_REQUIRE_DAEMON(NO);
     NSLog(@"[JamiBridge] exportAccount: %@ to %@", accountId, destinationPath);
-    return libjami::exportToFile(toCppString(accountId), toCppString(destinationPath), "", toCppString(password));
+    return libjami::exportToFile(toCppIdentifier(accountId), toCppString(destinationPath), "", toCppString(password));
 }
 
 - (void)deleteAccount:(NSString *)accountId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] deleteAccount: %@", accountId);
-    libjami::removeAccount(toCppString(accountId));
+    libjami::removeAccount(toCppIdentifier(accountId));
+    [[JBMessageIndex shared] removeAccount:accountId];
+    [[JBConversationCache shared] removeAccount:toCppIdentifier(accountId)];
+    [[JBProfileThumbnailCache shared] removeAccount:accountId];
+    [[JBReadReceipts shared] removeAccount:toCppIdentifier(accountId)];
+    [[JBMemoryGovernor shared] removeAccount:toCppIdentifier(accountId)];
+    [[JBSignalDispatcher shared] removeAccount:toCppIdentifier(accountId)];
 }
 
 - (NSArray<NSString *> *)getAccountIds {
+    JB_REQUIRE_DAEMON(@[]);
     std::vector<std::string> accounts = libjami::getAccountList();
     return toNSArray(accounts);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getAccountDetails:(NSString *)accountId {
-    auto details = libjami::getAccountDetails(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getAccountDetails(toCppIdentifier(accountId));
     return toNSDictionary(details);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getVolatileAccountDetails:(NSString *)accountId {
-    auto details = libjami::getVolatileAccountDetails(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getVolatileAccountDetails(toCppIdentifier(accountId));
     return toNSDictionary(details);
 }
 
 - (void)setAccountDetails:(NSString *)accountId
                   details:(NSDictionary<NSString *, NSString *> *)details {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setAccountDetails: %@", accountId);
-    libjami::setAccountDetails(toCppString(accountId), toCppMap(details));
+    libjami::setAccountDetails(toCppIdentifier(accountId), toCppMap(details));
 }
 
 - (void)setAccountActive:(NSString *)accountId active:(BOOL)active {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setAccountActive: %@ active: %d", accountId, active);
-    libjami::setAccountActive(toCppString(accountId), active);
+    libjami::setAccountActive(toCppIdentifier(accountId), active);
 }
 
 - (void)updateProfile:(NSString *)accountId
           displayName:(NSString *)displayName
            avatarPath:(nullable NSString *)avatarPath {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] updateProfile: %@ name: %@ avatarPath: %@", accountId, displayName, avatarPath);
     // Determine MIME type from file extension so the daemon broadcasts the profile to contacts.
     // An empty fileType tells the daemon to skip avatar processing entirely.
@@ -1130,7 +1688,7 @@ static JBCallState toCallState(const std::string& state) {
         }
     }
     NSLog(@"[JamiBridge] updateProfile fileType: %@", fileType);
-    libjami::updateProfile(toCppString(accountId),
+    libjami::updateProfile(toCppIdentifier(accountId),
                           toCppString(displayName),
                           avatarPath ? toCppString(avatarPath) : "",
                           toCppString(fileType),
@@ -1138,44 +1696,184 @@ static JBCallState toCallState(const std::string& state) {
 }
 
 - (BOOL)registerName:(NSString *)accountId name:(NSString *)name password:(NSString *)password {
+    JB_REQUIRE_DAEMON(NO);
     NSLog(@"[JamiBridge] registerName: %@ name: %@", accountId, name);
-    return libjami::registerName(toCppString(accountId), toCppString(name), "", toCppString(password));
+    return libjami::registerName(toCppIdentifier(accountId), toCppString(name), "", toCppString(password));
 }
 
-- (nullable JBLookupResult *)lookupName:(NSString *)accountId name:(NSString *)name {
+- (BOOL)lookupName:(NSString *)accountId name:(NSString *)name {
+    JB_REQUIRE_DAEMON(NO);
+    JBLookupResult *cached = [[JBNameResolver shared] cachedResultForName:name accountId:accountId];
+    if (cached) {
+        // Callers waiting on onRegisteredNameFound still get their answer
+        [self deliverRegisteredName:cached accountId:accountId];
+        return YES;
+    }
     NSLog(@"[JamiBridge] lookupName: %@", name);
-    libjami::lookupName(toCppString(accountId), "", toCppString(name));
     // Result comes via RegisteredNameFound callback
-    return nil;
+    return [[JBNameResolver shared] resolveName:name accountId:accountId completion:nil];
 }
 
-- (nullable JBLookupResult *)lookupAddress:(NSString *)accountId address:(NSString *)address {
+- (BOOL)lookupAddress:(NSString *)accountId address:(NSString *)address {
+    JB_REQUIRE_DAEMON(NO);
+    JBLookupResult *cached = [[JBNameResolver shared] cachedResultForAddress:address accountId:accountId];
+    if (cached) {
+        [self deliverRegisteredName:cached accountId:accountId];
+        return YES;
+    }
     NSLog(@"[JamiBridge] lookupAddress: %@", address);
-    libjami::lookupAddress(toCppString(accountId), "", toCppString(address));
     // Result comes via RegisteredNameFound callback
-    return nil;
+    return [[JBNameResolver shared] resolveAddress:address accountId:accountId completion:nil];
+}
+
+- (void)deliverRegisteredName:(JBLookupResult *)result accountId:(NSString *)accountId {
+    NSString *accountIdCopy = [accountId copy];
+    dispatchSignal(JBSignalDomainConfiguration, toCppIdentifier(accountIdCopy), ^{
+        id<JamiBridgeDelegate> delegate = self.delegate;
+        if ([delegate respondsToSelector:@selector(onRegisteredNameFound:state:address:name:query:)]) {
+            [delegate onRegisteredNameFound:accountIdCopy
+                                      state:result.state
+                                    address:result.address
+                                       name:result.name
+                                      query:result.query];
+        } else if ([delegate respondsToSelector:@selector(onRegisteredNameFound:state:address:name:)]) {
+            [delegate onRegisteredNameFound:accountIdCopy
+                                      state:result.state
+                                    address:result.address
+                                       name:result.name];
+        }
+    });
+}
+
+// =============================================================================
+// Account Bootstrap
+// =============================================================================
+
+- (JBAccountSnapshot *)snapshotAccount:(NSString *)accountId {
+    JB_REQUIRE_DAEMON(emptyAccountSnapshot(accountId));
+    std::string account = toCppIdentifier(accountId);
+    JBAccountSnapshot *snapshot = [[JBAccountSnapshot alloc] init];
+    snapshot.accountId = [accountId copy];
+    snapshot.details = toNSDictionary(libjami::getAccountDetails(account));
+    snapshot.volatileDetails = toNSDictionary(libjami::getVolatileAccountDetails(account));
+    snapshot.contacts = toJBContacts(libjami::getContacts(account));
+    snapshot.conversationRequests = toJBConversationRequests(libjami::getConversationRequests(account));
+    snapshot.trustRequests = toJBTrustRequests(libjami::getTrustRequests(account));
+
+    // Each conversation is an independent repository on the daemon side:
+    // query and convert them in parallel, each worker filling its own slot
+    auto conversationIds = libjami::getConversations(account);
+    std::vector<JBConversationSnapshot *> conversations(conversationIds.size());
+    // dispatch_apply is synchronous: the block can work through pointers to the locals
+    const std::string *ids = conversationIds.data();
+    JBConversationSnapshot * __strong *slots = conversations.data();
+    dispatch_apply(conversationIds.size(), dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        JBConversationSnapshot *conversation = [[JBConversationSnapshot alloc] init];
+        conversation.conversationId = toNSIdentifier(ids[i]);
+        // A member or profile signal landing during the reads invalidates the
+        // entry: the values read here may predate it and are then not cached
+        uint64_t epoch = [[JBConversationCache shared] epoch:account conversationId:ids[i]];
+        conversation.info = toNSDictionary(libjami::conversationInfos(account, ids[i]));
+        conversation.members = toJBConversationMembers(libjami::getConversationMembers(account, ids[i]));
+        // Later getConversationInfo/Members calls are served from them
+        [[JBConversationCache shared] storeInfo:conversation.info
+                                        members:conversation.members
+                                      accountId:account
+                                 conversationId:ids[i]
+                                        ifEpoch:epoch];
+        slots[i] = conversation;
+    });
+    NSMutableArray<JBConversationSnapshot *> *conversationList = [NSMutableArray arrayWithCapacity:conversations.size()];
+    for (JBConversationSnapshot *conversation : conversations) {
+        [conversationList addObject:conversation];
+    }
+    snapshot.conversations = [conversationList copy];
+    return snapshot;
+}
+
+- (NSArray<JBAccountSnapshot *> *)snapshotAllAccounts {
+    JB_REQUIRE_DAEMON(@[]);
+    auto accountIds = libjami::getAccountList();
+    NSMutableArray<JBAccountSnapshot *> *snapshots = [NSMutableArray arrayWithCapacity:accountIds.size()];
+    for (const auto& accountId : accountIds) {
+        [snapshots addObject:[self snapshotAccount:toNSIdentifier(accountId)]];
+    }
+    return [snapshots copy];
+}
+
+// =============================================================================
+// Name Resolution
+// =============================================================================
+
+- (void)resolveName:(NSString *)name
+          accountId:(NSString *)accountId
+         completion:(JBLookupCompletion)completion {
+    JB_REQUIRE_DAEMON(failLookup(name, accountId, completion));
+    [[JBNameResolver shared] resolveName:name accountId:accountId completion:completion];
+}
+
+- (void)resolveAddress:(NSString *)address
+             accountId:(NSString *)accountId
+            completion:(JBLookupCompletion)completion {
+    JB_REQUIRE_DAEMON(failLookup(address, accountId, completion));
+    [[JBNameResolver shared] resolveAddress:address accountId:accountId completion:completion];
+}
+
+- (void)resolveAddresses:(NSArray<NSString *> *)addresses
+               accountId:(NSString *)accountId
+              completion:(void (^)(NSDictionary<NSString *, JBLookupResult *> *results))completion {
+    if (!completion) return;
+    NSOrderedSet<NSString *> *unique = [NSOrderedSet orderedSetWithArray:addresses];
+    JB_REQUIRE_DAEMON(failLookups(unique.array, accountId, completion));
+    if (unique.count == 0) {
+        dispatchSignal(JBSignalDomainConfiguration, toCppIdentifier(accountId), ^{ completion(@{}); });
+        return;
+    }
+    // Cached addresses complete right away, the others share in-flight requests
+    NSMutableDictionary<NSString *, JBLookupResult *> *results =
+        [NSMutableDictionary dictionaryWithCapacity:unique.count];
+    NSUInteger expected = unique.count;
+    for (NSString *address in unique) {
+        [[JBNameResolver shared] resolveAddress:address accountId:accountId completion:^(JBLookupResult *result) {
+            NSDictionary<NSString *, JBLookupResult *> *done = nil;
+            // The delivery queue may have been replaced by a concurrent one
+            @synchronized (results) {
+                results[address] = result;
+                if (results.count == expected) done = [results copy];
+            }
+            if (done) completion(done);
+        }];
+    }
+}
+
+- (void)clearLookupCache {
+    [[JBNameResolver shared] clear];
 }
 
 - (NSDictionary<NSString *, NSString *> *)getAccountTemplate:(NSString *)accountType {
+    JB_REQUIRE_DAEMON(@{});
     auto tmpl = libjami::getAccountTemplate(toCppString(accountType));
     return toNSDictionary(tmpl);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getKnownRingDevices:(NSString *)accountId {
-    auto devices = libjami::getKnownRingDevices(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@{});
+    auto devices = libjami::getKnownRingDevices(toCppIdentifier(accountId));
     return toNSDictionary(devices);
 }
 
 - (BOOL)changeAccountPassword:(NSString *)accountId
                   oldPassword:(NSString *)oldPassword
                   newPassword:(NSString *)newPassword {
-    return libjami::changeAccountPassword(toCppString(accountId),
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::changeAccountPassword(toCppIdentifier(accountId),
                                           toCppString(oldPassword),
                                           toCppString(newPassword));
 }
 
 - (NSArray<NSDictionary<NSString *, NSString *> *> *)getCredentials:(NSString *)accountId {
-    auto creds = libjami::getCredentials(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto creds = libjami::getCredentials(toCppIdentifier(accountId));
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:creds.size()];
     for (const auto& credMap : creds) {
         [result addObject:toNSDictionary(credMap)];
@@ -1185,6 +1883,7 @@ static JBCallState toCallState(const std::string& state) {
 
 - (void)setCredentials:(NSString *)accountId
            credentials:(NSArray<NSDictionary<NSString *, NSString *> *> *)credentials {
+    JB_REQUIRE_DAEMON();
     std::vector<std::map<std::string, std::string>> creds;
     for (NSDictionary *dict in credentials) {
         std::map<std::string, std::string> credMap;
@@ -1193,40 +1892,48 @@ static JBCallState toCallState(const std::string& state) {
         }
         creds.push_back(credMap);
     }
-    libjami::setCredentials(toCppString(accountId), creds);
+    libjami::setCredentials(toCppIdentifier(accountId), creds);
 }
 
 - (void)setAccountsOrder:(NSString *)order {
+    JB_REQUIRE_DAEMON();
     libjami::setAccountsOrder(toCppString(order));
 }
 
 - (BOOL)searchUser:(NSString *)accountId query:(NSString *)query {
-    return libjami::searchUser(toCppString(accountId), toCppString(query));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::searchUser(toCppIdentifier(accountId), toCppString(query));
 }
 
 - (BOOL)cancelMessage:(NSString *)accountId messageId:(uint64_t)messageId {
-    return libjami::cancelMessage(toCppString(accountId), messageId);
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::cancelMessage(toCppIdentifier(accountId), messageId);
 }
 
 - (BOOL)revokeDevice:(NSString *)accountId deviceId:(NSString *)deviceId scheme:(NSString *)scheme password:(NSString *)password {
-    return libjami::revokeDevice(toCppString(accountId), toCppString(deviceId),
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::revokeDevice(toCppIdentifier(accountId), toCppString(deviceId),
                                   toCppString(scheme), toCppString(password));
 }
 
 - (int32_t)addDevice:(NSString *)accountId uri:(NSString *)uri {
-    return libjami::addDevice(toCppString(accountId), toCppString(uri));
+    JB_REQUIRE_DAEMON(-1);
+    return libjami::addDevice(toCppIdentifier(accountId), toCppString(uri));
 }
 
 - (BOOL)confirmAddDevice:(NSString *)accountId opId:(uint32_t)opId {
-    return libjami::confirmAddDevice(toCppString(accountId), opId);
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::confirmAddDevice(toCppIdentifier(accountId), opId);
 }
 
 - (BOOL)cancelAddDevice:(NSString *)accountId opId:(uint32_t)opId {
-    return libjami::cancelAddDevice(toCppString(accountId), opId);
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::cancelAddDevice(toCppIdentifier(accountId), opId);
 }
 
 - (BOOL)provideAccountAuthentication:(NSString *)accountId password:(NSString *)password scheme:(NSString *)scheme {
-    return libjami::provideAccountAuthentication(toCppString(accountId), toCppString(password), toCppString(scheme));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::provideAccountAuthentication(toCppIdentifier(accountId), toCppString(password), toCppString(scheme));
 }
 
 // =============================================================================
@@ -1234,24 +1941,14 @@ static JBCallState toCallState(const std::string& state) {
 // =============================================================================
 
 - (NSArray<JBContact *> *)getContacts:(NSString *)accountId {
-    auto contacts = libjami::getContacts(toCppString(accountId));
-    NSMutableArray *result = [NSMutableArray arrayWithCapacity:contacts.size()];
-
-    for (const auto& contactMap : contacts) {
-        JBContact *contact = [[JBContact alloc] init];
-        contact.uri = toNSString(contactMap.count("id") ? contactMap.at("id") : "");
-        contact.displayName = toNSString(contactMap.count("displayName") ? contactMap.at("displayName") : "");
-        contact.isConfirmed = contactMap.count("confirmed") && contactMap.at("confirmed") == "true";
-        contact.isBanned = contactMap.count("banned") && contactMap.at("banned") == "true";
-        [result addObject:contact];
-    }
-
-    return [result copy];
+    JB_REQUIRE_DAEMON(@[]);
+    return toJBContacts(libjami::getContacts(toCppIdentifier(accountId)));
 }
 
 - (void)addContact:(NSString *)accountId uri:(NSString *)uri {
+    JB_REQUIRE_DAEMON();
     FILE_LOG_I("JamiBridge", @"addContact: accountId=%@ uri=%@", accountId, uri);
-    std::string accountIdStr = toCppString(accountId);
+    std::string accountIdStr = toCppIdentifier(accountId);
     std::string uriStr = toCppString(uri);
     FILE_LOG_I("JamiBridge", @"addContact: calling libjami::addContact with accountId=%s uri=%s", accountIdStr.c_str(), uriStr.c_str());
     libjami::addContact(accountIdStr, uriStr);
@@ -1259,45 +1956,38 @@ static JBCallState toCallState(const std::string& state) {
 }
 
 - (void)removeContact:(NSString *)accountId uri:(NSString *)uri ban:(BOOL)ban {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] removeContact: %@ uri: %@ ban: %d", accountId, uri, ban);
-    libjami::removeContact(toCppString(accountId), toCppString(uri), ban);
+    libjami::removeContact(toCppIdentifier(accountId), toCppString(uri), ban);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getContactDetails:(NSString *)accountId uri:(NSString *)uri {
-    auto details = libjami::getContactDetails(toCppString(accountId), toCppString(uri));
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getContactDetails(toCppIdentifier(accountId), toCppString(uri));
     return toNSDictionary(details);
 }
 
 - (void)acceptTrustRequest:(NSString *)accountId uri:(NSString *)uri {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] acceptTrustRequest: %@ uri: %@", accountId, uri);
-    libjami::acceptTrustRequest(toCppString(accountId), toCppString(uri));
+    libjami::acceptTrustRequest(toCppIdentifier(accountId), toCppString(uri));
 }
 
 - (void)discardTrustRequest:(NSString *)accountId uri:(NSString *)uri {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] discardTrustRequest: %@ uri: %@", accountId, uri);
-    libjami::discardTrustRequest(toCppString(accountId), toCppString(uri));
+    libjami::discardTrustRequest(toCppIdentifier(accountId), toCppString(uri));
 }
 
 - (NSArray<JBTrustRequest *> *)getTrustRequests:(NSString *)accountId {
-    auto requests = libjami::getTrustRequests(toCppString(accountId));
-    NSMutableArray *result = [NSMutableArray arrayWithCapacity:requests.size()];
-
-    for (const auto& reqMap : requests) {
-        JBTrustRequest *request = [[JBTrustRequest alloc] init];
-        request.from = toNSString(reqMap.count(Account::TrustRequest::FROM) ? reqMap.at(Account::TrustRequest::FROM) : "");
-        request.conversationId = toNSString(reqMap.count(Account::TrustRequest::CONVERSATIONID) ? reqMap.at(Account::TrustRequest::CONVERSATIONID) : "");
-        if (reqMap.count(Account::TrustRequest::RECEIVED)) {
-            request.received = std::stoll(reqMap.at(Account::TrustRequest::RECEIVED));
-        }
-        [result addObject:request];
-    }
-
-    return [result copy];
+    JB_REQUIRE_DAEMON(@[]);
+    return toJBTrustRequests(libjami::getTrustRequests(toCppIdentifier(accountId)));
 }
 
 - (void)subscribeBuddy:(NSString *)accountId uri:(NSString *)uri flag:(BOOL)flag {
+    JB_REQUIRE_DAEMON();
     FILE_LOG_I("JamiBridge", @"subscribeBuddy: accountId=%@ uri=%@ flag=%d", accountId, uri, flag);
-    libjami::subscribeBuddy(toCppString(accountId), toCppString(uri), flag);
+    libjami::subscribeBuddy(toCppIdentifier(accountId), toCppString(uri), flag);
     FILE_LOG_I("JamiBridge", @"subscribeBuddy: completed");
 }
 
@@ -1306,107 +1996,102 @@ static JBCallState toCallState(const std::string& state) {
 // =============================================================================
 
 - (NSArray<NSString *> *)getConversations:(NSString *)accountId {
-    auto conversations = libjami::getConversations(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto conversations = libjami::getConversations(toCppIdentifier(accountId));
     return toNSArray(conversations);
 }
 
 - (NSString *)startConversation:(NSString *)accountId {
+    JB_REQUIRE_DAEMON(@"");
     FILE_LOG_I("JamiBridge", @"startConversation: accountId=%@", accountId);
-    std::string accountIdStr = toCppString(accountId);
+    std::string accountIdStr = toCppIdentifier(accountId);
     FILE_LOG_I("JamiBridge", @"startConversation: calling libjami::startConversation");
     std::string conversationId = libjami::startConversation(accountIdStr);
     FILE_LOG_I("JamiBridge", @"startConversation: result=%s", conversationId.c_str());
-    return toNSString(conversationId);
+    return toNSIdentifier(conversationId);
 }
 
 - (void)removeConversation:(NSString *)accountId conversationId:(NSString *)conversationId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] removeConversation: %@ conversationId: %@", accountId, conversationId);
-    libjami::removeConversation(toCppString(accountId), toCppString(conversationId));
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    libjami::removeConversation(accountIdStr, conversationIdStr);
+    [[JBConversationCache shared] removeConversation:conversationIdStr accountId:accountIdStr];
+    [[JBMemoryGovernor shared] removeConversation:conversationIdStr accountId:accountIdStr];
 }
 
 - (NSDictionary<NSString *, NSString *> *)getConversationInfo:(NSString *)accountId
                                                conversationId:(NSString *)conversationId {
-    auto info = libjami::conversationInfos(toCppString(accountId), toCppString(conversationId));
-    return toNSDictionary(info);
+    JB_REQUIRE_DAEMON(@{});
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    return [[JBConversationCache shared] info:accountIdStr conversationId:conversationIdStr loader:^{
+        return toNSDictionary(libjami::conversationInfos(accountIdStr, conversationIdStr));
+    }];
 }
 
 - (void)updateConversationInfo:(NSString *)accountId
                 conversationId:(NSString *)conversationId
                           info:(NSDictionary<NSString *, NSString *> *)info {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] updateConversationInfo: %@", conversationId);
-    libjami::updateConversationInfos(toCppString(accountId), toCppString(conversationId), toCppMap(info));
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    libjami::updateConversationInfos(accountIdStr, conversationIdStr, toCppMap(info));
+    [[JBConversationCache shared] invalidate:JBConversationFieldInfo accountId:accountIdStr conversationId:conversationIdStr];
 }
 
 - (NSArray<JBConversationMember *> *)getConversationMembers:(NSString *)accountId
                                              conversationId:(NSString *)conversationId {
-    auto members = libjami::getConversationMembers(toCppString(accountId), toCppString(conversationId));
-    NSMutableArray *result = [NSMutableArray arrayWithCapacity:members.size()];
-
-    for (const auto& memberMap : members) {
-        JBConversationMember *member = [[JBConversationMember alloc] init];
-        member.uri = toNSString(memberMap.count("uri") ? memberMap.at("uri") : "");
-
-        std::string role = memberMap.count("role") ? memberMap.at("role") : "";
-        if (role == "admin") {
-            member.role = JBMemberRoleAdmin;
-        } else if (role == "member") {
-            member.role = JBMemberRoleMember;
-        } else if (role == "invited") {
-            member.role = JBMemberRoleInvited;
-        } else if (role == "banned") {
-            member.role = JBMemberRoleBanned;
-        } else {
-            member.role = JBMemberRoleMember;
-        }
-
-        [result addObject:member];
-    }
-
-    return [result copy];
+    JB_REQUIRE_DAEMON(@[]);
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    return [[JBConversationCache shared] members:accountIdStr conversationId:conversationIdStr loader:^{
+        return toJBConversationMembers(libjami::getConversationMembers(accountIdStr, conversationIdStr));
+    }];
 }
 
 - (void)addConversationMember:(NSString *)accountId
                conversationId:(NSString *)conversationId
                    contactUri:(NSString *)contactUri {
+    JB_REQUIRE_DAEMON();
     FILE_LOG_I("JamiBridge", @"addConversationMember: accountId=%@ conversationId=%@ contactUri=%@", accountId, conversationId, contactUri);
-    std::string accountIdStr = toCppString(accountId);
-    std::string conversationIdStr = toCppString(conversationId);
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
     std::string contactUriStr = toCppString(contactUri);
     FILE_LOG_I("JamiBridge", @"addConversationMember: calling libjami::addConversationMember");
     libjami::addConversationMember(accountIdStr, conversationIdStr, contactUriStr);
+    [[JBConversationCache shared] invalidate:JBConversationFieldMembers accountId:accountIdStr conversationId:conversationIdStr];
     FILE_LOG_I("JamiBridge", @"addConversationMember: completed");
 }
 
 - (void)removeConversationMember:(NSString *)accountId
                   conversationId:(NSString *)conversationId
                       contactUri:(NSString *)contactUri {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] removeConversationMember: %@ from %@", contactUri, conversationId);
-    libjami::removeConversationMember(toCppString(accountId), toCppString(conversationId), toCppString(contactUri));
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    libjami::removeConversationMember(accountIdStr, conversationIdStr, toCppString(contactUri));
+    [[JBConversationCache shared] invalidate:JBConversationFieldMembers accountId:accountIdStr conversationId:conversationIdStr];
 }
 
 - (void)acceptConversationRequest:(NSString *)accountId conversationId:(NSString *)conversationId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] acceptConversationRequest: %@", conversationId);
-    libjami::acceptConversationRequest(toCppString(accountId), toCppString(conversationId));
+    libjami::acceptConversationRequest(toCppIdentifier(accountId), toCppIdentifier(conversationId));
 }
 
 - (void)declineConversationRequest:(NSString *)accountId conversationId:(NSString *)conversationId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] declineConversationRequest: %@", conversationId);
-    libjami::declineConversationRequest(toCppString(accountId), toCppString(conversationId));
+    libjami::declineConversationRequest(toCppIdentifier(accountId), toCppIdentifier(conversationId));
 }
 
 - (NSArray<JBConversationRequest *> *)getConversationRequests:(NSString *)accountId {
-    auto requests = libjami::getConversationRequests(toCppString(accountId));
-    NSMutableArray *result = [NSMutableArray arrayWithCapacity:requests.size()];
-
-    for (const auto& reqMap : requests) {
-        JBConversationRequest *request = [[JBConversationRequest alloc] init];
-        request.conversationId = toNSString(reqMap.count("id") ? reqMap.at("id") : "");
-        request.from = toNSString(reqMap.count("from") ? reqMap.at("from") : "");
-        request.metadata = toNSDictionary(reqMap);
-        [result addObject:request];
-    }
-
-    return [result copy];
+    JB_REQUIRE_DAEMON(@[]);
+    return toJBConversationRequests(libjami::getConversationRequests(toCppIdentifier(accountId)));
 }
 
 // =============================================================================
@@ -1417,9 +2102,13 @@ static JBCallState toCallState(const std::string& state) {
            conversationId:(NSString *)conversationId
                   message:(NSString *)message
                   replyTo:(nullable NSString *)replyTo {
+    JB_REQUIRE_DAEMON(@"");
     NSLog(@"[JamiBridge] sendMessage to %@: %@", conversationId, message);
-    libjami::sendMessage(toCppString(accountId),
-                        toCppString(conversationId),
+    std::string account = toCppIdentifier(accountId);
+    std::string conversation = toCppIdentifier(conversationId);
+    [[JBMemoryGovernor shared] conversationActive:account conversationId:conversation];
+    libjami::sendMessage(account,
+                        conversation,
                         toCppString(message),
                         replyTo ? toCppString(replyTo) : "",
                         0);
@@ -1430,9 +2119,13 @@ static JBCallState toCallState(const std::string& state) {
                  conversationId:(NSString *)conversationId
                     fromMessage:(NSString *)fromMessage
                           count:(int)count {
+    JB_REQUIRE_DAEMON(0);
     NSLog(@"[JamiBridge] loadConversationMessages: %@ count: %d", conversationId, count);
-    uint32_t requestId = libjami::loadConversation(toCppString(accountId),
-                                                   toCppString(conversationId),
+    std::string account = toCppIdentifier(accountId);
+    std::string conversation = toCppIdentifier(conversationId);
+    [[JBMemoryGovernor shared] conversationActive:account conversationId:conversation];
+    uint32_t requestId = libjami::loadConversation(account,
+                                                   conversation,
                                                    toCppString(fromMessage),
                                                    static_cast<size_t>(count));
     return static_cast<int>(requestId);
@@ -1442,8 +2135,59 @@ static JBCallState toCallState(const std::string& state) {
             conversationId:(NSString *)conversationId
                fromMessage:(NSString *)fromMessage
                  toMessage:(NSString *)toMessage {
-    return libjami::loadSwarmUntil(toCppString(accountId), toCppString(conversationId),
-                                   toCppString(fromMessage), toCppString(toMessage));
+    JB_REQUIRE_DAEMON(0);
+    std::string account = toCppIdentifier(accountId);
+    std::string conversation = toCppIdentifier(conversationId);
+    [[JBMemoryGovernor shared] conversationActive:account conversationId:conversation];
+    return libjami::loadSwarmUntil(account, conversation, toCppString(fromMessage), toCppString(toMessage));
+}
+
+- (void)cancelMessagesLoad:(int)requestId {
+    JBMessagesLoadCursor *cursor;
+    @synchronized (self.messagesLoads) {
+        cursor = self.messagesLoads[@(requestId)];
+        [self.messagesLoads removeObjectForKey:@(requestId)];
+    }
+    [cursor cancel];
+}
+
+// Runs on the conversation queue. Each chunk is a separate block so other
+// conversation signals are not held behind a large history load.
+- (void)deliverMessagesLoad:(JBMessagesLoadCursor *)cursor chunked:(BOOL)chunked {
+    NSArray<JBSwarmMessage *> *chunk = [cursor nextChunk];
+    if (!chunk) {
+        [self finishMessagesLoad:cursor];
+        return;
+    }
+    id<JamiBridgeDelegate> delegate = self.delegate;
+    if (!chunked) {
+        if ([delegate respondsToSelector:@selector(onMessagesLoaded:accountId:conversationId:messages:)]) {
+            [delegate onMessagesLoaded:cursor.requestId
+                             accountId:cursor.accountId
+                        conversationId:cursor.conversationId
+                              messages:chunk];
+        }
+        return;
+    }
+    [delegate onMessagesLoadedChunk:chunk cursor:cursor];
+    if (cursor.isLast || cursor.isCancelled) {
+        [cursor nextChunk]; // releases the remaining C++ messages
+        [self finishMessagesLoad:cursor];
+        return;
+    }
+    // Back of the account's lane: the other accounts get their turn between chunks
+    __weak JamiBridgeWrapper *weakSelf = self;
+    dispatchSignal(JBSignalDomainConversation, toCppIdentifier(cursor.accountId), ^{
+        [weakSelf deliverMessagesLoad:cursor chunked:YES];
+    });
+}
+
+- (void)finishMessagesLoad:(JBMessagesLoadCursor *)cursor {
+    @synchronized (self.messagesLoads) {
+        if (self.messagesLoads[@(cursor.requestId)] == cursor) {
+            [self.messagesLoads removeObjectForKey:@(cursor.requestId)];
+        }
+    }
 }
 
 - (uint32_t)searchConversation:(NSString *)accountId
@@ -1456,48 +2200,105 @@ static JBCallState toCallState(const std::string& state) {
                         before:(int64_t)before
                      maxResult:(uint32_t)maxResult
                           flag:(int32_t)flag {
-    return libjami::searchConversation(toCppString(accountId), toCppString(conversationId),
+    JB_REQUIRE_DAEMON(0);
+    return libjami::searchConversation(toCppIdentifier(accountId), toCppIdentifier(conversationId),
                                        toCppString(author), toCppString(lastId),
                                        toCppString(regexSearch), toCppString(type),
                                        after, before, maxResult, flag);
 }
 
+- (void)cancelSearch:(uint32_t)requestId {
+    @synchronized (self.cancelledSearches) {
+        [self.cancelledSearches addIndex:requestId];
+    }
+}
+
+// =============================================================================
+// Local Message Index
+// =============================================================================
+
+- (NSArray<JBIndexedMessage *> *)searchMessageIndex:(NSString *)query
+                                          accountId:(NSString *)accountId
+                                              limit:(NSUInteger)limit {
+    return [[JBMessageIndex shared] search:query accountId:accountId limit:limit];
+}
+
+- (void)clearMessageIndex:(NSString *)accountId {
+    [[JBMessageIndex shared] removeAccount:accountId];
+}
+
 - (void)setIsComposing:(NSString *)accountId
         conversationId:(NSString *)conversationId
            isComposing:(BOOL)isComposing {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setIsComposing: %@ composing: %d", conversationId, isComposing);
-    libjami::setIsComposing(toCppString(accountId), toCppString(conversationId), isComposing);
+    libjami::setIsComposing(toCppIdentifier(accountId), toCppIdentifier(conversationId), isComposing);
 }
 
 - (void)setMessageDisplayed:(NSString *)accountId
              conversationId:(NSString *)conversationId
                   messageId:(NSString *)messageId {
-    NSLog(@"[JamiBridge] setMessageDisplayed: %@ message: %@", conversationId, messageId);
-    libjami::setMessageDisplayed(toCppString(accountId), toCppString(conversationId), toCppString(messageId), 3);
+    JB_REQUIRE_DAEMON();
+    std::string account = toCppIdentifier(accountId);
+    std::string conversation = toCppIdentifier(conversationId);
+    [[JBMemoryGovernor shared] conversationActive:account conversationId:conversation];
+    [[JBReadReceipts shared] markDisplayed:account conversationId:conversation messageId:toCppString(messageId)];
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)countUnreadMessages:(NSString *)accountId
+                                              conversationIds:(NSArray<NSString *> *)conversationIds {
+    JB_REQUIRE_DAEMON(@{});
+    std::string account = toCppIdentifier(accountId);
+    std::string selfUri = jbcore::selfUri(libjami::getAccountDetails(account));
+
+    std::vector<uint32_t> counts(conversationIds.count);
+    uint32_t *slots = counts.data();
+    // dispatch_apply is synchronous: the block can work through pointers to the locals
+    dispatch_apply(conversationIds.count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        std::string conversation = toCppIdentifier(conversationIds[i]);
+        slots[i] = jbcore::countUnread(account, selfUri, conversation,
+                                       [[JBReadReceipts shared] pendingMessage:account conversationId:conversation]);
+    });
+
+    NSMutableDictionary<NSString *, NSNumber *> *result = [NSMutableDictionary dictionaryWithCapacity:counts.size()];
+    for (NSUInteger i = 0; i < conversationIds.count; i++) {
+        result[conversationIds[i]] = @(counts[i]);
+    }
+    return [result copy];
 }
 
 - (uint64_t)sendAccountTextMessage:(NSString *)accountId
                     conversationId:(NSString *)conversationId
                           messages:(NSDictionary<NSString *, NSString *> *)messages
                               flag:(int)flag {
+    JB_REQUIRE_DAEMON(0);
     NSLog(@"[JamiBridge] sendAccountTextMessage to %@", conversationId);
     std::map<std::string, std::string> cppMessages;
     for (NSString *key in messages) {
         cppMessages[toCppString(key)] = toCppString(messages[key]);
     }
-    return libjami::sendAccountTextMessage(toCppString(accountId), toCppString(conversationId), cppMessages, flag);
+    return libjami::sendAccountTextMessage(toCppIdentifier(accountId), toCppIdentifier(conversationId), cppMessages, flag);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getConversationPreferences:(NSString *)accountId
                                                        conversationId:(NSString *)conversationId {
-    auto prefs = libjami::getConversationPreferences(toCppString(accountId), toCppString(conversationId));
-    return toNSDictionary(prefs);
+    JB_REQUIRE_DAEMON(@{});
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    return [[JBConversationCache shared] preferences:accountIdStr conversationId:conversationIdStr loader:^{
+        return toNSDictionary(libjami::getConversationPreferences(accountIdStr, conversationIdStr));
+    }];
 }
 
 - (void)setConversationPreferences:(NSString *)accountId
                     conversationId:(NSString *)conversationId
                              prefs:(NSDictionary<NSString *, NSString *> *)prefs {
-    libjami::setConversationPreferences(toCppString(accountId), toCppString(conversationId), toCppMap(prefs));
+    JB_REQUIRE_DAEMON();
+    std::string accountIdStr = toCppIdentifier(accountId);
+    std::string conversationIdStr = toCppIdentifier(conversationId);
+    libjami::setConversationPreferences(accountIdStr, conversationIdStr, toCppMap(prefs));
+    // setConversationPreferences merges: the signal that follows carries the result
+    [[JBConversationCache shared] invalidate:JBConversationFieldPreferences accountId:accountIdStr conversationId:conversationIdStr];
 }
 
 // =============================================================================
@@ -1505,6 +2306,7 @@ static JBCallState toCallState(const std::string& state) {
 // =============================================================================
 
 - (NSString *)placeCall:(NSString *)accountId uri:(NSString *)uri withVideo:(BOOL)withVideo {
+    JB_REQUIRE_DAEMON(@"");
     NSLog(@"[JamiBridge] placeCall to %@ video: %d", uri, withVideo);
 
     std::vector<std::map<std::string, std::string>> mediaList;
@@ -1523,15 +2325,25 @@ static JBCallState toCallState(const std::string& state) {
         video["MEDIA_TYPE"] = "MEDIA_TYPE_VIDEO";
         video["ENABLED"] = "true";
         video["MUTED"] = "false";
-        video["SOURCE"] = "camera://0";
+        video["SOURCE"] = defaultCameraSource();
         mediaList.push_back(video);
     }
 
-    std::string callId = libjami::placeCallWithMedia(toCppString(accountId), toCppString(uri), mediaList);
-    return toNSString(callId);
+    uint64_t startedAt = callTraceNow();
+    [[JBCodecGovernor shared] prepareCall];
+    std::string callId = libjami::placeCallWithMedia(toCppIdentifier(accountId), toCppString(uri), mediaList);
+    if (!callId.empty()) {
+        [[JBCodecGovernor shared] callStarted:callId];
+        [[JBAudioSession shared] callStarted:callId];
+    } else {
+        [[JBCodecGovernor shared] callNotPlaced];
+    }
+    callTraceStarted(callId, "placeCall", startedAt, withVideo);
+    return toNSIdentifier(callId);
 }
 
 - (void)acceptCall:(NSString *)accountId callId:(NSString *)callId withVideo:(BOOL)withVideo {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] acceptCall: %@ video: %d", callId, withVideo);
 
     std::vector<std::map<std::string, std::string>> mediaList;
@@ -1548,110 +2360,134 @@ static JBCallState toCallState(const std::string& state) {
         video["MEDIA_TYPE"] = "MEDIA_TYPE_VIDEO";
         video["ENABLED"] = "true";
         video["MUTED"] = "false";
-        video["SOURCE"] = "camera://0";
+        video["SOURCE"] = defaultCameraSource();
         mediaList.push_back(video);
     }
 
-    libjami::acceptWithMedia(toCppString(accountId), toCppString(callId), mediaList);
+    std::string callIdStr = toCppIdentifier(callId);
+    callTraceStarted(callIdStr, "acceptCall", callTraceNow(), withVideo);
+    [[JBCodecGovernor shared] prepareCall];
+    [[JBCodecGovernor shared] callStarted:callIdStr];
+    [[JBAudioSession shared] callStarted:callIdStr];
+    libjami::acceptWithMedia(toCppIdentifier(accountId), callIdStr, mediaList);
 }
 
 - (void)refuseCall:(NSString *)accountId callId:(NSString *)callId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] refuseCall: %@", callId);
-    libjami::refuse(toCppString(accountId), toCppString(callId));
+    libjami::refuse(toCppIdentifier(accountId), toCppIdentifier(callId));
 }
 
 - (void)hangUp:(NSString *)accountId callId:(NSString *)callId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] hangUp: %@", callId);
-    libjami::hangUp(toCppString(accountId), toCppString(callId));
+    libjami::hangUp(toCppIdentifier(accountId), toCppIdentifier(callId));
 }
 
 - (void)holdCall:(NSString *)accountId callId:(NSString *)callId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] holdCall: %@", callId);
-    libjami::hold(toCppString(accountId), toCppString(callId));
+    libjami::hold(toCppIdentifier(accountId), toCppIdentifier(callId));
 }
 
 - (void)unholdCall:(NSString *)accountId callId:(NSString *)callId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] unholdCall: %@", callId);
-    libjami::unhold(toCppString(accountId), toCppString(callId));
+    libjami::unhold(toCppIdentifier(accountId), toCppIdentifier(callId));
 }
 
 - (void)muteAudio:(NSString *)accountId callId:(NSString *)callId muted:(BOOL)muted {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] muteAudio: %@ muted: %d", callId, muted);
-    libjami::muteLocalMedia(toCppString(accountId), toCppString(callId), "MEDIA_TYPE_AUDIO", muted);
+    libjami::muteLocalMedia(toCppIdentifier(accountId), toCppIdentifier(callId), "MEDIA_TYPE_AUDIO", muted);
 }
 
 - (void)muteVideo:(NSString *)accountId callId:(NSString *)callId muted:(BOOL)muted {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] muteVideo: %@ muted: %d", callId, muted);
-    libjami::muteLocalMedia(toCppString(accountId), toCppString(callId), "MEDIA_TYPE_VIDEO", muted);
+    libjami::muteLocalMedia(toCppIdentifier(accountId), toCppIdentifier(callId), "MEDIA_TYPE_VIDEO", muted);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getCallDetails:(NSString *)accountId callId:(NSString *)callId {
-    auto details = libjami::getCallDetails(toCppString(accountId), toCppString(callId));
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getCallDetails(toCppIdentifier(accountId), toCppIdentifier(callId));
     return toNSDictionary(details);
 }
 
 - (NSArray<NSString *> *)getActiveCalls:(NSString *)accountId {
-    auto calls = libjami::getCallList(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto calls = libjami::getCallList(toCppIdentifier(accountId));
     return toNSArray(calls);
 }
 
 - (void)sendTextMessage:(NSString *)accountId callId:(NSString *)callId
                messages:(NSDictionary<NSString *, NSString *> *)messages
                    from:(NSString *)from isMixed:(BOOL)isMixed {
-    libjami::sendTextMessage(toCppString(accountId), toCppString(callId),
+    JB_REQUIRE_DAEMON();
+    libjami::sendTextMessage(toCppIdentifier(accountId), toCppIdentifier(callId),
                               toCppMap(messages), toCppString(from), isMixed);
 }
 
 - (BOOL)addMainParticipant:(NSString *)accountId conferenceId:(NSString *)conferenceId {
-    return libjami::addMainParticipant(toCppString(accountId), toCppString(conferenceId));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::addMainParticipant(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
 }
 
 - (BOOL)detachParticipant:(NSString *)accountId callId:(NSString *)callId {
-    return libjami::detachParticipant(toCppString(accountId), toCppString(callId));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::detachParticipant(toCppIdentifier(accountId), toCppIdentifier(callId));
 }
 
 - (BOOL)transfer:(NSString *)accountId callId:(NSString *)callId to:(NSString *)to {
-    return libjami::transfer(toCppString(accountId), toCppString(callId), toCppString(to));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::transfer(toCppIdentifier(accountId), toCppIdentifier(callId), toCppString(to));
 }
 
 - (BOOL)attendedTransfer:(NSString *)accountId callId:(NSString *)callId targetId:(NSString *)targetId {
-    return libjami::attendedTransfer(toCppString(accountId), toCppString(callId), toCppString(targetId));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::attendedTransfer(toCppIdentifier(accountId), toCppIdentifier(callId), toCppString(targetId));
 }
 
 - (void)playDtmf:(NSString *)key {
+    JB_REQUIRE_DAEMON();
     libjami::playDTMF(toCppString(key));
 }
 
 - (void)muteCapture:(BOOL)muted {
+    JB_REQUIRE_DAEMON();
     libjami::muteCapture(muted);
 }
 
 - (BOOL)isCaptureMuted {
+    JB_REQUIRE_DAEMON(NO);
     return libjami::isCaptureMuted();
 }
 
 - (void)muteRingtone:(BOOL)muted {
+    JB_REQUIRE_DAEMON();
     libjami::muteRingtone(muted);
 }
 
 - (BOOL)requestMediaChange:(NSString *)accountId
                     callId:(NSString *)callId
                  mediaList:(NSArray<NSDictionary<NSString *, NSString *> *> *)mediaList {
+    JB_REQUIRE_DAEMON(NO);
     std::vector<std::map<std::string, std::string>> cppMedia;
     for (NSDictionary *dict in mediaList) {
         cppMedia.push_back(toCppMap(dict));
     }
-    return libjami::requestMediaChange(toCppString(accountId), toCppString(callId), cppMedia);
+    return libjami::requestMediaChange(toCppIdentifier(accountId), toCppIdentifier(callId), cppMedia);
 }
 
 - (BOOL)answerMediaChangeRequest:(NSString *)accountId
                           callId:(NSString *)callId
                        mediaList:(NSArray<NSDictionary<NSString *, NSString *> *> *)mediaList {
+    JB_REQUIRE_DAEMON(NO);
     std::vector<std::map<std::string, std::string>> cppMedia;
     for (NSDictionary *dict in mediaList) {
         cppMedia.push_back(toCppMap(dict));
     }
-    return libjami::answerMediaChangeRequest(toCppString(accountId), toCppString(callId), cppMedia);
+    return libjami::answerMediaChangeRequest(toCppIdentifier(accountId), toCppIdentifier(callId), cppMedia);
 }
 
 - (void)switchCamera {
@@ -1672,8 +2508,9 @@ static JBCallState toCallState(const std::string& state) {
 
 - (NSString *)createConference:(NSString *)accountId
                participantUris:(NSArray<NSString *> *)participantUris {
+    JB_REQUIRE_DAEMON(@"");
     NSLog(@"[JamiBridge] createConference with %lu participants", (unsigned long)participantUris.count);
-    libjami::createConfFromParticipantList(toCppString(accountId), toCppVector(participantUris));
+    libjami::createConfFromParticipantList(toCppIdentifier(accountId), toCppVector(participantUris));
     return @"";  // Conference ID comes via callback
 }
 
@@ -1681,8 +2518,9 @@ static JBCallState toCallState(const std::string& state) {
                  callId:(NSString *)callId
               accountId2:(NSString *)accountId2
                  callId2:(NSString *)callId2 {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] joinParticipant: %@ with %@", callId, callId2);
-    libjami::joinParticipant(toCppString(accountId), toCppString(callId),
+    libjami::joinParticipant(toCppIdentifier(accountId), toCppIdentifier(callId),
                             toCppString(accountId2), toCppString(callId2));
 }
 
@@ -1690,31 +2528,36 @@ static JBCallState toCallState(const std::string& state) {
                             callId:(NSString *)callId
                conferenceAccountId:(NSString *)conferenceAccountId
                       conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] addParticipantToConference: %@ conference: %@", callId, conferenceId);
-    libjami::addParticipant(toCppString(accountId), toCppString(callId),
-                           toCppString(conferenceAccountId), toCppString(conferenceId));
+    libjami::addParticipant(toCppIdentifier(accountId), toCppIdentifier(callId),
+                           toCppString(conferenceAccountId), toCppIdentifier(conferenceId));
 }
 
 - (void)hangUpConference:(NSString *)accountId conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] hangUpConference: %@", conferenceId);
-    libjami::hangUpConference(toCppString(accountId), toCppString(conferenceId));
+    libjami::hangUpConference(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
 }
 
 - (NSDictionary<NSString *, NSString *> *)getConferenceDetails:(NSString *)accountId
                                                   conferenceId:(NSString *)conferenceId {
-    auto details = libjami::getConferenceDetails(toCppString(accountId), toCppString(conferenceId));
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getConferenceDetails(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
     return toNSDictionary(details);
 }
 
 - (NSArray<NSString *> *)getConferenceParticipants:(NSString *)accountId
                                       conferenceId:(NSString *)conferenceId {
-    auto participants = libjami::getParticipantList(toCppString(accountId), toCppString(conferenceId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto participants = libjami::getParticipantList(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
     return toNSArray(participants);
 }
 
 - (NSArray<NSDictionary<NSString *, NSString *> *> *)getConferenceInfos:(NSString *)accountId
                                                            conferenceId:(NSString *)conferenceId {
-    auto infos = libjami::getConferenceInfos(toCppString(accountId), toCppString(conferenceId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto infos = libjami::getConferenceInfos(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:infos.size()];
     for (const auto& info : infos) {
         [result addObject:toNSDictionary(info)];
@@ -1725,16 +2568,18 @@ static JBCallState toCallState(const std::string& state) {
 - (void)setConferenceLayout:(NSString *)accountId
                conferenceId:(NSString *)conferenceId
                      layout:(JBConferenceLayout)layout {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setConferenceLayout: %@ layout: %ld", conferenceId, (long)layout);
-    libjami::setConferenceLayout(toCppString(accountId), toCppString(conferenceId), static_cast<uint32_t>(layout));
+    libjami::setConferenceLayout(toCppIdentifier(accountId), toCppIdentifier(conferenceId), static_cast<uint32_t>(layout));
 }
 
 - (void)muteConferenceParticipant:(NSString *)accountId
                      conferenceId:(NSString *)conferenceId
                    participantUri:(NSString *)participantUri
                             muted:(BOOL)muted {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] muteConferenceParticipant: %@ muted: %d", participantUri, muted);
-    libjami::muteParticipant(toCppString(accountId), toCppString(conferenceId),
+    libjami::muteParticipant(toCppIdentifier(accountId), toCppIdentifier(conferenceId),
                             toCppString(participantUri), muted);
 }
 
@@ -1742,29 +2587,49 @@ static JBCallState toCallState(const std::string& state) {
                        conferenceId:(NSString *)conferenceId
                      participantUri:(NSString *)participantUri
                            deviceId:(NSString *)deviceId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] hangUpConferenceParticipant: %@", participantUri);
-    libjami::hangupParticipant(toCppString(accountId), toCppString(conferenceId),
+    libjami::hangupParticipant(toCppIdentifier(accountId), toCppIdentifier(conferenceId),
                               toCppString(participantUri), toCppString(deviceId));
 }
 
 - (BOOL)holdConference:(NSString *)accountId conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON(NO);
     NSLog(@"[JamiBridge] holdConference: %@", conferenceId);
-    return libjami::holdConference(toCppString(accountId), toCppString(conferenceId));
+    return libjami::holdConference(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
 }
 
 - (BOOL)unholdConference:(NSString *)accountId conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON(NO);
     NSLog(@"[JamiBridge] unholdConference: %@", conferenceId);
-    return libjami::resumeConference(toCppString(accountId), toCppString(conferenceId));
+    return libjami::resumeConference(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
 }
 
 - (BOOL)resumeConference:(NSString *)accountId conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON(NO);
     NSLog(@"[JamiBridge] resumeConference: %@", conferenceId);
-    return libjami::resumeConference(toCppString(accountId), toCppString(conferenceId));
+    return libjami::resumeConference(toCppIdentifier(accountId), toCppIdentifier(conferenceId));
 }
 
 - (void)setActiveParticipant:(NSString *)accountId conferenceId:(NSString *)conferenceId callId:(NSString *)callId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setActiveParticipant: conf=%@ call=%@", conferenceId, callId);
-    libjami::setActiveParticipant(toCppString(accountId), toCppString(conferenceId), toCppString(callId));
+    libjami::setActiveParticipant(toCppIdentifier(accountId), toCppIdentifier(conferenceId), toCppIdentifier(callId));
+}
+
+- (void)setVisibleConferenceStreams:(NSArray<JBStreamVisibility *> *)streams
+                          accountId:(NSString *)accountId
+                       conferenceId:(NSString *)conferenceId {
+    JB_REQUIRE_DAEMON();
+    [[JBConferenceStreams shared] setVisibleStreams:streams accountId:accountId conferenceId:conferenceId];
+}
+
+- (void)setConferenceLayoutFollowsVisibility:(BOOL)enabled {
+    [JBConferenceStreams shared].layoutFollowsVisibility = enabled;
+}
+
+- (BOOL)conferenceLayoutFollowsVisibility {
+    return [JBConferenceStreams shared].layoutFollowsVisibility;
 }
 
 // =============================================================================
@@ -1775,22 +2640,53 @@ static JBCallState toCallState(const std::string& state) {
         conversationId:(NSString *)conversationId
               filePath:(NSString *)filePath
            displayName:(NSString *)displayName {
+    // Before preprocessing, which may transcode a whole video
+    JB_REQUIRE_DAEMON(@"");
     NSLog(@"[JamiBridge] sendFile: %@ name: %@", filePath, displayName);
-    // File transfer in swarm conversations uses sendMessage with file:// URI
-    std::string fileUri = "file://" + toCppString(filePath);
-    libjami::sendMessage(toCppString(accountId), toCppString(conversationId), fileUri, "", 0);
+    JBMediaPreprocessor *preprocessor = [JBMediaPreprocessor shared];
+    if (![preprocessor shouldPrepare:filePath]) {
+        [self sendFileNow:accountId conversationId:conversationId filePath:filePath displayName:displayName];
+        return @"";
+    }
+    [preprocessor prepareFile:filePath accountId:accountId conversationId:conversationId
+                   completion:^(NSString *preparedPath) {
+        if (!preparedPath) {
+            [self sendFileNow:accountId conversationId:conversationId filePath:filePath displayName:displayName];
+            return;
+        }
+        [[JBScopedFileAccess shared] sourceReplaced:toCppString(filePath)];
+        // Keep the name, with the extension of what is actually sent
+        NSString *name = [displayName.stringByDeletingPathExtension
+                          stringByAppendingPathExtension:preparedPath.pathExtension];
+        [self sendFileNow:accountId conversationId:conversationId filePath:preparedPath displayName:name ?: displayName];
+    }];
     return @"";
 }
 
+- (void)sendFileNow:(NSString *)accountId
+     conversationId:(NSString *)conversationId
+           filePath:(NSString *)filePath
+        displayName:(NSString *)displayName {
+    // Stopped while preprocessing: a picked file must not stay in scope until it expires
+    JB_REQUIRE_DAEMON([[JBScopedFileAccess shared] sendDropped:toCppString(filePath)]);
+    std::string account = toCppIdentifier(accountId);
+    std::string conversation = toCppIdentifier(conversationId);
+    std::string path = toCppString(filePath);
+    // A picked file sent in place keeps its security scope until the transfer ends
+    [[JBScopedFileAccess shared] sendStarted:path accountId:account conversationId:conversation];
+    libjami::sendFile(account, conversation, path, toCppString(displayName), "");
+}
+
 - (void)acceptFileTransfer:(NSString *)accountId
             conversationId:(NSString *)conversationId
              interactionId:(NSString *)interactionId
                     fileId:(NSString *)fileId
            destinationPath:(NSString *)destinationPath {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] acceptFileTransfer: account=%@ conv=%@ interaction=%@ fileId=%@ dest=%@",
           accountId, conversationId, interactionId, fileId, destinationPath);
-    bool result = libjami::downloadFile(toCppString(accountId),
-                                        toCppString(conversationId),
+    bool result = libjami::downloadFile(toCppIdentifier(accountId),
+                                        toCppIdentifier(conversationId),
                                         toCppString(interactionId),
                                         toCppString(fileId),
                                         toCppString(destinationPath));
@@ -1800,106 +2696,194 @@ static JBCallState toCallState(const std::string& state) {
 - (void)cancelFileTransfer:(NSString *)accountId
             conversationId:(NSString *)conversationId
                     fileId:(NSString *)fileId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] cancelFileTransfer: %@", fileId);
-    libjami::cancelDataTransfer(toCppString(accountId),
-                                toCppString(conversationId),
+    libjami::cancelDataTransfer(toCppIdentifier(accountId),
+                                toCppIdentifier(conversationId),
                                 toCppString(fileId));
 }
 
 - (nullable JBFileTransferInfo *)getFileTransferInfo:(NSString *)accountId
                                       conversationId:(NSString *)conversationId
                                               fileId:(NSString *)fileId {
+    JB_REQUIRE_DAEMON(nil);
+    std::string fileIdStr = toCppString(fileId);
     std::string path;
     int64_t total = 0;
     int64_t progress = 0;
-    libjami::DataTransferError err = libjami::fileTransferInfo(toCppString(accountId),
-                                                               toCppString(conversationId),
-                                                               toCppString(fileId),
+    libjami::DataTransferError err = libjami::fileTransferInfo(toCppIdentifier(accountId),
+                                                               toCppIdentifier(conversationId),
+                                                               fileIdStr,
                                                                path, total, progress);
     if (err != libjami::DataTransferError::success) {
         return nil;
     }
+    JBTrackedTransfer tracked = [[JBTransferTracker shared] trackedTransferForFileId:fileIdStr];
     JBFileTransferInfo *info = [[JBFileTransferInfo alloc] init];
+    info.accountId = accountId;
+    info.conversationId = conversationId;
+    info.interactionId = toNSString(tracked.interactionId);
     info.fileId = fileId;
     info.path = toNSString(path);
-    info.displayName = [toNSString(path) lastPathComponent];
+    info.displayName = [info.path lastPathComponent];
     info.totalSize = total;
     info.progress = progress;
-    info.bytesPerSecond = 0;
-    info.author = @"";
+    // Estimates are only known while the tracker follows the transfer
+    info.bytesPerSecond = tracked.bytesPerSecond;
+    info.etaSeconds = tracked.etaSeconds;
+    info.author = tracked.author.empty() ? @"" : toNSIdentifier(tracked.author);
     info.flags = 0;
     return info;
 }
 
+- (void)setMediaSettings:(JBMediaSettings *)mediaSettings {
+    [JBMediaPreprocessor shared].settings = mediaSettings;
+}
+
+- (JBMediaSettings *)mediaSettings {
+    return [JBMediaPreprocessor shared].settings;
+}
+
 // =============================================================================
 // Video
 // =============================================================================
 
 - (NSArray<NSString *> *)getVideoDevices {
-    // On iOS, video devices are handled by AVFoundation
-    return @[@"camera://0", @"camera://1"];
+    return [JBCameraFrameProducer captureDeviceIds];
 }
 
 - (NSString *)getCurrentVideoDevice {
-    return @"camera://0";
+    JB_REQUIRE_DAEMON(@"");
+    auto device = libjami::getDefaultDevice();
+    if (!device.empty()) {
+        return toNSIdentifier(device);
+    }
+    return [JBCameraFrameProducer captureDeviceIds].firstObject ?: @"";
 }
 
 - (void)setVideoDevice:(NSString *)deviceId {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setVideoDevice: %@", deviceId);
+    libjami::setDefaultDevice(toCppString(deviceId));
 }
 
 - (void)startVideo {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] startVideo");
+    if (self.localVideoInputId) return;
+    // The daemon answers with StartCapture for the device, frames then flow through the capture output
+    self.localVideoInputId = toNSString(libjami::openVideoInput(defaultCameraSource()));
 }
 
 - (void)stopVideo {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] stopVideo");
+    if (!self.localVideoInputId) return;
+    libjami::closeVideoInput(toCppString(self.localVideoInputId));
+    self.localVideoInputId = nil;
 }
 
 - (void)setDefaultVideoDevice:(NSString *)deviceId {
+    JB_REQUIRE_DAEMON();
     libjami::setDefaultDevice(toCppString(deviceId));
 }
 
 - (void)setDeviceOrientation:(NSString *)deviceId angle:(int)angle {
+    JB_REQUIRE_DAEMON();
     libjami::setDeviceOrientation(toCppString(deviceId), angle);
 }
 
 - (void)applyVideoSettings:(NSString *)deviceId settings:(NSDictionary<NSString *, NSString *> *)settings {
-    libjami::applySettings(toCppString(deviceId), toCppMap(settings));
+    JB_REQUIRE_DAEMON();
+    [[JBCodecGovernor shared] applyUserSettings:toCppMap(settings) device:toCppString(deviceId)];
+}
+
+- (void)setAdaptiveVideoQuality:(BOOL)enabled {
+    [JBCodecGovernor shared].enabled = enabled;
+}
+
+- (BOOL)adaptiveVideoQuality {
+    return [JBCodecGovernor shared].enabled;
 }
 
 - (BOOL)switchVideoInput:(NSString *)accountId callId:(NSString *)callId uri:(NSString *)uri {
-    return libjami::switchInput(toCppString(accountId), toCppString(callId), toCppString(uri));
+    JB_REQUIRE_DAEMON(NO);
+    return libjami::switchInput(toCppIdentifier(accountId), toCppIdentifier(callId), toCppString(uri));
 }
 
 - (void)addVideoDevice:(NSString *)node {
-    libjami::addVideoDevice(toCppString(node));
+    JB_REQUIRE_DAEMON();
+    libjami::addVideoDevice(toCppString(node), [JBCameraFrameProducer deviceInfoForDevice:node]);
 }
 
 - (void)removeVideoDevice:(NSString *)node {
+    JB_REQUIRE_DAEMON();
     libjami::removeVideoDevice(toCppString(node));
 }
 
+// =============================================================================
+// Video Capture
+// =============================================================================
+
+- (void)attachCaptureOutput:(AVCaptureVideoDataOutput *)output inputId:(NSString *)inputId {
+    JB_REQUIRE_DAEMON();
+    FILE_LOG_D("JamiBridge", @"attachCaptureOutput: %@", inputId);
+    [[JBCameraFrameProducer shared] attachOutput:output inputId:inputId];
+}
+
+- (void)detachCaptureOutput:(AVCaptureVideoDataOutput *)output {
+    FILE_LOG_D("JamiBridge", @"detachCaptureOutput");
+    [[JBCameraFrameProducer shared] detachOutput:output];
+}
+
+// =============================================================================
+// Video Rendering
+// =============================================================================
+
+- (void)attachVideoSink:(NSString *)sinkId displayLayer:(AVSampleBufferDisplayLayer *)layer {
+    FILE_LOG_D("JamiBridge", @"attachVideoSink: %@", sinkId);
+    [[JBVideoSinkManager shared] attachLayer:layer toSink:sinkId];
+}
+
+- (void)detachVideoSink:(NSString *)sinkId {
+    FILE_LOG_D("JamiBridge", @"detachVideoSink: %@", sinkId);
+    [[JBVideoSinkManager shared] detachSink:sinkId];
+}
+
+- (void)setVideoSinkSize:(NSString *)sinkId width:(int)width height:(int)height {
+    // Decoded frames are measured in pixels
+#if TARGET_OS_IPHONE
+    CGFloat scale = UIScreen.mainScreen.nativeScale;
+#else
+    CGFloat scale = 1;
+#endif
+    [[JBVideoSinkManager shared] setDisplaySize:CGSizeMake(width * scale, height * scale) forSink:sinkId];
+}
+
 // =============================================================================
 // Audio Settings
 // =============================================================================
 
 - (NSArray<NSString *> *)getAudioOutputDevices {
+    JB_REQUIRE_DAEMON(@[]);
     auto devices = libjami::getAudioOutputDeviceList();
     return toNSArray(devices);
 }
 
 - (NSArray<NSString *> *)getAudioInputDevices {
+    JB_REQUIRE_DAEMON(@[]);
     auto devices = libjami::getAudioInputDeviceList();
     return toNSArray(devices);
 }
 
 - (void)setAudioOutputDevice:(int)index {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setAudioOutputDevice: %d", index);
     libjami::setAudioOutputDevice(index);
 }
 
 - (void)setAudioInputDevice:(int)index {
+    JB_REQUIRE_DAEMON();
     NSLog(@"[JamiBridge] setAudioInputDevice: %d", index);
     libjami::setAudioInputDevice(index);
 }
@@ -1909,6 +2893,7 @@ static JBCallState toCallState(const std::string& state) {
 // =========================================================================
 
 - (NSArray<NSNumber *> *)getCodecList {
+    JB_REQUIRE_DAEMON(@[]);
     auto codecs = libjami::getCodecList();
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:codecs.size()];
     for (unsigned codecId : codecs) {
@@ -1918,7 +2903,8 @@ static JBCallState toCallState(const std::string& state) {
 }
 
 - (NSArray<NSNumber *> *)getActiveCodecList:(NSString *)accountId {
-    auto codecs = libjami::getActiveCodecList(toCppString(accountId));
+    JB_REQUIRE_DAEMON(@[]);
+    auto codecs = libjami::getActiveCodecList(toCppIdentifier(accountId));
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:codecs.size()];
     for (unsigned codecId : codecs) {
         [result addObject:@(codecId)];
@@ -1927,15 +2913,17 @@ static JBCallState toCallState(const std::string& state) {
 }
 
 - (void)setActiveCodecList:(NSString *)accountId codecList:(NSArray<NSNumber *> *)codecList {
+    JB_REQUIRE_DAEMON();
     std::vector<unsigned> cppCodecs;
     for (NSNumber *num in codecList) {
         cppCodecs.push_back([num unsignedIntValue]);
     }
-    libjami::setActiveCodecList(toCppString(accountId), cppCodecs);
+    libjami::setActiveCodecList(toCppIdentifier(accountId), cppCodecs);
 }
 
 - (NSDictionary<NSString *, NSString *> *)getCodecDetails:(NSString *)accountId codecId:(uint32_t)codecId {
-    auto details = libjami::getCodecDetails(toCppString(accountId), codecId);
+    JB_REQUIRE_DAEMON(@{});
+    auto details = libjami::getCodecDetails(toCppIdentifier(accountId), codecId);
     return toNSDictionary(details);
 }
 
@@ -2034,38 +3022,8 @@ static JBCallState toCallState(const std::string& state) {
 }
 
 - (NSString *)captureRecentLogs:(int)maxLines {
-    NSArray *paths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
-    NSString *documentsPath = paths.firstObject;
-    if (!documentsPath) return @"";
-
-    NSError *error = nil;
-    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:documentsPath error:&error];
-    if (!files) return @"";
-
-    // Find the most recent .log file
-    NSString *latestLog = nil;
-    NSDate *latestDate = nil;
-    for (NSString *file in files) {
-        if ([file hasSuffix:@".log"]) {
-            NSString *fullPath = [documentsPath stringByAppendingPathComponent:file];
-            NSDictionary *attrs = [[NSFileManager defaultManager] attributesOfItemAtPath:fullPath error:nil];
-            NSDate *modDate = attrs[NSFileModificationDate];
-            if (!latestDate || [modDate compare:latestDate] == NSOrderedDescending) {
-                latestDate = modDate;
-                latestLog = fullPath;
-            }
-        }
-    }
-    if (!latestLog) return @"";
-
-    NSString *content = [NSString stringWithContentsOfFile:latestLog encoding:NSUTF8StringEncoding error:nil];
-    if (!content) return @"";
-
-    NSArray<NSString *> *lines = [content componentsSeparatedByString:@"\n"];
-    if ((int)lines.count <= maxLines) return content;
-
-    NSArray *tail = [lines subarrayWithRange:NSMakeRange(lines.count - maxLines, maxLines)];
-    return [tail componentsJoinedByString:@"\n"];
+    // Served from the logger's in-memory ring: no file read, no line splitting
+    return fileLogRecentLines(maxLines);
 }
 
 @end
@@ -2093,23 +3051,26 @@ didPickDocumentsAtURLs:(NSArray<NSURL *> *)urls {
     NSURL *url = urls.firstObject;
     if (!url) { _completion(nil); return; }
 
-    // Copy to tmp dir so the caller gets a regular file path
-    [url startAccessingSecurityScopedResource];
+    BOOL scoped = [url startAccessingSecurityScopedResource];
     NSString *fileName = url.lastPathComponent ?: @"import_file";
     NSString *tmpPath = [NSTemporaryDirectory()
         stringByAppendingPathComponent:
             [NSString stringWithFormat:@"jami_import_%lld_%@",
              (long long)[[NSDate date] timeIntervalSince1970], fileName]];
-    NSError *error = nil;
-    [[NSFileManager defaultManager] copyItemAtPath:url.path toPath:tmpPath error:&error];
-    [url stopAccessingSecurityScopedResource];
 
-    if (error) {
-        FILE_LOG_E("FilePicker", @"Copy failed: %@", error.localizedDescription);
-        _completion(nil);
-    } else {
+    // APFS clone: a regular file in our container that shares the original's
+    // blocks, created without reading or writing the data
+    if (clonefile(url.fileSystemRepresentation, tmpPath.fileSystemRepresentation, 0) == 0) {
+        if (scoped) [url stopAccessingSecurityScopedResource];
         _completion(tmpPath);
+        return;
     }
+    FILE_LOG_I("FilePicker", @"clonefile: %s, sending %@ in place", strerror(errno), fileName);
+
+    // Other volume or a file provider without clone support: libjami reads the
+    // original, the scope stays open until the transfer ends
+    if (scoped) [[JBScopedFileAccess shared] holdURL:url];
+    _completion(url.path);
 }
 
 - (void)documentPickerWasCancelled:(UIDocumentPickerViewController *)controller {
@@ -2126,6 +3087,20 @@ didPickDocumentsAtURLs:(NSArray<NSURL *> *)urls {
 - (instancetype)initWithCompletion:(void (^)(NSString * _Nullable))completion;
 @end
 
+static CGImagePropertyOrientation imageOrientation(UIImageOrientation orientation) {
+    switch (orientation) {
+        case UIImageOrientationUp: return kCGImagePropertyOrientationUp;
+        case UIImageOrientationDown: return kCGImagePropertyOrientationDown;
+        case UIImageOrientationLeft: return kCGImagePropertyOrientationLeft;
+        case UIImageOrientationRight: return kCGImagePropertyOrientationRight;
+        case UIImageOrientationUpMirrored: return kCGImagePropertyOrientationUpMirrored;
+        case UIImageOrientationDownMirrored: return kCGImagePropertyOrientationDownMirrored;
+        case UIImageOrientationLeftMirrored: return kCGImagePropertyOrientationLeftMirrored;
+        case UIImageOrientationRightMirrored: return kCGImagePropertyOrientationRightMirrored;
+    }
+    return kCGImagePropertyOrientationUp;
+}
+
 @implementation JBImagePickerDelegate {
     void (^_completion)(NSString * _Nullable);
 }
@@ -2140,19 +3115,16 @@ didPickDocumentsAtURLs:(NSArray<NSURL *> *)urls {
 didFinishPickingMediaWithInfo:(NSDictionary<UIImagePickerControllerInfoKey, id> *)info {
     [picker dismissViewControllerAnimated:YES completion:nil];
     UIImage *image = info[UIImagePickerControllerOriginalImage];
-    if (!image) { _completion(nil); return; }
-
-    NSString *filePath = [NSTemporaryDirectory()
-        stringByAppendingPathComponent:
-            [NSString stringWithFormat:@"jami_capture_%lld.jpg",
-             (long long)[[NSDate date] timeIntervalSince1970]]];
-    NSData *imageData = UIImageJPEGRepresentation(image, 0.9f);
-    if ([imageData writeToFile:filePath atomically:YES]) {
-        _completion(filePath);
-    } else {
-        FILE_LOG_E("ImageCapture", @"Failed to write captured image to temp file");
-        _completion(nil);
-    }
+    if (!image.CGImage) { _completion(nil); return; }
+
+    // Encoded off the main thread, downscaled to the media settings
+    void (^completion)(NSString * _Nullable) = _completion;
+    [[JBMediaPreprocessor shared] writeCapturedImage:image.CGImage
+                                         orientation:imageOrientation(image.imageOrientation)
+                                          completion:^(NSString *filePath) {
+        if (!filePath) FILE_LOG_E("ImageCapture", @"Failed to write captured image to temp file");
+        completion(filePath);
+    }];
 }
 
 - (void)imagePickerControllerDidCancel:(UIImagePickerController *)picker {
@@ -1,2 +1,69 @@
-// Empty stub - logging is now inline in JamiBridgeWrapper.mm
+//
+//  NativeFileLogger.h
+//  GetTogether
+//
+//  File logger shared by the JamiBridge sources.
+//  Writes to the Documents folder for crash-safe debugging.
+//
+//  Callers format into a lock-free ring of fixed-size records and return; a
+//  background queue copies the records into an mmap'd log file (rotated when
+//  full) according to the flush policy. The ring also keeps the most recent
+//  records for fileLogRecentLines().
+//
+
 #import <Foundation/Foundation.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void fileLog(const char* level, const char* tag, NSString *message);
+
+// Writes once `maxPendingBytes` are buffered, `maxDelaySeconds` after the first
+// buffered record, and right away for errors when `flushOnError` is set.
+// Defaults: 32 KB, 1 s, flush on error.
+void fileLogSetFlushPolicy(size_t maxPendingBytes, double maxDelaySeconds, bool flushOnError);
+
+// Synchronously writes buffered records (e.g. when the app moves to background)
+void fileLogFlush(void);
+
+// Last `maxLines` records from the in-memory ring, oldest first
+NSString *fileLogRecentLines(int maxLines);
+
+// Console (os_log) only: no log file and no ring (fileLogRecentLines is empty).
+// For the notification service extension; takes full effect before the first record.
+void fileLogSetFileOutputEnabled(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Compile-time level filtering: records below JB_LOG_MIN_LEVEL, including the
+// formatting of their arguments, are compiled out.
+#define JB_LOG_LEVEL_DEBUG 0
+#define JB_LOG_LEVEL_INFO  1
+#define JB_LOG_LEVEL_WARN  2
+#define JB_LOG_LEVEL_ERROR 3
+
+#ifndef JB_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define JB_LOG_MIN_LEVEL JB_LOG_LEVEL_INFO
+#else
+#define JB_LOG_MIN_LEVEL JB_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define JB_FILE_LOG(levelValue, levelName, tag, ...) do { \
+    if (levelValue >= JB_LOG_MIN_LEVEL) { \
+        NSString *msg = [NSString stringWithFormat:__VA_ARGS__]; \
+        fileLog(levelName, tag, msg); \
+    } \
+} while(0)
+
+// Convenience macros for file logging
+#define FILE_LOG_I(tag, ...) JB_FILE_LOG(JB_LOG_LEVEL_INFO, "I", tag, __VA_ARGS__)
+#define FILE_LOG_D(tag, ...) JB_FILE_LOG(JB_LOG_LEVEL_DEBUG, "D", tag, __VA_ARGS__)
+#define FILE_LOG_W(tag, ...) JB_FILE_LOG(JB_LOG_LEVEL_WARN, "W", tag, __VA_ARGS__)
+#define FILE_LOG_E(tag, ...) JB_FILE_LOG(JB_LOG_LEVEL_ERROR, "E", tag, __VA_ARGS__)
@@ -1,2 +1,395 @@
-// Empty stub - logging is now inline in JamiBridgeWrapper.mm
+//
+//  NativeFileLogger.m
+//  GetTogether
+//
+//  Inline File Logger - writes to Documents folder for crash-safe debugging
+//
+//  Ring: bounded multi-producer queue (Vyukov) of fixed-size slots. A producer
+//  claims a slot with one CAS, formats the record into it and publishes it;
+//  when the ring is full the record is counted as dropped instead of blocking.
+//  Flushed slots keep their text until reused, so the ring doubles as the
+//  recent-history buffer; readers validate each slot with a per-slot seqlock.
+//  Slot text is stored and read as relaxed atomic words, so a reader racing a
+//  writer gets a torn copy it then discards, never a data race.
+//
+//  File: the log file is pre-sized and mapped MAP_SHARED, a flush is a memcpy
+//  into the page cache (which survives an app crash) instead of write+fsync
+//  per line. When the mapping is full the file is trimmed and rotated.
+//
+
 #import "NativeFileLogger.h"
+
+#import <os/log.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kRingSlots 1024u
+#define kRingMask (kRingSlots - 1)
+#define kSlotTextSize 480
+#define kSlotTextWords (kSlotTextSize / sizeof(uint64_t))
+#define kLogFileSize (4u * 1024 * 1024)
+#define kRotatedFiles 2
+
+typedef struct {
+    _Atomic uint64_t seq;       // queue position bookkeeping
+    _Atomic uint32_t version;   // odd while the producer writes the slot
+    _Atomic uint32_t length;    // bytes used in text
+    _Atomic uint64_t position;  // ring position of the record held
+    char level;
+    char *overflow;             // full record when it did not fit in text
+    size_t overflowLength;
+    _Atomic uint64_t text[kSlotTextWords];
+} LogSlot;
+
+static LogSlot g_slots[kRingSlots];
+static _Atomic uint64_t g_enqueuePos;
+static uint64_t g_dequeuePos;           // log queue only
+static _Atomic uint64_t g_dropped;
+static _Atomic size_t g_pendingBytes;
+static atomic_bool g_flushArmed;
+
+static _Atomic size_t g_maxPendingBytes = 32 * 1024;
+static _Atomic uint64_t g_maxDelayNs = NSEC_PER_SEC;
+static atomic_bool g_flushOnError = true;
+static atomic_bool g_fileOutput = true;
+
+static dispatch_queue_t g_logQueue = nil;
+static os_log_t g_osLog;
+
+// UTC offset at start, to turn wall clock readings into local time of day
+static int64_t g_localOffsetNs;
+
+// Log queue only
+static NSString *g_logFilePath = nil;
+static int g_fd = -1;
+static char *g_map = NULL;
+static size_t g_mapOffset = 0;
+
+#pragma mark - File
+
+static void openLogFile(void) {
+    g_fd = open(g_logFilePath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (g_fd < 0) return;
+    g_mapOffset = 0;
+    if (ftruncate(g_fd, kLogFileSize) == 0) {
+        void *map = mmap(NULL, kLogFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, g_fd, 0);
+        g_map = map == MAP_FAILED ? NULL : (char *)map;
+    }
+    // Without a mapping records go through write(2)
+    if (!g_map) ftruncate(g_fd, 0);
+}
+
+static void closeLogFile(void) {
+    if (g_fd < 0) return;
+    if (g_map) {
+        msync(g_map, g_mapOffset, MS_ASYNC);
+        munmap(g_map, kLogFileSize);
+        g_map = NULL;
+        // Drop the unused, zero-filled tail
+        ftruncate(g_fd, g_mapOffset);
+    }
+    close(g_fd);
+    g_fd = -1;
+}
+
+static NSString *rotatedPath(int index) {
+    NSString *base = [g_logFilePath stringByDeletingPathExtension];
+    return [NSString stringWithFormat:@"%@.%d.log", base, index];
+}
+
+static void rotateLogFile(void) {
+    closeLogFile();
+    NSFileManager *fm = [NSFileManager defaultManager];
+    [fm removeItemAtPath:rotatedPath(kRotatedFiles) error:nil];
+    for (int i = kRotatedFiles - 1; i >= 1; i--) {
+        [fm moveItemAtPath:rotatedPath(i) toPath:rotatedPath(i + 1) error:nil];
+    }
+    [fm moveItemAtPath:g_logFilePath toPath:rotatedPath(1) error:nil];
+    openLogFile();
+}
+
+static void writeToFile(const char *bytes, size_t length) {
+    if (g_fd < 0) return;
+    if (!g_map) {
+        write(g_fd, bytes, length);
+        return;
+    }
+    if (g_mapOffset + length > kLogFileSize) {
+        rotateLogFile();
+        if (!g_map) {
+            if (g_fd >= 0) write(g_fd, bytes, length);
+            return;
+        }
+        length = MIN(length, (size_t)kLogFileSize);
+    }
+    memcpy(g_map + g_mapOffset, bytes, length);
+    g_mapOffset += length;
+}
+
+#pragma mark - Ring
+
+// Relaxed word copies: seqlock readers may run concurrently with the producer
+static void slotStoreText(LogSlot *slot, const char *bytes, uint32_t length) {
+    for (uint32_t i = 0; i < length; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, MIN(sizeof(word), (size_t)(length - i)));
+        atomic_store_explicit(&slot->text[i / sizeof(uint64_t)], word, memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->length, length, memory_order_relaxed);
+}
+
+static uint32_t slotLoadText(LogSlot *slot, char *out) {
+    uint32_t length = MIN(atomic_load_explicit(&slot->length, memory_order_relaxed), (uint32_t)kSlotTextSize);
+    for (uint32_t i = 0; i < length; i += sizeof(uint64_t)) {
+        uint64_t word = atomic_load_explicit(&slot->text[i / sizeof(uint64_t)], memory_order_relaxed);
+        memcpy(out + i, &word, MIN(sizeof(word), (size_t)(length - i)));
+    }
+    return length;
+}
+
+// Runs on g_logQueue
+static void drainRing(bool sync) {
+    atomic_store_explicit(&g_flushArmed, false, memory_order_relaxed);
+    atomic_store_explicit(&g_pendingBytes, 0, memory_order_relaxed);
+
+    uint64_t dropped = atomic_exchange_explicit(&g_dropped, 0, memory_order_relaxed);
+    if (dropped) {
+        char note[64];
+        int length = snprintf(note, sizeof(note), "[logger] %llu records dropped\n", (unsigned long long)dropped);
+        writeToFile(note, (size_t)length);
+    }
+
+    bool error = false;
+    char text[kSlotTextSize];
+    for (;;) {
+        LogSlot *slot = &g_slots[g_dequeuePos & kRingMask];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != g_dequeuePos + 1) break;
+        if (slot->overflow) {
+            writeToFile(slot->overflow, slot->overflowLength);
+            free(slot->overflow);
+            slot->overflow = NULL;
+        } else {
+            writeToFile(text, slotLoadText(slot, text));
+        }
+        error |= slot->level == 'E';
+        atomic_store_explicit(&slot->seq, g_dequeuePos + kRingSlots, memory_order_release);
+        g_dequeuePos++;
+    }
+    if (g_map && (error || sync)) {
+        // Hand dirty pages to the kernel now: an error is usually followed by more trouble
+        msync(g_map, g_mapOffset, MS_ASYNC);
+    }
+}
+
+static void scheduleFlush(bool urgent) {
+    if (urgent) {
+        dispatch_async(g_logQueue, ^{ drainRing(false); });
+        return;
+    }
+    if (atomic_exchange_explicit(&g_flushArmed, true, memory_order_relaxed)) return;
+    uint64_t delay = atomic_load_explicit(&g_maxDelayNs, memory_order_relaxed);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)delay), g_logQueue, ^{ drainRing(false); });
+}
+
+static size_t formatTimestamp(char *out, size_t capacity) {
+    // Wall clock, not a monotonic one: those stop while the device sleeps
+    int64_t local = (int64_t)clock_gettime_nsec_np(CLOCK_REALTIME) + g_localOffsetNs;
+    int64_t msOfDay = (local / 1000000) % (86400LL * 1000);
+    if (msOfDay < 0) msOfDay += 86400LL * 1000;
+    int length = snprintf(out, capacity, "[%02d:%02d:%02d.%03d] ",
+                          (int)(msOfDay / 3600000), (int)(msOfDay / 60000 % 60),
+                          (int)(msOfDay / 1000 % 60), (int)(msOfDay % 1000));
+    return length > 0 ? (size_t)length : 0;
+}
+
+static void ringAppend(const char *level, const char *tag, NSString *message) {
+    uint64_t pos = atomic_load_explicit(&g_enqueuePos, memory_order_relaxed);
+    LogSlot *slot;
+    for (;;) {
+        slot = &g_slots[pos & kRingMask];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t dif = (int64_t)seq - (int64_t)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&g_enqueuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            // Flusher is behind by a full ring: drop rather than block the caller
+            atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&g_enqueuePos, memory_order_relaxed);
+        }
+    }
+
+    atomic_fetch_add_explicit(&slot->version, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    char prefix[96];
+    size_t prefixLength = formatTimestamp(prefix, sizeof(prefix));
+    int tagLength = snprintf(prefix + prefixLength, sizeof(prefix) - prefixLength, "%s/%s: ", level, tag);
+    if (tagLength > 0) prefixLength = MIN(prefixLength + (size_t)tagLength, sizeof(prefix) - 1);
+
+    NSRange all = NSMakeRange(0, message.length);
+    NSUInteger messageLength = [message lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    size_t recordLength = prefixLength + messageLength + 1;
+
+    char text[kSlotTextSize];
+    memcpy(text, prefix, prefixLength);
+    NSUInteger used = 0;
+    [message getBytes:text + prefixLength
+            maxLength:kSlotTextSize - prefixLength - 1
+           usedLength:&used
+             encoding:NSUTF8StringEncoding
+              options:0
+                range:all
+       remainingRange:NULL];
+    uint32_t textLength = (uint32_t)(prefixLength + used);
+    text[textLength++] = '\n';
+    slotStoreText(slot, text, textLength);
+
+    slot->overflow = NULL;
+    slot->overflowLength = 0;
+    if (recordLength > textLength) {
+        // Ring keeps the truncated text, the file gets the whole record
+        char *full = malloc(recordLength);
+        if (full) {
+            memcpy(full, prefix, prefixLength);
+            [message getBytes:full + prefixLength maxLength:messageLength usedLength:&used
+                     encoding:NSUTF8StringEncoding options:0 range:all remainingRange:NULL];
+            full[prefixLength + used] = '\n';
+            slot->overflow = full;
+            slot->overflowLength = prefixLength + used + 1;
+        }
+    }
+    slot->level = level[0];
+    atomic_store_explicit(&slot->position, pos, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&slot->version, 1, memory_order_release);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    size_t threshold = atomic_load_explicit(&g_maxPendingBytes, memory_order_relaxed);
+    size_t before = atomic_fetch_add_explicit(&g_pendingBytes, recordLength, memory_order_relaxed);
+    bool urgent = (before < threshold && before + recordLength >= threshold)
+        || (level[0] == 'E' && atomic_load_explicit(&g_flushOnError, memory_order_relaxed));
+    scheduleFlush(urgent);
+}
+
+#pragma mark - Setup
+
+static void initFileLogger(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (uint32_t i = 0; i < kRingSlots; i++) {
+            atomic_init(&g_slots[i].seq, i);
+            atomic_init(&g_slots[i].version, 0);
+        }
+        g_osLog = os_log_create("net.jami.bridge", "native");
+        g_logQueue = dispatch_queue_create("com.gettogether.filelogger",
+            dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+
+        time_t now = time(NULL);
+        struct tm localTime;
+        localtime_r(&now, &localTime);
+        g_localOffsetNs = (int64_t)localTime.tm_gmtoff * (int64_t)NSEC_PER_SEC;
+
+        if (!atomic_load(&g_fileOutput)) return;
+
+        NSArray *paths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
+        NSString *documentsPath = paths.firstObject;
+        if (!documentsPath) {
+            os_log_error(g_osLog, "[FileLogger] ERROR: Could not find Documents directory");
+            return;
+        }
+
+        NSDateFormatter *timestampFormatter = [[NSDateFormatter alloc] init];
+        timestampFormatter.dateFormat = @"yyyy-MM-dd_HH-mm-ss";
+        NSString *timestamp = [timestampFormatter stringFromDate:[NSDate date]];
+
+        NSString *fileName = [NSString stringWithFormat:@"gettogether_native_%@.log", timestamp];
+        NSString *logFilePath = [documentsPath stringByAppendingPathComponent:fileName];
+
+        dispatch_sync(g_logQueue, ^{
+            g_logFilePath = logFilePath;
+            openLogFile();
+
+            // Write header
+            NSString *header = [NSString stringWithFormat:
+                @"=====================================\n"
+                @"GetTogether iOS Native Debug Log\n"
+                @"Started: %@\n"
+                @"=====================================\n\n",
+                [NSDate date]];
+            NSData *data = [header dataUsingEncoding:NSUTF8StringEncoding];
+            writeToFile(data.bytes, data.length);
+        });
+        atexit_b(^{
+            dispatch_sync(g_logQueue, ^{
+                drainRing(true);
+                closeLogFile();
+            });
+        });
+
+        os_log(g_osLog, "[FileLogger] Initialized at %{public}@", logFilePath);
+    });
+}
+
+#pragma mark - API
+
+void fileLog(const char* level, const char* tag, NSString *message) {
+    initFileLogger();
+
+    // Console: os_log formats lazily and does not block like NSLog
+    os_log_type_t type = level[0] == 'E' ? OS_LOG_TYPE_ERROR
+        : level[0] == 'D' ? OS_LOG_TYPE_DEBUG : OS_LOG_TYPE_DEFAULT;
+    os_log_with_type(g_osLog, type, "%{public}s/%{public}s: %{public}@", level, tag, message);
+
+    if (!atomic_load_explicit(&g_fileOutput, memory_order_relaxed)) return;
+    ringAppend(level, tag, message ?: @"");
+}
+
+void fileLogSetFlushPolicy(size_t maxPendingBytes, double maxDelaySeconds, bool flushOnError) {
+    atomic_store(&g_maxPendingBytes, MAX(maxPendingBytes, (size_t)1));
+    atomic_store(&g_maxDelayNs, (uint64_t)(MAX(maxDelaySeconds, 0.0) * NSEC_PER_SEC));
+    atomic_store(&g_flushOnError, flushOnError);
+}
+
+void fileLogSetFileOutputEnabled(bool enabled) {
+    atomic_store(&g_fileOutput, enabled);
+}
+
+void fileLogFlush(void) {
+    initFileLogger();
+    dispatch_sync(g_logQueue, ^{ drainRing(true); });
+}
+
+NSString *fileLogRecentLines(int maxLines) {
+    initFileLogger();
+    if (maxLines <= 0) return @"";
+    uint64_t end = atomic_load_explicit(&g_enqueuePos, memory_order_acquire);
+    uint64_t count = MIN((uint64_t)maxLines, MIN(end, (uint64_t)kRingSlots));
+
+    NSMutableString *result = [NSMutableString stringWithCapacity:(NSUInteger)count * 96];
+    char buffer[kSlotTextSize];
+    for (uint64_t pos = end - count; pos < end; pos++) {
+        LogSlot *slot = &g_slots[pos & kRingMask];
+        uint32_t before = atomic_load_explicit(&slot->version, memory_order_acquire);
+        if (before & 1) continue;
+        uint32_t length = slotLoadText(slot, buffer);
+        uint64_t position = atomic_load_explicit(&slot->position, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        // Rewritten meanwhile, or an older record never overwritten: skip
+        if (atomic_load_explicit(&slot->version, memory_order_relaxed) != before || position != pos) continue;
+        NSString *line = [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+        if (line) [result appendString:line];
+    }
+    // Same shape as lines joined by "\n": no trailing newline
+    if ([result hasSuffix:@"\n"]) [result deleteCharactersInRange:NSMakeRange(result.length - 1, 1)];
+    return result;
+}
@@ -0,0 +1,85 @@
+#!/bin/bash
+#
+# Build and run the JamiBridge micro-benchmark (macOS)
+#
+# Compiles the bridge sources together with bench/*.mm into a command-line
+# tool linked against libjami.a. No daemon is started: the signal handlers are
+# invoked directly with synthetic payloads, or with a trace captured on device
+# through -[JamiBridgeWrapper startSignalTrace:].
+#
+# Usage:
+#   ./bench-jamibridge.sh [--iterations N] [--filter substring]
+#   ./bench-jamibridge.sh --replay trace.jsonl [--realtime]
+#
+# Prerequisites: same as build-jamibridge.sh
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+CINTEROP_DIR="$(dirname "$SCRIPT_DIR")"
+NATIVE_INTEROP_DIR="$(dirname "$CINTEROP_DIR")"
+
+# Configuration
+HEADERS_DIR="$CINTEROP_DIR/headers"
+LIB_DIR="$CINTEROP_DIR/lib"
+BUILD_DIR="$CINTEROP_DIR/build/bench"
+BENCH="$BUILD_DIR/jamibridge-bench"
+
+# Build settings (kept in sync with build-jamibridge.sh)
+CXX_FLAGS="-std=c++17 -fobjc-arc -fmodules -DNDEBUG -O2"
+OBJC_FLAGS="-fobjc-arc -fmodules -DNDEBUG -O2"
+CORE_FLAGS="-std=c++17 -DNDEBUG -O2"
+INCLUDE_FLAGS="-I$HEADERS_DIR -I$SCRIPT_DIR -I$NATIVE_INTEROP_DIR"
+LINK_FLAGS="-L$LIB_DIR -ljami -lc++ -lsqlite3"
+
+SOURCES=("$SCRIPT_DIR"/*.mm "$SCRIPT_DIR"/*.m "$NATIVE_INTEROP_DIR"/jbcore/*.cpp "$SCRIPT_DIR"/bench/*.mm)
+
+# Check prerequisites
+if [ ! -f "$LIB_DIR/libjami.a" ]; then
+    echo "Error: libjami.a not found in $LIB_DIR"
+    echo "Please copy libjami.a from gettogether or build it from jami-daemon"
+    exit 1
+fi
+
+if [ ! -f "$HEADERS_DIR/jami.h" ]; then
+    echo "Error: jami.h not found in $HEADERS_DIR"
+    echo "Please copy libjami headers from gettogether or jami-daemon"
+    exit 1
+fi
+
+ARCH=$(uname -m)
+if [ "$ARCH" = "arm64" ]; then
+    TARGET="arm64-apple-macos11.0"
+else
+    TARGET="x86_64-apple-macos11.0"
+fi
+
+mkdir -p "$BUILD_DIR"
+
+echo "=== Building jamibridge-bench ($TARGET) ==="
+objects=()
+for src in "${SOURCES[@]}"; do
+    name="$(basename "${src%.*}")"
+    obj="$BUILD_DIR/${name}.o"
+    compiler="clang++"
+    flags="$CXX_FLAGS"
+    if [ "${src##*.}" = "m" ]; then
+        compiler="clang"
+        flags="$OBJC_FLAGS"
+    elif [ "${src##*.}" = "cpp" ]; then
+        flags="$CORE_FLAGS"
+    fi
+    # Only rebuild what changed since the last run
+    if [ ! -f "$obj" ] || [ "$src" -nt "$obj" ]; then
+        echo "  $(basename "$src")"
+        $compiler -c "$src" -o "$obj" $flags $INCLUDE_FLAGS -target "$TARGET"
+    fi
+    objects+=("$obj")
+done
+
+clang++ "${objects[@]}" -o "$BENCH" -target "$TARGET" -fobjc-arc $LINK_FLAGS
+
+echo ""
+echo "=== Running ==="
+"$BENCH" "$@"
@@ -0,0 +1,515 @@
+//
+//  JBBridgeBench.mm
+//  GetTogether
+//
+//  Micro-benchmarks for the bridge conversions and signal handlers, and replay
+//  of captured signal traces, without a running daemon. The handlers are the
+//  ones registerSignalHandlers installs (makeSignalHandlers) and are invoked
+//  directly; delegate calls land on a counting delegate that reads what the
+//  Kotlin bridge copies, so lazy conversions are paid for.
+//
+//  Usage: jamibridge-bench [--iterations N] [--filter substring]
+//         jamibridge-bench --replay trace.jsonl [--realtime]
+//
+
+#import "JBBridgeInternal.h"
+#import "JBLazySwarmMessage.h"
+#import "JBSignalMetrics.h"
+#import "JBSignalTrace.h"
+#include "JBConversions.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "callmanager_interface.h"
+#include "configurationmanager_interface.h"
+#include "conversation_interface.h"
+#include "presencemanager_interface.h"
+
+namespace {
+
+uint64_t now() {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+// =============================================================================
+// Synthetic payloads (sizes taken from real accounts)
+// =============================================================================
+
+std::string hexId(size_t seed) {
+    static const char *digits = "0123456789abcdef";
+    std::string id(40, '0');
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (auto& c : id) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        c = digits[x & 15];
+    }
+    return id;
+}
+
+std::map<std::string, std::string> messageBody(size_t i) {
+    return {
+        {"id", hexId(i)},
+        {"type", "text/plain"},
+        {"author", hexId(i % 7 + 100000)},
+        {"body", "Message " + std::to_string(i) + ": see you at the station at eight, bring the tickets please"},
+        {"timestamp", std::to_string(1700000000 + i)},
+        {"linearizedParent", hexId(i + 1)},
+        {"parents", hexId(i + 1)},
+        {"reply-to", i % 10 == 0 ? hexId(i + 5) : ""},
+    };
+}
+
+libjami::SwarmMessage swarmMessage(size_t i) {
+    libjami::SwarmMessage message;
+    message.id = hexId(i);
+    message.type = "text/plain";
+    message.linearizedParent = hexId(i + 1);
+    message.body = messageBody(i);
+    if (i % 5 == 0) {
+        message.reactions.push_back({{"id", hexId(i + 9)}, {"author", hexId(3)}, {"body", "👍"}});
+    }
+    message.status = {{hexId(100001), 3}, {hexId(100002), 2}};
+    return message;
+}
+
+std::vector<libjami::SwarmMessage> swarmPage(size_t count) {
+    std::vector<libjami::SwarmMessage> page;
+    page.reserve(count);
+    for (size_t i = 0; i < count; ++i) page.push_back(swarmMessage(i));
+    return page;
+}
+
+std::vector<std::map<std::string, std::string>> contacts(size_t count) {
+    std::vector<std::map<std::string, std::string>> list;
+    list.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        list.push_back({
+            {"id", hexId(i + 200000)},
+            {"added", std::to_string(1600000000 + i)},
+            {"confirmed", i % 9 ? "true" : "false"},
+            {"conversationId", hexId(i + 300000)},
+        });
+    }
+    return list;
+}
+
+std::vector<std::map<std::string, std::string>> conferenceParticipants(size_t count) {
+    std::vector<std::map<std::string, std::string>> list;
+    list.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        list.push_back({
+            {"uri", hexId(i + 400000)},
+            {"device", hexId(i + 500000)},
+            {"sinkId", "conf_" + hexId(i + 600000)},
+            {"active", i == 0 ? "true" : "false"},
+            {"x", std::to_string((i % 5) * 256)},
+            {"y", std::to_string((i / 5) * 144)},
+            {"w", "256"},
+            {"h", "144"},
+            {"videoMuted", i % 3 ? "false" : "true"},
+            {"audioLocalMuted", "false"},
+            {"audioModeratorMuted", "false"},
+            {"isModerator", i == 0 ? "true" : "false"},
+            {"handRaised", "false"},
+            {"voiceActivity", i % 4 ? "false" : "true"},
+            {"recording", "false"},
+        });
+    }
+    return list;
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+struct Timing {
+    std::vector<uint64_t> samples;
+
+    void report(const char *name, size_t itemsPerIteration) {
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) { return samples[(size_t)(q * (double)(samples.size() - 1))] / 1000.0; };
+        double median = at(0.5);
+        printf("%-44s min %9.1f us  p50 %9.1f us  p90 %9.1f us  %8.2f us/item\n",
+               name, at(0), median, at(0.9), median / (double)std::max<size_t>(itemsPerIteration, 1));
+    }
+};
+
+template <typename Body>
+void bench(const char *name, const char *filter, int iterations, size_t items, Body&& body) {
+    if (filter && !strstr(name, filter)) return;
+    Timing timing;
+    body(); // warm up caches and interned ids
+    for (int i = 0; i < iterations; ++i) {
+        @autoreleasepool {
+            uint64_t start = now();
+            body();
+            timing.samples.push_back(now() - start);
+        }
+    }
+    timing.report(name, items);
+}
+
+void printSignalMetrics() {
+    NSDictionary<NSString *, JBSignalMetrics *> *snapshot = signalMetricsSnapshot();
+    if (snapshot.count == 0) return;
+    printf("\n%-32s %8s %10s %10s %10s %10s %10s %12s\n", "signal", "count",
+           "conv p50", "conv p99", "wait p50", "wait p99", "dlg p99", "bytes");
+    for (NSString *name in [snapshot.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        JBSignalMetrics *m = snapshot[name];
+        printf("%-32s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f %12llu\n", name.UTF8String,
+               (unsigned long long)m.count, m.conversionP50Micros, m.conversionP99Micros,
+               m.queueWaitP50Micros, m.queueWaitP99Micros, m.delegateP99Micros,
+               (unsigned long long)m.bytesConverted);
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// Delegate: counts deliveries and touches what a received message ends up
+// converting (toKotlinSwarmMessage, then the model building its interaction)
+// =============================================================================
+
+@interface JBBenchDelegate : NSObject <JamiBridgeDelegate>
+@property (atomic, assign) uint64_t deliveries;
+@end
+
+@implementation JBBenchDelegate
+
+static void touch(JBSwarmMessage *message) {
+    (void)message.messageId;
+    (void)message.type;
+    (void)message.replyTo;
+    (void)message.body;
+    (void)message.status;
+}
+
+- (void)onMessageReceived:(NSString *)accountId conversationId:(NSString *)conversationId message:(JBSwarmMessage *)message {
+    touch(message);
+    self.deliveries++;
+}
+
+- (void)onMessagesLoaded:(int)requestId accountId:(NSString *)accountId conversationId:(NSString *)conversationId messages:(NSArray<JBSwarmMessage *> *)messages {
+    for (JBSwarmMessage *message in messages) touch(message);
+    self.deliveries++;
+}
+
+- (void)onMessagesUpdatedBatch:(NSArray<JBMessageUpdate *> *)updates {
+    for (JBMessageUpdate *update in updates) touch(update.message);
+    self.deliveries++;
+}
+
+- (void)onMessagesFound:(NSString *)accountId requestId:(uint32_t)requestId conversationId:(NSString *)conversationId messages:(NSArray<NSDictionary<NSString *, NSString *> *> *)messages {
+    self.deliveries++;
+}
+
+- (void)onConferenceInfoUpdated:(NSString *)conferenceId participantInfos:(NSArray<NSDictionary<NSString *, NSString *> *> *)participantInfos {
+    self.deliveries++;
+}
+
+- (void)onPresenceBatch:(NSArray<JBPresenceUpdate *> *)updates {
+    self.deliveries++;
+}
+
+- (void)onComposingStatusBatch:(NSArray<JBComposingUpdate *> *)updates {
+    self.deliveries++;
+}
+
+- (void)onConversationReady:(NSString *)accountId conversationId:(NSString *)conversationId {
+    self.deliveries++;
+}
+
+- (void)onConversationMemberEvent:(NSString *)accountId conversationId:(NSString *)conversationId memberUri:(NSString *)memberUri event:(JBMemberEventType)event {
+    self.deliveries++;
+}
+
+- (void)onCallStateChanged:(NSString *)accountId callId:(NSString *)callId state:(JBCallState)state code:(int)code {
+    self.deliveries++;
+}
+
+@end
+
+namespace {
+
+dispatch_queue_t gDeliveryQueue;
+
+// Waits for queued and coalesced (16 ms window) deliveries to reach the delegate
+void drainDeliveries() {
+    usleep(40 * 1000);
+    dispatch_sync(gDeliveryQueue, ^{});
+}
+
+template <typename Ts, typename... Args>
+void invoke(const JBSignalHandlerMap& handlers, Args&&... args) {
+    auto it = handlers.find(Ts::name);
+    if (it == handlers.end()) return;
+    auto *wrapper = static_cast<libjami::CallbackWrapper<typename Ts::cb_type> *>(it->second.get());
+    (**wrapper)(std::forward<Args>(args)...);
+}
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+using Replayer = std::function<void(const std::shared_ptr<libjami::CallbackWrapperBase>&, NSArray *)>;
+
+// Out-parameters get fresh local storage
+template <typename A>
+using Stored = std::conditional_t<std::is_pointer_v<std::decay_t<A>>,
+                                  std::remove_pointer_t<std::decay_t<A>>,
+                                  std::decay_t<A>>;
+
+template <typename A>
+Stored<A> decodeArgument(NSArray *args, size_t index) {
+    if constexpr (std::is_pointer_v<std::decay_t<A>>) {
+        return Stored<A>();
+    } else {
+        id value = index < args.count ? args[index] : nil;
+        return TraceDecoder<Stored<A>>::decode(value);
+    }
+}
+
+template <typename A>
+decltype(auto) passArgument(Stored<A>& value) {
+    if constexpr (std::is_pointer_v<std::decay_t<A>>) return &value;
+    else return std::move(value);
+}
+
+template <typename F>
+struct ReplayCall;
+
+template <typename... Args>
+struct ReplayCall<void(Args...)> {
+    static void call(const std::shared_ptr<libjami::CallbackWrapperBase>& base, NSArray *args) {
+        auto *wrapper = static_cast<libjami::CallbackWrapper<void(Args...)> *>(base.get());
+        if (!*wrapper) return;
+        apply(**wrapper, args, std::index_sequence_for<Args...>{});
+    }
+
+    template <size_t... I>
+    static void apply(const std::function<void(Args...)>& callback, NSArray *args, std::index_sequence<I...>) {
+        std::tuple<Stored<Args>...> values {decodeArgument<Args>(args, I)...};
+        callback(passArgument<Args>(std::get<I>(values))...);
+    }
+};
+
+template <typename Ts>
+void addReplayer(std::map<std::string, Replayer>& table) {
+    table[Ts::name] = &ReplayCall<typename Ts::cb_type>::call;
+}
+
+// Video and data transfer handlers call into libjami (sinks, fileTransferInfo)
+// and are not replayed; request callbacks (out-parameters) have nothing to replay.
+std::map<std::string, Replayer> replayers() {
+    using namespace libjami;
+    std::map<std::string, Replayer> table;
+    addReplayer<ConfigurationSignal::RegistrationStateChanged>(table);
+    addReplayer<ConfigurationSignal::AccountDetailsChanged>(table);
+    addReplayer<ConfigurationSignal::ContactAdded>(table);
+    addReplayer<ConfigurationSignal::ContactRemoved>(table);
+    addReplayer<ConfigurationSignal::IncomingTrustRequest>(table);
+    addReplayer<ConfigurationSignal::NameRegistrationEnded>(table);
+    addReplayer<ConfigurationSignal::RegisteredNameFound>(table);
+    addReplayer<ConfigurationSignal::KnownDevicesChanged>(table);
+    addReplayer<ConfigurationSignal::ComposingStatusChanged>(table);
+    addReplayer<ConfigurationSignal::ProfileReceived>(table);
+    addReplayer<CallSignal::StateChange>(table);
+    addReplayer<CallSignal::IncomingCall>(table);
+    addReplayer<CallSignal::AudioMuted>(table);
+    addReplayer<CallSignal::VideoMuted>(table);
+    addReplayer<CallSignal::ConferenceCreated>(table);
+    addReplayer<CallSignal::ConferenceChanged>(table);
+    addReplayer<CallSignal::ConferenceRemoved>(table);
+    addReplayer<CallSignal::OnConferenceInfosUpdated>(table);
+    addReplayer<CallSignal::MediaChangeRequested>(table);
+    addReplayer<ConversationSignal::ConversationReady>(table);
+    addReplayer<ConversationSignal::ConversationRemoved>(table);
+    addReplayer<ConversationSignal::ConversationRequestReceived>(table);
+    addReplayer<ConversationSignal::SwarmMessageReceived>(table);
+    addReplayer<ConversationSignal::SwarmMessageUpdated>(table);
+    addReplayer<ConversationSignal::SwarmLoaded>(table);
+    addReplayer<ConversationSignal::ConversationMemberEvent>(table);
+    addReplayer<ConversationSignal::ConversationProfileUpdated>(table);
+    addReplayer<ConversationSignal::ConversationPreferencesUpdated>(table);
+    addReplayer<ConversationSignal::MessagesFound>(table);
+    addReplayer<ConversationSignal::ReactionAdded>(table);
+    addReplayer<ConversationSignal::ReactionRemoved>(table);
+    addReplayer<PresenceSignal::NewBuddyNotification>(table);
+    return table;
+}
+
+int replay(const JBSignalHandlerMap& handlers, const char *path, bool realtime) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    auto table = replayers();
+    std::map<std::string, size_t> skipped;
+    size_t replayed = 0;
+    uint64_t start = now();
+    uint64_t handlerTime = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        @autoreleasepool {
+            NSData *data = [NSData dataWithBytesNoCopy:line.data() length:line.size() freeWhenDone:NO];
+            NSDictionary *entry = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+            if (![entry isKindOfClass:[NSDictionary class]]) continue;
+            std::string signal = TraceDecoder<std::string>::decode(entry[@"signal"]);
+            auto replayer = table.find(signal);
+            auto handler = handlers.find(signal);
+            if (replayer == table.end() || handler == handlers.end()) {
+                skipped[signal]++;
+                continue;
+            }
+            if (realtime) {
+                uint64_t due = start + TraceDecoder<uint64_t>::decode(entry[@"t"]);
+                uint64_t current = now();
+                if (due > current) usleep((useconds_t)((due - current) / 1000));
+            }
+            uint64_t before = now();
+            replayer->second(handler->second, entry[@"args"]);
+            handlerTime += now() - before;
+            replayed++;
+        }
+    }
+    drainDeliveries();
+    printf("Replayed %zu signals in %.1f ms (%.1f ms in handlers)\n",
+           replayed, (now() - start) / 1e6, handlerTime / 1e6);
+    for (const auto& [signal, count] : skipped) {
+        printf("  skipped %zu x %s\n", count, signal.c_str());
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    @autoreleasepool {
+        int iterations = 20;
+        const char *filter = nullptr;
+        const char *replayPath = nullptr;
+        bool realtime = false;
+        for (int i = 1; i < argc; ++i) {
+            if (!strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1, atoi(argv[++i]));
+            else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+            else if (!strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+            else if (!strcmp(argv[i], "--realtime")) realtime = true;
+            else {
+                fprintf(stderr, "Usage: %s [--iterations N] [--filter substring] | --replay trace.jsonl [--realtime]\n", argv[0]);
+                return 2;
+            }
+        }
+
+        JamiBridgeWrapper *bridge = [JamiBridgeWrapper shared];
+        JBBenchDelegate *delegate = [[JBBenchDelegate alloc] init];
+        bridge.delegate = delegate;
+        gDeliveryQueue = dispatch_queue_create("net.jami.bridge.bench.delivery", DISPATCH_QUEUE_SERIAL);
+        for (JBSignalDomain domain : {JBSignalDomainCall, JBSignalDomainConversation, JBSignalDomainConfiguration,
+                                      JBSignalDomainPresence, JBSignalDomainVideo}) {
+            [bridge setDeliveryQueue:gDeliveryQueue forDomain:domain];
+        }
+        JBSignalHandlerMap handlers = [bridge makeSignalHandlers];
+
+        if (replayPath) {
+            int status = replay(handlers, replayPath, realtime);
+            printSignalMetrics();
+            return status;
+        }
+
+        // ---------------------------------------------------------------------
+        // Conversion helpers
+        // ---------------------------------------------------------------------
+        printf("== Conversions (%d iterations)\n", iterations);
+
+        std::vector<std::map<std::string, std::string>> bodies;
+        for (size_t i = 0; i < 1000; ++i) bodies.push_back(messageBody(i));
+        bench("toNSDictionary x1000 message bodies", filter, iterations, bodies.size(), [&] {
+            for (const auto& body : bodies) (void)toNSDictionary(body);
+        });
+
+        NSMutableArray<NSDictionary<NSString *, NSString *> *> *dictionaries = [NSMutableArray array];
+        for (const auto& body : bodies) [dictionaries addObject:toNSDictionary(body)];
+        bench("toCppMap x1000 message bodies", filter, iterations, dictionaries.count, [&] {
+            for (NSDictionary *dictionary in dictionaries) (void)toCppMap(dictionary);
+        });
+
+        std::vector<std::string> ids;
+        for (size_t i = 0; i < 2000; ++i) ids.push_back(hexId(i));
+        bench("toNSArray 2000 ids", filter, iterations, ids.size(), [&] {
+            (void)toNSArray(ids);
+        });
+
+        auto page = swarmPage(1000);
+        bench("toJBSwarmMessage x1000 (+ id/type/body read)", filter, iterations, page.size(), [&] {
+            for (const auto& message : page) {
+                touch([[JBLazySwarmMessage alloc] initWithSwarmMessage:libjami::SwarmMessage(message)]);
+            }
+        });
+
+        auto contactList = contacts(2000);
+        bench("toJBContacts 2000 contacts", filter, iterations, contactList.size(), [&] {
+            (void)toJBContacts(contactList);
+        });
+
+        auto participants = conferenceParticipants(25);
+        bench("conference infos 25 participants", filter, iterations, participants.size(), [&] {
+            NSMutableArray *infos = [NSMutableArray arrayWithCapacity:participants.size()];
+            for (const auto& info : participants) [infos addObject:toNSDictionary(info)];
+        });
+
+        // ---------------------------------------------------------------------
+        // Handler bodies (daemon-thread cost; delivery cost in the metrics table)
+        // ---------------------------------------------------------------------
+        printf("\n== Signal handlers (%d iterations)\n", iterations);
+        resetSignalMetrics();
+        using namespace libjami;
+        std::string account = hexId(1);
+        std::string conversation = hexId(2);
+
+        bench("SwarmLoaded 1000-message page", filter, iterations, page.size(), [&] {
+            invoke<ConversationSignal::SwarmLoaded>(handlers, 1u, account, conversation, swarmPage(1000));
+        });
+        drainDeliveries();
+
+        bench("SwarmMessageReceived x1000", filter, iterations, page.size(), [&] {
+            for (const auto& message : page) {
+                invoke<ConversationSignal::SwarmMessageReceived>(handlers, account, conversation, message);
+            }
+        });
+        drainDeliveries();
+
+        bench("OnConferenceInfosUpdated 25 participants x100", filter, iterations, 100, [&] {
+            for (int i = 0; i < 100; ++i) {
+                invoke<CallSignal::OnConferenceInfosUpdated>(handlers, hexId(700000 + i), participants);
+            }
+        });
+        drainDeliveries();
+
+        bench("NewBuddyNotification 2000 contacts", filter, iterations, contactList.size(), [&] {
+            for (const auto& contact : contactList) {
+                invoke<PresenceSignal::NewBuddyNotification>(handlers, account, contact.at("id"), 1, std::string());
+            }
+        });
+        drainDeliveries();
+
+        bench("MessagesFound 1000 results", filter, iterations, bodies.size(), [&] {
+            invoke<ConversationSignal::MessagesFound>(handlers, 2u, account, conversation, bodies);
+        });
+        drainDeliveries();
+
+        printf("\n%llu delegate deliveries\n", (unsigned long long)delegate.deliveries);
+        printSignalMetrics();
+    }
+    return 0;
+}
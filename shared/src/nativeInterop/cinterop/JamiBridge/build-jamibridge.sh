@@ -2,12 +2,14 @@
 #
 # Build JamiBridge static library for iOS/macOS
 #
-# This script compiles JamiBridgeWrapper.mm into a static library
-# that can be linked with Kotlin/Native via cinterop.
+# This script compiles the JamiBridge sources (JamiBridgeWrapper.mm and the
+# subsystem files next to it) and the platform-neutral bridge core
+# (../../jbcore, shared with the JNI library) into a static library that can
+# be linked with Kotlin/Native via cinterop.
 #
 # Prerequisites:
 # - libjami.a in ../lib/
-# - libjami headers in ../headers/
+# - libjami headers in ../headers/ (including the FFmpeg libavutil/ headers)
 # - Xcode Command Line Tools installed
 #
 
@@ -15,6 +17,7 @@ set -e
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 CINTEROP_DIR="$(dirname "$SCRIPT_DIR")"
+NATIVE_INTEROP_DIR="$(dirname "$CINTEROP_DIR")"
 
 # Configuration
 HEADERS_DIR="$CINTEROP_DIR/headers"
@@ -23,7 +26,50 @@ OUTPUT_DIR="$LIB_DIR"
 
 # Build settings
 CXX_FLAGS="-std=c++17 -fobjc-arc -fmodules -DNDEBUG -O2"
-INCLUDE_FLAGS="-I$HEADERS_DIR -I$SCRIPT_DIR"
+OBJC_FLAGS="-fobjc-arc -fmodules -DNDEBUG -O2"
+CORE_FLAGS="-std=c++17 -DNDEBUG -O2"
+INCLUDE_FLAGS="-I$HEADERS_DIR -I$SCRIPT_DIR -I$NATIVE_INTEROP_DIR"
+
+# Bridge sources - every .mm/.m in this directory is part of the library,
+# plus the core's .cpp files
+SOURCES=("$SCRIPT_DIR"/*.mm "$SCRIPT_DIR"/*.m "$NATIVE_INTEROP_DIR"/jbcore/*.cpp)
+
+# Compile all sources for one target and archive them
+# Usage: build_library <suffix> <target> [sysroot]
+build_library() {
+    local suffix="$1"
+    local target="$2"
+    local sysroot_flags=""
+    if [ -n "$3" ]; then
+        sysroot_flags="-isysroot $3"
+    fi
+
+    local objects=()
+    for src in "${SOURCES[@]}"; do
+        local name
+        name="$(basename "${src%.*}")"
+        local obj="$OUTPUT_DIR/${name}_${suffix}.o"
+        local compiler="clang++"
+        local flags="$CXX_FLAGS"
+        if [ "${src##*.}" = "m" ]; then
+            compiler="clang"
+            flags="$OBJC_FLAGS"
+        elif [ "${src##*.}" = "cpp" ]; then
+            flags="$CORE_FLAGS"
+        fi
+        echo "  $(basename "$src")"
+        $compiler -c "$src" \
+            -o "$obj" \
+            $flags \
+            $INCLUDE_FLAGS \
+            -target "$target" \
+            $sysroot_flags
+        objects+=("$obj")
+    done
+
+    echo "Creating libJamiBridge_${suffix}.a..."
+    ar rcs "$OUTPUT_DIR/libJamiBridge_${suffix}.a" "${objects[@]}"
+}
 
 echo "=== Building JamiBridge Static Library ==="
 echo "Headers: $HEADERS_DIR"
@@ -43,6 +89,12 @@ if [ ! -f "$HEADERS_DIR/jami.h" ]; then
     exit 1
 fi
 
+if [ ! -f "$HEADERS_DIR/libavutil/frame.h" ]; then
+    echo "Error: libavutil/frame.h not found in $HEADERS_DIR"
+    echo "Please copy the FFmpeg headers from the jami-daemon contrib build"
+    exit 1
+fi
+
 # Detect architecture
 ARCH=$(uname -m)
 if [ "$ARCH" = "arm64" ]; then
@@ -61,14 +113,7 @@ mkdir -p "$OUTPUT_DIR"
 
 # Build for macOS
 echo "=== Compiling for macOS ($TARGET) ==="
-clang++ -c "$SCRIPT_DIR/JamiBridgeWrapper.mm" \
-    -o "$OUTPUT_DIR/JamiBridgeWrapper_macos.o" \
-    $CXX_FLAGS \
-    $INCLUDE_FLAGS \
-    -target "$TARGET"
-
-echo "Creating libJamiBridge_macos.a..."
-ar rcs "$OUTPUT_DIR/libJamiBridge_macos.a" "$OUTPUT_DIR/JamiBridgeWrapper_macos.o"
+build_library macos "$TARGET"
 
 # Build for iOS (if on arm64 Mac)
 if [ "$ARCH" = "arm64" ]; then
@@ -79,29 +124,13 @@ if [ "$ARCH" = "arm64" ]; then
     echo ""
     echo "=== Compiling for iOS ($IOS_TARGET) ==="
     echo "Using SDK: $IOS_SDK"
-    clang++ -c "$SCRIPT_DIR/JamiBridgeWrapper.mm" \
-        -o "$OUTPUT_DIR/JamiBridgeWrapper_ios.o" \
-        $CXX_FLAGS \
-        $INCLUDE_FLAGS \
-        -target "$IOS_TARGET" \
-        -isysroot "$IOS_SDK"
-
-    echo "Creating libJamiBridge_ios.a..."
-    ar rcs "$OUTPUT_DIR/libJamiBridge_ios.a" "$OUTPUT_DIR/JamiBridgeWrapper_ios.o"
+    build_library ios "$IOS_TARGET" "$IOS_SDK"
 
     # Also create iOS simulator build
     echo ""
     echo "=== Compiling for iOS Simulator ==="
     echo "Using SDK: $IOS_SIM_SDK"
-    clang++ -c "$SCRIPT_DIR/JamiBridgeWrapper.mm" \
-        -o "$OUTPUT_DIR/JamiBridgeWrapper_iossim.o" \
-        $CXX_FLAGS \
-        $INCLUDE_FLAGS \
-        -target "arm64-apple-ios14.0-simulator" \
-        -isysroot "$IOS_SIM_SDK"
-
-    echo "Creating libJamiBridge_iossim.a..."
-    ar rcs "$OUTPUT_DIR/libJamiBridge_iossim.a" "$OUTPUT_DIR/JamiBridgeWrapper_iossim.o"
+    build_library iossim "arm64-apple-ios14.0-simulator" "$IOS_SIM_SDK"
 fi
 
 # Cleanup object files
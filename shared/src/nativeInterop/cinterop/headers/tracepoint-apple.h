@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2004-2026 Savoir-faire Linux Inc.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+ * Apple backend for jami_tracepoint(): the events of tracepoint-def.h become
+ * os_signpost events and intervals in the "net.jami.daemon" / "Tracepoints"
+ * log, visible in Instruments (os_signpost instrument) and in sysdiagnoses.
+ * A disabled log costs one check per tracepoint.
+ *
+ * Call and conference intervals use jami_trace_signpost_id(id), so spans
+ * emitted by the client for the same call id (see JBCallTrace in the iOS
+ * bridge) share their signpost id.
+ */
+
+#include <os/signpost.h>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace jami {
+namespace tracepoint_apple {
+
+inline os_log_t
+log()
+{
+    static os_log_t handle = os_log_create("net.jami.daemon", "Tracepoints");
+    return handle;
+}
+
+inline os_signpost_id_t
+valid_id(uint64_t value)
+{
+    // OS_SIGNPOST_ID_NULL and OS_SIGNPOST_ID_INVALID are reserved
+    if (value == OS_SIGNPOST_ID_NULL || value == OS_SIGNPOST_ID_INVALID || value == OS_SIGNPOST_ID_EXCLUSIVE)
+        return 0x4a414d49; // "JAMI"
+    return value;
+}
+
+// Signal emission nests (emit_signal > callback) on the emitting thread only
+inline os_signpost_id_t
+thread_id()
+{
+    static thread_local char marker;
+    return os_signpost_id_make_with_pointer(log(), &marker);
+}
+
+} // namespace tracepoint_apple
+} // namespace jami
+
+// FNV-1a of a call/conference id
+inline os_signpost_id_t
+jami_trace_signpost_id(const char* id)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char* c = id ? id : ""; *c; ++c) {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 0x100000001b3ull;
+    }
+    return jami::tracepoint_apple::valid_id(hash);
+}
+
+#define JAMI_APPLE_TP_LOG jami::tracepoint_apple::log()
+
+inline void
+jami_apple_tp_scheduled_executor_task_begin(const char* executor_name,
+                                            const char* filename,
+                                            uint32_t linum,
+                                            uint64_t cookie)
+{
+    os_signpost_interval_begin(JAMI_APPLE_TP_LOG,
+                               jami::tracepoint_apple::valid_id(cookie),
+                               "ExecutorTask",
+                               "%{public}s %{public}s:%u",
+                               executor_name,
+                               filename,
+                               linum);
+}
+
+inline void
+jami_apple_tp_scheduled_executor_task_end(uint64_t cookie)
+{
+    os_signpost_interval_end(JAMI_APPLE_TP_LOG, jami::tracepoint_apple::valid_id(cookie), "ExecutorTask");
+}
+
+inline void
+jami_apple_tp_ice_transport_context(uint64_t context)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG,
+                           jami::tracepoint_apple::valid_id(context),
+                           "ICE",
+                           "context %llu",
+                           (unsigned long long) context);
+}
+
+inline void
+jami_apple_tp_ice_transport_send(uint64_t context, unsigned component, size_t len, const char* remote_addr)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG,
+                           jami::tracepoint_apple::valid_id(context),
+                           "ICESend",
+                           "component %u, %zu bytes to %{public}s",
+                           component,
+                           len,
+                           remote_addr);
+}
+
+inline void
+jami_apple_tp_ice_transport_send_status(int status)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG, OS_SIGNPOST_ID_EXCLUSIVE, "ICESendStatus", "status %d", status);
+}
+
+inline void
+jami_apple_tp_ice_transport_recv(uint64_t context, unsigned component, size_t len, const char* remote_addr)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG,
+                           jami::tracepoint_apple::valid_id(context),
+                           "ICERecv",
+                           "component %u, %zu bytes from %{public}s",
+                           component,
+                           len,
+                           remote_addr);
+}
+
+inline void
+jami_apple_tp_emit_signal(const char* signal_type)
+{
+    os_signpost_interval_begin(JAMI_APPLE_TP_LOG,
+                               jami::tracepoint_apple::thread_id(),
+                               "EmitSignal",
+                               "%{public}s",
+                               signal_type);
+}
+
+inline void
+jami_apple_tp_emit_signal_end()
+{
+    os_signpost_interval_end(JAMI_APPLE_TP_LOG, jami::tracepoint_apple::thread_id(), "EmitSignal");
+}
+
+inline void
+jami_apple_tp_emit_signal_begin_callback(const char* filename, uint32_t linum)
+{
+    os_signpost_interval_begin(JAMI_APPLE_TP_LOG,
+                               jami::tracepoint_apple::thread_id(),
+                               "SignalCallback",
+                               "%{public}s:%u",
+                               filename,
+                               linum);
+}
+
+inline void
+jami_apple_tp_emit_signal_end_callback()
+{
+    os_signpost_interval_end(JAMI_APPLE_TP_LOG, jami::tracepoint_apple::thread_id(), "SignalCallback");
+}
+
+inline void
+jami_apple_tp_audio_input_read_from_device_end(const char* id)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG, jami_trace_signpost_id(id), "AudioInputRead");
+}
+
+inline void
+jami_apple_tp_audio_layer_put_recorded_end()
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG, jami::tracepoint_apple::thread_id(), "AudioPutRecorded");
+}
+
+inline void
+jami_apple_tp_audio_layer_get_to_play_end()
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG, jami::tracepoint_apple::thread_id(), "AudioGetToPlay");
+}
+
+inline void
+jami_apple_tp_call_start(const char* id)
+{
+    os_signpost_interval_begin(JAMI_APPLE_TP_LOG, jami_trace_signpost_id(id), "Call", "%{public}s", id);
+}
+
+inline void
+jami_apple_tp_call_end(const char* id)
+{
+    os_signpost_interval_end(JAMI_APPLE_TP_LOG, jami_trace_signpost_id(id), "Call");
+}
+
+inline void
+jami_apple_tp_conference_begin(const char* id)
+{
+    os_signpost_interval_begin(JAMI_APPLE_TP_LOG, jami_trace_signpost_id(id), "Conference", "%{public}s", id);
+}
+
+inline void
+jami_apple_tp_conference_end(const char* id)
+{
+    os_signpost_interval_end(JAMI_APPLE_TP_LOG, jami_trace_signpost_id(id), "Conference");
+}
+
+inline void
+jami_apple_tp_conference_add_participant(const char* conference_id, const char* participant_id)
+{
+    os_signpost_event_emit(JAMI_APPLE_TP_LOG,
+                           jami_trace_signpost_id(conference_id),
+                           "ConferenceParticipant",
+                           "%{public}s",
+                           participant_id);
+}
+
+#undef JAMI_APPLE_TP_LOG
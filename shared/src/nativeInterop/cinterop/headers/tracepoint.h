@@ -43,6 +43,13 @@
         } \
     } while (0)
 
+#elif defined(__APPLE__) && !defined(JAMI_DISABLE_APPLE_TRACEPOINTS)
+
+#include "tracepoint-apple.h"
+
+#define jami_tracepoint(tp_name, ...)            jami_apple_tp_##tp_name(__VA_ARGS__)
+#define jami_tracepoint_if_enabled(tp_name, ...) jami_apple_tp_##tp_name(__VA_ARGS__)
+
 #else
 
 #define jami_tracepoint(...)            static_assert(true)
@@ -0,0 +1,112 @@
+//
+//  Coalescer.h
+//  GetTogether
+//
+//  Latest-state-per-key batching for high-frequency daemon signals.
+//  Events are stored as plain C++ values on the daemon thread; within one
+//  window only the newest value per key is kept, and the whole batch is
+//  flushed once through the front-end's scheduler.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jbcore {
+
+// Batching window: one frame at 60 Hz
+constexpr int64_t kCoalesceWindowNs = 16 * kNanosPerMilli;
+
+template <typename Key, typename Value>
+class Coalescer : public std::enable_shared_from_this<Coalescer<Key, Value>>
+{
+public:
+    // Called on the scheduler's executor with the events in first-arrival order
+    using Flush = std::function<void(std::vector<Value>&&)>;
+
+    static std::shared_ptr<Coalescer> create(Scheduler scheduler, Flush flush) {
+        return std::shared_ptr<Coalescer>(new Coalescer(std::move(scheduler), std::move(flush)));
+    }
+
+    void post(Key key, Value value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            values_[it->second] = std::move(value);
+        } else {
+            index_.emplace(std::move(key), values_.size());
+            values_.push_back(std::move(value));
+        }
+        if (scheduled_) return;
+        scheduled_ = true;
+        auto self = this->shared_from_this();
+        scheduler_(kCoalesceWindowNs, [self] { self->drain(); });
+    }
+
+private:
+    Coalescer(Scheduler scheduler, Flush flush)
+        : scheduler_(std::move(scheduler)), flush_(std::move(flush)) {}
+
+    void drain() {
+        std::vector<Value> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(values_);
+            index_.clear();
+            scheduled_ = false;
+        }
+        if (!batch.empty()) flush_(std::move(batch));
+    }
+
+    const Scheduler scheduler_;
+    const Flush flush_;
+    std::mutex mutex_;
+    std::map<Key, size_t> index_;
+    std::vector<Value> values_;
+    bool scheduled_ {false};
+};
+
+// Account of a coalesced event, empty for events without one (conference infos)
+template <typename Value, typename = void>
+struct EventAccount
+{
+    static std::string of(const Value&) { return std::string(); }
+};
+
+template <typename Value>
+struct EventAccount<Value, std::void_t<decltype(std::declval<const Value&>().accountId)>>
+{
+    static std::string of(const Value& value) { return value.accountId; }
+};
+
+// Splits a flushed batch per account, so each part can be delivered in its
+// account's lane. Accounts and their events keep first-arrival order.
+template <typename Value>
+std::vector<std::pair<std::string, std::vector<Value>>> splitByAccount(std::vector<Value>&& events) {
+    // A handful of accounts: a linear search is cheaper than a map
+    std::vector<std::pair<std::string, std::vector<Value>>> result;
+    for (auto& event : events) {
+        std::string account = EventAccount<Value>::of(event);
+        auto it = std::find_if(result.begin(), result.end(),
+                               [&](const auto& entry) { return entry.first == account; });
+        if (it == result.end()) {
+            result.emplace_back(std::move(account), std::vector<Value>());
+            it = result.end() - 1;
+        }
+        it->second.push_back(std::move(event));
+    }
+    return result;
+}
+
+} // namespace jbcore
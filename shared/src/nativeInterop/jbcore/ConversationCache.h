@@ -0,0 +1,169 @@
+//
+//  ConversationCache.h
+//  GetTogether
+//
+//  Conversation info, members and preferences per (account, conversation),
+//  loaded on first access and kept until a conversation signal or a local
+//  change invalidates them. Each front-end picks the value type it hands out
+//  without converting again: immutable Foundation objects for the
+//  Objective-C bridge, encoded buffers for the JNI library.
+//
+//  Loads run outside the lock, so an invalidation can land while a value is
+//  being loaded. Every invalidation stamps the entry with a new epoch; a load
+//  only stores its value if the entry still has the epoch it started with.
+//  Entries are small and bounded by the number of conversations, so there
+//  is no eviction besides clear.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace jbcore {
+
+enum ConversationField : uint32_t {
+    ConversationFieldInfo        = 1 << 0,
+    ConversationFieldMembers     = 1 << 1,
+    ConversationFieldPreferences = 1 << 2,
+    ConversationFieldAll         = ConversationFieldInfo | ConversationFieldMembers | ConversationFieldPreferences,
+};
+
+// `Value` must be default-constructible as "absent" and testable as a bool
+// (an ObjC object pointer, a shared_ptr)
+template <typename Value>
+class ConversationCache
+{
+public:
+    using Loader = std::function<Value()>;
+
+    // Cached value, or the loader's result (called without the lock held).
+    // A value loaded while the entry was invalidated is returned but not kept.
+    Value get(const std::string& accountId, const std::string& conversationId,
+              ConversationField field, const Loader& loader) {
+        std::string key = cacheKey(accountId, conversationId);
+        uint64_t epoch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto [it, inserted] = entries_.try_emplace(key);
+            if (inserted) it->second.epoch = epoch_;
+            if (Value cached = it->second.slot(field)) return cached;
+            epoch = it->second.epoch;
+        }
+
+        Value loaded = loader();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.epoch == epoch) {
+            it->second.slot(field) = loaded;
+        }
+        return loaded;
+    }
+
+    // Seeds fresh values (snapshot, ConversationPreferencesUpdated payload);
+    // absent values leave their field as it is
+    void store(const std::string& accountId, const std::string& conversationId,
+               Value info, Value members, Value preferences) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = entries_[cacheKey(accountId, conversationId)];
+        // Loads started before this store must not overwrite it
+        entry.epoch = ++epoch_;
+        if (info) entry.values[0] = std::move(info);
+        if (members) entry.values[1] = std::move(members);
+        if (preferences) entry.values[2] = std::move(preferences);
+    }
+
+    // Epoch to pass to storeIfEpoch, taken before reading the daemon
+    uint64_t epoch(const std::string& accountId, const std::string& conversationId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = entries_.try_emplace(cacheKey(accountId, conversationId));
+        if (inserted) it->second.epoch = epoch_;
+        return it->second.epoch;
+    }
+
+    // store() for values read outside the cache: dropped when the entry was
+    // invalidated or stored since `expectedEpoch`. False when dropped.
+    bool storeIfEpoch(uint64_t expectedEpoch, const std::string& accountId, const std::string& conversationId,
+                      Value info, Value members, Value preferences) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(cacheKey(accountId, conversationId));
+        if (it == entries_.end() || it->second.epoch != expectedEpoch) return false;
+        auto& entry = it->second;
+        entry.epoch = ++epoch_;
+        if (info) entry.values[0] = std::move(info);
+        if (members) entry.values[1] = std::move(members);
+        if (preferences) entry.values[2] = std::move(preferences);
+        return true;
+    }
+
+    void invalidate(uint32_t fields, const std::string& accountId, const std::string& conversationId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(cacheKey(accountId, conversationId));
+        if (it == entries_.end()) return;
+        it->second.epoch = ++epoch_;
+        for (uint32_t field : {ConversationFieldInfo, ConversationFieldMembers, ConversationFieldPreferences}) {
+            if (fields & field) it->second.slot((ConversationField)field) = Value();
+        }
+    }
+
+    void removeConversation(const std::string& accountId, const std::string& conversationId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(cacheKey(accountId, conversationId));
+        // A load in flight for it must not store into a recreated entry
+        ++epoch_;
+    }
+
+    void removeAccount(const std::string& accountId) {
+        std::string prefix = accountId + "\n";
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0) {
+                it = entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        ++epoch_;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        ++epoch_;
+    }
+
+private:
+    struct Entry {
+        std::array<Value, 3> values;  // info, members, preferences
+        uint64_t epoch = 0;
+
+        Value& slot(ConversationField field) {
+            switch (field) {
+                case ConversationFieldMembers: return values[1];
+                case ConversationFieldPreferences: return values[2];
+                default: return values[0];
+            }
+        }
+    };
+
+    static std::string cacheKey(const std::string& accountId, const std::string& conversationId) {
+        std::string key;
+        key.reserve(accountId.size() + conversationId.size() + 1);
+        key.append(accountId).push_back('\n');
+        key.append(conversationId);
+        return key;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t epoch_ {0};
+};
+
+} // namespace jbcore
@@ -0,0 +1,50 @@
+//
+//  CoreEvents.h
+//  GetTogether
+//
+//  Payloads of the coalesced signals, kept as daemon types until a batch is
+//  converted by a front-end.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "conversation_interface.h"
+
+namespace jbcore {
+
+using StringPair = std::pair<std::string, std::string>;
+using StringTuple3 = std::tuple<std::string, std::string, std::string>;
+
+struct ComposingEvent {
+    std::string accountId;
+    std::string conversationId;
+    std::string from;
+    int status;
+};
+
+struct PresenceEvent {
+    std::string accountId;
+    std::string uri;
+    int status;
+    std::string lineStatus;
+};
+
+struct ConferenceInfoEvent {
+    std::string conferenceId;
+    std::vector<std::map<std::string, std::string>> participantInfos;
+};
+
+struct MessageUpdateEvent {
+    std::string accountId;
+    std::string conversationId;
+    libjami::SwarmMessage message;
+};
+
+} // namespace jbcore
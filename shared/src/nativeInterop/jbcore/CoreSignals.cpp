@@ -0,0 +1,221 @@
+//
+//  CoreSignals.cpp
+//  GetTogether
+//
+//  Each handler encodes its arguments on the daemon thread and pushes one
+//  record; nothing waits for the consumer. Composing status and message
+//  updates go through a Coalescer first and are pushed as one record per
+//  window, newest state per key.
+//
+
+#include "CoreSignals.h"
+
+#include "Coalescer.h"
+#include "CoreEvents.h"
+
+#include "configurationmanager_interface.h"
+#include "conversation_interface.h"
+
+namespace jbcore {
+
+namespace {
+
+using libjami::exportable_callback;
+using libjami::SwarmMessage;
+
+using ConfigurationSignal = libjami::ConfigurationSignal;
+using ConversationSignal = libjami::ConversationSignal;
+
+} // namespace
+
+void addCoreSignalHandlers(SignalHandlerMap& handlers, const CoreSignalContext& context) {
+    std::shared_ptr<EventQueue> events = context.events;
+    std::shared_ptr<EncodedConversationCache> conversations = context.conversations;
+    std::shared_ptr<ReceiptScheduler> receipts = context.receipts;
+
+    auto composing = Coalescer<StringTuple3, ComposingEvent>::create(context.scheduler,
+        [events](std::vector<ComposingEvent>&& batch) {
+            EventWriter writer(EventType::ComposingStatusChanged);
+            writer.count(batch.size());
+            for (const auto& event : batch) {
+                writer.string(event.accountId).string(event.conversationId).string(event.from).int32(event.status);
+            }
+            events->push(writer.finish());
+        });
+
+    auto messageUpdates = Coalescer<StringTuple3, MessageUpdateEvent>::create(context.scheduler,
+        [events](std::vector<MessageUpdateEvent>&& batch) {
+            EventWriter writer(EventType::SwarmMessagesUpdated);
+            writer.count(batch.size());
+            for (const auto& event : batch) {
+                writer.string(event.accountId).string(event.conversationId).message(event.message);
+            }
+            events->push(writer.finish());
+        });
+
+    // =========================================================================
+    // Configuration/Account Signals
+    // =========================================================================
+
+    handlers.insert(exportable_callback<ConfigurationSignal::AccountsChanged>([events]() {
+        events->push(EventWriter(EventType::AccountsChanged).finish());
+    }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::AccountDetailsChanged>(
+        [events](const std::string& accountId, const std::map<std::string, std::string>& details) {
+            events->push(EventWriter(EventType::AccountDetailsChanged).string(accountId).map(details).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::RegistrationStateChanged>(
+        [events](const std::string& accountId, const std::string& state, int code, const std::string& detail) {
+            events->push(EventWriter(EventType::RegistrationStateChanged)
+                             .string(accountId).string(state).int32(code).string(detail).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::VolatileDetailsChanged>(
+        [events](const std::string& accountId, const std::map<std::string, std::string>& details) {
+            events->push(EventWriter(EventType::VolatileDetailsChanged).string(accountId).map(details).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::AccountMessageStatusChanged>(
+        [events](const std::string& accountId, const std::string& conversationId,
+                 const std::string& peer, const std::string& messageId, int state) {
+            events->push(EventWriter(EventType::AccountMessageStatusChanged)
+                             .string(accountId).string(conversationId).string(peer).string(messageId).int32(state)
+                             .finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::ContactAdded>(
+        [events](const std::string& accountId, const std::string& uri, bool confirmed) {
+            events->push(EventWriter(EventType::ContactAdded).string(accountId).string(uri).boolean(confirmed).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::ContactRemoved>(
+        [events](const std::string& accountId, const std::string& uri, bool banned) {
+            events->push(EventWriter(EventType::ContactRemoved).string(accountId).string(uri).boolean(banned).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::RegisteredNameFound>(
+        [events](const std::string& accountId, const std::string& requestName,
+                 int state, const std::string& address, const std::string& name) {
+            events->push(EventWriter(EventType::RegisteredNameFound)
+                             .string(accountId).string(requestName).int32(state).string(address).string(name)
+                             .finish());
+        }));
+
+    handlers.insert(exportable_callback<ConfigurationSignal::ProfileReceived>(
+        [events](const std::string& accountId, const std::string& from, const std::string& vcard) {
+            events->push(EventWriter(EventType::ProfileReceived).string(accountId).string(from).string(vcard).finish());
+        }));
+
+    // Composing status changed (coalesced per account/conversation/peer)
+    handlers.insert(exportable_callback<ConfigurationSignal::ComposingStatusChanged>(
+        [composing](const std::string& accountId, const std::string& convId, const std::string& from, int status) {
+            composing->post({accountId, convId, from}, {accountId, convId, from, status});
+        }));
+
+    // =========================================================================
+    // Conversation Signals
+    // =========================================================================
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationReady>(
+        [events, conversations](const std::string& accountId, const std::string& conversationId) {
+            // Cloned or re-synced: anything cached may predate the repository
+            conversations->invalidate(ConversationFieldAll, accountId, conversationId);
+            events->push(EventWriter(EventType::ConversationReady).string(accountId).string(conversationId).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationRemoved>(
+        [events, conversations](const std::string& accountId, const std::string& conversationId) {
+            conversations->removeConversation(accountId, conversationId);
+            events->push(EventWriter(EventType::ConversationRemoved).string(accountId).string(conversationId).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationRequestReceived>(
+        [events](const std::string& accountId, const std::string& conversationId,
+                 std::map<std::string, std::string> metadata) {
+            events->push(EventWriter(EventType::ConversationRequestReceived)
+                             .string(accountId).string(conversationId).map(metadata).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationRequestDeclined>(
+        [events](const std::string& accountId, const std::string& conversationId) {
+            events->push(EventWriter(EventType::ConversationRequestDeclined)
+                             .string(accountId).string(conversationId).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationMemberEvent>(
+        [events, conversations](const std::string& accountId, const std::string& conversationId,
+                                const std::string& memberUri, int event) {
+            conversations->invalidate(ConversationFieldMembers, accountId, conversationId);
+            events->push(EventWriter(EventType::ConversationMemberEvent)
+                             .string(accountId).string(conversationId).string(memberUri).int32(event).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ConversationProfileUpdated>(
+        [events, conversations](const std::string& accountId, const std::string& conversationId,
+                                std::map<std::string, std::string> profile) {
+            // The profile is only part of conversationInfos: reload it on next access
+            conversations->invalidate(ConversationFieldInfo, accountId, conversationId);
+            events->push(EventWriter(EventType::ConversationProfileUpdated)
+                             .string(accountId).string(conversationId).map(profile).finish());
+        }));
+
+    // Carries the full preference map: it replaces the cached one
+    handlers.insert(exportable_callback<ConversationSignal::ConversationPreferencesUpdated>(
+        [events, conversations](const std::string& accountId, const std::string& conversationId,
+                                std::map<std::string, std::string> preferences) {
+            conversations->store(accountId, conversationId, nullptr, nullptr,
+                                 std::make_shared<const std::vector<uint8_t>>(encodeMap(preferences)));
+            events->push(EventWriter(EventType::ConversationPreferencesUpdated)
+                             .string(accountId).string(conversationId).map(preferences).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::SwarmMessageReceived>(
+        [events, receipts](const std::string& accountId, const std::string& conversationId,
+                           const SwarmMessage& message) {
+            receipts->noteMessage(message);
+            events->push(EventWriter(EventType::SwarmMessageReceived)
+                             .string(accountId).string(conversationId).message(message).finish());
+        }));
+
+    // Swarm message updated (coalesced per message)
+    handlers.insert(exportable_callback<ConversationSignal::SwarmMessageUpdated>(
+        [messageUpdates](const std::string& accountId, const std::string& conversationId,
+                         const SwarmMessage& message) {
+            messageUpdates->post({accountId, conversationId, message.id}, {accountId, conversationId, message});
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::SwarmLoaded>(
+        [events, receipts](uint32_t requestId, const std::string& accountId,
+                           const std::string& conversationId, std::vector<SwarmMessage> messages) {
+            receipts->noteMessages(messages);
+            events->push(EventWriter(EventType::SwarmLoaded)
+                             .int32((int32_t)requestId).string(accountId).string(conversationId).messages(messages)
+                             .finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::MessagesFound>(
+        [events](uint32_t requestId, const std::string& accountId, const std::string& conversationId,
+                 std::vector<std::map<std::string, std::string>> messages) {
+            events->push(EventWriter(EventType::MessagesFound)
+                             .int32((int32_t)requestId).string(accountId).string(conversationId).mapList(messages)
+                             .finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ReactionAdded>(
+        [events](const std::string& accountId, const std::string& conversationId,
+                 const std::string& messageId, std::map<std::string, std::string> reaction) {
+            events->push(EventWriter(EventType::ReactionAdded)
+                             .string(accountId).string(conversationId).string(messageId).map(reaction).finish());
+        }));
+
+    handlers.insert(exportable_callback<ConversationSignal::ReactionRemoved>(
+        [events](const std::string& accountId, const std::string& conversationId,
+                 const std::string& messageId, const std::string& reactionId) {
+            events->push(EventWriter(EventType::ReactionRemoved)
+                             .string(accountId).string(conversationId).string(messageId).string(reactionId).finish());
+        }));
+}
+
+} // namespace jbcore
@@ -0,0 +1,46 @@
+//
+//  CoreSignals.h
+//  GetTogether
+//
+//  Account, conversation, contact and name signal handlers for front-ends
+//  that consume encoded events (EventBuffer.h) instead of objects. They keep
+//  the conversation cache and the read receipts in step with the daemon the
+//  same way the Objective-C handlers do. Calls, video and transfers are not
+//  covered.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include "ConversationCache.h"
+#include "EventBuffer.h"
+#include "ReceiptScheduler.h"
+#include "Scheduler.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "jami.h"
+
+namespace jbcore {
+
+// Getter results, encoded once and shared by every reader of the cache
+using EncodedValue = std::shared_ptr<const std::vector<uint8_t>>;
+using EncodedConversationCache = ConversationCache<EncodedValue>;
+
+struct CoreSignalContext {
+    std::shared_ptr<EventQueue> events;
+    std::shared_ptr<EncodedConversationCache> conversations;
+    std::shared_ptr<ReceiptScheduler> receipts;
+    Scheduler scheduler;  // coalescing windows
+};
+
+using SignalHandlerMap = std::map<std::string, std::shared_ptr<libjami::CallbackWrapperBase>>;
+
+// Adds the handlers to `handlers`, for libjami::registerSignalHandlers
+void addCoreSignalHandlers(SignalHandlerMap& handlers, const CoreSignalContext& context);
+
+} // namespace jbcore
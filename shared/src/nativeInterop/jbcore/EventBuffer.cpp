@@ -0,0 +1,242 @@
+//
+//  EventBuffer.cpp
+//  GetTogether
+//
+//  Records are appended to one contiguous buffer, so a drain is a single
+//  memcpy of the records that fit; the consumed prefix is compacted away
+//  once it is the larger part of the buffer.
+//
+
+#include "EventBuffer.h"
+
+#include <cstring>
+
+namespace jbcore {
+
+namespace {
+
+constexpr size_t kRecordHeaderSize = sizeof(uint16_t) + sizeof(uint32_t);
+
+// Apple and Android/desktop targets are little-endian
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "wire format is little-endian");
+
+class Reader
+{
+public:
+    Reader(const uint8_t* data, size_t size) : data_(data), end_(data + size) {}
+
+    bool u32(uint32_t& value) {
+        if ((size_t)(end_ - data_) < sizeof(value)) return false;
+        std::memcpy(&value, data_, sizeof(value));
+        data_ += sizeof(value);
+        return true;
+    }
+
+    bool string(std::string& value) {
+        uint32_t size;
+        if (!u32(size) || (size_t)(end_ - data_) < size) return false;
+        value.assign(reinterpret_cast<const char*>(data_), size);
+        data_ += size;
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    const uint8_t* end_;
+};
+
+} // namespace
+
+EventWriter::EventWriter(EventType type) {
+    bytes_.reserve(64);
+    auto value = static_cast<uint16_t>(type);
+    put(&value, sizeof(value));
+    uint32_t size = 0;
+    put(&size, sizeof(size));
+}
+
+void EventWriter::put(const void* data, size_t size) {
+    auto* bytes = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), bytes, bytes + size);
+}
+
+EventWriter& EventWriter::string(const std::string& value) {
+    count(value.size());
+    put(value.data(), value.size());
+    return *this;
+}
+
+EventWriter& EventWriter::int32(int32_t value) {
+    put(&value, sizeof(value));
+    return *this;
+}
+
+EventWriter& EventWriter::int64(int64_t value) {
+    put(&value, sizeof(value));
+    return *this;
+}
+
+EventWriter& EventWriter::boolean(bool value) {
+    uint8_t byte = value ? 1 : 0;
+    put(&byte, sizeof(byte));
+    return *this;
+}
+
+EventWriter& EventWriter::count(size_t value) {
+    auto count = static_cast<uint32_t>(value);
+    put(&count, sizeof(count));
+    return *this;
+}
+
+EventWriter& EventWriter::map(const StringMap& value) {
+    count(value.size());
+    for (const auto& [key, entry] : value) string(key).string(entry);
+    return *this;
+}
+
+EventWriter& EventWriter::mapList(const std::vector<StringMap>& value) {
+    count(value.size());
+    for (const auto& entry : value) map(entry);
+    return *this;
+}
+
+EventWriter& EventWriter::message(const libjami::SwarmMessage& value) {
+    string(value.id).string(value.type).string(value.linearizedParent).map(value.body);
+    mapList(value.reactions).mapList(value.editions);
+    count(value.status.size());
+    for (const auto& [uri, status] : value.status) string(uri).int32(status);
+    return *this;
+}
+
+EventWriter& EventWriter::messages(const std::vector<libjami::SwarmMessage>& value) {
+    count(value.size());
+    for (const auto& entry : value) message(entry);
+    return *this;
+}
+
+std::vector<uint8_t> EventWriter::finish() {
+    auto size = static_cast<uint32_t>(bytes_.size() - kRecordHeaderSize);
+    std::memcpy(bytes_.data() + sizeof(uint16_t), &size, sizeof(size));
+    return std::move(bytes_);
+}
+
+// Values are encoded as the payload of a record, without its header
+static std::vector<uint8_t> payload(std::vector<uint8_t>&& record) {
+    record.erase(record.begin(), record.begin() + kRecordHeaderSize);
+    return std::move(record);
+}
+
+std::vector<uint8_t> encodeStringList(const std::vector<std::string>& values) {
+    EventWriter writer(EventType::AccountsChanged);
+    writer.count(values.size());
+    for (const auto& value : values) writer.string(value);
+    return payload(writer.finish());
+}
+
+std::vector<uint8_t> encodeMap(const StringMap& value) {
+    EventWriter writer(EventType::AccountsChanged);
+    writer.map(value);
+    return payload(writer.finish());
+}
+
+std::vector<uint8_t> encodeMapList(const std::vector<StringMap>& value) {
+    EventWriter writer(EventType::AccountsChanged);
+    writer.mapList(value);
+    return payload(writer.finish());
+}
+
+bool decodeMap(const uint8_t* data, size_t size, StringMap& out) {
+    Reader reader(data, size);
+    uint32_t count;
+    if (!reader.u32(count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        std::string key, value;
+        if (!reader.string(key) || !reader.string(value)) return false;
+        out.emplace(std::move(key), std::move(value));
+    }
+    return true;
+}
+
+bool decodeStringList(const uint8_t* data, size_t size, std::vector<std::string>& out) {
+    Reader reader(data, size);
+    uint32_t count;
+    if (!reader.u32(count)) return false;
+    out.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        std::string value;
+        if (!reader.string(value)) return false;
+        out.push_back(std::move(value));
+    }
+    return true;
+}
+
+EventQueue::EventQueue(size_t maxPendingBytes)
+    : maxPendingBytes_(maxPendingBytes)
+{}
+
+void EventQueue::push(std::vector<uint8_t>&& record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bytes_.insert(bytes_.end(), record.begin(), record.end());
+        sizes_.push_back(static_cast<uint32_t>(record.size()));
+        // Oldest first; the record just pushed is always kept
+        while (sizes_.size() > 1 && bytes_.size() - offset_ > maxPendingBytes_) {
+            offset_ += sizes_.front();
+            sizes_.pop_front();
+            dropped_++;
+        }
+        if (offset_ > bytes_.size() / 2) {
+            bytes_.erase(bytes_.begin(), bytes_.begin() + offset_);
+            offset_ = 0;
+        }
+    }
+    available_.notify_one();
+}
+
+int64_t EventQueue::drain(uint8_t* buffer, size_t capacity, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait_for(lock, timeout, [this] { return closed_ || !sizes_.empty(); });
+    if (closed_ || sizes_.empty()) return 0;
+    if (sizes_.front() > capacity) return -static_cast<int64_t>(sizes_.front());
+
+    size_t total = 0;
+    while (!sizes_.empty() && total + sizes_.front() <= capacity) {
+        total += sizes_.front();
+        sizes_.pop_front();
+    }
+    std::memcpy(buffer, bytes_.data() + offset_, total);
+    offset_ += total;
+    if (sizes_.empty()) {
+        bytes_.clear();
+        offset_ = 0;
+    } else if (offset_ > bytes_.size() / 2) {
+        bytes_.erase(bytes_.begin(), bytes_.begin() + offset_);
+        offset_ = 0;
+    }
+    return static_cast<int64_t>(total);
+}
+
+void EventQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    available_.notify_all();
+}
+
+void EventQueue::reopen() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = false;
+}
+
+size_t EventQueue::pendingBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_.size() - offset_;
+}
+
+uint64_t EventQueue::droppedRecords() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+} // namespace jbcore
@@ -0,0 +1,132 @@
+//
+//  EventBuffer.h
+//  GetTogether
+//
+//  Daemon signals as binary records, queued until a front-end drains them in
+//  batches (the JNI library copies them into a direct ByteBuffer). Encoding,
+//  little-endian:
+//
+//      record  = u16 type, u32 payload size, payload
+//      string  = u32 byte count, UTF-8 bytes
+//      map     = u32 count, count x (string key, string value)
+//      list    = u32 count, count x element
+//      message = string id, string type, string linearizedParent, map body,
+//                list<map> reactions, list<map> editions, u32 count x (string, i32) status
+//
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "conversation_interface.h"
+
+namespace jbcore {
+
+// Stable wire values: the desktop decoder (NativeEvents.kt) mirrors them
+enum class EventType : uint16_t {
+    AccountsChanged = 1,
+    AccountDetailsChanged = 2,
+    RegistrationStateChanged = 3,
+    VolatileDetailsChanged = 4,
+    ConversationReady = 5,
+    ConversationRemoved = 6,
+    ConversationRequestReceived = 7,
+    ConversationRequestDeclined = 8,
+    ConversationMemberEvent = 9,
+    ConversationProfileUpdated = 10,
+    ConversationPreferencesUpdated = 11,
+    SwarmMessageReceived = 12,
+    SwarmMessagesUpdated = 13,     // coalesced: list of (account, conversation, message)
+    SwarmLoaded = 14,
+    ComposingStatusChanged = 15,   // coalesced: list of (account, conversation, from, status)
+    ReactionAdded = 16,
+    ReactionRemoved = 17,
+    AccountMessageStatusChanged = 18,
+    ContactAdded = 19,
+    ContactRemoved = 20,
+    ProfileReceived = 21,
+    RegisteredNameFound = 22,
+    MessagesFound = 23,
+};
+
+using StringMap = std::map<std::string, std::string>;
+
+// Appends the fields of one record
+class EventWriter
+{
+public:
+    explicit EventWriter(EventType type);
+
+    EventWriter& string(const std::string& value);
+    EventWriter& int32(int32_t value);
+    EventWriter& int64(int64_t value);
+    EventWriter& boolean(bool value);
+    EventWriter& map(const StringMap& value);
+    EventWriter& mapList(const std::vector<StringMap>& value);
+    EventWriter& count(size_t value);
+    EventWriter& message(const libjami::SwarmMessage& value);
+    EventWriter& messages(const std::vector<libjami::SwarmMessage>& value);
+
+    // Moves out the finished record (payload size filled in); the writer is spent
+    std::vector<uint8_t> finish();
+
+private:
+    void put(const void* data, size_t size);
+    std::vector<uint8_t> bytes_;
+};
+
+// Values outside events (getters of the JNI library) use the same encoding
+std::vector<uint8_t> encodeStringList(const std::vector<std::string>& values);
+std::vector<uint8_t> encodeMap(const StringMap& value);
+std::vector<uint8_t> encodeMapList(const std::vector<StringMap>& value);
+// False on truncated input
+bool decodeMap(const uint8_t* data, size_t size, StringMap& out);
+bool decodeStringList(const uint8_t* data, size_t size, std::vector<std::string>& out);
+
+// Records pending when nobody drains: about a minute of a busy daemon
+constexpr size_t kMaxPendingEventBytes = 8 * 1024 * 1024;
+
+class EventQueue
+{
+public:
+    // Past `maxPendingBytes` the oldest records are dropped (and counted):
+    // the daemon must not grow memory while no front-end drains
+    explicit EventQueue(size_t maxPendingBytes = kMaxPendingEventBytes);
+
+    void push(std::vector<uint8_t>&& record);
+
+    // Copies as many whole records as fit into `buffer` and returns their size,
+    // waiting up to `timeout` for the first one. 0 on timeout or once closed;
+    // minus the record size when the first record does not fit `capacity`.
+    int64_t drain(uint8_t* buffer, size_t capacity, std::chrono::milliseconds timeout);
+
+    // Wakes the drainer; later drains return 0 until reopen
+    void close();
+    void reopen();
+
+    size_t pendingBytes();
+    // Records dropped since the queue was created
+    uint64_t droppedRecords();
+
+private:
+    const size_t maxPendingBytes_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<uint8_t> bytes_;      // records from offset_ on
+    size_t offset_ {0};
+    std::deque<uint32_t> sizes_;      // record sizes, in order
+    bool closed_ {false};
+    uint64_t dropped_ {0};
+};
+
+} // namespace jbcore
@@ -0,0 +1,121 @@
+//
+//  FairQueue.cpp
+//  GetTogether
+//
+//  ready_ holds each lane with lane tasks once, front = the lane being
+//  served. A lane keeps the front until it has run `weight` tasks or runs
+//  dry, then goes to the back (or leaves). Priority tasks do not touch the
+//  round: they only count in their lane's stats.
+//
+
+#include "FairQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace jbcore {
+
+namespace {
+
+int64_t nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void FairQueue::push(const std::string& lane, Task task, bool priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lane& state = lanes_[lane];
+    state.removed = false;
+    state.stats.pending++;
+    state.stats.peakPending = std::max(state.stats.peakPending, state.stats.pending);
+    Item item {lane, std::move(task), nowNs()};
+    if (priority) {
+        priority_.push_back(std::move(item));
+        return;
+    }
+    if (state.items.empty()) ready_.push_back(lane);
+    state.items.push_back(std::move(item));
+}
+
+bool FairQueue::takeNext(Item& item, bool& priority) {
+    priority = !priority_.empty();
+    if (priority) {
+        item = std::move(priority_.front());
+        priority_.pop_front();
+        return true;
+    }
+    if (ready_.empty()) return false;
+    const std::string name = ready_.front();
+    Lane& lane = lanes_[name];
+    item = std::move(lane.items.front());
+    lane.items.pop_front();
+    lane.credit++;
+    if (lane.items.empty() || lane.credit >= lane.stats.weight) {
+        ready_.pop_front();
+        lane.credit = 0;
+        if (!lane.items.empty()) ready_.push_back(name);
+    }
+    return true;
+}
+
+bool FairQueue::runNext() {
+    Item item;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool priority = false;
+        if (!takeNext(item, priority)) return false;
+        auto it = lanes_.find(item.lane);
+        if (it != lanes_.end()) {
+            LaneStats& stats = it->second.stats;
+            stats.pending--;
+            stats.delivered++;
+            if (priority) stats.priorityDelivered++;
+            stats.maxWaitNs = std::max(stats.maxWaitNs, nowNs() - item.queuedNs);
+            if (it->second.removed && stats.pending == 0) lanes_.erase(it);
+        }
+    }
+    if (item.task) item.task();
+    return true;
+}
+
+void FairQueue::setWeight(const std::string& lane, uint32_t weight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lanes_[lane].stats.weight = std::max<uint32_t>(weight, 1);
+}
+
+void FairQueue::removeLane(const std::string& lane) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = lanes_.find(lane);
+    if (it == lanes_.end()) return;
+    // Tasks already queued still run; the entry goes with the last one
+    if (it->second.stats.pending == 0) {
+        lanes_.erase(it);
+    } else {
+        it->second.removed = true;
+        it->second.stats.weight = 1;
+    }
+}
+
+std::map<std::string, FairQueue::LaneStats> FairQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, LaneStats> result;
+    for (const auto& [name, lane] : lanes_) {
+        if (!lane.removed) result.emplace(name, lane.stats);
+    }
+    return result;
+}
+
+void FairQueue::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, lane] : lanes_) {
+        LaneStats& stats = lane.stats;
+        stats.peakPending = stats.pending;
+        stats.delivered = 0;
+        stats.priorityDelivered = 0;
+        stats.maxWaitNs = 0;
+    }
+}
+
+} // namespace jbcore
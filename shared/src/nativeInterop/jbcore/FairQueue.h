@@ -0,0 +1,81 @@
+//
+//  FairQueue.h
+//  GetTogether
+//
+//  Per-account lanes in front of one serial executor. Each push is paired by
+//  the front-end with one "run next" on the executor; which task that runs is
+//  chosen here: priority tasks first (FIFO), then the account lanes in
+//  weighted round-robin, so a swarm sync on one account only delays the
+//  others by its own share. Tasks of one lane keep their order.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace jbcore {
+
+class FairQueue
+{
+public:
+    using Task = std::function<void()>;
+
+    // Counters of one lane since creation or the last resetStats()
+    struct LaneStats {
+        uint64_t pending = 0;
+        uint64_t peakPending = 0;
+        uint64_t delivered = 0;
+        uint64_t priorityDelivered = 0;
+        int64_t maxWaitNs = 0;  // push until the task starts
+        uint32_t weight = 1;
+    };
+
+    // Any thread. A priority task runs before every lane task not started yet,
+    // but after the priority tasks pushed before it.
+    void push(const std::string& lane, Task task, bool priority = false);
+
+    // On the executor: runs the next task outside the lock. False when empty.
+    bool runNext();
+
+    // Tasks taken from `lane` per round (minimum 1)
+    void setWeight(const std::string& lane, uint32_t weight);
+
+    // Drops the lane's counters and weight. Pending tasks still run.
+    void removeLane(const std::string& lane);
+
+    std::map<std::string, LaneStats> stats() const;
+    // Keeps pending and weight
+    void resetStats();
+
+private:
+    struct Item {
+        std::string lane;
+        Task task;
+        int64_t queuedNs = 0;
+    };
+
+    struct Lane {
+        std::deque<Item> items;
+        uint32_t credit = 0;  // tasks taken in the current round
+        bool removed = false; // erased once its pending tasks have run
+        LaneStats stats;
+    };
+
+    // Under mutex_
+    bool takeNext(Item& item, bool& priority);
+
+    mutable std::mutex mutex_;
+    // All below under mutex_
+    std::deque<Item> priority_;
+    std::map<std::string, Lane> lanes_;
+    std::deque<std::string> ready_;  // lanes with items, round-robin order
+};
+
+} // namespace jbcore
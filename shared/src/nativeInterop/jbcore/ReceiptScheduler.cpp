@@ -0,0 +1,139 @@
+//
+//  ReceiptScheduler.cpp
+//  GetTogether
+//
+//  A receipt replaces the pending one of its conversation unless it is known
+//  to be older: the messages seen in SwarmLoaded and SwarmMessageReceived
+//  give the order, and an unknown message counts as the newest (the caller
+//  just displayed it). The timestamp table is simply dropped when full.
+//
+//  A flush waits for kIdleDelay without receipts, but no more than
+//  kMaxDelay after the first one, so continuous scrolling still syncs.
+//
+
+#include "ReceiptScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+
+namespace jbcore {
+
+namespace {
+
+constexpr int64_t kIdleDelay = 2 * kNanosPerSecond;
+constexpr int64_t kMaxDelay = 10 * kNanosPerSecond;
+constexpr size_t kMaxKnownMessages = 4096;
+
+int64_t steadyNowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t messageTimestamp(const libjami::SwarmMessage& message) {
+    auto it = message.body.find("timestamp");
+    return it != message.body.end() ? std::strtoll(it->second.c_str(), nullptr, 10) : 0;
+}
+
+} // namespace
+
+std::shared_ptr<ReceiptScheduler> ReceiptScheduler::create(Scheduler scheduler, Send send, Clock clock) {
+    if (!clock) clock = steadyNowNs;
+    return std::shared_ptr<ReceiptScheduler>(
+        new ReceiptScheduler(std::move(scheduler), std::move(send), std::move(clock)));
+}
+
+void ReceiptScheduler::noteMessages(const std::vector<libjami::SwarmMessage>& messages) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timestamps_.size() + messages.size() > kMaxKnownMessages) timestamps_.clear();
+    for (const auto& message : messages) {
+        if (int64_t timestamp = messageTimestamp(message)) timestamps_[message.id] = timestamp;
+    }
+}
+
+void ReceiptScheduler::noteMessage(const libjami::SwarmMessage& message) {
+    int64_t timestamp = messageTimestamp(message);
+    if (!timestamp) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timestamps_.size() >= kMaxKnownMessages) timestamps_.clear();
+    timestamps_[message.id] = timestamp;
+}
+
+void ReceiptScheduler::markDisplayed(const std::string& accountId,
+                                     const std::string& conversationId,
+                                     const std::string& messageId) {
+    ConversationKey key {accountId, conversationId};
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto known = timestamps_.find(messageId);
+    Receipt receipt {messageId, known != timestamps_.end() ? known->second : 0};
+    if (isStale(receipt, key)) return;
+    pending_[key] = std::move(receipt);
+    scheduleFlush();
+}
+
+std::string ReceiptScheduler::pendingMessage(const std::string& accountId, const std::string& conversationId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find({accountId, conversationId});
+    return it != pending_.end() ? it->second.messageId : std::string();
+}
+
+void ReceiptScheduler::flush() {
+    std::map<ConversationKey, Receipt> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+        firstPendingNs_ = 0;
+        for (const auto& [key, receipt] : pending) sent_[key] = receipt;
+    }
+    for (const auto& [key, receipt] : pending) {
+        send_(key.first, key.second, receipt.messageId);
+    }
+}
+
+void ReceiptScheduler::removeAccount(const std::string& accountId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto* receipts : {&pending_, &sent_}) {
+        for (auto it = receipts->begin(); it != receipts->end();) {
+            it = it->first.first == accountId ? receipts->erase(it) : std::next(it);
+        }
+    }
+}
+
+void ReceiptScheduler::clearKnownMessages() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, int64_t>().swap(timestamps_);
+}
+
+// Same message, or known to be older than the pending or last sent receipt
+bool ReceiptScheduler::isStale(const Receipt& receipt, const ConversationKey& key) const {
+    for (const auto* receipts : {&pending_, &sent_}) {
+        auto it = receipts->find(key);
+        if (it == receipts->end()) continue;
+        if (it->second.messageId == receipt.messageId) return true;
+        if (receipt.timestamp && it->second.timestamp && receipt.timestamp < it->second.timestamp) return true;
+    }
+    return false;
+}
+
+void ReceiptScheduler::scheduleFlush() {
+    uint64_t generation = ++generation_;
+    int64_t now = clock_();
+    if (!firstPendingNs_) firstPendingNs_ = now;
+    int64_t delay = std::min(kIdleDelay, firstPendingNs_ + kMaxDelay - now);
+    std::weak_ptr<ReceiptScheduler> weakSelf = shared_from_this();
+    scheduler_(std::max<int64_t>(delay, 0), [weakSelf, generation] {
+        auto self = weakSelf.lock();
+        if (!self) return;
+        bool due;
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            // A newer receipt rescheduled the flush, unless the cap is reached
+            due = self->generation_ == generation
+                || (self->firstPendingNs_ && self->firstPendingNs_ + kMaxDelay <= self->clock_());
+        }
+        if (due) self->flush();
+    });
+}
+
+} // namespace jbcore
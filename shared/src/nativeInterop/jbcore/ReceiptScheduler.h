@@ -0,0 +1,90 @@
+//
+//  ReceiptScheduler.h
+//  GetTogether
+//
+//  Coalesced setMessageDisplayed: only the newest message displayed in each
+//  conversation reaches libjami (one swarm commit and peer sync), once the
+//  calls go quiet. Front-ends also flush on their platform's background or
+//  shutdown events.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include "Scheduler.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "conversation_interface.h"
+
+namespace jbcore {
+
+class ReceiptScheduler : public std::enable_shared_from_this<ReceiptScheduler>
+{
+public:
+    // Receives each flushed receipt, on the scheduler's executor or flush()'s caller
+    using Send = std::function<void(const std::string& accountId,
+                                    const std::string& conversationId,
+                                    const std::string& messageId)>;
+
+    // Monotonic nanoseconds, the base of the scheduler's delays
+    using Clock = std::function<int64_t()>;
+
+    // `clock` defaults to std::chrono::steady_clock
+    static std::shared_ptr<ReceiptScheduler> create(Scheduler scheduler, Send send, Clock clock = nullptr);
+
+    // Message signal handlers (daemon thread): timestamps that order the
+    // receipts, so scrolling back through history does not move them back
+    void noteMessages(const std::vector<libjami::SwarmMessage>& messages);
+    void noteMessage(const libjami::SwarmMessage& message);
+
+    // setMessageDisplayed, any thread. Schedules a flush.
+    void markDisplayed(const std::string& accountId, const std::string& conversationId, const std::string& messageId);
+
+    // Receipt not flushed yet, empty if none
+    std::string pendingMessage(const std::string& accountId, const std::string& conversationId);
+
+    // Sends the pending receipts now
+    void flush();
+
+    void removeAccount(const std::string& accountId);
+
+    // Memory pressure: forgets the message timestamps (pending receipts are kept)
+    void clearKnownMessages();
+
+private:
+    using ConversationKey = std::pair<std::string, std::string>; // account, conversation
+
+    struct Receipt {
+        std::string messageId;
+        int64_t timestamp = 0;  // 0 when unknown
+    };
+
+    ReceiptScheduler(Scheduler scheduler, Send send, Clock clock)
+        : scheduler_(std::move(scheduler)), send_(std::move(send)), clock_(std::move(clock)) {}
+
+    // Under mutex_
+    bool isStale(const Receipt& receipt, const ConversationKey& key) const;
+    void scheduleFlush();
+
+    const Scheduler scheduler_;
+    const Send send_;
+    const Clock clock_;
+    std::mutex mutex_;
+    // All below under mutex_
+    std::unordered_map<std::string, int64_t> timestamps_; // messageId -> timestamp
+    std::map<ConversationKey, Receipt> pending_;
+    std::map<ConversationKey, Receipt> sent_;
+    uint64_t generation_ {0};        // bumped by each receipt, cancels older idle flushes
+    int64_t firstPendingNs_ {0};     // 0 when nothing is pending
+};
+
+} // namespace jbcore
@@ -0,0 +1,24 @@
+//
+//  Scheduler.h
+//  GetTogether
+//
+//  How the core runs deferred work without owning a thread: each front-end
+//  passes a Scheduler backed by its own executor (dispatch queues for the
+//  Objective-C bridge, a TimerQueue for the JNI library).
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace jbcore {
+
+constexpr int64_t kNanosPerMilli = 1000 * 1000;
+constexpr int64_t kNanosPerSecond = 1000 * kNanosPerMilli;
+
+// Runs `task` once, `delayNs` nanoseconds from now, on the front-end's executor
+using Scheduler = std::function<void(int64_t delayNs, std::function<void()> task)>;
+
+} // namespace jbcore
@@ -0,0 +1,77 @@
+//
+//  TimerQueue.cpp
+//  GetTogether
+//
+
+#include "TimerQueue.h"
+
+#include <chrono>
+
+namespace jbcore {
+
+namespace {
+
+int64_t nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TimerQueue::TimerQueue() : thread_([this] { loop(); }) {}
+
+TimerQueue::~TimerQueue() {
+    stop();
+}
+
+void TimerQueue::post(int64_t delayNs, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) return;
+        tasks_.push({nowNs() + delayNs, sequence_++, std::move(task)});
+    }
+    changed_.notify_one();
+}
+
+Scheduler TimerQueue::scheduler() {
+    return [this](int64_t delayNs, std::function<void()> task) { post(delayNs, std::move(task)); };
+}
+
+void TimerQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        tasks_ = {};
+    }
+    changed_.notify_one();
+    if (!thread_.joinable()) return;
+    // Stopped from one of its own tasks: the loop exits once the task returns
+    if (thread_.get_id() == std::this_thread::get_id()) {
+        thread_.detach();
+    } else {
+        thread_.join();
+    }
+}
+
+void TimerQueue::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        if (tasks_.empty()) {
+            changed_.wait(lock);
+            continue;
+        }
+        int64_t wait = tasks_.top().deadlineNs - nowNs();
+        if (wait > 0) {
+            changed_.wait_for(lock, std::chrono::nanoseconds(wait));
+            continue;
+        }
+        // priority_queue::top is const: the task is copied out before popping
+        auto run = tasks_.top().run;
+        tasks_.pop();
+        lock.unlock();
+        run();
+        lock.lock();
+    }
+}
+
+} // namespace jbcore
@@ -0,0 +1,62 @@
+//
+//  TimerQueue.h
+//  GetTogether
+//
+//  One thread running delayed tasks in deadline order: the Scheduler of
+//  front-ends without a platform executor (the JNI library).
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include "Scheduler.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace jbcore {
+
+class TimerQueue
+{
+public:
+    TimerQueue();
+    ~TimerQueue();
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    void post(int64_t delayNs, std::function<void()> task);
+
+    // Valid for the lifetime of the queue
+    Scheduler scheduler();
+
+    // Drops the tasks not run yet and joins the thread; posts are ignored afterwards
+    void stop();
+
+private:
+    struct Task {
+        int64_t deadlineNs;
+        uint64_t sequence;            // FIFO among equal deadlines
+        std::function<void()> run;
+
+        bool operator>(const Task& other) const {
+            return deadlineNs != other.deadlineNs ? deadlineNs > other.deadlineNs : sequence > other.sequence;
+        }
+    };
+
+    void loop();
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::priority_queue<Task, std::vector<Task>, std::greater<Task>> tasks_;
+    uint64_t sequence_ {0};
+    bool stopped_ {false};
+    std::thread thread_;
+};
+
+} // namespace jbcore
@@ -0,0 +1,39 @@
+//
+//  UnreadCounter.cpp
+//  GetTogether
+//
+
+#include "UnreadCounter.h"
+
+#include "account_const.h"
+#include "conversation_interface.h"
+
+namespace jbcore {
+
+std::string selfUri(const std::map<std::string, std::string>& accountDetails) {
+    auto it = accountDetails.find(libjami::Account::ConfProperties::USERNAME);
+    if (it == accountDetails.end()) return {};
+    std::string uri = it->second;
+    // Jami accounts report "ring:<hash>", members are listed by hash
+    if (uri.rfind("ring:", 0) == 0) uri.erase(0, 5);
+    return uri;
+}
+
+uint32_t countUnread(const std::string& accountId,
+                     const std::string& selfUri,
+                     const std::string& conversationId,
+                     std::string lastRead) {
+    if (lastRead.empty()) {
+        for (const auto& member : libjami::getConversationMembers(accountId, conversationId)) {
+            auto uri = member.find("uri");
+            if (uri == member.end() || uri->second != selfUri) continue;
+            auto displayed = member.find("lastDisplayed");
+            if (displayed != member.end()) lastRead = displayed->second;
+            break;
+        }
+    }
+    // Newest first down to lastRead (the whole history when empty), or to our own last message
+    return libjami::countInteractions(accountId, conversationId, lastRead, "", selfUri);
+}
+
+} // namespace jbcore
@@ -0,0 +1,28 @@
+//
+//  UnreadCounter.h
+//  GetTogether
+//
+//  Unread message counts through libjami::countInteractions, which walks the
+//  conversation's history in the daemon without loading messages.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace jbcore {
+
+// The account's own URI as conversation members list it, from its details
+std::string selfUri(const std::map<std::string, std::string>& accountDetails);
+
+// Messages after `lastRead` (the member's lastDisplayed when empty), stopping
+// at the account's own latest message. Blocking.
+uint32_t countUnread(const std::string& accountId,
+                     const std::string& selfUri,
+                     const std::string& conversationId,
+                     std::string lastRead);
+
+} // namespace jbcore
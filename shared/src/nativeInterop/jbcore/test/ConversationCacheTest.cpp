@@ -0,0 +1,119 @@
+//
+//  ConversationCacheTest.cpp
+//  GetTogether
+//
+//  Values read from the daemon racing conversation signals: a snapshot or a
+//  load that started before an invalidation must not cache what it read,
+//  and each invalidation only drops the fields it names.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#include "jbcore/ConversationCache.h"
+#include "test_util.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+using Value = std::shared_ptr<std::string>;
+using Cache = jbcore::ConversationCache<Value>;
+
+Value value(const char* text) {
+    return std::make_shared<std::string>(text);
+}
+
+std::string cached(Cache& cache, jbcore::ConversationField field, const char* fallback = "loaded") {
+    return *cache.get("a", "c", field, [fallback] { return value(fallback); });
+}
+
+// Snapshot: epoch taken, daemon read, member signal invalidates, store
+void testSnapshotStoreAfterInvalidationIsDropped() {
+    Cache cache;
+    uint64_t epoch = cache.epoch("a", "c");
+    Value info = value("old info");
+    Value members = value("old members");
+    cache.invalidate(jbcore::ConversationFieldMembers, "a", "c");
+
+    EXPECT(!cache.storeIfEpoch(epoch, "a", "c", info, members, Value()));
+    EXPECT(cached(cache, jbcore::ConversationFieldMembers) == "loaded");
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "loaded");
+}
+
+void testSnapshotStoreWithoutInvalidationIsKept() {
+    Cache cache;
+    uint64_t epoch = cache.epoch("a", "c");
+    EXPECT(cache.storeIfEpoch(epoch, "a", "c", value("info"), value("members"), Value()));
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "info");
+    EXPECT(cached(cache, jbcore::ConversationFieldMembers) == "members");
+    // Not part of the snapshot: still loaded on demand
+    EXPECT(cached(cache, jbcore::ConversationFieldPreferences) == "loaded");
+}
+
+// A preferences payload stored meanwhile also moves the epoch
+void testSnapshotStoreAfterStoreIsDropped() {
+    Cache cache;
+    uint64_t epoch = cache.epoch("a", "c");
+    cache.store("a", "c", Value(), Value(), value("preferences"));
+    EXPECT(!cache.storeIfEpoch(epoch, "a", "c", value("info"), Value(), Value()));
+    EXPECT(cached(cache, jbcore::ConversationFieldPreferences) == "preferences");
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "loaded");
+}
+
+void testSnapshotStoreAfterRemovalIsDropped() {
+    Cache cache;
+    uint64_t epoch = cache.epoch("a", "c");
+    cache.removeConversation("a", "c");
+    EXPECT(!cache.storeIfEpoch(epoch, "a", "c", value("info"), Value(), Value()));
+    // Recreated entry: the epoch taken before the removal still does not match
+    cache.epoch("a", "c");
+    EXPECT(!cache.storeIfEpoch(epoch, "a", "c", value("info"), Value(), Value()));
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "loaded");
+}
+
+// A signal landing while get()'s loader reads the daemon
+void testLoadRacingInvalidationIsNotKept() {
+    Cache cache;
+    Value loaded = cache.get("a", "c", jbcore::ConversationFieldMembers, [&cache] {
+        cache.invalidate(jbcore::ConversationFieldMembers, "a", "c");
+        return value("stale");
+    });
+    EXPECT(*loaded == "stale");
+    EXPECT(cached(cache, jbcore::ConversationFieldMembers) == "loaded");
+    // Kept once loaded without interference
+    EXPECT(cached(cache, jbcore::ConversationFieldMembers, "other") == "loaded");
+}
+
+void testLoadRacingClearIsNotKept() {
+    Cache cache;
+    cache.get("a", "c", jbcore::ConversationFieldInfo, [&cache] {
+        cache.clear();
+        return value("stale");
+    });
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "loaded");
+}
+
+void testInvalidateOnlyDropsItsFields() {
+    Cache cache;
+    cache.store("a", "c", value("info"), value("members"), value("preferences"));
+    cache.invalidate(jbcore::ConversationFieldMembers, "a", "c");
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo) == "info");
+    EXPECT(cached(cache, jbcore::ConversationFieldMembers) == "loaded");
+    EXPECT(cached(cache, jbcore::ConversationFieldPreferences) == "preferences");
+
+    cache.removeAccount("a");
+    EXPECT(cached(cache, jbcore::ConversationFieldInfo, "reloaded") == "reloaded");
+}
+
+} // namespace
+
+int main() {
+    testSnapshotStoreAfterInvalidationIsDropped();
+    testSnapshotStoreWithoutInvalidationIsKept();
+    testSnapshotStoreAfterStoreIsDropped();
+    testSnapshotStoreAfterRemovalIsDropped();
+    testLoadRacingInvalidationIsNotKept();
+    testLoadRacingClearIsNotKept();
+    testInvalidateOnlyDropsItsFields();
+    return jbcore_test::testResult("ConversationCacheTest");
+}
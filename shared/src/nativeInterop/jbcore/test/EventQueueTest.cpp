@@ -0,0 +1,152 @@
+//
+//  EventQueueTest.cpp
+//  GetTogether
+//
+//  Records drained as the JNI library drains them: whole records only, in
+//  order, across partial drains that compact the buffer, and the oldest
+//  dropped once nobody drains.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#include "jbcore/EventBuffer.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::chrono::milliseconds kNoWait {0};
+constexpr size_t kHeaderSize = sizeof(uint16_t) + sizeof(uint32_t);
+
+std::vector<uint8_t> record(const std::string& accountId) {
+    return jbcore::EventWriter(jbcore::EventType::AccountsChanged).string(accountId).finish();
+}
+
+// Account ids of the records in `data`, empty on a malformed record
+std::vector<std::string> decode(const uint8_t* data, size_t size) {
+    std::vector<std::string> result;
+    size_t offset = 0;
+    while (offset < size) {
+        uint32_t payload, length;
+        if (size - offset < kHeaderSize + sizeof(length)) return {};
+        std::memcpy(&payload, data + offset + sizeof(uint16_t), sizeof(payload));
+        std::memcpy(&length, data + offset + kHeaderSize, sizeof(length));
+        if (length + sizeof(length) != payload || size - offset < kHeaderSize + payload) return {};
+        result.emplace_back(reinterpret_cast<const char*>(data + offset + kHeaderSize + sizeof(length)), length);
+        offset += kHeaderSize + payload;
+    }
+    return result;
+}
+
+void testDrainTakesWholeRecords() {
+    jbcore::EventQueue queue;
+    for (int i = 0; i < 5; i++) queue.push(record("account" + std::to_string(i)));
+    size_t recordSize = record("account0").size();
+    EXPECT(queue.pendingBytes() == 5 * recordSize);
+
+    // Room for two and a half records: two are copied
+    std::vector<uint8_t> buffer(recordSize * 5 / 2);
+    int64_t drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+    EXPECT(drained == (int64_t)(2 * recordSize));
+    auto first = decode(buffer.data(), (size_t)drained);
+    EXPECT(first == (std::vector<std::string> {"account0", "account1"}));
+    EXPECT(queue.pendingBytes() == 3 * recordSize);
+
+    drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+    EXPECT(decode(buffer.data(), (size_t)drained) == (std::vector<std::string> {"account2", "account3"}));
+    drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+    EXPECT(decode(buffer.data(), (size_t)drained) == (std::vector<std::string> {"account4"}));
+    EXPECT(queue.pendingBytes() == 0);
+    EXPECT(queue.drain(buffer.data(), buffer.size(), kNoWait) == 0);
+}
+
+// Same length for every record: r000, r001...
+std::string recordId(int index) {
+    std::string digits = std::to_string(index);
+    return "r" + std::string(3 - std::min<size_t>(digits.size(), 3), '0') + digits;
+}
+
+// Records pushed between partial drains keep their order through compaction
+void testCompactionKeepsOrder() {
+    jbcore::EventQueue queue;
+    size_t recordSize = record(recordId(0)).size();
+    std::vector<uint8_t> buffer(recordSize);
+    std::vector<std::string> received;
+    int pushed = 0;
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 3; i++) queue.push(record(recordId(pushed++)));
+        for (int i = 0; i < 2; i++) {
+            int64_t drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+            for (auto& id : decode(buffer.data(), (size_t)drained)) received.push_back(id);
+        }
+        // Drained bytes do not pile up in front of the pending ones
+        EXPECT(queue.pendingBytes() == (size_t)(pushed - (int)received.size()) * recordSize);
+    }
+    int64_t drained;
+    while ((drained = queue.drain(buffer.data(), buffer.size(), kNoWait)) > 0) {
+        for (auto& id : decode(buffer.data(), (size_t)drained)) received.push_back(id);
+    }
+
+    EXPECT((int)received.size() == pushed);
+    for (size_t i = 0; i < received.size(); i++) EXPECT(received[i] == recordId((int)i));
+}
+
+void testRecordLargerThanBuffer() {
+    jbcore::EventQueue queue;
+    auto large = record(std::string(64, 'x'));
+    size_t size = large.size();
+    queue.push(std::move(large));
+
+    std::vector<uint8_t> buffer(16);
+    // The drainer learns the size to grow its buffer to; the record stays queued
+    EXPECT(queue.drain(buffer.data(), buffer.size(), kNoWait) == -(int64_t)size);
+    EXPECT(queue.pendingBytes() == size);
+    buffer.resize(size);
+    EXPECT(queue.drain(buffer.data(), buffer.size(), kNoWait) == (int64_t)size);
+}
+
+// Nobody drains: the oldest records go, the newest stay in order
+void testFullQueueDropsOldest() {
+    size_t recordSize = record(recordId(0)).size();
+    jbcore::EventQueue queue(4 * recordSize);
+    for (int i = 0; i < 10; i++) queue.push(record(recordId(i)));
+    EXPECT(queue.droppedRecords() == 6);
+    EXPECT(queue.pendingBytes() == 4 * recordSize);
+
+    std::vector<uint8_t> buffer(10 * recordSize);
+    int64_t drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+    EXPECT(decode(buffer.data(), (size_t)drained)
+           == (std::vector<std::string> {recordId(6), recordId(7), recordId(8), recordId(9)}));
+
+    // A record larger than the bound is still delivered
+    queue.push(record(std::string(8 * recordSize, 'x')));
+    queue.push(record(recordId(10)));
+    EXPECT(queue.droppedRecords() == 7);
+    drained = queue.drain(buffer.data(), buffer.size(), kNoWait);
+    EXPECT(decode(buffer.data(), (size_t)drained) == (std::vector<std::string> {recordId(10)}));
+}
+
+void testCloseAndReopen() {
+    jbcore::EventQueue queue;
+    queue.push(record("a"));
+    queue.close();
+    std::vector<uint8_t> buffer(256);
+    EXPECT(queue.drain(buffer.data(), buffer.size(), std::chrono::milliseconds(50)) == 0);
+    queue.reopen();
+    EXPECT(queue.drain(buffer.data(), buffer.size(), kNoWait) > 0);
+}
+
+} // namespace
+
+int main() {
+    testDrainTakesWholeRecords();
+    testCompactionKeepsOrder();
+    testRecordLargerThanBuffer();
+    testFullQueueDropsOldest();
+    testCloseAndReopen();
+    return jbcore_test::testResult("EventQueueTest");
+}
@@ -0,0 +1,158 @@
+//
+//  FairQueueTest.cpp
+//  GetTogether
+//
+//  Delivery lanes as the front-ends drive them: one runNext() slot queued on
+//  a serial executor per push, coalesced batches split per account and
+//  pushed when the window closes.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#include "jbcore/Coalescer.h"
+#include "jbcore/FairQueue.h"
+#include "test_util.h"
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A serial queue: each push queues one runNext() slot, as dispatch_async does
+struct SerialExecutor {
+    jbcore::FairQueue lanes;
+    std::deque<std::function<void()>> slots;
+
+    void dispatch(const std::string& account, std::function<void()> task, bool priority = false) {
+        lanes.push(account, std::move(task), priority);
+        slots.push_back([this] { lanes.runNext(); });
+    }
+
+    void drain() {
+        while (!slots.empty()) {
+            auto slot = std::move(slots.front());
+            slots.pop_front();
+            slot();
+        }
+    }
+};
+
+struct UpdateEvent {
+    std::string accountId;
+    std::string messageId;
+};
+
+size_t indexOf(const std::vector<std::string>& log, const std::string& entry) {
+    for (size_t i = 0; i < log.size(); i++) {
+        if (log[i] == entry) return i;
+    }
+    return log.size();
+}
+
+void testRoundRobinKeepsLaneOrder() {
+    SerialExecutor executor;
+    std::vector<std::string> log;
+    for (int i = 0; i < 50; i++) {
+        executor.dispatch("b", [&log, i] { log.push_back("b" + std::to_string(i)); });
+    }
+    for (int i = 0; i < 3; i++) {
+        executor.dispatch("a", [&log, i] { log.push_back("a" + std::to_string(i)); });
+    }
+    executor.drain();
+
+    EXPECT(log.size() == 53);
+    // a takes turns with b instead of waiting for the whole backlog
+    EXPECT(indexOf(log, "a0") == 1);
+    EXPECT(indexOf(log, "a2") == 5);
+    EXPECT(indexOf(log, "a0") < indexOf(log, "a1"));
+    EXPECT(indexOf(log, "a1") < indexOf(log, "a2"));
+    for (int i = 1; i < 50; i++) {
+        EXPECT(indexOf(log, "b" + std::to_string(i - 1)) < indexOf(log, "b" + std::to_string(i)));
+    }
+}
+
+// A coalesced update must not overtake the received signal of its account
+// still waiting in the lane, while other accounts take turns with it
+void testCoalescedFlushStaysBehindItsLane() {
+    SerialExecutor executor;
+    std::vector<std::string> log;
+    std::function<void()> window;
+    auto updates = jbcore::Coalescer<std::string, UpdateEvent>::create(
+        [&window](int64_t, std::function<void()> task) { window = std::move(task); },
+        [&executor, &log](std::vector<UpdateEvent>&& events) {
+            for (auto& [account, batch] : jbcore::splitByAccount(std::move(events))) {
+                EXPECT(!batch.empty());
+                for (const auto& event : batch) EXPECT(event.accountId == account);
+                std::string entry = account + ":updated";
+                for (const auto& event : batch) entry += " " + event.messageId;
+                executor.dispatch(account, [&log, entry] { log.push_back(entry); });
+            }
+        });
+
+    // a is backlogged itself, and b keeps queueing after the window closed
+    for (int i = 0; i < 50; i++) {
+        std::string entry = i == 49 ? "a:received m1" : "a:received " + std::to_string(i);
+        executor.dispatch("a", [&log, entry] { log.push_back(entry); });
+    }
+    updates->post("a/m1", {"a", "m1"});
+    updates->post("b/x", {"b", "x"});
+    updates->post("a/m2", {"a", "m2"});
+    // The window closes before the executor caught up, as during a swarm sync
+    EXPECT(window != nullptr);
+    window();
+    for (int i = 0; i < 100; i++) {
+        executor.dispatch("b", [&log, i] { log.push_back("b:received " + std::to_string(i)); });
+    }
+    executor.drain();
+
+    size_t received = indexOf(log, "a:received m1");
+    size_t updated = indexOf(log, "a:updated m1 m2");
+    EXPECT(received < log.size());
+    EXPECT(updated < log.size());
+    EXPECT(received < updated);
+    EXPECT(indexOf(log, "b:updated x") < indexOf(log, "b:received 0"));
+}
+
+void testPriorityPassesLanes() {
+    SerialExecutor executor;
+    std::vector<std::string> log;
+    for (int i = 0; i < 10; i++) {
+        executor.dispatch("a", [&log, i] { log.push_back("a" + std::to_string(i)); });
+    }
+    executor.dispatch("a", [&log] { log.push_back("incoming"); }, true);
+    executor.dispatch("a", [&log] { log.push_back("state"); }, true);
+    executor.drain();
+
+    EXPECT(indexOf(log, "incoming") == 0);
+    EXPECT(indexOf(log, "state") == 1);
+    auto stats = executor.lanes.stats();
+    EXPECT(stats["a"].delivered == 12);
+    EXPECT(stats["a"].priorityDelivered == 2);
+    EXPECT(stats["a"].pending == 0);
+}
+
+void testWeight() {
+    SerialExecutor executor;
+    std::vector<std::string> log;
+    executor.lanes.setWeight("a", 3);
+    for (int i = 0; i < 6; i++) {
+        executor.dispatch("a", [&log] { log.push_back("a"); });
+        executor.dispatch("b", [&log] { log.push_back("b"); });
+    }
+    executor.drain();
+
+    std::string order;
+    for (const auto& entry : log) order += entry;
+    EXPECT(order == "aaabaaabbbbb");
+}
+
+} // namespace
+
+int main() {
+    testRoundRobinKeepsLaneOrder();
+    testCoalescedFlushStaysBehindItsLane();
+    testPriorityPassesLanes();
+    testWeight();
+    return jbcore_test::testResult("FairQueueTest");
+}
@@ -0,0 +1,186 @@
+//
+//  ReceiptSchedulerTest.cpp
+//  GetTogether
+//
+//  Read receipts as a conversation screen produces them: repeated and older
+//  receipts suppressed, the idle flush pushed back by each receipt but never
+//  past the cap, and removed accounts forgotten. Time is driven by a fake
+//  scheduler and clock.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#include "jbcore/ReceiptScheduler.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int64_t kSecond = jbcore::kNanosPerSecond;
+
+// Tasks run in deadline order when the test advances the clock. Times are
+// relative to an arbitrary start, as a steady clock's are.
+struct FakeTimers {
+    struct Task {
+        int64_t deadlineNs;
+        std::function<void()> run;
+    };
+
+    static constexpr int64_t kStartNs = 1000 * kSecond;
+    int64_t nowNs = kStartNs;
+    std::vector<Task> tasks;
+
+    jbcore::Scheduler scheduler() {
+        return [this](int64_t delayNs, std::function<void()> task) {
+            tasks.push_back({nowNs + delayNs, std::move(task)});
+        };
+    }
+
+    jbcore::ReceiptScheduler::Clock clock() {
+        return [this] { return nowNs; };
+    }
+
+    void advanceTo(int64_t elapsedNs) {
+        int64_t timeNs = kStartNs + elapsedNs;
+        for (;;) {
+            auto next = std::min_element(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
+                return a.deadlineNs < b.deadlineNs;
+            });
+            if (next == tasks.end() || next->deadlineNs > timeNs) break;
+            Task task = std::move(*next);
+            tasks.erase(next);
+            nowNs = task.deadlineNs;
+            task.run();
+        }
+        nowNs = timeNs;
+    }
+};
+
+struct Sent {
+    std::string accountId;
+    std::string conversationId;
+    std::string messageId;
+};
+
+struct Fixture {
+    FakeTimers timers;
+    std::vector<Sent> sent;
+    std::shared_ptr<jbcore::ReceiptScheduler> receipts = jbcore::ReceiptScheduler::create(
+        timers.scheduler(),
+        [this](const std::string& account, const std::string& conversation, const std::string& message) {
+            sent.push_back({account, conversation, message});
+        },
+        timers.clock());
+};
+
+libjami::SwarmMessage message(const std::string& id, int64_t timestamp) {
+    libjami::SwarmMessage result;
+    result.id = id;
+    result.type = "text/plain";
+    result.body["timestamp"] = std::to_string(timestamp);
+    return result;
+}
+
+void testNewestReceiptPerConversation() {
+    Fixture f;
+    f.receipts->noteMessages({message("m1", 100), message("m2", 200), message("m3", 300)});
+    f.receipts->markDisplayed("a", "c", "m2");
+    f.receipts->markDisplayed("a", "c", "m3");
+    // Scrolling back through history
+    f.receipts->markDisplayed("a", "c", "m1");
+    f.receipts->markDisplayed("a", "d", "x");
+    EXPECT(f.receipts->pendingMessage("a", "c") == "m3");
+
+    f.timers.advanceTo(10 * kSecond);
+    EXPECT(f.sent.size() == 2);
+    EXPECT(f.receipts->pendingMessage("a", "c").empty());
+    for (const auto& receipt : f.sent) {
+        EXPECT(receipt.conversationId == "c" ? receipt.messageId == "m3" : receipt.messageId == "x");
+    }
+}
+
+void testSentReceiptIsNotRepeated() {
+    Fixture f;
+    f.receipts->noteMessages({message("m1", 100), message("m2", 200)});
+    f.receipts->markDisplayed("a", "c", "m2");
+    f.receipts->flush();
+    EXPECT(f.sent.size() == 1);
+
+    // Same message again, then an older one: neither is pending nor scheduled
+    f.receipts->markDisplayed("a", "c", "m2");
+    f.receipts->markDisplayed("a", "c", "m1");
+    EXPECT(f.receipts->pendingMessage("a", "c").empty());
+    f.timers.advanceTo(20 * kSecond);
+    EXPECT(f.sent.size() == 1);
+
+    // An unknown message counts as the newest: it was just displayed
+    f.receipts->markDisplayed("a", "c", "m9");
+    EXPECT(f.receipts->pendingMessage("a", "c") == "m9");
+}
+
+void testIdleFlushWaitsForQuiet() {
+    Fixture f;
+    f.receipts->markDisplayed("a", "c", "m1");
+    f.timers.advanceTo(1 * kSecond);
+    f.receipts->markDisplayed("a", "c", "m2");
+    // The first receipt's flush is superseded by the second one
+    f.timers.advanceTo(2 * kSecond + kSecond / 2);
+    EXPECT(f.sent.empty());
+    f.timers.advanceTo(3 * kSecond);
+    EXPECT(f.sent.size() == 1);
+    EXPECT(!f.sent.empty() && f.sent[0].messageId == "m2");
+}
+
+void testContinuousReceiptsFlushAtTheCap() {
+    Fixture f;
+    // One receipt per second keeps the idle flush from ever running
+    for (int i = 0; i < 10; i++) {
+        f.timers.advanceTo(i * kSecond);
+        EXPECT(f.sent.empty());
+        f.receipts->markDisplayed("a", "c", "m" + std::to_string(i));
+    }
+    f.timers.advanceTo(10 * kSecond - 1);
+    EXPECT(f.sent.empty());
+    f.timers.advanceTo(10 * kSecond);
+    EXPECT(f.sent.size() == 1);
+    EXPECT(!f.sent.empty() && f.sent[0].messageId == "m9");
+
+    // The cap restarts with the next receipt
+    f.receipts->markDisplayed("a", "c", "m10");
+    f.timers.advanceTo(12 * kSecond);
+    EXPECT(f.sent.size() == 2);
+}
+
+void testRemoveAccount() {
+    Fixture f;
+    f.receipts->markDisplayed("a", "c", "m1");
+    f.receipts->markDisplayed("b", "c", "m1");
+    f.receipts->flush();
+    EXPECT(f.sent.size() == 2);
+
+    f.receipts->markDisplayed("a", "c", "m2");
+    f.receipts->markDisplayed("b", "c", "m2");
+    f.receipts->removeAccount("a");
+    EXPECT(f.receipts->pendingMessage("a", "c").empty());
+    f.timers.advanceTo(10 * kSecond);
+    EXPECT(f.sent.size() == 3);
+    EXPECT(f.sent.size() == 3 && f.sent[2].accountId == "b");
+
+    // The last sent receipt is forgotten too: a re-added account sends again
+    f.receipts->markDisplayed("a", "c", "m1");
+    EXPECT(f.receipts->pendingMessage("a", "c") == "m1");
+}
+
+} // namespace
+
+int main() {
+    testNewestReceiptPerConversation();
+    testSentReceiptIsNotRepeated();
+    testIdleFlushWaitsForQuiet();
+    testContinuousReceiptsFlushAtTheCap();
+    testRemoveAccount();
+    return jbcore_test::testResult("ReceiptSchedulerTest");
+}
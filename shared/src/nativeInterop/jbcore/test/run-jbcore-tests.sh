@@ -0,0 +1,38 @@
+#!/bin/bash
+#
+# Build and run the bridge core tests on the host
+#
+# The tests only use jbcore, the libjami headers (for its value types) and
+# the C++ standard library: no libjami library, no Foundation, no JNI. Set
+# CXX to pick the compiler (default c++). Binaries are built in a temporary
+# directory, removed on exit.
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+JBCORE_DIR="$(dirname "$SCRIPT_DIR")"
+NATIVE_INTEROP_DIR="$(dirname "$JBCORE_DIR")"
+
+# Configuration
+CXX="${CXX:-c++}"
+BUILD_DIR="$(mktemp -d "${TMPDIR:-/tmp}/jbcore-tests.XXXXXX")"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+# Build settings
+CXX_FLAGS="-std=c++17 -Wall -Wextra -g -O1"
+INCLUDE_FLAGS="-I$NATIVE_INTEROP_DIR/cinterop/headers -I$NATIVE_INTEROP_DIR"
+LINK_FLAGS="-lpthread"
+
+# Core sources that do not call into libjami
+SOURCES=("$JBCORE_DIR/FairQueue.cpp" "$JBCORE_DIR/ReceiptScheduler.cpp" "$JBCORE_DIR/EventBuffer.cpp")
+
+status=0
+for test in "$SCRIPT_DIR"/*Test.cpp; do
+    name="$(basename "${test%.*}")"
+    echo "=== $name ==="
+    "$CXX" "$test" "${SOURCES[@]}" -o "$BUILD_DIR/$name" $CXX_FLAGS $INCLUDE_FLAGS $LINK_FLAGS
+    "$BUILD_DIR/$name" || status=1
+done
+
+exit $status
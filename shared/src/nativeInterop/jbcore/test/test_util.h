@@ -0,0 +1,36 @@
+//
+//  test_util.h
+//  GetTogether
+//
+//  Checks shared by the core tests: EXPECT records a failure and carries on,
+//  testResult() reports them and gives main() its exit status. Each test is
+//  its own executable, so the counter is per test.
+//  Platform-neutral C++: no Foundation, no JNI.
+//
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace jbcore_test {
+
+inline int failures = 0;
+
+inline int testResult(const char *name) {
+    if (failures > 0) {
+        std::fprintf(stderr, "%s: %d failure(s)\n", name, failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: ok\n", name);
+    return EXIT_SUCCESS;
+}
+
+} // namespace jbcore_test
+
+#define EXPECT(condition) do { \
+    if (!(condition)) { \
+        std::fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition); \
+        jbcore_test::failures++; \
+    } \
+} while (0)
@@ -0,0 +1,402 @@
+//
+//  JamiBridgeJNI.cpp
+//  GetTogether
+//
+//  JNI entry points of libjamibridge, the desktop (JVM) front-end of the
+//  bridge core: net.jami.services.JamiNative. Signals are encoded by the
+//  core handlers (jbcore/CoreSignals.h) and drained by one Kotlin thread
+//  through pollEvents into a direct ByteBuffer, so a batch of events costs
+//  one JNI transition and no per-event Java objects on the daemon thread.
+//
+//  Maps and lists cross as byte arrays in the event encoding
+//  (jbcore/EventBuffer.h). Identifiers are ASCII and cross as jstring;
+//  free text (message bodies, profile fields) always crosses as UTF-8 bytes,
+//  since JNI's modified UTF-8 differs for supplementary characters.
+//
+
+#include <jni.h>
+
+#include "jbcore/CoreSignals.h"
+#include "jbcore/EventBuffer.h"
+#include "jbcore/ReceiptScheduler.h"
+#include "jbcore/TimerQueue.h"
+#include "jbcore/UnreadCounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "jami.h"
+#include "configurationmanager_interface.h"
+#include "conversation_interface.h"
+
+#define JB_JNI(name) Java_net_jami_services_JamiNative_##name
+
+namespace {
+
+using jbcore::ConversationField;
+using jbcore::EncodedValue;
+using jbcore::StringMap;
+
+// libjami's status for a displayed message
+constexpr int kDisplayedStatus = 3;
+
+// Parallel countInteractions walks for countUnreadMessages
+constexpr unsigned kMaxUnreadWorkers = 4;
+
+struct Bridge {
+    std::shared_ptr<jbcore::EventQueue> events = std::make_shared<jbcore::EventQueue>();
+    std::shared_ptr<jbcore::EncodedConversationCache> conversations =
+        std::make_shared<jbcore::EncodedConversationCache>();
+    std::unique_ptr<jbcore::TimerQueue> timers;
+    std::shared_ptr<jbcore::ReceiptScheduler> receipts;
+    std::mutex lifecycle;  // init/start/fini
+};
+
+Bridge& bridge() {
+    static Bridge* instance = new Bridge();
+    return *instance;
+}
+
+// init and fini replace the scheduler: copy the pointer under their lock
+std::shared_ptr<jbcore::ReceiptScheduler> receipts() {
+    auto& b = bridge();
+    std::lock_guard<std::mutex> lock(b.lifecycle);
+    return b.receipts;
+}
+
+std::string toString(JNIEnv* env, jstring value) {
+    if (!value) return {};
+    const char* chars = env->GetStringUTFChars(value, nullptr);
+    if (!chars) return {};
+    std::string result(chars);
+    env->ReleaseStringUTFChars(value, chars);
+    return result;
+}
+
+jstring toJString(JNIEnv* env, const std::string& value) {
+    return env->NewStringUTF(value.c_str());
+}
+
+std::vector<uint8_t> toBytes(JNIEnv* env, jbyteArray value) {
+    if (!value) return {};
+    std::vector<uint8_t> bytes(env->GetArrayLength(value));
+    env->GetByteArrayRegion(value, 0, (jsize)bytes.size(), reinterpret_cast<jbyte*>(bytes.data()));
+    return bytes;
+}
+
+std::string toUtf8(JNIEnv* env, jbyteArray value) {
+    auto bytes = toBytes(env, value);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+StringMap toMap(JNIEnv* env, jbyteArray value) {
+    auto bytes = toBytes(env, value);
+    StringMap map;
+    if (!bytes.empty() && !jbcore::decodeMap(bytes.data(), bytes.size(), map)) map.clear();
+    return map;
+}
+
+jbyteArray toByteArray(JNIEnv* env, const std::vector<uint8_t>& bytes) {
+    jbyteArray array = env->NewByteArray((jsize)bytes.size());
+    if (array) env->SetByteArrayRegion(array, 0, (jsize)bytes.size(), reinterpret_cast<const jbyte*>(bytes.data()));
+    return array;
+}
+
+EncodedValue shared(std::vector<uint8_t>&& bytes) {
+    return std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+}
+
+// Cached getter: the encoded value is built once per invalidation
+jbyteArray cachedConversationValue(JNIEnv* env, jstring accountId, jstring conversationId,
+                                   ConversationField field,
+                                   std::vector<uint8_t> (*load)(const std::string&, const std::string&)) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    EncodedValue value = bridge().conversations->get(account, conversation, field, [&] {
+        return shared(load(account, conversation));
+    });
+    return toByteArray(env, *value);
+}
+
+} // namespace
+
+extern "C" {
+
+// =============================================================================
+// Lifecycle
+// =============================================================================
+
+JNIEXPORT jboolean JNICALL JB_JNI(init)(JNIEnv*, jclass, jint flags) {
+    auto& b = bridge();
+    std::lock_guard<std::mutex> lock(b.lifecycle);
+    if (libjami::initialized()) return JNI_TRUE;
+
+    b.timers = std::make_unique<jbcore::TimerQueue>();
+    b.receipts = jbcore::ReceiptScheduler::create(b.timers->scheduler(),
+        [](const std::string& accountId, const std::string& conversationId, const std::string& messageId) {
+            libjami::setMessageDisplayed(accountId, conversationId, messageId, kDisplayedStatus);
+        });
+    b.events->reopen();
+
+    if (!libjami::init(static_cast<libjami::InitFlag>(flags))) {
+        // Receipts must not schedule on a stopped queue: a retried init creates both again
+        b.receipts.reset();
+        b.timers->stop();
+        b.timers.reset();
+        return JNI_FALSE;
+    }
+    jbcore::SignalHandlerMap handlers;
+    jbcore::addCoreSignalHandlers(handlers, {b.events, b.conversations, b.receipts, b.timers->scheduler()});
+    libjami::registerSignalHandlers(handlers);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL JB_JNI(start)(JNIEnv*, jclass) {
+    std::lock_guard<std::mutex> lock(bridge().lifecycle);
+    return libjami::start() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL JB_JNI(fini)(JNIEnv*, jclass) {
+    auto& b = bridge();
+    std::lock_guard<std::mutex> lock(b.lifecycle);
+    if (b.receipts) b.receipts->flush();
+    libjami::unregisterSignalHandlers();
+    libjami::fini();
+    b.receipts.reset();
+    if (b.timers) b.timers->stop();
+    b.timers.reset();
+    b.conversations->clear();
+    // Wakes the event thread; it sees the closed queue and exits
+    b.events->close();
+}
+
+// Copies whole records into `buffer` (a direct ByteBuffer) and returns their
+// size: 0 after `timeoutMs` without events or once fini closed the queue,
+// minus the size of a record larger than the buffer.
+JNIEXPORT jint JNICALL JB_JNI(pollEvents)(JNIEnv* env, jclass, jobject buffer, jint timeoutMs) {
+    auto* data = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!data || capacity <= 0) return 0;
+    return (jint)bridge().events->drain(data, (size_t)capacity, std::chrono::milliseconds(timeoutMs));
+}
+
+// Records dropped because the queue was full (nobody polled)
+JNIEXPORT jlong JNICALL JB_JNI(droppedEvents)(JNIEnv*, jclass) {
+    return (jlong)bridge().events->droppedRecords();
+}
+
+// =============================================================================
+// Accounts
+// =============================================================================
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getAccountList)(JNIEnv* env, jclass) {
+    return toByteArray(env, jbcore::encodeStringList(libjami::getAccountList()));
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getAccountDetails)(JNIEnv* env, jclass, jstring accountId) {
+    return toByteArray(env, jbcore::encodeMap(libjami::getAccountDetails(toString(env, accountId))));
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getVolatileAccountDetails)(JNIEnv* env, jclass, jstring accountId) {
+    return toByteArray(env, jbcore::encodeMap(libjami::getVolatileAccountDetails(toString(env, accountId))));
+}
+
+JNIEXPORT jstring JNICALL JB_JNI(addAccount)(JNIEnv* env, jclass, jbyteArray details) {
+    return toJString(env, libjami::addAccount(toMap(env, details)));
+}
+
+JNIEXPORT void JNICALL JB_JNI(removeAccount)(JNIEnv* env, jclass, jstring accountId) {
+    std::string account = toString(env, accountId);
+    if (auto scheduler = receipts()) scheduler->removeAccount(account);
+    bridge().conversations->removeAccount(account);
+    libjami::removeAccount(account);
+}
+
+JNIEXPORT void JNICALL JB_JNI(setAccountDetails)(JNIEnv* env, jclass, jstring accountId, jbyteArray details) {
+    libjami::setAccountDetails(toString(env, accountId), toMap(env, details));
+}
+
+JNIEXPORT void JNICALL JB_JNI(setAccountActive)(JNIEnv* env, jclass, jstring accountId, jboolean active) {
+    libjami::setAccountActive(toString(env, accountId), active == JNI_TRUE);
+}
+
+JNIEXPORT void JNICALL JB_JNI(sendRegister)(JNIEnv* env, jclass, jstring accountId, jboolean enable) {
+    libjami::sendRegister(toString(env, accountId), enable == JNI_TRUE);
+}
+
+// =============================================================================
+// Conversations
+// =============================================================================
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getConversations)(JNIEnv* env, jclass, jstring accountId) {
+    return toByteArray(env, jbcore::encodeStringList(libjami::getConversations(toString(env, accountId))));
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(conversationInfos)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    return cachedConversationValue(env, accountId, conversationId, jbcore::ConversationFieldInfo,
+        [](const std::string& account, const std::string& conversation) {
+            return jbcore::encodeMap(libjami::conversationInfos(account, conversation));
+        });
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getConversationMembers)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    return cachedConversationValue(env, accountId, conversationId, jbcore::ConversationFieldMembers,
+        [](const std::string& account, const std::string& conversation) {
+            return jbcore::encodeMapList(libjami::getConversationMembers(account, conversation));
+        });
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getConversationPreferences)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    return cachedConversationValue(env, accountId, conversationId, jbcore::ConversationFieldPreferences,
+        [](const std::string& account, const std::string& conversation) {
+            return jbcore::encodeMap(libjami::getConversationPreferences(account, conversation));
+        });
+}
+
+JNIEXPORT void JNICALL JB_JNI(setConversationPreferences)(JNIEnv* env, jclass, jstring accountId,
+                                                          jstring conversationId, jbyteArray prefs) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    libjami::setConversationPreferences(account, conversation, toMap(env, prefs));
+    // Merged by the daemon: reloaded, or replaced by ConversationPreferencesUpdated
+    bridge().conversations->invalidate(jbcore::ConversationFieldPreferences, account, conversation);
+}
+
+JNIEXPORT void JNICALL JB_JNI(updateConversationInfos)(JNIEnv* env, jclass, jstring accountId,
+                                                       jstring conversationId, jbyteArray infos) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    libjami::updateConversationInfos(account, conversation, toMap(env, infos));
+    bridge().conversations->invalidate(jbcore::ConversationFieldInfo, account, conversation);
+}
+
+JNIEXPORT jstring JNICALL JB_JNI(startConversation)(JNIEnv* env, jclass, jstring accountId) {
+    return toJString(env, libjami::startConversation(toString(env, accountId)));
+}
+
+JNIEXPORT void JNICALL JB_JNI(removeConversation)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    libjami::removeConversation(account, conversation);
+    bridge().conversations->removeConversation(account, conversation);
+}
+
+JNIEXPORT void JNICALL JB_JNI(addConversationMember)(JNIEnv* env, jclass, jstring accountId,
+                                                     jstring conversationId, jstring uri) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    libjami::addConversationMember(account, conversation, toString(env, uri));
+    bridge().conversations->invalidate(jbcore::ConversationFieldMembers, account, conversation);
+}
+
+JNIEXPORT void JNICALL JB_JNI(removeConversationMember)(JNIEnv* env, jclass, jstring accountId,
+                                                        jstring conversationId, jstring uri) {
+    std::string account = toString(env, accountId);
+    std::string conversation = toString(env, conversationId);
+    libjami::removeConversationMember(account, conversation, toString(env, uri));
+    bridge().conversations->invalidate(jbcore::ConversationFieldMembers, account, conversation);
+}
+
+JNIEXPORT jint JNICALL JB_JNI(loadConversation)(JNIEnv* env, jclass, jstring accountId, jstring conversationId,
+                                                jstring fromMessage, jint size) {
+    return (jint)libjami::loadConversation(toString(env, accountId), toString(env, conversationId),
+                                           toString(env, fromMessage), (size_t)std::max(size, 0));
+}
+
+JNIEXPORT jint JNICALL JB_JNI(loadSwarmUntil)(JNIEnv* env, jclass, jstring accountId, jstring conversationId,
+                                              jstring fromMessage, jstring toMessage) {
+    return (jint)libjami::loadSwarmUntil(toString(env, accountId), toString(env, conversationId),
+                                         toString(env, fromMessage), toString(env, toMessage));
+}
+
+JNIEXPORT void JNICALL JB_JNI(sendMessage)(JNIEnv* env, jclass, jstring accountId, jstring conversationId,
+                                           jbyteArray message, jstring replyTo, jint flag) {
+    libjami::sendMessage(toString(env, accountId), toString(env, conversationId),
+                         toUtf8(env, message), toString(env, replyTo), flag);
+}
+
+// Coalesced: only the newest receipt per conversation reaches the daemon
+JNIEXPORT void JNICALL JB_JNI(setMessageDisplayed)(JNIEnv* env, jclass, jstring accountId,
+                                                   jstring conversationId, jstring messageId) {
+    auto scheduler = receipts();
+    if (!scheduler) return;
+    scheduler->markDisplayed(toString(env, accountId), toString(env, conversationId), toString(env, messageId));
+}
+
+// Counts in the order of `conversationIds` (an encoded string list)
+JNIEXPORT jintArray JNICALL JB_JNI(countUnreadMessages)(JNIEnv* env, jclass, jstring accountId,
+                                                        jbyteArray conversationIds) {
+    std::string account = toString(env, accountId);
+    auto bytes = toBytes(env, conversationIds);
+    std::vector<std::string> conversations;
+    if (!bytes.empty() && !jbcore::decodeStringList(bytes.data(), bytes.size(), conversations)) conversations.clear();
+
+    std::string selfUri = jbcore::selfUri(libjami::getAccountDetails(account));
+    std::shared_ptr<jbcore::ReceiptScheduler> scheduler = receipts();
+    std::vector<jint> counts(conversations.size());
+    std::atomic<size_t> next {0};
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < conversations.size();) {
+            std::string lastRead = scheduler ? scheduler->pendingMessage(account, conversations[i]) : std::string();
+            counts[i] = (jint)jbcore::countUnread(account, selfUri, conversations[i], std::move(lastRead));
+        }
+    };
+    unsigned workers = std::min<size_t>({kMaxUnreadWorkers, std::max(1u, std::thread::hardware_concurrency()),
+                                         conversations.size()});
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workers; i++) threads.emplace_back(work);
+    work();
+    for (auto& thread : threads) thread.join();
+
+    jintArray result = env->NewIntArray((jsize)counts.size());
+    if (result) env->SetIntArrayRegion(result, 0, (jsize)counts.size(), counts.data());
+    return result;
+}
+
+// =============================================================================
+// Requests, contacts and names
+// =============================================================================
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getConversationRequests)(JNIEnv* env, jclass, jstring accountId) {
+    return toByteArray(env, jbcore::encodeMapList(libjami::getConversationRequests(toString(env, accountId))));
+}
+
+JNIEXPORT void JNICALL JB_JNI(acceptConversationRequest)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    libjami::acceptConversationRequest(toString(env, accountId), toString(env, conversationId));
+}
+
+JNIEXPORT void JNICALL JB_JNI(declineConversationRequest)(JNIEnv* env, jclass, jstring accountId, jstring conversationId) {
+    libjami::declineConversationRequest(toString(env, accountId), toString(env, conversationId));
+}
+
+JNIEXPORT jbyteArray JNICALL JB_JNI(getContacts)(JNIEnv* env, jclass, jstring accountId) {
+    return toByteArray(env, jbcore::encodeMapList(libjami::getContacts(toString(env, accountId))));
+}
+
+JNIEXPORT void JNICALL JB_JNI(addContact)(JNIEnv* env, jclass, jstring accountId, jstring uri) {
+    libjami::addContact(toString(env, accountId), toString(env, uri));
+}
+
+JNIEXPORT void JNICALL JB_JNI(removeContact)(JNIEnv* env, jclass, jstring accountId, jstring uri, jboolean ban) {
+    libjami::removeContact(toString(env, accountId), toString(env, uri), ban == JNI_TRUE);
+}
+
+JNIEXPORT jboolean JNICALL JB_JNI(lookupName)(JNIEnv* env, jclass, jstring accountId, jstring nameServer, jbyteArray name) {
+    return libjami::lookupName(toString(env, accountId), toString(env, nameServer), toUtf8(env, name)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL JB_JNI(lookupAddress)(JNIEnv* env, jclass, jstring accountId, jstring nameServer, jstring address) {
+    return libjami::lookupAddress(toString(env, accountId), toString(env, nameServer), toString(env, address)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL JB_JNI(setIsComposing)(JNIEnv* env, jclass, jstring accountId, jstring conversationUri, jboolean composing) {
+    libjami::setIsComposing(toString(env, accountId), toString(env, conversationUri), composing == JNI_TRUE);
+}
+
+} // extern "C"
@@ -0,0 +1,85 @@
+#!/bin/bash
+#
+# Build libjamibridge, the JNI library of the desktop (JVM) target
+#
+# This script compiles JamiBridgeJNI.cpp and the platform-neutral bridge core
+# (../jbcore, shared with the iOS/macOS JamiBridge) into a shared library
+# loaded by DaemonBridge.desktop.kt as "jamibridge".
+#
+# Prerequisites:
+# - libjami built for the host (shared or static), in $LIBJAMI_DIR
+# - libjami headers in ../cinterop/headers/
+# - A JDK ($JAVA_HOME/include/jni.h)
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+NATIVE_INTEROP_DIR="$(dirname "$SCRIPT_DIR")"
+
+# Configuration
+HEADERS_DIR="$NATIVE_INTEROP_DIR/cinterop/headers"
+LIBJAMI_DIR="${LIBJAMI_DIR:-/usr/local/lib}"
+BUILD_DIR="$NATIVE_INTEROP_DIR/build/jni"
+OUTPUT_DIR="${OUTPUT_DIR:-$BUILD_DIR}"
+
+if [ -z "$JAVA_HOME" ]; then
+    echo "Error: JAVA_HOME is not set"
+    exit 1
+fi
+
+case "$(uname -s)" in
+    Darwin)
+        JNI_PLATFORM="darwin"
+        LIBRARY="libjamibridge.dylib"
+        SHARED_FLAGS="-dynamiclib -install_name @rpath/$LIBRARY"
+        ;;
+    *)
+        JNI_PLATFORM="linux"
+        LIBRARY="libjamibridge.so"
+        SHARED_FLAGS="-shared -Wl,--no-undefined"
+        ;;
+esac
+
+# Build settings
+CXX_FLAGS="-std=c++17 -fPIC -fvisibility=hidden -DNDEBUG -O2"
+INCLUDE_FLAGS="-I$HEADERS_DIR -I$NATIVE_INTEROP_DIR -I$JAVA_HOME/include -I$JAVA_HOME/include/$JNI_PLATFORM"
+LINK_FLAGS="-L$LIBJAMI_DIR -ljami -lpthread"
+
+SOURCES=("$SCRIPT_DIR"/*.cpp "$NATIVE_INTEROP_DIR"/jbcore/*.cpp)
+
+# Check prerequisites
+if [ ! -f "$HEADERS_DIR/jami.h" ]; then
+    echo "Error: jami.h not found in $HEADERS_DIR"
+    echo "Please copy libjami headers from gettogether or jami-daemon"
+    exit 1
+fi
+
+if [ ! -f "$JAVA_HOME/include/jni.h" ]; then
+    echo "Error: jni.h not found in $JAVA_HOME/include"
+    exit 1
+fi
+
+echo "=== Building $LIBRARY ==="
+echo "libjami: $LIBJAMI_DIR"
+echo "Output:  $OUTPUT_DIR"
+echo ""
+
+mkdir -p "$BUILD_DIR" "$OUTPUT_DIR"
+
+objects=()
+for src in "${SOURCES[@]}"; do
+    name="$(basename "${src%.*}")"
+    obj="$BUILD_DIR/${name}.o"
+    echo "  $(basename "$src")"
+    clang++ -c "$src" -o "$obj" $CXX_FLAGS $INCLUDE_FLAGS
+    objects+=("$obj")
+done
+
+clang++ "${objects[@]}" -o "$OUTPUT_DIR/$LIBRARY" $SHARED_FLAGS $LINK_FLAGS
+
+echo ""
+echo "=== Build Complete ==="
+ls -lh "$OUTPUT_DIR/$LIBRARY"
+echo ""
+echo "Run the desktop app with -Djava.library.path=$OUTPUT_DIR"